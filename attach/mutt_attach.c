@@ -367,7 +367,7 @@ void mutt_check_lookup_list(struct Body *b, char *type, size_t len)
                  tmp.subtype);
         mutt_debug(LL_DEBUG1, "\"%s\" -> %s\n", b->filename, type);
       }
-      FREE(&tmp.subtype);
+      mutt_intern_free(&tmp.subtype);
       FREE(&tmp.xtype);
     }
   }
@@ -952,7 +952,7 @@ int mutt_save_attachment(FILE *fp, struct Body *m, const char *path,
         return -1;
       }
       if ((m_att->type == MUTT_MBOX) || (m_att->type == MUTT_MMDF))
-        chflags = CH_FROM | CH_UPDATE_LEN;
+        chflags = CH_FROM | CH_UPDATE_LEN | CH_PAD_STATUS;
       chflags |= ((m_att->type == MUTT_MAILDIR) ? CH_NOSTATUS : CH_UPDATE);
       if ((mutt_copy_message_fp(msg->fp, fp, e_new, MUTT_CM_NO_FLAGS, chflags, 0) == 0) &&
           (mx_msg_commit(m_att, msg) == 0))
@@ -1360,7 +1360,7 @@ static int op_attachment_new_mime(struct ComposeSharedData *shared, int op)
   struct AttachPtr *cur_att = current_attachment(shared->adata->actx,
                                                  shared->adata->menu);
   cur_att->body->type = itype;
-  mutt_str_replace(&cur_att->body->subtype, p);
+  mutt_intern_replace(&cur_att->body->subtype, p);
   cur_att->body->unlink = true;
   menu_queue_redraw(shared->adata->menu, MENU_REDRAW_INDEX);
   notify_send(shared->email->notify, NT_EMAIL, NT_EMAIL_CHANGE_ATTACH, NULL);
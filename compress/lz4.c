@@ -133,9 +133,10 @@ static void *compr_lz4_compress(ComprHandle *handle, const char *data,
 /**
  * compr_lz4_decompress - Implements ComprOps::decompress() - @ingroup compress_decompress
  */
-static void *compr_lz4_decompress(ComprHandle *handle, const char *cbuf, size_t clen)
+static void *compr_lz4_decompress(ComprHandle *handle, const char *cbuf,
+                                  size_t clen, size_t *dlen)
 {
-  if (!handle)
+  if (!handle || !dlen)
     return NULL;
 
   // Decloak an opaque pointer
@@ -149,7 +150,10 @@ static void *compr_lz4_decompress(ComprHandle *handle, const char *cbuf, size_t
   if (ulen > INT_MAX)
     return NULL; // LCOV_EXCL_LINE
   if (ulen == 0)
+  {
+    *dlen = 0;
     return (void *) cbuf;
+  }
 
   mutt_mem_realloc(&cdata->buf, ulen);
   void *ubuf = cdata->buf;
@@ -158,6 +162,7 @@ static void *compr_lz4_decompress(ComprHandle *handle, const char *cbuf, size_t
   if (rc < 0)
     return NULL;
 
+  *dlen = rc;
   return ubuf;
 }
 
@@ -130,9 +130,10 @@ static void *compr_zlib_compress(ComprHandle *handle, const char *data,
 /**
  * compr_zlib_decompress - Implements ComprOps::decompress() - @ingroup compress_decompress
  */
-static void *compr_zlib_decompress(ComprHandle *handle, const char *cbuf, size_t clen)
+static void *compr_zlib_decompress(ComprHandle *handle, const char *cbuf,
+                                   size_t clen, size_t *dlen)
 {
-  if (!handle)
+  if (!handle || !dlen)
     return NULL;
 
   // Decloak an opaque pointer
@@ -153,6 +154,7 @@ static void *compr_zlib_decompress(ComprHandle *handle, const char *cbuf, size_t
   if (rc != Z_OK)
     return NULL;
 
+  *dlen = ulen;
   return ubuf;
 }
 
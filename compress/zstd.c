@@ -134,9 +134,10 @@ static void *compr_zstd_compress(ComprHandle *handle, const char *data,
 /**
  * compr_zstd_decompress - Implements ComprOps::decompress() - @ingroup compress_decompress
  */
-static void *compr_zstd_decompress(ComprHandle *handle, const char *cbuf, size_t clen)
+static void *compr_zstd_decompress(ComprHandle *handle, const char *cbuf,
+                                   size_t clen, size_t *dlen)
 {
-  if (!handle)
+  if (!handle || !dlen)
     return NULL;
 
   // Decloak an opaque pointer
@@ -155,6 +156,7 @@ static void *compr_zstd_decompress(ComprHandle *handle, const char *cbuf, size_t
   if (ZSTD_isError(rc))
     return NULL; // LCOV_EXCL_LINE
 
+  *dlen = rc;
   return cdata->buf;
 }
 
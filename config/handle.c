@@ -0,0 +1,286 @@
+/**
+ * @file
+ * Pre-resolved config variables
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_handle Pre-resolved config variables
+ *
+ * Getting a config variable by name, e.g. cs_subset_bool(), means building a
+ * scoped name and looking it up in a Hash Table.  That's fine for most code,
+ * but not for loops over every Email, or every row of the Index.
+ *
+ * A ConfigHandle remembers the config item of a variable, once it's been
+ * looked up.  After that, reading the variable costs a function call.
+ *
+ * The handles are reset if any config item is deleted, e.g. when an Account or
+ * Mailbox is freed.  They will be looked up again, next time they're used.
+ *
+ * @note Handles must only be used from the main thread.
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "handle.h"
+#include "quad.h"
+#include "set.h"
+#include "subset.h"
+#include "types.h"
+
+/// Handles that have been resolved
+static struct ConfigHandle *ResolvedHandles = NULL;
+/// Is the config observer registered?
+static bool HandlesActive = false;
+
+/**
+ * ch_config_observer - Notification that a Config Variable has changed - Implements ::observer_t - @ingroup observer_api
+ *
+ * Deleting a config item could leave a handle pointing at freed memory.
+ * Deletions are rare, so just reset all the handles.
+ */
+static int ch_config_observer(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_CONFIG)
+    return 0; // LCOV_EXCL_LINE
+  if (nc->event_subtype != NT_CONFIG_DELETED)
+    return 0;
+
+  for (struct ConfigHandle *ch = ResolvedHandles; ch; ch = ch->next)
+  {
+    ch->sub = NULL;
+    ch->he = NULL;
+  }
+
+  mutt_debug(LL_DEBUG5, "config done\n");
+  return 0;
+}
+
+/**
+ * ch_get_elem - Get the config item of a handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval ptr Config item
+ */
+static struct HashElem *ch_get_elem(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  if (ch->he && (ch->sub == sub))
+    return ch->he;
+
+  struct HashElem *he = cs_subset_create_inheritance(sub, ch->name);
+  assert(he);
+
+  // Without notifications, the handle can't be reset, so don't keep it
+  if (!HandlesActive)
+  {
+    if (!NeoMutt)
+      return he;
+
+    notify_observer_add(NeoMutt->notify, NT_CONFIG, ch_config_observer, NULL);
+    HandlesActive = true;
+  }
+
+  if (!ch->listed)
+  {
+    ch->next = ResolvedHandles;
+    ResolvedHandles = ch;
+    ch->listed = true;
+  }
+
+  ch->sub = sub;
+  ch->he = he;
+  return he;
+}
+
+/**
+ * ch_native_get - Get the native value of a handle
+ * @param sub  Config Subset
+ * @param ch   Config Handle
+ * @param type Expected type of the config item, e.g. #DT_BOOL
+ * @retval num Native value
+ */
+static intptr_t ch_native_get(const struct ConfigSubset *sub,
+                              struct ConfigHandle *ch, unsigned int type)
+{
+  assert(sub && ch && ch->name);
+
+  struct HashElem *he = ch_get_elem(sub, ch);
+
+#ifndef NDEBUG
+  struct HashElem *he_base = cs_get_base(he);
+  assert(DTYPE(he_base->type) == type);
+#endif
+
+  intptr_t value = cs_subset_he_native_get(sub, he, NULL);
+  assert(value != INT_MIN);
+
+  return value;
+}
+
+/**
+ * ch_bool - Get a boolean config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval bool Boolean value
+ */
+bool ch_bool(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (bool) ch_native_get(sub, ch, DT_BOOL);
+}
+
+/**
+ * ch_enum - Get an enumeration config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval num Enumeration
+ */
+unsigned char ch_enum(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (unsigned char) ch_native_get(sub, ch, DT_ENUM);
+}
+
+/**
+ * ch_long - Get a long config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval num Long value
+ */
+long ch_long(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (long) ch_native_get(sub, ch, DT_LONG);
+}
+
+/**
+ * ch_mbtable - Get a Multibyte table config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval ptr Multibyte table
+ */
+struct MbTable *ch_mbtable(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (struct MbTable *) ch_native_get(sub, ch, DT_MBTABLE);
+}
+
+/**
+ * ch_number - Get a number config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval num Number
+ */
+short ch_number(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (short) ch_native_get(sub, ch, DT_NUMBER);
+}
+
+/**
+ * ch_path - Get a path config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval ptr  Path
+ * @retval NULL Empty path
+ */
+const char *ch_path(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (const char *) ch_native_get(sub, ch, DT_PATH);
+}
+
+/**
+ * ch_quad - Get a quad-value config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval num Quad-value
+ */
+enum QuadOption ch_quad(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (enum QuadOption) ch_native_get(sub, ch, DT_QUAD);
+}
+
+/**
+ * ch_regex - Get a regex config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval ptr  Regex
+ * @retval NULL Empty regex
+ */
+const struct Regex *ch_regex(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (const struct Regex *) ch_native_get(sub, ch, DT_REGEX);
+}
+
+/**
+ * ch_slist - Get a string-list config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval ptr  String list
+ * @retval NULL Empty string list
+ */
+const struct Slist *ch_slist(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (const struct Slist *) ch_native_get(sub, ch, DT_SLIST);
+}
+
+/**
+ * ch_sort - Get a sort config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval num Sort
+ */
+short ch_sort(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (short) ch_native_get(sub, ch, DT_SORT);
+}
+
+/**
+ * ch_string - Get a string config item by handle
+ * @param sub Config Subset
+ * @param ch  Config Handle
+ * @retval ptr  String
+ * @retval NULL Empty string
+ */
+const char *ch_string(const struct ConfigSubset *sub, struct ConfigHandle *ch)
+{
+  return (const char *) ch_native_get(sub, ch, DT_STRING);
+}
+
+/**
+ * config_handle_cleanup - Reset all the config handles
+ */
+void config_handle_cleanup(void)
+{
+  if (NeoMutt && HandlesActive)
+    notify_observer_remove(NeoMutt->notify, ch_config_observer, NULL);
+
+  struct ConfigHandle *next = NULL;
+  for (struct ConfigHandle *ch = ResolvedHandles; ch; ch = next)
+  {
+    next = ch->next;
+    ch->sub = NULL;
+    ch->he = NULL;
+    ch->next = NULL;
+    ch->listed = false;
+  }
+
+  ResolvedHandles = NULL;
+  HandlesActive = false;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file
+ * Pre-resolved config variables
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_HANDLE_H
+#define MUTT_CONFIG_HANDLE_H
+
+#include <stdbool.h>
+#include "quad.h"
+
+struct ConfigSubset;
+struct HashElem;
+
+/**
+ * struct ConfigHandle - A config variable, looked up once
+ *
+ * Declare one statically, with CONFIG_HANDLE(), for each variable that's read
+ * in a hot path.
+ */
+struct ConfigHandle
+{
+  const char *name;               ///< Name of the config variable
+  const struct ConfigSubset *sub; ///< Subset the variable was resolved in
+  struct HashElem *he;            ///< Resolved config item, NULL if not resolved
+  struct ConfigHandle *next;      ///< Next handle in the list of resolved handles
+  bool listed;                    ///< Handle is in the list of resolved handles
+};
+
+/// Initialise a ConfigHandle for the variable NAME
+#define CONFIG_HANDLE(NAME) { NAME, NULL, NULL, NULL, false }
+
+bool                ch_bool   (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+unsigned char       ch_enum   (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+long                ch_long   (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+struct MbTable     *ch_mbtable(const struct ConfigSubset *sub, struct ConfigHandle *ch);
+short               ch_number (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+const char *        ch_path   (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+enum QuadOption     ch_quad   (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+const struct Regex *ch_regex  (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+const struct Slist *ch_slist  (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+short               ch_sort   (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+const char *        ch_string (const struct ConfigSubset *sub, struct ConfigHandle *ch);
+
+void config_handle_cleanup(void);
+
+#endif /* MUTT_CONFIG_HANDLE_H */
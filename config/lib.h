@@ -33,6 +33,7 @@
  * | config/charset.c    | @subpage config_charset    |
  * | config/dump.c       | @subpage config_dump       |
  * | config/enum.c       | @subpage config_enum       |
+ * | config/handle.c     | @subpage config_handle     |
  * | config/helpers.c    | @subpage config_helpers    |
  * | config/long.c       | @subpage config_long       |
  * | config/mbtable.c    | @subpage config_mbtable    |
@@ -59,6 +60,7 @@
 #include "charset.h"
 #include "dump.h"
 #include "enum.h"
+#include "handle.h"
 #include "helpers.h"
 #include "inheritance.h"
 #include "mbtable.h"
@@ -42,6 +42,9 @@ static struct ConfigDef ConnVars[] = {
   { "preconnect", DT_STRING, 0, 0, NULL,
     "(socket) External command to run prior to opening a socket"
   },
+  { "socket_buffer_size", DT_LONG|DT_NOT_NEGATIVE, 65536, 0, NULL,
+    "(socket) Size of the buffer for data read from a server"
+  },
   { "socket_timeout", DT_NUMBER, 30, 0, NULL,
     "Timeout for socket connect/read/write operations (-1 to wait indefinitely)"
   },
@@ -43,6 +43,9 @@
 #include "protos.h"
 #include "ssl.h"
 
+/// Smallest buffer for incoming traffic, see `$socket_buffer_size`
+#define SOCKET_BUFFER_MIN 1024
+
 /**
  * socket_preconnect - Execute a command before opening a socket
  * @retval 0  Success
@@ -204,6 +207,60 @@ int mutt_socket_poll(struct Connection *conn, time_t wait_secs)
   return -1;
 }
 
+/**
+ * socket_fill - Read more data into the Connection's buffer
+ * @param conn Connection to a server
+ * @retval >0 Success, number of bytes read
+ * @retval -1 Error
+ *
+ * Any unread data is kept, at the start of the buffer.  If the buffer is full
+ * of unread data, e.g. a very long line, it's doubled in size.  Once it's
+ * empty again, it's shrunk back to `$socket_buffer_size`.
+ */
+static int socket_fill(struct Connection *conn)
+{
+  if (conn->fd < 0)
+  {
+    mutt_debug(LL_DEBUG1, "attempt to read from closed connection\n");
+    return -1;
+  }
+
+  const long c_socket_buffer_size = cs_subset_long(NeoMutt->sub, "socket_buffer_size");
+  const size_t size = MAX(c_socket_buffer_size, SOCKET_BUFFER_MIN);
+
+  const size_t pending = conn->available - conn->bufpos;
+  if ((pending > 0) && (conn->bufpos > 0))
+    memmove(conn->inbuf, conn->inbuf + conn->bufpos, pending);
+  conn->bufpos = 0;
+  conn->available = pending;
+
+  if (pending == conn->inbuf_size)
+  {
+    conn->inbuf_size = conn->inbuf ? (conn->inbuf_size * 2) : size;
+    mutt_mem_realloc(&conn->inbuf, conn->inbuf_size);
+  }
+  else if ((pending == 0) && (conn->inbuf_size != size))
+  {
+    conn->inbuf_size = size;
+    mutt_mem_realloc(&conn->inbuf, conn->inbuf_size);
+  }
+
+  const int rc = conn->read(conn, conn->inbuf + conn->available,
+                            conn->inbuf_size - conn->available);
+  if (rc == 0)
+  {
+    mutt_error(_("Connection to %s closed"), conn->account.host);
+  }
+  if (rc <= 0)
+  {
+    mutt_socket_close(conn);
+    return -1;
+  }
+
+  conn->available += rc;
+  return rc;
+}
+
 /**
  * mutt_socket_readchar - Simple read buffering to speed things up
  * @param[in]  conn Connection to a server
@@ -213,33 +270,36 @@ int mutt_socket_poll(struct Connection *conn, time_t wait_secs)
  */
 int mutt_socket_readchar(struct Connection *conn, char *c)
 {
-  if (conn->bufpos >= conn->available)
-  {
-    if (conn->fd >= 0)
-    {
-      conn->available = conn->read(conn, conn->inbuf, sizeof(conn->inbuf));
-    }
-    else
-    {
-      mutt_debug(LL_DEBUG1, "attempt to read from closed connection\n");
-      return -1;
-    }
-    conn->bufpos = 0;
-    if (conn->available == 0)
-    {
-      mutt_error(_("Connection to %s closed"), conn->account.host);
-    }
-    if (conn->available <= 0)
-    {
-      mutt_socket_close(conn);
-      return -1;
-    }
-  }
+  if ((conn->bufpos >= conn->available) && (socket_fill(conn) < 0))
+    return -1;
+
   *c = conn->inbuf[conn->bufpos];
   conn->bufpos++;
   return 1;
 }
 
+/**
+ * mutt_socket_read_buffered - Read some data from a socket
+ * @param conn Connection to a server
+ * @param buf  Buffer to store the data
+ * @param len  Maximum number of bytes to read
+ * @retval >0 Success, number of bytes read
+ * @retval -1 Error
+ *
+ * Unlike mutt_socket_read(), the data comes from the Connection's buffer, so
+ * it can be mixed with reads of lines.
+ */
+int mutt_socket_read_buffered(struct Connection *conn, char *buf, size_t len)
+{
+  if ((conn->bufpos >= conn->available) && (socket_fill(conn) < 0))
+    return -1;
+
+  const size_t n = MIN(len, (size_t) (conn->available - conn->bufpos));
+  memcpy(buf, conn->inbuf + conn->bufpos, n);
+  conn->bufpos += n;
+  return n;
+}
+
 /**
  * mutt_socket_readln_d - Read a line from a socket
  * @param buf    Buffer to store the line
@@ -251,20 +311,31 @@ int mutt_socket_readchar(struct Connection *conn, char *c)
  */
 int mutt_socket_readln_d(char *buf, size_t buflen, struct Connection *conn, int dbg)
 {
-  char ch;
-  int i;
+  size_t i = 0;
 
-  for (i = 0; i < buflen - 1; i++)
+  while (i < (buflen - 1))
   {
-    if (mutt_socket_readchar(conn, &ch) != 1)
+    if ((conn->bufpos >= conn->available) && (socket_fill(conn) < 0))
     {
       buf[i] = '\0';
       return -1;
     }
 
-    if (ch == '\n')
+    const char *start = conn->inbuf + conn->bufpos;
+    size_t n = MIN(buflen - 1 - i, (size_t) (conn->available - conn->bufpos));
+    const char *nl = memchr(start, '\n', n);
+    if (nl)
+      n = nl - start;
+
+    memcpy(buf + i, start, n);
+    i += n;
+    conn->bufpos += n;
+
+    if (nl)
+    {
+      conn->bufpos++; // skip the '\n'
       break;
-    buf[i] = ch;
+    }
   }
 
   /* strip \r from \r\n termination */
@@ -278,6 +349,50 @@ int mutt_socket_readln_d(char *buf, size_t buflen, struct Connection *conn, int
   return i + 1;
 }
 
+/**
+ * mutt_socket_readln_borrow - Read a line from a socket, without copying it
+ * @param[in]  conn Connection to a server
+ * @param[out] len  Length of the line
+ * @param[in]  dbg  Debug level for logging
+ * @retval ptr  Line, with the `\r\n` removed
+ * @retval NULL Error
+ *
+ * The line stays in the Connection's buffer, which grows to fit it.
+ *
+ * @note The line is only valid until the next read from the Connection.
+ *       It may be modified, but not beyond its terminating NUL.
+ */
+char *mutt_socket_readln_borrow(struct Connection *conn, size_t *len, int dbg)
+{
+  size_t scanned = 0;
+
+  while (true)
+  {
+    char *start = conn->inbuf + conn->bufpos;
+    const size_t pending = conn->available - conn->bufpos;
+    char *nl = (pending > scanned) ? memchr(start + scanned, '\n', pending - scanned) : NULL;
+    if (nl)
+    {
+      size_t n = nl - start;
+      conn->bufpos += n + 1;
+
+      /* strip \r from \r\n termination */
+      if (n && (start[n - 1] == '\r'))
+        n--;
+      start[n] = '\0';
+
+      mutt_debug(dbg, "%d< %s\n", conn->fd, start);
+      if (len)
+        *len = n;
+      return start;
+    }
+
+    scanned = pending;
+    if (socket_fill(conn) < 0)
+      return NULL;
+  }
+}
+
 /**
  * mutt_socket_new - Allocate and initialise a new connection
  * @param type Type of the new Connection
@@ -296,7 +411,7 @@ struct Connection *mutt_socket_new(enum ConnectionType type)
   {
     int rc = mutt_ssl_socket_setup(conn);
     if (rc < 0)
-      FREE(&conn);
+      mutt_socket_free(&conn);
   }
   else
   {
@@ -310,6 +425,22 @@ struct Connection *mutt_socket_new(enum ConnectionType type)
   return conn;
 }
 
+/**
+ * mutt_socket_free - Free a Connection
+ * @param ptr Connection to free
+ *
+ * @note The Connection must already be closed
+ */
+void mutt_socket_free(struct Connection **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct Connection *conn = *ptr;
+  FREE(&conn->inbuf);
+  FREE(ptr);
+}
+
 /**
  * mutt_socket_empty - Clear out any queued data
  * @param conn Connection to a server
@@ -325,6 +456,9 @@ void mutt_socket_empty(struct Connection *conn)
   char buf[1024] = { 0 };
   int bytes;
 
+  conn->bufpos = 0;
+  conn->available = 0;
+
   while ((bytes = mutt_socket_poll(conn, 0)) > 0)
   {
     mutt_socket_read(conn, buf, MIN(bytes, sizeof(buf)));
@@ -341,31 +475,42 @@ void mutt_socket_empty(struct Connection *conn)
  */
 int mutt_socket_buffer_readln_d(struct Buffer *buf, struct Connection *conn, int dbg)
 {
-  char ch;
-  bool has_cr = false;
-
+  int rc = 0;
   buf_reset(buf);
 
   while (true)
   {
-    if (mutt_socket_readchar(conn, &ch) != 1)
-      return -1;
+    const char *start = conn->inbuf + conn->bufpos;
+    const size_t pending = conn->available - conn->bufpos;
+    const char *nl = pending ? memchr(start, '\n', pending) : NULL;
+    const size_t n = nl ? (nl - start) : pending;
+
+    /* Copy whole runs, so the Connection's buffer never has to grow */
+    buf_addstr_n(buf, start, n);
+    conn->bufpos += n;
 
-    if (ch == '\n')
+    if (nl)
+    {
+      conn->bufpos++; // skip the '\n'
       break;
+    }
 
-    if (has_cr)
+    if (socket_fill(conn) < 0)
     {
-      buf_addch(buf, '\r');
-      has_cr = false;
+      rc = -1;
+      break;
     }
+  }
 
-    if (ch == '\r')
-      has_cr = true;
-    else
-      buf_addch(buf, ch);
+  /* strip \r from \r\n termination, or from the end of a partial line */
+  const size_t len = buf_len(buf);
+  if ((len > 0) && (buf_at(buf, len - 1) == '\r'))
+  {
+    buf->dptr--;
+    *buf->dptr = '\0';
   }
 
-  mutt_debug(dbg, "%d< %s\n", conn->fd, buf_string(buf));
-  return 0;
+  if (rc == 0)
+    mutt_debug(dbg, "%d< %s\n", conn->fd, buf_string(buf));
+  return rc;
 }
@@ -24,6 +24,7 @@
 #ifndef MUTT_CONN_SOCKET_H
 #define MUTT_CONN_SOCKET_H
 
+#include <stddef.h>
 #include <time.h>
 
 struct Buffer;
@@ -39,16 +40,19 @@ enum ConnectionType
   MUTT_CONNECTION_SSL,    ///< SSL/TLS-encrypted connection
 };
 
-int                mutt_socket_close   (struct Connection *conn);
-void               mutt_socket_empty   (struct Connection *conn);
-struct Connection *mutt_socket_new     (enum ConnectionType type);
-int                mutt_socket_open    (struct Connection *conn);
-int                mutt_socket_poll    (struct Connection *conn, time_t wait_secs);
-int                mutt_socket_read    (struct Connection *conn, char *buf, size_t len);
-int                mutt_socket_readchar(struct Connection *conn, char *c);
-int                mutt_socket_readln_d(char *buf, size_t buflen, struct Connection *conn, int dbg);
-int                mutt_socket_write   (struct Connection *conn, const char *buf, size_t len);
-int                mutt_socket_write_d (struct Connection *conn, const char *buf, int len, int dbg);
+int                mutt_socket_close        (struct Connection *conn);
+void               mutt_socket_empty        (struct Connection *conn);
+void               mutt_socket_free         (struct Connection **ptr);
+struct Connection *mutt_socket_new          (enum ConnectionType type);
+int                mutt_socket_open         (struct Connection *conn);
+int                mutt_socket_poll         (struct Connection *conn, time_t wait_secs);
+int                mutt_socket_read         (struct Connection *conn, char *buf, size_t len);
+int                mutt_socket_read_buffered(struct Connection *conn, char *buf, size_t len);
+int                mutt_socket_readchar     (struct Connection *conn, char *c);
+char *             mutt_socket_readln_borrow(struct Connection *conn, size_t *len, int dbg);
+int                mutt_socket_readln_d     (char *buf, size_t buflen, struct Connection *conn, int dbg);
+int                mutt_socket_write        (struct Connection *conn, const char *buf, size_t len);
+int                mutt_socket_write_d      (struct Connection *conn, const char *buf, int len, int dbg);
 
 /* logging levels */
 #define MUTT_SOCK_LOG_CMD  2
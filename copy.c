@@ -471,25 +471,7 @@ int mutt_copy_header(FILE *fp_in, struct Email *e, FILE *fp_out,
 
   if ((chflags & CH_UPDATE) && ((chflags & CH_NOSTATUS) == 0))
   {
-    if (e->old || e->read)
-    {
-      fputs("Status: ", fp_out);
-      if (e->read)
-        fputs("RO", fp_out);
-      else if (e->old)
-        fputc('O', fp_out);
-      fputc('\n', fp_out);
-    }
-
-    if (e->flagged || e->replied)
-    {
-      fputs("X-Status: ", fp_out);
-      if (e->replied)
-        fputc('A', fp_out);
-      if (e->flagged)
-        fputc('F', fp_out);
-      fputc('\n', fp_out);
-    }
+    mutt_copy_status_headers(fp_out, e, (chflags & CH_PAD_STATUS));
   }
 
   if (chflags & CH_UPDATE_LEN && ((chflags & CH_NOLEN) == 0))
@@ -930,7 +912,7 @@ static int append_message(struct Mailbox *dest, FILE *fp_in, struct Mailbox *src
   if (!msg)
     return -1;
   if ((dest->type == MUTT_MBOX) || (dest->type == MUTT_MMDF))
-    chflags |= CH_FROM | CH_FORCE_FROM;
+    chflags |= CH_FROM | CH_FORCE_FROM | CH_PAD_STATUS;
   chflags |= ((dest->type == MUTT_MAILDIR) ? CH_NOSTATUS : CH_UPDATE);
   rc = mutt_copy_message_fp(msg->fp, fp_in, e, cmflags, chflags, 0);
   if (mx_msg_commit(dest, msg) != 0)
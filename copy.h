@@ -24,10 +24,11 @@
 #define MUTT_COPY_H
 
 #include "config.h"
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include "email/lib.h"
 
-struct Email;
 struct Mailbox;
 struct Message;
 
@@ -71,6 +72,60 @@ typedef uint32_t CopyHeaderFlags;   ///< Flags for mutt_copy_header(), e.g. #CH_
 #define CH_UPDATE_LABEL   (1 << 19) ///< Update X-Label: from email->env->x_label?
 #define CH_UPDATE_SUBJECT (1 << 20) ///< Update Subject: protected header update
 #define CH_VIRTUAL        (1 << 21) ///< Write virtual header lines too
+#define CH_PAD_STATUS     (1 << 22) ///< Always write fixed-width Status: and X-Status: (needs #CH_UPDATE)
+
+#define STATUS_FLAGS_SIZE 3                       ///< Size of the buffers for mutt_copy_status_flags()
+#define STATUS_PAD_WIDTH  (STATUS_FLAGS_SIZE - 1) ///< Width of the Status: and X-Status: values written with #CH_PAD_STATUS
+
+/**
+ * mutt_copy_status_flags - Get the values of the Status: and X-Status: headers
+ * @param[in]  e       Email
+ * @param[out] status  Buffer for the Status: value, at least #STATUS_FLAGS_SIZE chars
+ * @param[out] xstatus Buffer for the X-Status: value, at least #STATUS_FLAGS_SIZE chars
+ *
+ * An empty string means that the header isn't needed.
+ */
+static inline void mutt_copy_status_flags(const struct Email *e, char *status, char *xstatus)
+{
+  char *p = status;
+  if (e->read)
+  {
+    *p++ = 'R';
+    *p++ = 'O';
+  }
+  else if (e->old)
+  {
+    *p++ = 'O';
+  }
+  *p = '\0';
+
+  p = xstatus;
+  if (e->replied)
+    *p++ = 'A';
+  if (e->flagged)
+    *p++ = 'F';
+  *p = '\0';
+}
+
+/**
+ * mutt_copy_status_headers - Write the Status: and X-Status: headers
+ * @param fp  File to write to
+ * @param e   Email
+ * @param pad If true, always write both headers, with room for every flag
+ *
+ * The padded headers let mbox_patch_status() change the flags in place later.
+ */
+static inline void mutt_copy_status_headers(FILE *fp, const struct Email *e, bool pad)
+{
+  char status[STATUS_FLAGS_SIZE] = { 0 };
+  char xstatus[STATUS_FLAGS_SIZE] = { 0 };
+  mutt_copy_status_flags(e, status, xstatus);
+
+  if (pad || (status[0] != '\0'))
+    fprintf(fp, "Status: %-*s\n", pad ? STATUS_PAD_WIDTH : 0, status);
+  if (pad || (xstatus[0] != '\0'))
+    fprintf(fp, "X-Status: %-*s\n", pad ? STATUS_PAD_WIDTH : 0, xstatus);
+}
 
 int mutt_copy_hdr(FILE *fp_in, FILE *fp_out, LOFF_T off_start, LOFF_T off_end, CopyHeaderFlags chflags, const char *prefix, int wraplen);
 
@@ -113,6 +113,7 @@ void mailbox_free(struct Mailbox **ptr)
 
   for (size_t i = 0; i < m->email_max; i++)
     email_free(&m->emails[i]);
+  email_arena_free(&m->arena);
 
   if (m->mdata_free && m->mdata)
     m->mdata_free(&m->mdata);
@@ -132,6 +133,25 @@ void mailbox_free(struct Mailbox **ptr)
   FREE(&m);
 }
 
+/**
+ * mailbox_arena - Get the EmailArena of a Mailbox
+ * @param m Mailbox
+ * @retval ptr Arena for the Mailbox's Emails
+ *
+ * The arena is created on first use and freed when the Mailbox is closed.
+ * The parsers use it for the Emails, Envelopes and Bodies they create.
+ */
+struct EmailArena *mailbox_arena(struct Mailbox *m)
+{
+  if (!m)
+    return NULL;
+
+  if (!m->arena)
+    m->arena = email_arena_new();
+
+  return m->arena;
+}
+
 /**
  * mailbox_find - Find the mailbox with a given path
  * @param path Path to match
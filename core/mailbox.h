@@ -33,6 +33,7 @@
 
 struct ConfigSubset;
 struct Email;
+struct EmailArena;
 
 /**
  * enum MailboxType - Supported mailbox formats
@@ -95,6 +96,7 @@ struct Mailbox
 
   struct Email **emails;              ///< Array of Emails
   int email_max;                      ///< Size of `emails` array
+  struct EmailArena *arena;           ///< Memory for the Emails, see mailbox_arena()
   int *v2r;                           ///< Mapping from virtual to real msgno
   int vcount;                         ///< The number of virtual messages
 
@@ -185,6 +187,7 @@ struct EventMailbox
   struct Mailbox *mailbox; ///< The Mailbox this Event relates to
 };
 
+struct EmailArena *mailbox_arena(struct Mailbox *m);
 void            mailbox_changed   (struct Mailbox *m, enum NotifyMailbox action);
 struct Mailbox *mailbox_find      (const char *path);
 struct Mailbox *mailbox_find_name (const char *name);
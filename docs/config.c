@@ -436,6 +436,19 @@
 ** $$beep variable.
 */
 
+{ "body_index", DT_BOOL, false },
+/*
+** .pp
+** If this variable is \fIset\fP, NeoMutt keeps a summary of the decoded text of
+** each message in the header cache (see $$header_cache) of mbox, MMDF, Maildir
+** and MH mailboxes.  Body searches, e.g. \fC~b\fP and \fC~B\fP, use it to skip
+** messages that can't match, without reading them.
+** .pp
+** Messages are added to the summary when they're searched and when new mail
+** arrives.  Encrypted messages are never added.  The summary is only used if
+** $$thorough_search is \fIset\fP.
+*/
+
 { "bounce", DT_QUAD, MUTT_ASKYES },
 /*
 ** .pp
@@ -1858,6 +1871,22 @@
 ** headers.
 */
 
+{ "imap_fetch_connections", DT_NUMBER, 0 },
+/*
+** .pp
+** When set to a value greater than 0, NeoMutt will open up to this many
+** extra connections to the server when it first opens a large mailbox.
+** The headers that need downloading are shared out between all the
+** connections and fetched at the same time.  This can make opening a
+** mailbox over a slow link much faster.
+** .pp
+** Extra connections are only used if there are at least 1000 headers
+** for each one.  They are closed once the headers have been downloaded.
+** .pp
+** \fBNote:\fP Many servers limit the number of connections a user may
+** have open at once.
+*/
+
 { "imap_headers", DT_STRING, 0 },
 /*
 ** .pp
@@ -2276,6 +2305,18 @@
 ** how often (in seconds) NeoMutt will update message counts.
 */
 
+{ "mail_check_threads", DT_NUMBER, 4 },
+/*
+** .pp
+** This variable controls how many threads NeoMutt uses to check Maildir
+** mailboxes for new mail.  The checks run in the background, so a slow
+** disk doesn't stop NeoMutt responding.  The results are shown as they
+** arrive.
+** .pp
+** If \fIset\fP to 0, the mailboxes are checked one at a time, and NeoMutt
+** waits for the results.
+*/
+
 { "mailbox_folder_format", DT_STRING, "%2C %<n?%6n&      > %6m %i" },
 /*
 ** .pp
@@ -2331,6 +2372,17 @@
 */
 #endif
 
+{ "maildir_read_threads", DT_NUMBER, 4 },
+/*
+** .pp
+** When a Maildir or MH mailbox is opened, the messages which aren't in the
+** header cache are read by this many background threads.  Reading several
+** files at once is much faster on a cold cache or a network filesystem.
+** The headers are still parsed by NeoMutt's main thread.
+** .pp
+** If \fIset\fP to 0, the messages are read one at a time.
+*/
+
 { "maildir_trash", DT_BOOL, false },
 /*
 ** .pp
@@ -2953,6 +3005,23 @@
 ** function.
 */
 
+{ "pager_stream_size", DT_LONG, 1048576 },
+/*
+** .pp
+** Messages larger than this many bytes are shown in the internal-pager
+** while they're still being decoded.  The first screen is displayed as soon
+** as the parts it shows have been decoded, and the rest of the message is
+** decoded as you scroll through it.  Searching, or jumping to the end, waits
+** for the whole message to be decoded.
+** .pp
+** Encrypted or signed messages, messages shown through $$display_filter and
+** messages in mbox or MMDF mailboxes are always decoded before they're
+** displayed.  So are all messages while mailboxes are being checked in the
+** background, see $$mail_check_threads.
+** .pp
+** A value of 0 disables this feature.
+*/
+
 { "pattern_format", DT_STRING, "%2n %-15e  %d" },
 /*
 ** .pp
@@ -2966,6 +3035,19 @@
 ** .pp
 */
 
+{ "pattern_threads", DT_NUMBER, 4 },
+/*
+** .pp
+** When a pattern is matched against a whole mailbox, e.g. by \fC<limit>\fP,
+** \fC<tag-pattern>\fP or \fC<search>\fP, this many background threads help.
+** .pp
+** If the pattern only tests flags and headers, the messages are shared out
+** between the threads.  If it searches the messages, e.g. \fC~b\fP, the
+** threads read local messages ahead, so they're ready when they're searched.
+** .pp
+** If \fIset\fP to 0, the patterns are matched one message at a time.
+*/
+
 { "pgp_auto_decode", DT_BOOL, false },
 /*
 ** .pp
@@ -4806,6 +4888,17 @@
 */
 #endif
 
+{ "socket_buffer_size", DT_LONG, 65536 },
+/*
+** .pp
+** The size, in bytes, of the buffer NeoMutt uses for the data it reads from
+** an IMAP, POP, NNTP or SMTP server.  A larger buffer means fewer reads,
+** which speeds up big downloads, e.g. of the headers of a large mailbox.
+** .pp
+** The buffer grows, if necessary, to hold a long line.  It's never smaller
+** than 1024 bytes.
+*/
+
 { "socket_timeout", DT_NUMBER, 30 },
 /*
 ** .pp
@@ -0,0 +1,250 @@
+/**
+ * @file
+ * Memory for the Emails of a Mailbox
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page email_arena Memory for the Emails of a Mailbox
+ *
+ * Opening a Mailbox creates an Email, an Envelope and a Body for every
+ * message.  Rather than allocating each of them separately, the parsers carve
+ * them out of large blocks owned by the Mailbox's EmailArena.
+ *
+ * Every object remembers its arena, e.g. Email::arena, so it can be freed
+ * anywhere, in the usual way.  Freed objects are kept for reuse.
+ *
+ * When the Mailbox is closed, email_arena_free() releases all the blocks at
+ * once.  If some objects are still in use, e.g. an Email being replied to,
+ * the blocks are released when the last of them is freed.
+ *
+ * Only the objects themselves live in the arena.  Their contents, e.g. the
+ * strings of an Envelope, are allocated normally, so they can be edited,
+ * replaced, or moved to another object.
+ *
+ * @note The arena isn't thread-safe.  Objects must be created and freed by
+ *       the main thread.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "arena.h"
+#include "body.h"
+#include "email.h"
+#include "envelope.h"
+
+/// Number of objects in the first block of a pool
+#define ARENA_BLOCK_MIN 32
+/// Maximum number of objects in a block
+#define ARENA_BLOCK_MAX 1024
+
+/**
+ * struct ArenaBlock - A block of objects
+ */
+struct ArenaBlock
+{
+  struct ArenaBlock *next; ///< Next block in the pool
+  void *objects[];         ///< Objects, aligned like a pointer
+};
+
+/**
+ * struct ArenaFree - An object that's been freed
+ *
+ * While an object is on the free list, its first bytes are reused as a link.
+ */
+struct ArenaFree
+{
+  struct ArenaFree *next; ///< Next free object
+};
+
+/**
+ * struct ArenaPool - Objects of one type
+ */
+struct ArenaPool
+{
+  struct ArenaBlock *blocks;    ///< Blocks of objects, newest first
+  size_t block_size;            ///< Number of objects in the newest block
+  size_t block_used;            ///< Number of objects handed out from the newest block
+  struct ArenaFree *free_list;  ///< Objects that have been freed
+};
+
+/**
+ * struct EmailArena - Memory for the Emails of a Mailbox
+ */
+struct EmailArena
+{
+  struct ArenaPool pools[ARENA_MAX]; ///< Pools of Emails, Envelopes and Bodies
+  size_t live;                       ///< Number of objects in use
+  bool closed;                       ///< Owner has finished with the arena
+};
+
+/// Size of each type of object
+static const size_t ArenaObjectSize[ARENA_MAX] = {
+  sizeof(struct Email),
+  sizeof(struct Envelope),
+  sizeof(struct Body),
+};
+
+/**
+ * arena_object_size - Get the space used by an object
+ * @param type Type of object, e.g. #ARENA_EMAIL
+ * @retval num Size, rounded up to keep the objects aligned
+ */
+static size_t arena_object_size(enum ArenaType type)
+{
+  const size_t align = sizeof(void *);
+  return (ArenaObjectSize[type] + align - 1) & ~(align - 1);
+}
+
+/**
+ * arena_destroy - Release all the memory of an EmailArena
+ * @param ea Arena
+ */
+static void arena_destroy(struct EmailArena *ea)
+{
+  for (int i = 0; i < ARENA_MAX; i++)
+  {
+    struct ArenaBlock *block = ea->pools[i].blocks;
+    while (block)
+    {
+      struct ArenaBlock *next = block->next;
+      FREE(&block);
+      block = next;
+    }
+  }
+
+  FREE(&ea);
+}
+
+/**
+ * email_arena_new - Create a new EmailArena
+ * @retval ptr New EmailArena
+ */
+struct EmailArena *email_arena_new(void)
+{
+  return mutt_mem_calloc(1, sizeof(struct EmailArena));
+}
+
+/**
+ * email_arena_free - Free an EmailArena
+ * @param ptr Arena to free
+ *
+ * If any of the arena's objects are still in use, the memory will be released
+ * when the last of them is freed, see email_arena_release().
+ */
+void email_arena_free(struct EmailArena **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct EmailArena *ea = *ptr;
+  *ptr = NULL;
+
+  if (ea->live == 0)
+  {
+    arena_destroy(ea);
+    return;
+  }
+
+  mutt_debug(LL_DEBUG2, "%zu objects still in use\n", ea->live);
+  ea->closed = true;
+}
+
+/**
+ * email_arena_alloc - Allocate an object from an EmailArena
+ * @param ea   Arena
+ * @param type Type of object, e.g. #ARENA_EMAIL
+ * @retval ptr Zeroed object
+ */
+void *email_arena_alloc(struct EmailArena *ea, enum ArenaType type)
+{
+  if (!ea || (type >= ARENA_MAX))
+    return NULL;
+
+  struct ArenaPool *pool = &ea->pools[type];
+  const size_t size = arena_object_size(type);
+  void *obj = NULL;
+
+  if (pool->free_list)
+  {
+    obj = pool->free_list;
+    pool->free_list = pool->free_list->next;
+    memset(obj, 0, size);
+  }
+  else
+  {
+    if (!pool->blocks || (pool->block_used == pool->block_size))
+    {
+      size_t num = pool->block_size * 2;
+      if (num < ARENA_BLOCK_MIN)
+        num = ARENA_BLOCK_MIN;
+      if (num > ARENA_BLOCK_MAX)
+        num = ARENA_BLOCK_MAX;
+
+      struct ArenaBlock *block = mutt_mem_calloc(1, sizeof(struct ArenaBlock) + (num * size));
+      block->next = pool->blocks;
+      pool->blocks = block;
+      pool->block_size = num;
+      pool->block_used = 0;
+    }
+
+    obj = (char *) pool->blocks->objects + (pool->block_used * size);
+    pool->block_used++;
+  }
+
+  ea->live++;
+  return obj;
+}
+
+/**
+ * email_arena_release - Return an object to its EmailArena
+ * @param ea   Arena
+ * @param type Type of object, e.g. #ARENA_EMAIL
+ * @param obj  Object to release
+ *
+ * If the owner has finished with the arena, and this was its last object,
+ * the arena is freed.
+ */
+void email_arena_release(struct EmailArena *ea, enum ArenaType type, void *obj)
+{
+  if (!ea || !obj || (type >= ARENA_MAX))
+    return;
+
+  struct ArenaPool *pool = &ea->pools[type];
+  struct ArenaFree *af = obj;
+  af->next = pool->free_list;
+  pool->free_list = af;
+
+  ea->live--;
+  if (ea->closed && (ea->live == 0))
+    arena_destroy(ea);
+}
+
+/**
+ * email_arena_live - How many objects of an EmailArena are in use?
+ * @param ea Arena
+ * @retval num Number of objects in use
+ */
+size_t email_arena_live(const struct EmailArena *ea)
+{
+  return ea ? ea->live : 0;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * Memory for the Emails of a Mailbox
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_EMAIL_ARENA_H
+#define MUTT_EMAIL_ARENA_H
+
+#include <stddef.h>
+
+struct EmailArena;
+
+/**
+ * enum ArenaType - Types of object stored in an EmailArena
+ */
+enum ArenaType
+{
+  ARENA_EMAIL,    ///< struct Email
+  ARENA_ENVELOPE, ///< struct Envelope
+  ARENA_BODY,     ///< struct Body
+  ARENA_MAX,
+};
+
+void *             email_arena_alloc  (struct EmailArena *ea, enum ArenaType type);
+void               email_arena_free   (struct EmailArena **ptr);
+size_t             email_arena_live   (const struct EmailArena *ea);
+struct EmailArena *email_arena_new    (void);
+void               email_arena_release(struct EmailArena *ea, enum ArenaType type, void *obj);
+
+#endif /* MUTT_EMAIL_ARENA_H */
@@ -31,6 +31,7 @@
 #include <unistd.h>
 #include "mutt/lib.h"
 #include "body.h"
+#include "arena.h"
 #include "email.h"
 #include "envelope.h"
 #include "mime.h"
@@ -42,7 +43,21 @@
  */
 struct Body *mutt_body_new(void)
 {
-  struct Body *p = mutt_mem_calloc(1, sizeof(struct Body));
+  return mutt_body_new_arena(NULL);
+}
+
+/**
+ * mutt_body_new_arena - Create a new Body in an EmailArena
+ * @param ea Arena, may be NULL
+ * @retval ptr Newly allocated Body
+ *
+ * If @a ea is NULL, the Body is allocated normally.
+ */
+struct Body *mutt_body_new_arena(struct EmailArena *ea)
+{
+  struct Body *p = ea ? email_arena_alloc(ea, ARENA_BODY) :
+                        mutt_mem_calloc(1, sizeof(struct Body));
+  p->arena = ea;
 
   p->disposition = DISP_ATTACH;
   p->use_disp = true;
@@ -79,7 +94,7 @@ void mutt_body_free(struct Body **ptr)
     FREE(&b->charset);
     FREE(&b->content);
     FREE(&b->xtype);
-    FREE(&b->subtype);
+    mutt_intern_free(&b->subtype);
     FREE(&b->language);
     FREE(&b->description);
     FREE(&b->form_name);
@@ -93,7 +108,10 @@ void mutt_body_free(struct Body **ptr)
 
     mutt_env_free(&b->mime_headers);
     mutt_body_free(&b->parts);
-    FREE(&b);
+    if (b->arena)
+      email_arena_release(b->arena, ARENA_BODY, b);
+    else
+      FREE(&b);
   }
 
   *ptr = NULL;
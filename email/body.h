@@ -73,6 +73,7 @@ struct Body
   struct Email *email;            ///< header information for message/rfc822
   struct AttachPtr *aptr;         ///< Menu information, used in recvattach.c
   struct Envelope *mime_headers;  ///< Memory hole protected headers
+  struct EmailArena *arena;       ///< Arena holding the Body, see mutt_body_new_arena()
   time_t stamp;                   ///< Time stamp of last encoding update
   char *language;                 ///< content-language (RFC8255)
   char *charset;                  ///< Send mode: charset of attached file as stored on disk.
@@ -95,5 +96,6 @@ bool         mutt_body_cmp_strict(const struct Body *b1, const struct Body *b2);
 void         mutt_body_free      (struct Body **ptr);
 char *       mutt_body_get_charset(struct Body *b, char *buf, size_t buflen);
 struct Body *mutt_body_new       (void);
+struct Body *mutt_body_new_arena (struct EmailArena *ea);
 
 #endif /* MUTT_EMAIL_BODY_H */
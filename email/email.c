@@ -31,6 +31,7 @@
 #include <string.h>
 #include "mutt/lib.h"
 #include "email.h"
+#include "arena.h"
 #include "body.h"
 #include "envelope.h"
 #include "tags.h"
@@ -55,9 +56,11 @@ void email_free(struct Email **ptr)
   if (e->edata_free && e->edata)
     e->edata_free(&e->edata);
 
+  FREE(&e->lazy_data);
   mutt_env_free(&e->env);
   mutt_body_free(&e->body);
   FREE(&e->tree);
+  FREE(&e->index_row);
   FREE(&e->path);
 #ifdef MIXMASTER
   mutt_list_free(&e->chain);
@@ -68,6 +71,13 @@ void email_free(struct Email **ptr)
   driver_tags_free(&e->tags);
   notify_free(&e->notify);
 
+  if (e->arena)
+  {
+    email_arena_release(e->arena, ARENA_EMAIL, e);
+    *ptr = NULL;
+    return;
+  }
+
   FREE(ptr);
 }
 
@@ -76,10 +86,26 @@ void email_free(struct Email **ptr)
  * @retval ptr Newly created Email
  */
 struct Email *email_new(void)
+{
+  return email_new_arena(NULL);
+}
+
+/**
+ * email_new_arena - Create a new Email in an EmailArena
+ * @param ea Arena, may be NULL
+ * @retval ptr Newly created Email
+ *
+ * If @a ea is NULL, the Email is allocated normally.
+ *
+ * @note This should be freed using email_free()
+ */
+struct Email *email_new_arena(struct EmailArena *ea)
 {
   static size_t sequence = 0;
 
-  struct Email *e = mutt_mem_calloc(1, sizeof(struct Email));
+  struct Email *e = ea ? email_arena_alloc(ea, ARENA_EMAIL) :
+                         mutt_mem_calloc(1, sizeof(struct Email));
+  e->arena = ea;
 #ifdef MIXMASTER
   STAILQ_INIT(&e->chain);
 #endif
@@ -91,6 +117,24 @@ struct Email *email_new(void)
   return e;
 }
 
+/**
+ * email_materialize - Decode the rest of an Email's Envelope
+ * @param e Email
+ *
+ * Emails restored from the Header Cache only decode the fields needed by the
+ * Index, e.g. the subject and the From/To/Cc addresses.  The rest, e.g.
+ * Envelope.reply_to or Envelope.userhdrs, is decoded on first use.
+ *
+ * Call this before using any of the other Envelope fields.
+ */
+void email_materialize(struct Email *e)
+{
+  if (!e || !e->lazy_data || !e->lazy_load)
+    return;
+
+  e->lazy_load(e);
+}
+
 /**
  * email_cmp_strict - Strictly compare message emails
  * @param e1 First Email
@@ -101,6 +145,10 @@ bool email_cmp_strict(const struct Email *e1, const struct Email *e2)
 {
   if (e1 && e2)
   {
+    // Decoding the rest of the Envelope doesn't change the Email
+    email_materialize((struct Email *) e1);
+    email_materialize((struct Email *) e2);
+
     if ((e1->received != e2->received) || (e1->date_sent != e2->date_sent) ||
         (e1->body->length != e2->body->length) || (e1->lines != e2->lines) ||
         (e1->zhours != e2->zhours) || (e1->zminutes != e2->zminutes) ||
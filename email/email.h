@@ -65,6 +65,7 @@ struct Email
   size_t sequence;             ///< Sequence number assigned on creation
   struct Envelope *env;        ///< Envelope information
   struct Body *body;           ///< List of MIME parts
+  struct EmailArena *arena;    ///< Arena holding the Email, see email_new_arena()
   char *path;                  ///< Path of Email (for local Mailboxes)
   LOFF_T offset;               ///< Where in the stream does this message begin?
   struct TagList tags;         ///< For drivers that support server tagging
@@ -85,6 +86,19 @@ struct Email
    */
   void (*edata_free)(void **ptr);
 
+  void *lazy_data;             ///< Envelope fields that haven't been decoded yet
+
+  /**
+   * lazy_load - Decode the rest of the Envelope
+   * @param e Email
+   *
+   * Fill in the Envelope from Email.lazy_data, then free it.
+   *
+   * @pre e            is not NULL
+   * @pre e->lazy_data is not NULL
+   */
+  void (*lazy_load)(struct Email *e);
+
 #ifdef MIXMASTER
   struct ListHead chain;       ///< Mixmaster chain
 #endif
@@ -109,6 +123,7 @@ struct Email
   int index;                   ///< The absolute (unsorted) message number
   int msgno;                   ///< Number displayed to the user
   struct AttrColor *attr_color; ///< Color-pair to use when displaying in the index
+  struct IndexRow *index_row;  ///< Cached line of the index, see index_row_get()
   int score;                   ///< Message score
   int vnum;                    ///< Virtual message number
   short attach_total;          ///< Number of qualifying attachments in message, if attach_valid
@@ -184,7 +199,9 @@ struct EventHeader
 
 bool          email_cmp_strict(const struct Email *e1, const struct Email *e2);
 void          email_free      (struct Email **ptr);
+void          email_materialize(struct Email *e);
 struct Email *email_new       (void);
+struct Email *email_new_arena (struct EmailArena *ea);
 size_t        email_size      (const struct Email *e);
 
 struct ListNode *header_add   (struct ListHead *hdrlist, const char *header);
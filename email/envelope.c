@@ -34,6 +34,7 @@
 #include "mutt/lib.h"
 #include "address/lib.h"
 #include "envelope.h"
+#include "arena.h"
 #include "email.h"
 
 /**
@@ -42,7 +43,21 @@
  */
 struct Envelope *mutt_env_new(void)
 {
-  struct Envelope *env = mutt_mem_calloc(1, sizeof(struct Envelope));
+  return mutt_env_new_arena(NULL);
+}
+
+/**
+ * mutt_env_new_arena - Create a new Envelope in an EmailArena
+ * @param ea Arena, may be NULL
+ * @retval ptr New Envelope
+ *
+ * If @a ea is NULL, the Envelope is allocated normally.
+ */
+struct Envelope *mutt_env_new_arena(struct EmailArena *ea)
+{
+  struct Envelope *env = ea ? email_arena_alloc(ea, ARENA_ENVELOPE) :
+                              mutt_mem_calloc(1, sizeof(struct Envelope));
+  env->arena = ea;
   TAILQ_INIT(&env->return_path);
   TAILQ_INIT(&env->from);
   TAILQ_INIT(&env->to);
@@ -111,9 +126,9 @@ void mutt_env_free(struct Envelope **ptr)
   mutt_addrlist_clear(&env->mail_followup_to);
   mutt_addrlist_clear(&env->x_original_to);
 
-  FREE(&env->list_post);
-  FREE(&env->list_subscribe);
-  FREE(&env->list_unsubscribe);
+  mutt_intern_free(&env->list_post);
+  mutt_intern_free(&env->list_subscribe);
+  mutt_intern_free(&env->list_unsubscribe);
   FREE(&env->subject);
   /* real_subj is just an offset to subject and shouldn't be freed */
   FREE(&env->disp_subj);
@@ -140,6 +155,13 @@ void mutt_env_free(struct Envelope **ptr)
   mutt_autocrypthdr_free(&env->autocrypt_gossip);
 #endif
 
+  if (env->arena)
+  {
+    email_arena_release(env->arena, ARENA_ENVELOPE, env);
+    *ptr = NULL;
+    return;
+  }
+
   FREE(ptr);
 }
 
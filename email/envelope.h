@@ -30,6 +30,7 @@
 #include "address/lib.h"
 
 struct Email;
+struct EmailArena;
 
 #define MUTT_ENV_CHANGED_IRT     (1 << 0)  ///< In-Reply-To changed to link/break threads
 #define MUTT_ENV_CHANGED_REFS    (1 << 1)  ///< References changed to break thread
@@ -90,6 +91,7 @@ struct Envelope
   struct AutocryptHeader *autocrypt_gossip; ///< Autocrypt Gossip header
 #endif
   unsigned char changed; ///< Changed fields, e.g. #MUTT_ENV_CHANGED_SUBJECT
+  struct EmailArena *arena; ///< Arena holding the Envelope, see mutt_env_new_arena()
 };
 
 /**
@@ -119,6 +121,7 @@ bool             mutt_env_cmp_strict (const struct Envelope *e1, const struct En
 void             mutt_env_free       (struct Envelope **ptr);
 void             mutt_env_merge      (struct Envelope *base, struct Envelope **extra);
 struct Envelope *mutt_env_new        (void);
+struct Envelope *mutt_env_new_arena  (struct EmailArena *ea);
 bool             mutt_env_notify_send(struct Email *e, enum NotifyEnvelope type);
 int              mutt_env_to_intl    (struct Envelope *env, const char **tag, char **err);
 void             mutt_env_to_local   (struct Envelope *env);
@@ -27,6 +27,7 @@
  *
  * | File                   | Description              |
  * | :--------------------- | :----------------------- |
+ * | email/arena.c          | @subpage email_arena     |
  * | email/body.c           | @subpage email_body      |
  * | email/email.c          | @subpage email_email     |
  * | email/envelope.c       | @subpage email_envelope  |
@@ -48,6 +49,7 @@
 #define MUTT_EMAIL_LIB_H
 
 // IWYU pragma: begin_exports
+#include "arena.h"
 #include "body.h"
 #include "content.h"
 #include "email.h"
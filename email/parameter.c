@@ -49,8 +49,8 @@ void mutt_param_free_one(struct Parameter **p)
 {
   if (!p || !*p)
     return;
-  FREE(&(*p)->attribute);
-  FREE(&(*p)->value);
+  mutt_intern_free(&(*p)->attribute);
+  mutt_intern_free(&(*p)->value);
   FREE(p);
 }
 
@@ -123,7 +123,10 @@ void mutt_param_set(struct ParameterList *pl, const char *attribute, const char
   {
     if (mutt_istr_equal(attribute, np->attribute))
     {
-      mutt_str_replace(&np->value, value);
+      // The old value may be shared, see mutt_param_intern()
+      char *old = np->value;
+      np->value = mutt_str_dup(value);
+      mutt_intern_free(&old);
       return;
     }
   }
@@ -134,6 +137,39 @@ void mutt_param_set(struct ParameterList *pl, const char *attribute, const char
   TAILQ_INSERT_HEAD(pl, np, entries);
 }
 
+/**
+ * mutt_param_intern - Share the common strings of a ParameterList
+ * @param pl ParameterList
+ *
+ * The attributes, and the values of common attributes, e.g. "charset", are
+ * replaced by shared copies, see mutt_intern_get().  Values that are usually
+ * unique, e.g. "boundary", are left alone.
+ */
+void mutt_param_intern(struct ParameterList *pl)
+{
+  static const char *const CommonAttributes[] = {
+    "charset", "delsp", "format", "micalg", "protocol", "reply-type",
+  };
+
+  if (!pl)
+    return;
+
+  struct Parameter *np = NULL;
+  TAILQ_FOREACH(np, pl, entries)
+  {
+    mutt_intern_replace(&np->attribute, np->attribute);
+
+    for (size_t i = 0; i < mutt_array_size(CommonAttributes); i++)
+    {
+      if (mutt_istr_equal(np->attribute, CommonAttributes[i]))
+      {
+        mutt_intern_replace(&np->value, np->value);
+        break;
+      }
+    }
+  }
+}
+
 /**
  * mutt_param_delete - Delete a matching Parameter
  * @param[in] pl        ParameterList
@@ -42,6 +42,7 @@ void              mutt_param_delete    (struct ParameterList *pl, const char *at
 void              mutt_param_free      (struct ParameterList *pl);
 void              mutt_param_free_one  (struct Parameter **pl);
 char *            mutt_param_get       (const struct ParameterList *pl, const char *s);
+void              mutt_param_intern    (struct ParameterList *pl);
 struct Parameter *mutt_param_new       (void);
 void              mutt_param_set       (struct ParameterList *pl, const char *attribute, const char *value);
 
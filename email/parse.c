@@ -428,7 +428,7 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
   if (!s || !ct)
     return;
 
-  FREE(&ct->subtype);
+  mutt_intern_free(&ct->subtype);
   mutt_param_free(&ct->parameter);
 
   /* First extract any existing parameters */
@@ -464,7 +464,7 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
       ; // do nothing
 
     *pc = '\0';
-    mutt_str_replace(&ct->subtype, subtype);
+    mutt_intern_replace(&ct->subtype, subtype);
   }
 
   /* Finally, get the major type */
@@ -472,7 +472,7 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
 
 #ifdef SUN_ATTACHMENT
   if (mutt_istr_equal("x-sun-attachment", s))
-    mutt_str_replace(&ct->subtype, "x-sun-attachment");
+    mutt_intern_replace(&ct->subtype, "x-sun-attachment");
 #endif
 
   if (ct->type == TYPE_OTHER)
@@ -486,15 +486,15 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
      * field, so we can attempt to convert the type to Body here.  */
     if (ct->type == TYPE_TEXT)
     {
-      ct->subtype = mutt_str_dup("plain");
+      ct->subtype = mutt_intern_get("plain");
     }
     else if (ct->type == TYPE_AUDIO)
     {
-      ct->subtype = mutt_str_dup("basic");
+      ct->subtype = mutt_intern_get("basic");
     }
     else if (ct->type == TYPE_MESSAGE)
     {
-      ct->subtype = mutt_str_dup("rfc822");
+      ct->subtype = mutt_intern_get("rfc822");
     }
     else if (ct->type == TYPE_OTHER)
     {
@@ -502,11 +502,11 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
 
       ct->type = TYPE_APPLICATION;
       snprintf(buf, sizeof(buf), "x-%s", s);
-      ct->subtype = mutt_str_dup(buf);
+      ct->subtype = mutt_intern_get(buf);
     }
     else
     {
-      ct->subtype = mutt_str_dup("x-unknown");
+      ct->subtype = mutt_intern_get("x-unknown");
     }
   }
 
@@ -527,6 +527,8 @@ void mutt_parse_content_type(const char *s, struct Body *ct)
                      mutt_ch_get_default_charset(cc_assumed_charset()));
     }
   }
+
+  mutt_param_intern(&ct->parameter);
 }
 
 #ifdef USE_AUTOCRYPT
@@ -825,8 +827,8 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e,
           char *mailto = rfc2369_first_mailto(body);
           if (mailto)
           {
-            FREE(&env->list_post);
-            env->list_post = mailto;
+            mutt_intern_replace(&env->list_post, mailto);
+            FREE(&mailto);
             const bool c_auto_subscribe = cs_subset_bool(NeoMutt->sub, "auto_subscribe");
             if (c_auto_subscribe)
               mutt_auto_subscribe(env->list_post);
@@ -840,8 +842,8 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e,
         char *mailto = rfc2369_first_mailto(body);
         if (mailto)
         {
-          FREE(&env->list_subscribe);
-          env->list_subscribe = mailto;
+          mutt_intern_replace(&env->list_subscribe, mailto);
+          FREE(&mailto);
         }
         matched = true;
       }
@@ -851,8 +853,8 @@ int mutt_rfc822_parse_line(struct Envelope *env, struct Email *e,
         char *mailto = rfc2369_first_mailto(body);
         if (mailto)
         {
-          FREE(&env->list_unsubscribe);
-          env->list_unsubscribe = mailto;
+          mutt_intern_replace(&env->list_unsubscribe, mailto);
+          FREE(&mailto);
         }
         matched = true;
       }
@@ -1155,30 +1157,88 @@ size_t mutt_rfc822_read_line(FILE *fp, struct Buffer *buf)
 }
 
 /**
- * mutt_rfc822_read_header - Parses an RFC822 header
- * @param fp        Stream to read from
+ * mutt_rfc822_read_line_mem - Read a header line from memory
+ * @param data    Text to read from
+ * @param datalen Length of data
+ * @param buf     Buffer to store the result
+ * @retval num Number of bytes of data consumed
+ *
+ * This is the in-memory equivalent of mutt_rfc822_read_line().
+ * Continuation lines are unfolded; reading stops at `datalen`.
+ */
+size_t mutt_rfc822_read_line_mem(const char *data, size_t datalen, struct Buffer *buf)
+{
+  if (!data || !buf)
+    return 0;
+
+  size_t read = 0;
+
+  buf_reset(buf);
+  while (read < datalen)
+  {
+    const char *line = data + read;
+    const char *nl = memchr(line, '\n', datalen - read);
+    const size_t linelen = nl ? (nl - line + 1) : (datalen - read);
+
+    if (isspace(line[0]) && buf_is_empty(buf))
+    {
+      read += linelen;
+      break;
+    }
+
+    read += linelen;
+
+    if (!nl)
+    {
+      buf_addstr_n(buf, line, linelen);
+      break;
+    }
+
+    /* We did get a full line: remove trailing space */
+    size_t len = linelen - 1;
+    while ((len > 1) && isspace(line[len - 1]))
+      len--;
+
+    buf_addstr_n(buf, line, len);
+
+    /* check to see if the next line is a continuation line */
+    if ((read == datalen) || ((data[read] != ' ') && (data[read] != '\t')))
+      break;
+
+    /* eat tabs and spaces from the beginning of the continuation line */
+    while ((read < datalen) && ((data[read] == ' ') || (data[read] == '\t')))
+      read++;
+
+    buf_addch(buf, ' ');
+  }
+
+  return read;
+}
+
+/**
+ * rfc822_read_header - Parse an RFC822 header from a file or from memory
+ * @param fp        Stream to read from (or NULL to read from memory)
+ * @param data      Message text, starting at e->offset (if fp is NULL)
+ * @param datalen   Length of data
  * @param e         Current Email (optional)
  * @param user_hdrs If set, store user headers
- *                  Used for recall-message and postpone modes
- * @param weed      If this parameter is set and the user has activated the
- *                  $weed option, honor the header weed list for user headers.
- *                  Used for recall-message
+ * @param weed      If set, honour the header weed list for user headers
  * @retval ptr Newly allocated envelope structure
- *
- * Caller should free the Envelope using mutt_env_free().
  */
-struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hdrs, bool weed)
+static struct Envelope *rfc822_read_header(FILE *fp, const char *data, size_t datalen,
+                                           struct Email *e, bool user_hdrs, bool weed)
 {
-  if (!fp)
-    return NULL;
-
-  struct Envelope *env = mutt_env_new();
+  struct Envelope *env = mutt_env_new_arena(e ? e->arena : NULL);
   char *p = NULL;
-  LOFF_T loc = e ? e->offset : ftello(fp);
-  if (loc < 0)
+  LOFF_T loc = 0;
+  if (fp)
   {
-    mutt_debug(LL_DEBUG1, "ftello: %s (errno %d)\n", strerror(errno), errno);
-    loc = 0;
+    loc = e ? e->offset : ftello(fp);
+    if (loc < 0)
+    {
+      mutt_debug(LL_DEBUG1, "ftello: %s (errno %d)\n", strerror(errno), errno);
+      loc = 0;
+    }
   }
 
   struct Buffer *line = buf_pool_get();
@@ -1187,7 +1247,7 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
   {
     if (!e->body)
     {
-      e->body = mutt_body_new();
+      e->body = mutt_body_new_arena(e->arena);
 
       /* set the defaults from RFC1521 */
       e->body->type = TYPE_TEXT;
@@ -1203,12 +1263,13 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
   while (true)
   {
     LOFF_T line_start_loc = loc;
-    size_t len = mutt_rfc822_read_line(fp, line);
+    size_t len = fp ? mutt_rfc822_read_line(fp, line) :
+                      mutt_rfc822_read_line_mem(data + loc, datalen - loc, line);
+    loc += len;
     if (buf_len(line) == 0)
     {
       break;
     }
-    loc += len;
     const char *lines = buf_string(line);
     p = strpbrk(lines, ": \t");
     if (!p || (*p != ':'))
@@ -1232,7 +1293,10 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
       /* We need to seek back to the start of the body. Note that we
        * keep track of loc ourselves, since calling ftello() incurs
        * a syscall, which can be expensive to do for every single line */
-      (void) mutt_file_seek(fp, line_start_loc, SEEK_SET);
+      if (fp)
+        (void) mutt_file_seek(fp, line_start_loc, SEEK_SET);
+      else
+        loc = line_start_loc;
       break; /* end of header */
     }
     size_t name_len = p - lines;
@@ -1287,7 +1351,7 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
   if (e)
   {
     e->body->hdr_offset = e->offset;
-    e->body->offset = ftello(fp);
+    e->body->offset = fp ? ftello(fp) : e->offset + loc;
 
     rfc2047_decode_envelope(env);
 
@@ -1335,6 +1399,51 @@ struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hd
   return env;
 }
 
+/**
+ * mutt_rfc822_read_header - Parses an RFC822 header
+ * @param fp        Stream to read from
+ * @param e         Current Email (optional)
+ * @param user_hdrs If set, store user headers
+ *                  Used for recall-message and postpone modes
+ * @param weed      If this parameter is set and the user has activated the
+ *                  $weed option, honor the header weed list for user headers.
+ *                  Used for recall-message
+ * @retval ptr Newly allocated envelope structure
+ *
+ * Caller should free the Envelope using mutt_env_free().
+ */
+struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hdrs, bool weed)
+{
+  if (!fp)
+    return NULL;
+
+  return rfc822_read_header(fp, NULL, 0, e, user_hdrs, weed);
+}
+
+/**
+ * mutt_rfc822_read_header_mem - Parses an RFC822 header held in memory
+ * @param data      Message text, starting at e->offset
+ * @param datalen   Length of data
+ * @param e         Current Email (optional)
+ * @param user_hdrs If set, store user headers
+ * @param weed      If set, honour the header weed list for user headers
+ * @retval ptr Newly allocated envelope structure
+ *
+ * This behaves like mutt_rfc822_read_header(), but reads from a buffer, e.g.
+ * a memory-mapped mailbox.  Parsing never goes beyond `datalen` bytes.
+ * e->body->offset is set to e->offset plus the length of the header.
+ *
+ * Caller should free the Envelope using mutt_env_free().
+ */
+struct Envelope *mutt_rfc822_read_header_mem(const char *data, size_t datalen,
+                                             struct Email *e, bool user_hdrs, bool weed)
+{
+  if (!data)
+    return NULL;
+
+  return rfc822_read_header(NULL, data, datalen, e, user_hdrs, weed);
+}
+
 /**
  * mutt_read_mime_header - Parse a MIME header
  * @param fp      stream to read from
@@ -1552,7 +1661,7 @@ static void parse_part(FILE *fp, struct Body *b, int *counter)
   if (!b->parts)
   {
     b->type = TYPE_TEXT;
-    mutt_str_replace(&b->subtype, "plain");
+    mutt_intern_replace(&b->subtype, "plain");
   }
 bail:
   recurse_level--;
@@ -47,6 +47,8 @@ struct Body *    mutt_read_mime_header    (FILE *fp, bool digest);
 int              mutt_rfc822_parse_line   (struct Envelope *env, struct Email *e, const char *name, size_t name_len, const char *body, bool user_hdrs, bool weed, bool do_2047);
 struct Body *    mutt_rfc822_parse_message(FILE *fp, struct Body *parent);
 struct Envelope *mutt_rfc822_read_header  (FILE *fp, struct Email *e, bool user_hdrs, bool weed);
+struct Envelope *mutt_rfc822_read_header_mem(const char *data, size_t datalen, struct Email *e, bool user_hdrs, bool weed);
 size_t           mutt_rfc822_read_line    (FILE *fp, struct Buffer *out);
+size_t           mutt_rfc822_read_line_mem(const char *data, size_t datalen, struct Buffer *out);
 
 #endif /* MUTT_EMAIL_PARSE_H */
@@ -96,7 +96,8 @@ void unlink_message(struct MuttThread **old, struct MuttThread *cur)
  * @param[in]     parent Parent of new thread
  * @param[in]     cur    Current thread to add after
  *
- * add cur as a prior sibling of *add, with parent parent
+ * add cur as a prior sibling of *add, with parent parent.
+ * cur is marked as needing to be sorted among its new siblings.
  */
 void insert_message(struct MuttThread **add, struct MuttThread *parent, struct MuttThread *cur)
 {
@@ -109,6 +110,7 @@ void insert_message(struct MuttThread **add, struct MuttThread *parent, struct M
   cur->parent = parent;
   cur->next = *add;
   cur->prev = NULL;
+  cur->sort_dirty = true;
   *add = cur;
 }
 
@@ -1126,7 +1126,7 @@ bool mutt_edit_content_type(struct Email *e, struct Body *b, FILE *fp)
 
   /* clean up previous junk */
   mutt_param_free(&b->parameter);
-  FREE(&b->subtype);
+  mutt_intern_free(&b->subtype);
 
   mutt_parse_content_type(buf_string(buf), b);
 
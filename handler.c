@@ -60,6 +60,7 @@
 
 #define BUFI_SIZE 1000
 #define BUFO_SIZE 2000
+#define BLOCK_SIZE 8192 ///< Size of the blocks read by the base64 and QP decoders
 
 #define TXT_HTML 1
 #define TXT_PLAIN 2
@@ -200,61 +201,68 @@ static void decode_xbit(struct State *state, long len, bool istext, iconv_t cd)
 }
 
 /**
- * qp_decode_triple - Decode a quoted-printable triplet
- * @param s State to work with
- * @param d Decoded character
- * @retval 0 Success
- * @retval -1 Error
+ * qp_decode_line - Decode a line of quoted-printable text
+ * @param dest Buffer for result, at least `len + 1` bytes
+ * @param src  Text to decode, including its line terminator, if any
+ * @param len  Length of the text
+ * @retval num Bytes written to the buffer
+ *
+ * If the text isn't a complete line, it's decoded as-is.  Otherwise, trailing
+ * whitespace is removed and, unless the line ends with a soft line break, it
+ * is terminated with a newline.
  */
-static int qp_decode_triple(char *s, char *d)
+static size_t qp_decode_line(char *dest, const char *src, size_t len)
 {
-  /* soft line break */
-  if ((s[0] == '=') && (s[1] == '\0'))
-    return 1;
+  const int last = (len != 0) ? src[len - 1] : 0;
 
-  /* quoted-printable triple */
-  if ((s[0] == '=') && isxdigit((unsigned char) s[1]) && isxdigit((unsigned char) s[2]))
+  /* chop trailing whitespace if we got the full line */
+  if (last == '\n')
   {
-    *d = (hexval(s[1]) << 4) | hexval(s[2]);
-    return 0;
+    while ((len > 0) && isspace((unsigned char) src[len - 1]))
+      len--;
   }
 
-  /* something else */
-  return -1;
-}
-
-/**
- * qp_decode_line - Decode a line of quoted-printable text
- * @param dest Buffer for result
- * @param src  Text to decode
- * @param l    Bytes written to buffer
- * @param last Last character of the line
- */
-static void qp_decode_line(char *dest, char *src, size_t *l, int last)
-{
-  char *d = NULL, *s = NULL;
-  char c = 0;
-
-  int kind = -1;
+  const char *s = src;
+  const char *end = src + len;
+  char *d = dest;
   bool soft = false;
+  bool cr = false; /* the line ended with an encoded \r */
 
-  /* decode the line */
-
-  for (d = dest, s = src; *s;)
+  while (s < end)
   {
-    switch ((kind = qp_decode_triple(s, &c)))
+    /* copy the plain text up to the next '=' in one go */
+    const char *eq = memchr(s, '=', end - s);
+    const size_t plain = (eq ? eq : end) - s;
+    if (plain != 0)
+    {
+      memcpy(d, s, plain);
+      d += plain;
+      s += plain;
+      cr = false;
+    }
+    if (!eq)
+      break;
+
+    if ((end - s) == 1)
+    {
+      /* soft line break */
+      soft = true;
+      s++;
+    }
+    else if (((end - s) >= 3) && isxdigit((unsigned char) s[1]) &&
+             isxdigit((unsigned char) s[2]))
     {
-      case 0:
-        *d++ = c;
-        s += 3;
-        break; /* qp triple */
-      case -1:
-        *d++ = *s++;
-        break; /* single character */
-      case 1:
-        soft = true;
-        s++;
-        break; /* soft line break */
+      /* quoted-printable triple */
+      *d = (hexval(s[1]) << 4) | hexval(s[2]);
+      cr = (*d == '\r');
+      d++;
+      s += 3;
+    }
+    else
+    {
+      /* something else */
+      *d++ = *s++;
+      cr = false;
     }
   }
 
@@ -263,14 +271,13 @@ static void qp_decode_line(char *dest, char *src, size_t *l, int last)
     /* neither \r nor \n as part of line-terminating CRLF
      * may be qp-encoded, so remove \r and \n-terminate;
      * see RFC2045, sect. 6.7, (1): General 8bit representation */
-    if ((kind == 0) && (c == '\r'))
+    if (cr)
       *(d - 1) = '\n';
     else
       *d++ = '\n';
   }
 
-  *d = '\0';
-  *l = d - dest;
+  return d - dest;
 }
 
 /**
@@ -280,63 +287,75 @@ static void qp_decode_line(char *dest, char *src, size_t *l, int last)
  * @param istext Mime part is plain text
  * @param cd     Iconv conversion descriptor
  *
- * Why doesn't this overflow any buffers? First, it's guaranteed that the
- * length of a line grows when you _en_-code it to quoted-printable. That
- * means that we always can store the result in a buffer of at most the _same_
- * size.
- *
- * Now, we don't special-case if the line we read with fgets() isn't
- * terminated. We don't care about this, since 256 > 78, so corrupted input
- * will just be corrupted a bit more. That implies that 256+1 bytes are
- * always sufficient to store the result of qp_decode_line.
+ * The text is read in blocks and decoded a line at a time.  A line can't grow
+ * when it's decoded, so a line from the input block always fits in the output
+ * block, alongside any multibyte character left over by convert_to_state().
  *
- * Finally, at soft line breaks, some part of a multibyte character may have
- * been left over by convert_to_state(). This shouldn't be more than 6
- * characters, so 256+7 should be sufficient memory to store the decoded
- * data.
- *
- * Just to make sure that I didn't make some off-by-one error above, we just
- * use 512 for the target buffer's size.
+ * Lines longer than a block are decoded in pieces, taking care not to split a
+ * quoted-printable triple.
  */
 static void decode_quoted(struct State *state, long len, bool istext, iconv_t cd)
 {
-  char line[256] = { 0 };
-  char decline[512] = { 0 };
+  char bufe[BLOCK_SIZE];
+  char bufi[BLOCK_SIZE * 2];
+  size_t have = 0;
   size_t l = 0;
-  size_t l3;
 
   if (istext)
     state_set_prefix(state);
 
-  while (len > 0)
+  while (true)
   {
-    /* It's ok to use a fixed size buffer for input, even if the line turns
-     * out to be longer than this.  Just process the line in chunks.  This
-     * really shouldn't happen according the MIME spec, since Q-P encoded
-     * lines are at most 76 characters, but we should be liberal about what
-     * we accept.  */
-    if (!fgets(line, MIN((ssize_t) sizeof(line), len + 1), state->fp_in))
+    if ((len > 0) && (have < sizeof(bufe)))
+    {
+      const size_t n = fread(bufe + have, 1, MIN(sizeof(bufe) - have, len), state->fp_in);
+      if (n == 0)
+        len = 0;
+      len -= n;
+      have += n;
+    }
+
+    if (have == 0)
       break;
 
-    size_t linelen = strlen(line);
-    len -= linelen;
+    size_t start = 0;
+    const char *nl = NULL;
+    while ((nl = memchr(bufe + start, '\n', have - start)))
+    {
+      const size_t linelen = nl + 1 - (bufe + start);
+      if ((l + linelen + 1) > sizeof(bufi))
+        convert_to_state(cd, bufi, &l, state);
+      l += qp_decode_line(bufi + l, bufe + start, linelen);
+      start += linelen;
+    }
 
-    /* inspect the last character we read so we can tell if we got the
-     * entire line.  */
-    const int last = (linelen != 0) ? line[linelen - 1] : 0;
+    size_t rest = 0;
+    if (len <= 0)
+    {
+      /* an unterminated last line */
+      rest = have - start;
+    }
+    else if ((start == 0) && (have == sizeof(bufe)))
+    {
+      /* a line longer than the block; don't split a triple */
+      rest = have;
+      if (bufe[rest - 1] == '=')
+        rest -= 1;
+      else if (bufe[rest - 2] == '=')
+        rest -= 2;
+    }
 
-    /* chop trailing whitespace if we got the full line */
-    if (last == '\n')
+    if (rest != 0)
     {
-      while ((linelen > 0) && isspace(line[linelen - 1]))
-        linelen--;
-      line[linelen] = '\0';
+      if ((l + rest + 1) > sizeof(bufi))
+        convert_to_state(cd, bufi, &l, state);
+      l += qp_decode_line(bufi + l, bufe + start, rest);
+      start += rest;
     }
 
-    /* decode and do character set conversion */
-    qp_decode_line(decline + l, line, &l3, last);
-    l += l3;
-    convert_to_state(cd, decline, &l, state);
+    memmove(bufe, bufe + start, have - start);
+    have -= start;
+    convert_to_state(cd, bufi, &l, state);
   }
 
   convert_to_state(cd, 0, 0, state);
@@ -1515,90 +1534,56 @@ static int malformed_pgp_encrypted_handler(struct Body *b, struct State *state)
  * @param len    Length of text to decode
  * @param istext Mime part is plain text
  * @param cd     Iconv conversion descriptor
+ *
+ * The text is read and decoded in blocks, see mutt_b64_decode_stream().
  */
 void mutt_decode_base64(struct State *state, size_t len, bool istext, iconv_t cd)
 {
-  char buf[5] = { 0 };
-  int ch, i;
+  char bufe[BLOCK_SIZE];
+  char bufd[BLOCK_SIZE];
+  char bufi[BLOCK_SIZE * 2];
+  struct Base64Decoder dec = { 0 };
   bool cr = false;
-  char bufi[BUFI_SIZE] = { 0 };
   size_t l = 0;
 
-  buf[4] = '\0';
-
   if (istext)
     state_set_prefix(state);
 
-  while (len > 0)
+  while ((len > 0) && !dec.done)
   {
-    for (i = 0; (i < 4) && (len > 0); len--)
-    {
-      ch = fgetc(state->fp_in);
-      if (ch == EOF)
-        break;
-      if ((ch >= 0) && (ch < 128) && ((base64val(ch) != -1) || (ch == '=')))
-        buf[i++] = ch;
-    }
-    if (i != 4)
-    {
-      /* "i" may be zero if there is trailing whitespace, which is not an error */
-      if (i != 0)
-        mutt_debug(LL_DEBUG2, "didn't get a multiple of 4 chars\n");
-      break;
-    }
-
-    const int c1 = base64val(buf[0]);
-    const int c2 = base64val(buf[1]);
-
-    /* first char */
-    ch = (c1 << 2) | (c2 >> 4);
-
-    if (cr && (ch != '\n'))
-      bufi[l++] = '\r';
-
-    cr = false;
-
-    if (istext && (ch == '\r'))
-      cr = true;
-    else
-      bufi[l++] = ch;
-
-    /* second char */
-    if (buf[2] == '=')
+    const size_t n = fread(bufe, 1, MIN(sizeof(bufe), len), state->fp_in);
+    if (n == 0)
       break;
-    const int c3 = base64val(buf[2]);
-    ch = ((c2 & 0xf) << 4) | (c3 >> 2);
-
-    if (cr && (ch != '\n'))
-      bufi[l++] = '\r';
+    len -= n;
 
-    cr = false;
-
-    if (istext && (ch == '\r'))
-      cr = true;
+    const size_t dlen = mutt_b64_decode_stream(&dec, bufe, n, bufd);
+    if (!istext)
+    {
+      memcpy(bufi + l, bufd, dlen);
+      l += dlen;
+    }
     else
-      bufi[l++] = ch;
-
-    /* third char */
-    if (buf[3] == '=')
-      break;
-    const int c4 = base64val(buf[3]);
-    ch = ((c3 & 0x3) << 6) | c4;
-
-    if (cr && (ch != '\n'))
-      bufi[l++] = '\r';
-
-    cr = false;
+    {
+      /* convert CRLF to LF */
+      for (size_t i = 0; i < dlen; i++)
+      {
+        const char ch = bufd[i];
+        if (cr && (ch != '\n'))
+          bufi[l++] = '\r';
 
-    if (istext && (ch == '\r'))
-      cr = true;
-    else
-      bufi[l++] = ch;
+        cr = (ch == '\r');
+        if (!cr)
+          bufi[l++] = ch;
+      }
+    }
 
-    if ((l + 8) >= sizeof(bufi))
-      convert_to_state(cd, bufi, &l, state);
+    convert_to_state(cd, bufi, &l, state);
   }
 
+  /* "dec.count" may be non-zero if there is trailing whitespace, which is not an error */
+  if (dec.count != 0)
+    mutt_debug(LL_DEBUG2, "didn't get a multiple of 4 chars\n");
+
   if (cr)
     bufi[l++] = '\r';
 
@@ -33,7 +33,6 @@
  */
 
 #include "config.h"
-#include <assert.h>
 #include <errno.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -50,7 +49,6 @@
 #include "lib.h"
 #include "compress/lib.h"
 #include "store/lib.h"
-#include "hcache/hcversion.h"
 #include "muttlib.h"
 #include "serialize.h"
 
@@ -109,94 +107,37 @@ static size_t header_size(void)
  */
 static void *dump_email(struct HeaderCache *hc, const struct Email *e, int *off, uint32_t uidvalidity)
 {
-  struct Email e_dump;
-  bool convert = !CharsetIsUtf8;
-
-  *off = 0;
-  unsigned char *d = mutt_mem_malloc(4096);
-
-  d = serial_dump_uint32_t((uidvalidity != 0) ? uidvalidity : mutt_date_now(), d, off);
-  d = serial_dump_int(hc->crc, d, off);
-
-  assert((size_t) *off == header_size());
-
-  lazy_realloc(&d, *off + sizeof(struct Email));
-  memcpy(&e_dump, e, sizeof(struct Email));
-
-  /* some fields are not safe to cache */
-  e_dump.tagged = false;
-  e_dump.changed = false;
-  e_dump.threaded = false;
-  e_dump.recip_valid = false;
-  e_dump.searched = false;
-  e_dump.matched = false;
-  e_dump.collapsed = false;
-  e_dump.visible = true;
-  e_dump.num_hidden = 0;
-  e_dump.recipient = 0;
-  e_dump.attr_color = NULL;
-  e_dump.attach_valid = false;
-  e_dump.path = NULL;
-  e_dump.tree = NULL;
-  e_dump.thread = NULL;
-  e_dump.sequence = 0;
-  e_dump.notify = NULL;
-  STAILQ_INIT(&e_dump.tags);
-#ifdef MIXMASTER
-  STAILQ_INIT(&e_dump.chain);
-#endif
-  e_dump.edata = NULL;
-
-  memcpy(d + *off, &e_dump, sizeof(struct Email));
-  *off += sizeof(struct Email);
+  size_t dlen = 0;
+  unsigned char *d = serial_dump_email(e, header_size(), &dlen, !CharsetIsUtf8);
 
-  d = serial_dump_envelope(e_dump.env, d, off, convert);
-  d = serial_dump_body(e_dump.body, d, off, convert);
-  d = serial_dump_tags(&e->tags, d, off);
+  uint32_t validity = (uidvalidity != 0) ? uidvalidity : mutt_date_now();
+  memcpy(d, &validity, sizeof(uint32_t));
+  memcpy(d + sizeof(uint32_t), &hc->crc, sizeof(int));
 
+  *off = dlen;
   return d;
 }
 
 /**
  * restore_email - Restore an Email from data retrieved from the cache
- * @param d Data retrieved using hcache_fetch()
- * @retval ptr Success, the restored header (can't be NULL)
+ * @param d    Data retrieved using hcache_fetch()
+ * @param dlen Length of the data
+ * @param ea   Arena for the Email, may be NULL
+ * @retval ptr  Success, the restored header
+ * @retval NULL The data is damaged
  *
  * @note The returned Email must be free'd by caller code with
  *       email_free()
  */
-static struct Email *restore_email(const unsigned char *d)
+static struct Email *restore_email(const unsigned char *d, size_t dlen,
+                                   struct EmailArena *ea)
 {
-  int off = 0;
-  struct Email *e = email_new();
-  bool convert = !CharsetIsUtf8;
-
-  /* skip validate */
-  off += sizeof(uint32_t);
-
-  /* skip crc */
-  off += sizeof(unsigned int);
-
-  size_t sequence = e->sequence;
-  struct Notify *notify = e->notify;
-  memcpy(e, d + off, sizeof(struct Email));
-  off += sizeof(struct Email);
-  e->sequence = sequence;
-  e->notify = notify;
-
-  STAILQ_INIT(&e->tags);
-#ifdef MIXMASTER
-  STAILQ_INIT(&e->chain);
-#endif
-
-  e->env = mutt_env_new();
-  serial_restore_envelope(e->env, d, &off, convert);
-
-  e->body = mutt_body_new();
-  serial_restore_body(e->body, d, &off, convert);
-  serial_restore_tags(&e->tags, d, &off);
+  const size_t hlen = header_size();
+  if (dlen < hlen)
+    return NULL;
 
-  return e;
+  /* skip validate and crc */
+  return serial_restore_email(d + hlen, dlen - hlen, !CharsetIsUtf8, true, ea);
 }
 
 /**
@@ -412,8 +353,8 @@ static unsigned int generate_hcachever(void)
 
   mutt_md5_init_ctx(&md5ctx);
 
-  /* Seed with the compiled-in header structure hash */
-  unsigned int ver = HCACHEVER;
+  /* Seed with the version of the record format */
+  unsigned int ver = HC_RECORD_VERSION;
   mutt_md5_process_bytes(&ver, sizeof(ver), &md5ctx);
 
   /* Mix in user's spam list */
@@ -516,6 +457,13 @@ void hcache_close(struct HeaderCache **ptr)
 
   struct HeaderCache *hc = *ptr;
 
+  /* don't lose the writes of an unbalanced hcache_begin_batch() */
+  if (hc->batch_depth > 0)
+  {
+    hc->store_ops->commit_batch(hc->store_handle);
+    hc->batch_depth = 0;
+  }
+
 #ifdef USE_HCACHE_COMPRESSION
   if (hc->compr_ops)
     hc->compr_ops->close(&hc->compr_handle);
@@ -549,10 +497,8 @@ struct HCacheEntry hcache_fetch(struct HeaderCache *hc, const char *key,
   {
     goto end;
   }
-  int off = 0;
-  serial_restore_uint32_t(&hce.uidvalidity, data, &off);
-  serial_restore_int(&hce.crc, data, &off);
-  assert((size_t) off == hlen);
+  memcpy(&hce.uidvalidity, data, sizeof(uint32_t));
+  memcpy(&hce.crc, (unsigned char *) data + sizeof(uint32_t), sizeof(int));
   if ((hce.crc != hc->crc) || ((uidvalidity != 0) && (uidvalidity != hce.uidvalidity)))
   {
     goto end;
@@ -561,17 +507,19 @@ struct HCacheEntry hcache_fetch(struct HeaderCache *hc, const char *key,
 #ifdef USE_HCACHE_COMPRESSION
   if (hc->compr_ops)
   {
-    void *dblob = hc->compr_ops->decompress(hc->compr_handle,
-                                            (char *) data + hlen, dlen - hlen);
+    size_t ulen = 0;
+    void *dblob = hc->compr_ops->decompress(hc->compr_handle, (char *) data + hlen,
+                                            dlen - hlen, &ulen);
     if (!dblob)
     {
       goto end;
     }
     data = (char *) dblob - hlen; /* restore skips uidvalidity and crc */
+    dlen = hlen + ulen;
   }
 #endif
 
-  hce.email = restore_email(data);
+  hce.email = restore_email(data, dlen, hc->arena);
 
 end:
   free_raw(hc, &to_free);
@@ -636,6 +584,9 @@ int hcache_store(struct HeaderCache *hc, const char *key, size_t keylen,
   if (!hc)
     return -1;
 
+  // The whole Envelope is needed to save the Email
+  email_materialize(e);
+
   int dlen = 0;
   char *data = dump_email(hc, e, &dlen, uidvalidity);
 
@@ -716,3 +667,40 @@ int hcache_delete_record(struct HeaderCache *hc, const char *key, size_t keylen)
   buf_dealloc(&path);
   return rc;
 }
+
+/**
+ * hcache_begin_batch - Multiplexor for StoreOps::begin_batch
+ */
+int hcache_begin_batch(struct HeaderCache *hc)
+{
+  if (!hc)
+    return -1;
+
+  if (hc->batch_depth++ > 0)
+    return 0;
+
+  int rc = hc->store_ops->begin_batch(hc->store_handle);
+  if (rc != 0)
+  {
+    mutt_debug(LL_DEBUG1, "%s: begin_batch failed: %d\n", hc->store_ops->name, rc);
+    hc->batch_depth = 0;
+  }
+  return rc;
+}
+
+/**
+ * hcache_commit_batch - Multiplexor for StoreOps::commit_batch
+ */
+int hcache_commit_batch(struct HeaderCache *hc)
+{
+  if (!hc || (hc->batch_depth == 0))
+    return -1;
+
+  if (--hc->batch_depth > 0)
+    return 0;
+
+  int rc = hc->store_ops->commit_batch(hc->store_handle);
+  if (rc != 0)
+    mutt_debug(LL_DEBUG1, "%s: commit_batch failed: %d\n", hc->store_ops->name, rc);
+  return rc;
+}
@@ -43,19 +43,17 @@
  *
  * @sa Address Body Buffer Email Envelope ListNode Parameter
  *
- * To save the data, the Header Cache uses a set of 'dump' functions
- * (\ref hc_serial) to 'serialise' the structures.  The cache also stores a CRC
- * checksum of the C structs that were used.  When retrieving the data, the
- * Header Cache uses a set of 'restore' functions to turn the data back into
- * structs.
+ * To save the data, the Header Cache uses \ref hc_serial to 'serialise' the
+ * Email into a compact record: a fixed header (dates, flags), a table of
+ * offsets and an arena of strings.  The layout doesn't depend on the C structs,
+ * so single fields can be read without restoring the whole Email.
  *
- * The CRC checksum is created by `hcache/hcachever.sh` during the build
- * process.  Whenever the definition of any of the structs changes, the CRC will
- * change, invalidating any existing cached data.
+ * The cache also stores a checksum, made from #HC_RECORD_VERSION and the
+ * user's spam config.  When either changes, existing cached data is ignored.
  *
- * @note Adding or removing a field from the set of serialised fields will
- * **not** affect the CRC.  In this case, it is vital that you bump the
- * **`BASEVERSION`** variable in `hcache/hcachever.sh`
+ * @note Changing the meaning of any field of the record means that
+ * #HC_RECORD_VERSION **must** be bumped.  New fields may be added to the end
+ * of the offset table without a bump.
  *
  * ## Source
  *
@@ -77,6 +75,7 @@
 
 struct Buffer;
 struct Email;
+struct EmailArena;
 
 /**
  * struct HeaderCache - Header Cache
@@ -92,6 +91,8 @@ struct HeaderCache
   StoreHandle *store_handle;          ///< Store handle
   const struct ComprOps *compr_ops;   ///< Compression backend
   ComprHandle *compr_handle;          ///< Compression handle
+  int batch_depth;                    ///< Nesting level of hcache_begin_batch()
+  struct EmailArena *arena;           ///< Arena for restored Emails, may be NULL
 };
 
 /**
@@ -176,4 +177,23 @@ int hcache_store_raw(struct HeaderCache *hc, const char *key, size_t keylen,
  */
 int hcache_delete_record(struct HeaderCache *hc, const char *key, size_t keylen);
 
+/**
+ * hcache_begin_batch - Start grouping writes to the header cache
+ * @param hc Pointer to the struct HeaderCache structure got by hcache_open()
+ * @retval 0   Success
+ * @retval num Generic or backend-specific error code otherwise
+ *
+ * Calls may be nested; the Store only sees the outermost pair.
+ * Every call must be matched by hcache_commit_batch().
+ */
+int hcache_begin_batch(struct HeaderCache *hc);
+
+/**
+ * hcache_commit_batch - Write out the grouped writes to the header cache
+ * @param hc Pointer to the struct HeaderCache structure got by hcache_open()
+ * @retval 0   Success
+ * @retval num Generic or backend-specific error code otherwise
+ */
+int hcache_commit_batch(struct HeaderCache *hc);
+
 #endif /* MUTT_HCACHE_LIB_H */
@@ -27,13 +27,17 @@
  * @page hc_serial Email-object serialiser
  *
  * Email-object serialiser
+ *
+ * An Email is saved as a compact record, see HcRecordHeader.  Its layout
+ * doesn't depend on the in-memory structs, and single fields can be read
+ * straight out of the cached data, without restoring the whole Email.
  */
 
 #include "config.h"
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
-#include <sys/types.h>
 #include "mutt/lib.h"
 #include "address/lib.h"
 #include "config/lib.h"
@@ -41,609 +45,1017 @@
 #include "core/lib.h"
 #include "serialize.h"
 
+/* Bits of HcRecordBody.flags */
+#define HCR_B_TYPE_SHIFT           0 ///< Body.type, 4 bits
+#define HCR_B_ENCODING_SHIFT       4 ///< Body.encoding, 3 bits
+#define HCR_B_DISPOSITION_SHIFT    7 ///< Body.disposition, 2 bits
+#define HCR_B_BADSIG         (1 << 9)  ///< Body.badsig
+#define HCR_B_FORCE_CHARSET  (1 << 10) ///< Body.force_charset
+#define HCR_B_GOODSIG        (1 << 11) ///< Body.goodsig
+#define HCR_B_NOCONV         (1 << 12) ///< Body.noconv
+#define HCR_B_USE_DISP       (1 << 13) ///< Body.use_disp
+#define HCR_B_WARNSIG        (1 << 14) ///< Body.warnsig
+#define HCR_B_AUTOCRYPT      (1 << 15) ///< Body.is_autocrypt
+
 /**
- * lazy_realloc - Reallocate some memory
- * @param[in] ptr Pointer to resize
- * @param[in] size Minimum size
- *
- * The minimum size is 4KiB to avoid repeated resizing.
+ * struct RecordWriter - Build a cached Email record
  */
-void lazy_realloc(void *ptr, size_t size)
+struct RecordWriter
 {
-  void **p = (void **) ptr;
+  unsigned char *data; ///< Output, including the caller's header
+  size_t len;          ///< Bytes used
+  size_t size;         ///< Bytes allocated
+  size_t base;         ///< Start of the record within the data
+  bool convert;        ///< Convert strings to utf-8
+};
 
-  if (p && (size < 4096))
-    return;
+/**
+ * struct RecordReader - Read a cached Email record
+ */
+struct RecordReader
+{
+  const unsigned char *data; ///< Start of the record
+  size_t size;               ///< Size of the record
+  uint16_t num_fields;       ///< Entries in the offset table
+};
 
-  mutt_mem_realloc(ptr, size);
+/**
+ * rw_append - Append some data to a record
+ * @param rw  Record writer
+ * @param src Data to append, NULL to append zeros
+ * @param len Length of the data
+ * @retval num Offset of the data within the record
+ */
+static uint32_t rw_append(struct RecordWriter *rw, const void *src, size_t len)
+{
+  if ((rw->len + len) > rw->size)
+  {
+    rw->size = MAX(rw->size * 2, rw->len + len);
+    mutt_mem_realloc(&rw->data, rw->size);
+  }
+
+  if (src)
+    memcpy(rw->data + rw->len, src, len);
+  else
+    memset(rw->data + rw->len, 0, len);
+
+  uint32_t off = rw->len - rw->base;
+  rw->len += len;
+  return off;
 }
 
 /**
- * serial_dump_int - Pack an integer into a binary blob
- * @param[in]     i   Integer to save
- * @param[in]     d   Binary blob to add to
- * @param[in,out] off Offset into the blob
- * @retval ptr End of the newly packed binary
+ * rw_put_u32 - Overwrite a number in a record
+ * @param rw  Record writer
+ * @param off Offset within the record
+ * @param num Number to save
  */
-unsigned char *serial_dump_int(const unsigned int i, unsigned char *d, int *off)
+static void rw_put_u32(struct RecordWriter *rw, uint32_t off, uint32_t num)
 {
-  lazy_realloc(&d, *off + sizeof(int));
-  memcpy(d + *off, &i, sizeof(int));
-  (*off) += sizeof(int);
+  memcpy(rw->data + rw->base + off, &num, sizeof(num));
+}
 
-  return d;
+/**
+ * rw_str - Append a string to a record
+ * @param rw      Record writer
+ * @param str     String to save
+ * @param convert If true, the string will be converted to utf-8
+ * @retval num Offset of the string, 0 if it's NULL
+ */
+static uint32_t rw_str(struct RecordWriter *rw, const char *str, bool convert)
+{
+  if (!str)
+    return 0;
+
+  size_t len = strlen(str);
+  if (convert && rw->convert && !mutt_str_is_ascii(str, len))
+  {
+    char *tmp = mutt_str_dup(str);
+    if (mutt_ch_convert_string(&tmp, cc_charset(), "utf-8", MUTT_ICONV_NO_FLAGS) == 0)
+    {
+      uint32_t off = rw_append(rw, tmp, strlen(tmp) + 1);
+      FREE(&tmp);
+      return off;
+    }
+    FREE(&tmp);
+  }
+
+  return rw_append(rw, str, len + 1);
 }
 
 /**
- * serial_dump_uint32_t - Pack a uint32_t into a binary blob
- * @param[in]     s   uint32_t to save
- * @param[in]     d   Binary blob to add to
- * @param[in,out] off Offset into the blob
- * @retval ptr End of the newly packed binary
+ * rw_address - Append an AddressList to a record
+ * @param rw Record writer
+ * @param al AddressList to save
+ * @retval num Offset of the list, 0 if it's empty
  */
-unsigned char *serial_dump_uint32_t(const uint32_t s, unsigned char *d, int *off)
+static uint32_t rw_address(struct RecordWriter *rw, const struct AddressList *al)
 {
-  lazy_realloc(&d, *off + sizeof(uint32_t));
-  memcpy(d + *off, &s, sizeof(uint32_t));
-  (*off) += sizeof(uint32_t);
+  uint32_t count = 0;
+  struct Address *a = NULL;
+  TAILQ_FOREACH(a, al, entries)
+  {
+    count++;
+  }
+  if (count == 0)
+    return 0;
+
+  uint32_t off = rw_append(rw, &count, sizeof(count));
+  uint32_t entry = rw_append(rw, NULL, count * 3 * sizeof(uint32_t));
 
-  return d;
+  TAILQ_FOREACH(a, al, entries)
+  {
+    rw_put_u32(rw, entry, buf_is_empty(a->personal) ? 0 : rw_str(rw, buf_string(a->personal), true));
+    entry += sizeof(uint32_t);
+    rw_put_u32(rw, entry, buf_is_empty(a->mailbox) ? 0 : rw_str(rw, buf_string(a->mailbox), true));
+    entry += sizeof(uint32_t);
+    rw_put_u32(rw, entry, a->group);
+    entry += sizeof(uint32_t);
+  }
+
+  return off;
 }
 
 /**
- * serial_restore_int - Unpack an integer from a binary blob
- * @param[in]     i   Integer to write to
- * @param[in]     d   Binary blob to read from
- * @param[in,out] off Offset into the blob
+ * rw_list - Append a list of strings to a record
+ * @param rw      Record writer
+ * @param l       List to save
+ * @param convert If true, the strings will be converted to utf-8
+ * @retval num Offset of the list, 0 if it's empty
  */
-void serial_restore_int(unsigned int *i, const unsigned char *d, int *off)
+static uint32_t rw_list(struct RecordWriter *rw, const struct ListHead *l, bool convert)
 {
-  memcpy(i, d + *off, sizeof(int));
-  (*off) += sizeof(int);
+  uint32_t count = 0;
+  struct ListNode *np = NULL;
+  STAILQ_FOREACH(np, l, entries)
+  {
+    count++;
+  }
+  if (count == 0)
+    return 0;
+
+  uint32_t off = rw_append(rw, &count, sizeof(count));
+  uint32_t entry = rw_append(rw, NULL, count * sizeof(uint32_t));
+
+  STAILQ_FOREACH(np, l, entries)
+  {
+    rw_put_u32(rw, entry, rw_str(rw, np->data, convert));
+    entry += sizeof(uint32_t);
+  }
+
+  return off;
 }
 
 /**
- * serial_restore_uint32_t - Unpack an uint32_t from a binary blob
- * @param[in]     s   uint32_t to write to
- * @param[in]     d   Binary blob to read from
- * @param[in,out] off Offset into the blob
+ * rw_tags - Append a TagList to a record
+ * @param rw   Record writer
+ * @param tags Tags to save
+ * @retval num Offset of the list, 0 if it's empty
  */
-void serial_restore_uint32_t(uint32_t *s, const unsigned char *d, int *off)
+static uint32_t rw_tags(struct RecordWriter *rw, const struct TagList *tags)
 {
-  memcpy(s, d + *off, sizeof(uint32_t));
-  (*off) += sizeof(uint32_t);
+  uint32_t count = 0;
+  struct Tag *t = NULL;
+  STAILQ_FOREACH(t, tags, entries)
+  {
+    count++;
+  }
+  if (count == 0)
+    return 0;
+
+  uint32_t off = rw_append(rw, &count, sizeof(count));
+  uint32_t entry = rw_append(rw, NULL, count * sizeof(uint32_t));
+
+  STAILQ_FOREACH(t, tags, entries)
+  {
+    rw_put_u32(rw, entry, rw_str(rw, t->name, false));
+    entry += sizeof(uint32_t);
+  }
+
+  return off;
 }
 
 /**
- * serial_dump_char_size - Pack a fixed-length string into a binary blob
- * @param[in]     c       String to pack
- * @param[in]     d       Binary blob to add to
- * @param[in]     size    Size of the string
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * rw_parameter - Append a ParameterList to a record
+ * @param rw Record writer
+ * @param pl Parameters to save
+ * @retval num Offset of the list, 0 if it's empty
  */
-unsigned char *serial_dump_char_size(const char *c, ssize_t size,
-                                     unsigned char *d, int *off, bool convert)
+static uint32_t rw_parameter(struct RecordWriter *rw, const struct ParameterList *pl)
 {
-  char *p = NULL;
+  uint32_t count = 0;
+  struct Parameter *np = NULL;
+  TAILQ_FOREACH(np, pl, entries)
+  {
+    count++;
+  }
+  if (count == 0)
+    return 0;
 
-  if (!c)
+  uint32_t off = rw_append(rw, &count, sizeof(count));
+  uint32_t entry = rw_append(rw, NULL, count * 2 * sizeof(uint32_t));
+
+  TAILQ_FOREACH(np, pl, entries)
   {
-    size = 0;
-    d = serial_dump_int(size, d, off);
-    return d;
+    rw_put_u32(rw, entry, rw_str(rw, np->attribute, false));
+    entry += sizeof(uint32_t);
+    rw_put_u32(rw, entry, rw_str(rw, np->value, true));
+    entry += sizeof(uint32_t);
   }
 
-  if (convert && !mutt_str_is_ascii(c, size))
+  return off;
+}
+
+/**
+ * rw_body - Append a Body to a record
+ * @param rw Record writer
+ * @param b  Body to save
+ * @retval num Offset of the Body, 0 if there isn't one
+ */
+static uint32_t rw_body(struct RecordWriter *rw, const struct Body *b)
+{
+  if (!b)
+    return 0;
+
+  struct HcRecordBody rb = { 0 };
+  uint32_t off = rw_append(rw, NULL, sizeof(rb));
+
+  rb.flags = (b->type << HCR_B_TYPE_SHIFT) | (b->encoding << HCR_B_ENCODING_SHIFT) |
+             (b->disposition << HCR_B_DISPOSITION_SHIFT);
+  if (b->badsig)
+    rb.flags |= HCR_B_BADSIG;
+  if (b->force_charset)
+    rb.flags |= HCR_B_FORCE_CHARSET;
+  if (b->goodsig)
+    rb.flags |= HCR_B_GOODSIG;
+  if (b->noconv)
+    rb.flags |= HCR_B_NOCONV;
+  if (b->use_disp)
+    rb.flags |= HCR_B_USE_DISP;
+  if (b->warnsig)
+    rb.flags |= HCR_B_WARNSIG;
+#ifdef USE_AUTOCRYPT
+  if (b->is_autocrypt)
+    rb.flags |= HCR_B_AUTOCRYPT;
+#endif
+
+  rb.xtype = rw_str(rw, b->xtype, false);
+  rb.subtype = rw_str(rw, b->subtype, false);
+  rb.description = rw_str(rw, b->description, true);
+  rb.form_name = rw_str(rw, b->form_name, true);
+  rb.filename = rw_str(rw, b->filename, true);
+  rb.d_filename = rw_str(rw, b->d_filename, true);
+  rb.parameter = rw_parameter(rw, &b->parameter);
+  rb.offset = b->offset;
+  rb.length = b->length;
+  rb.hdr_offset = b->hdr_offset;
+
+  memcpy(rw->data + rw->base + off, &rb, sizeof(rb));
+  return off;
+}
+
+/**
+ * serial_dump_email - Pack an Email into a cache record
+ * @param[in]  e       Email to pack
+ * @param[in]  hlen    Number of bytes to leave free for the caller, at the start
+ * @param[out] dlen    Length of the returned data, including @a hlen
+ * @param[in]  convert If true, the strings will be converted to utf-8
+ * @retval ptr Data to be cached; the record starts at offset @a hlen
+ *
+ * Fields that aren't safe to cache, e.g. the view data, aren't saved.
+ * The caller must free the returned data.
+ */
+void *serial_dump_email(const struct Email *e, size_t hlen, size_t *dlen, bool convert)
+{
+  struct RecordWriter rw = { 0 };
+  rw.size = 1024;
+  rw.data = mutt_mem_malloc(rw.size);
+  rw.convert = convert;
+
+  rw_append(&rw, NULL, hlen);
+  rw.base = hlen;
+
+  struct HcRecordHeader hdr = { 0 };
+  rw_append(&rw, NULL, sizeof(hdr));
+  uint32_t fields[HCR_MAX] = { 0 };
+  const uint32_t table = rw_append(&rw, NULL, sizeof(fields));
+
+  hdr.version = HC_RECORD_VERSION;
+  hdr.num_fields = HCR_MAX;
+  hdr.flags = HCR_F_NO_FLAGS;
+  if (e->expired)
+    hdr.flags |= HCR_F_EXPIRED;
+  if (e->flagged)
+    hdr.flags |= HCR_F_FLAGGED;
+  if (e->mime)
+    hdr.flags |= HCR_F_MIME;
+  if (e->old)
+    hdr.flags |= HCR_F_OLD;
+  if (e->read)
+    hdr.flags |= HCR_F_READ;
+  if (e->replied)
+    hdr.flags |= HCR_F_REPLIED;
+  if (e->superseded)
+    hdr.flags |= HCR_F_SUPERSEDED;
+  if (e->trash)
+    hdr.flags |= HCR_F_TRASH;
+  if (e->active)
+    hdr.flags |= HCR_F_ACTIVE;
+  if (e->deleted)
+    hdr.flags |= HCR_F_DELETED;
+  if (e->purge)
+    hdr.flags |= HCR_F_PURGE;
+  if (e->zoccident)
+    hdr.flags |= HCR_F_ZOCCIDENT;
+  hdr.security = e->security;
+  hdr.date_sent = e->date_sent;
+  hdr.received = e->received;
+  hdr.offset = e->offset;
+  hdr.lines = e->lines;
+  hdr.zhours = e->zhours;
+  hdr.zminutes = e->zminutes;
+
+  const struct Envelope *env = e->env;
+  if (env)
   {
-    p = mutt_strn_dup(c, size);
-    if (mutt_ch_convert_string(&p, cc_charset(), "utf-8", MUTT_ICONV_NO_FLAGS) == 0)
+    fields[HCR_SUBJECT] = rw_str(&rw, env->subject, true);
+    if (fields[HCR_SUBJECT] && env->real_subj && (env->real_subj >= env->subject) &&
+        (env->real_subj < (env->subject + strlen(env->subject))))
     {
-      size = mutt_str_len(p) + 1;
+      fields[HCR_REAL_SUBJ] = fields[HCR_SUBJECT] + (env->real_subj - env->subject);
     }
+    fields[HCR_FROM] = rw_address(&rw, &env->from);
+    fields[HCR_TO] = rw_address(&rw, &env->to);
+    fields[HCR_CC] = rw_address(&rw, &env->cc);
+    fields[HCR_BCC] = rw_address(&rw, &env->bcc);
+    fields[HCR_SENDER] = rw_address(&rw, &env->sender);
+    fields[HCR_REPLY_TO] = rw_address(&rw, &env->reply_to);
+    fields[HCR_MAIL_FOLLOWUP_TO] = rw_address(&rw, &env->mail_followup_to);
+    fields[HCR_RETURN_PATH] = rw_address(&rw, &env->return_path);
+    fields[HCR_MESSAGE_ID] = rw_str(&rw, env->message_id, false);
+    fields[HCR_SUPERSEDES] = rw_str(&rw, env->supersedes, false);
+    fields[HCR_DATE] = rw_str(&rw, env->date, false);
+    fields[HCR_X_LABEL] = rw_str(&rw, env->x_label, true);
+    fields[HCR_ORGANIZATION] = rw_str(&rw, env->organization, true);
+    if (!buf_is_empty(&env->spam))
+      fields[HCR_SPAM] = rw_str(&rw, buf_string(&env->spam), true);
+    fields[HCR_LIST_POST] = rw_str(&rw, env->list_post, true);
+    fields[HCR_LIST_SUBSCRIBE] = rw_str(&rw, env->list_subscribe, true);
+    fields[HCR_LIST_UNSUBSCRIBE] = rw_str(&rw, env->list_unsubscribe, true);
+    fields[HCR_REFERENCES] = rw_list(&rw, &env->references, false);
+    fields[HCR_IN_REPLY_TO] = rw_list(&rw, &env->in_reply_to, false);
+    fields[HCR_USERHDRS] = rw_list(&rw, &env->userhdrs, true);
+#ifdef USE_NNTP
+    fields[HCR_XREF] = rw_str(&rw, env->xref, false);
+    fields[HCR_FOLLOWUP_TO] = rw_str(&rw, env->followup_to, false);
+    fields[HCR_X_COMMENT_TO] = rw_str(&rw, env->x_comment_to, true);
+#endif
+  }
+  fields[HCR_TAGS] = rw_tags(&rw, &e->tags);
+  fields[HCR_BODY] = rw_body(&rw, e->body);
+
+  hdr.size = rw.len - rw.base;
+  memcpy(rw.data + rw.base, &hdr, sizeof(hdr));
+  memcpy(rw.data + rw.base + table, fields, sizeof(fields));
+
+  *dlen = rw.len;
+  return rw.data;
+}
+
+/**
+ * rr_init - Check a record and prepare to read it
+ * @param rr   Record reader
+ * @param d    Start of the record
+ * @param dlen Length of the available data
+ * @param hdr  Header of the record, may be NULL
+ * @retval true The record is usable
+ */
+static bool rr_init(struct RecordReader *rr, const unsigned char *d, size_t dlen,
+                    struct HcRecordHeader *hdr)
+{
+  struct HcRecordHeader h = { 0 };
+  if (!d || (dlen < sizeof(h)))
+    return false;
+
+  memcpy(&h, d, sizeof(h));
+  if ((h.version != HC_RECORD_VERSION) || (h.size > dlen) ||
+      ((sizeof(h) + (h.num_fields * sizeof(uint32_t))) > h.size))
+  {
+    return false;
   }
 
-  d = serial_dump_int(size, d, off);
-  lazy_realloc(&d, *off + size);
-  memcpy(d + *off, p ? p : c, size);
-  *off += size;
+  rr->data = d;
+  rr->size = h.size;
+  rr->num_fields = h.num_fields;
+  if (hdr)
+    *hdr = h;
+  return true;
+}
+
+/**
+ * rr_u32 - Read a number from a record
+ * @param rr  Record reader
+ * @param off Offset within the record
+ * @retval num Number, 0 if it's out of bounds
+ */
+static uint32_t rr_u32(const struct RecordReader *rr, size_t off)
+{
+  uint32_t num = 0;
+  if ((off + sizeof(num)) <= rr->size)
+    memcpy(&num, rr->data + off, sizeof(num));
+  return num;
+}
 
-  if (p)
-    FREE(&p);
+/**
+ * rr_field - Look up a field in the offset table
+ * @param rr    Record reader
+ * @param field Field, e.g. #HCR_SUBJECT
+ * @retval num Offset of the field, 0 if it's absent
+ */
+static uint32_t rr_field(const struct RecordReader *rr, enum HcRecordField field)
+{
+  if (field >= rr->num_fields)
+    return 0;
+  return rr_u32(rr, sizeof(struct HcRecordHeader) + (field * sizeof(uint32_t)));
+}
 
-  return d;
+/**
+ * rr_str - Get a string from a record
+ * @param rr  Record reader
+ * @param off Offset within the record
+ * @retval ptr  String, pointing into the record
+ * @retval NULL The string is absent or damaged
+ */
+static const char *rr_str(const struct RecordReader *rr, uint32_t off)
+{
+  if ((off == 0) || (off >= rr->size))
+    return NULL;
+  if (!memchr(rr->data + off, '\0', rr->size - off))
+    return NULL;
+  return (const char *) rr->data + off;
 }
 
 /**
- * serial_dump_char - Pack a variable-length string into a binary blob
- * @param[in]     c       String to pack
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * rr_count - Get the number of entries in a list
+ * @param rr    Record reader
+ * @param off   Offset of the list within the record
+ * @param width Number of `uint32_t` in each entry
+ * @retval num Number of entries, 0 if the list is damaged
  */
-unsigned char *serial_dump_char(const char *c, unsigned char *d, int *off, bool convert)
+static size_t rr_count(const struct RecordReader *rr, uint32_t off, size_t width)
 {
-  return serial_dump_char_size(c, mutt_str_len(c) + 1, d, off, convert);
+  if (off == 0)
+    return 0;
+  size_t count = rr_u32(rr, off);
+  if ((off + sizeof(uint32_t) + (count * width * sizeof(uint32_t))) > rr->size)
+    return 0;
+  return count;
 }
 
 /**
- * serial_restore_char - Unpack a variable-length string from a binary blob
- * @param[out]    c       Store the unpacked string here
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
+ * rr_dup - Copy a string out of a record
+ * @param rr      Record reader
+ * @param off     Offset within the record
+ * @param convert If true, the string will be converted from utf-8
+ * @retval ptr  New string
+ * @retval NULL The string is absent
  */
-void serial_restore_char(char **c, const unsigned char *d, int *off, bool convert)
+static char *rr_dup(const struct RecordReader *rr, uint32_t off, bool convert)
 {
-  unsigned int size = 0;
-  serial_restore_int(&size, d, off);
+  const char *str = rr_str(rr, off);
+  if (!str)
+    return NULL;
 
-  if (size == 0)
-  {
-    *c = NULL;
-    return;
-  }
+  char *c = mutt_str_dup(str);
+  if (!c)
+    c = mutt_mem_calloc(1, 1);
 
-  *c = mutt_mem_malloc(size);
-  memcpy(*c, d + *off, size);
-  if (convert && !mutt_str_is_ascii(*c, size))
+  if (convert && !mutt_str_is_ascii(c, strlen(c)))
   {
-    char *tmp = mutt_str_dup(*c);
+    char *tmp = mutt_str_dup(c);
     if (mutt_ch_convert_string(&tmp, "utf-8", cc_charset(), MUTT_ICONV_NO_FLAGS) == 0)
     {
-      FREE(c);
-      *c = tmp;
+      FREE(&c);
+      c = tmp;
     }
     else
     {
       FREE(&tmp);
     }
   }
-  *off += size;
+  return c;
 }
 
 /**
- * serial_dump_address - Pack an Address into a binary blob
- * @param[in]     al      AddressList to pack
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * rr_intern - Get a shared copy of a string in a record
+ * @param rr      Record reader
+ * @param off     Offset within the record
+ * @param convert If true, the string will be converted from utf-8
+ * @retval ptr  Shared string, see mutt_intern_get()
+ * @retval NULL The string is absent
  */
-unsigned char *serial_dump_address(const struct AddressList *al,
-                                   unsigned char *d, int *off, bool convert)
+static char *rr_intern(const struct RecordReader *rr, uint32_t off, bool convert)
 {
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
-
-  d = serial_dump_int(0xdeadbeef, d, off);
-
-  struct Address *a = NULL;
-  TAILQ_FOREACH(a, al, entries)
+  const char *str = rr_str(rr, off);
+  if (!str || (convert && !mutt_str_is_ascii(str, strlen(str))))
   {
-    d = serial_dump_buffer(a->personal, d, off, convert);
-    d = serial_dump_buffer(a->mailbox, d, off, convert);
-    d = serial_dump_int(a->group, d, off);
-    counter++;
+    char *c = rr_dup(rr, off, convert);
+    char *is = mutt_intern_get(c);
+    FREE(&c);
+    return is;
   }
 
-  memcpy(d + start_off, &counter, sizeof(int));
-
-  return d;
+  return mutt_intern_get(str);
 }
 
 /**
- * serial_restore_address - Unpack an Address from a binary blob
- * @param[out]    al      Store the unpacked AddressList here
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted from utf-8
+ * rr_address - Restore an AddressList from a record
+ * @param rr      Record reader
+ * @param off     Offset of the list within the record
+ * @param al      AddressList to add to
+ * @param convert If true, the strings will be converted from utf-8
  */
-void serial_restore_address(struct AddressList *al, const unsigned char *d,
-                            int *off, bool convert)
+static void rr_address(const struct RecordReader *rr, uint32_t off,
+                       struct AddressList *al, bool convert)
 {
-  unsigned int counter = 0;
-  unsigned int g = 0;
-
-  serial_restore_int(&counter, d, off);
-
-  while (counter)
+  size_t count = rr_count(rr, off, 3);
+  size_t entry = off + sizeof(uint32_t);
+  for (size_t i = 0; i < count; i++, entry += 3 * sizeof(uint32_t))
   {
     struct Address *a = mutt_addr_new();
 
-    a->personal = buf_new(NULL);
-    serial_restore_buffer(a->personal, d, off, convert);
-    if (buf_is_empty(a->personal))
+    char *personal = rr_dup(rr, rr_u32(rr, entry), convert);
+    if (personal)
     {
-      buf_free(&a->personal);
+      a->personal = buf_new(personal);
+      FREE(&personal);
     }
 
-    a->mailbox = buf_new(NULL);
-    serial_restore_buffer(a->mailbox, d, off, false);
-    if (buf_is_empty(a->mailbox))
+    char *mailbox = rr_dup(rr, rr_u32(rr, entry + sizeof(uint32_t)), convert);
+    if (mailbox)
     {
-      buf_free(&a->mailbox);
+      a->mailbox = buf_new(mailbox);
+      FREE(&mailbox);
     }
 
-    serial_restore_int(&g, d, off);
-    a->group = !!g;
+    a->group = (rr_u32(rr, entry + 2 * sizeof(uint32_t)) != 0);
     mutt_addrlist_append(al, a);
-    counter--;
   }
 }
 
 /**
- * serial_dump_stailq - Pack a STAILQ into a binary blob
- * @param[in]     l       List to read from
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * rr_list - Restore a list of strings from a record
+ * @param rr      Record reader
+ * @param off     Offset of the list within the record
+ * @param l       List to add to
+ * @param convert If true, the strings will be converted from utf-8
  */
-unsigned char *serial_dump_stailq(const struct ListHead *l, unsigned char *d,
-                                  int *off, bool convert)
+static void rr_list(const struct RecordReader *rr, uint32_t off,
+                    struct ListHead *l, bool convert)
 {
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
-
-  d = serial_dump_int(0xdeadbeef, d, off);
-
-  struct ListNode *np = NULL;
-  STAILQ_FOREACH(np, l, entries)
+  size_t count = rr_count(rr, off, 1);
+  size_t entry = off + sizeof(uint32_t);
+  for (size_t i = 0; i < count; i++, entry += sizeof(uint32_t))
   {
-    d = serial_dump_char(np->data, d, off, convert);
-    counter++;
+    mutt_list_insert_tail(l, rr_dup(rr, rr_u32(rr, entry), convert));
   }
-
-  memcpy(d + start_off, &counter, sizeof(int));
-
-  return d;
 }
 
 /**
- * serial_restore_stailq - Unpack a STAILQ from a binary blob
- * @param[in]     l       List to add to
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted from utf-8
+ * rr_tags - Restore a TagList from a record
+ * @param rr   Record reader
+ * @param off  Offset of the list within the record
+ * @param tags TagList to add to
  */
-void serial_restore_stailq(struct ListHead *l, const unsigned char *d, int *off, bool convert)
+static void rr_tags(const struct RecordReader *rr, uint32_t off, struct TagList *tags)
 {
-  unsigned int counter = 0;
-
-  serial_restore_int(&counter, d, off);
-
-  struct ListNode *np = NULL;
-  while (counter)
+  size_t count = rr_count(rr, off, 1);
+  size_t entry = off + sizeof(uint32_t);
+  for (size_t i = 0; i < count; i++, entry += sizeof(uint32_t))
   {
-    np = mutt_list_insert_tail(l, NULL);
-    serial_restore_char(&np->data, d, off, convert);
-    counter--;
+    char *name = rr_dup(rr, rr_u32(rr, entry), false);
+    if (name)
+      driver_tags_add(tags, name);
   }
 }
 
 /**
- * serial_dump_buffer - Pack a Buffer into a binary blob
- * @param[in]     buf     Buffer to pack
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * rr_parameter - Restore a ParameterList from a record
+ * @param rr      Record reader
+ * @param off     Offset of the list within the record
+ * @param pl      ParameterList to add to
+ * @param convert If true, the strings will be converted from utf-8
  */
-unsigned char *serial_dump_buffer(const struct Buffer *buf, unsigned char *d,
-                                  int *off, bool convert)
+static void rr_parameter(const struct RecordReader *rr, uint32_t off,
+                         struct ParameterList *pl, bool convert)
 {
-  if (!buf)
+  size_t count = rr_count(rr, off, 2);
+  size_t entry = off + sizeof(uint32_t);
+  for (size_t i = 0; i < count; i++, entry += 2 * sizeof(uint32_t))
   {
-    d = serial_dump_int(0, d, off);
-    return d;
+    struct Parameter *np = mutt_param_new();
+    np->attribute = rr_dup(rr, rr_u32(rr, entry), false);
+    np->value = rr_dup(rr, rr_u32(rr, entry + sizeof(uint32_t)), convert);
+    TAILQ_INSERT_TAIL(pl, np, entries);
   }
-
-  d = serial_dump_int(1, d, off);
-
-  d = serial_dump_char_size(buf->data, buf->dsize, d, off, convert);
-  d = serial_dump_int(buf->dptr - buf->data, d, off);
-  d = serial_dump_int(buf->dsize, d, off);
-
-  return d;
+  mutt_param_intern(pl);
 }
 
 /**
- * serial_restore_buffer - Unpack a Buffer from a binary blob
- * @param[out]    buf     Store the unpacked Buffer here
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted from utf-8
+ * rr_body - Restore a Body from a record
+ * @param rr      Record reader
+ * @param off     Offset of the Body within the record
+ * @param b       Body to fill in
+ * @param convert If true, the strings will be converted from utf-8
  */
-void serial_restore_buffer(struct Buffer *buf, const unsigned char *d, int *off, bool convert)
+static void rr_body(const struct RecordReader *rr, uint32_t off, struct Body *b, bool convert)
 {
-  unsigned int used = 0;
-  unsigned int offset = 0;
-  serial_restore_int(&used, d, off);
-  if (used == 0)
-  {
+  struct HcRecordBody rb = { 0 };
+  if ((off == 0) || ((off + sizeof(rb)) > rr->size))
     return;
-  }
 
-  serial_restore_char(&buf->data, d, off, convert);
-  serial_restore_int(&offset, d, off);
-  buf_seek(buf, offset);
-  serial_restore_int(&used, d, off);
-  buf->dsize = used;
+  memcpy(&rb, rr->data + off, sizeof(rb));
+
+  b->type = (rb.flags >> HCR_B_TYPE_SHIFT) & 0xf;
+  b->encoding = (rb.flags >> HCR_B_ENCODING_SHIFT) & 0x7;
+  b->disposition = (rb.flags >> HCR_B_DISPOSITION_SHIFT) & 0x3;
+  b->badsig = (rb.flags & HCR_B_BADSIG);
+  b->force_charset = (rb.flags & HCR_B_FORCE_CHARSET);
+  b->goodsig = (rb.flags & HCR_B_GOODSIG);
+  b->noconv = (rb.flags & HCR_B_NOCONV);
+  b->use_disp = (rb.flags & HCR_B_USE_DISP);
+  b->warnsig = (rb.flags & HCR_B_WARNSIG);
+#ifdef USE_AUTOCRYPT
+  b->is_autocrypt = (rb.flags & HCR_B_AUTOCRYPT);
+#endif
+
+  b->xtype = rr_dup(rr, rb.xtype, false);
+  b->subtype = rr_intern(rr, rb.subtype, false);
+  b->description = rr_dup(rr, rb.description, convert);
+  b->form_name = rr_dup(rr, rb.form_name, convert);
+  b->filename = rr_dup(rr, rb.filename, convert);
+  b->d_filename = rr_dup(rr, rb.d_filename, convert);
+  rr_parameter(rr, rb.parameter, &b->parameter, convert);
+  b->offset = rb.offset;
+  b->length = rb.length;
+  b->hdr_offset = rb.hdr_offset;
 }
 
 /**
- * serial_dump_parameter - Pack a Parameter into a binary blob
- * @param[in]     pl      Parameter to pack
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * rw_copy_list - Copy a list from one record to another
+ * @param rw      Record writer
+ * @param rr      Record reader
+ * @param off     Offset of the list within the source record
+ * @param width   Number of `uint32_t` in each entry
+ * @param strings Bitmask of the entry members that are strings
+ * @retval num Offset of the list, 0 if it's empty
  */
-unsigned char *serial_dump_parameter(const struct ParameterList *pl,
-                                     unsigned char *d, int *off, bool convert)
+static uint32_t rw_copy_list(struct RecordWriter *rw, const struct RecordReader *rr,
+                             uint32_t off, size_t width, uint32_t strings)
 {
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
+  uint32_t count = rr_count(rr, off, width);
+  if (count == 0)
+    return 0;
 
-  d = serial_dump_int(0xdeadbeef, d, off);
+  uint32_t list = rw_append(rw, &count, sizeof(count));
+  uint32_t entry = rw_append(rw, NULL, count * width * sizeof(uint32_t));
 
-  struct Parameter *np = NULL;
-  TAILQ_FOREACH(np, pl, entries)
+  size_t src = off + sizeof(uint32_t);
+  for (size_t i = 0; i < (count * width); i++)
   {
-    d = serial_dump_char(np->attribute, d, off, false);
-    d = serial_dump_char(np->value, d, off, convert);
-    counter++;
+    uint32_t num = rr_u32(rr, src + (i * sizeof(uint32_t)));
+    if (strings & (1 << (i % width)))
+      num = rw_str(rw, rr_str(rr, num), false);
+    rw_put_u32(rw, entry + (i * sizeof(uint32_t)), num);
   }
 
-  memcpy(d + start_off, &counter, sizeof(int));
-
-  return d;
+  return list;
 }
 
 /**
- * serial_restore_parameter - Unpack a Parameter from a binary blob
- * @param[in]     pl      Store the unpacked Parameter here
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted from utf-8
+ * rr_envelope_index - Restore the Envelope fields the Index needs
+ * @param rr      Record reader
+ * @param env     Envelope to fill in
+ * @param convert If true, the strings will be converted from utf-8
+ *
+ * These are needed to display, sort and thread the Emails.
  */
-void serial_restore_parameter(struct ParameterList *pl, const unsigned char *d,
-                              int *off, bool convert)
+static void rr_envelope_index(const struct RecordReader *rr, struct Envelope *env, bool convert)
 {
-  unsigned int counter = 0;
+  rr_address(rr, rr_field(rr, HCR_FROM), &env->from, convert);
+  rr_address(rr, rr_field(rr, HCR_TO), &env->to, convert);
+  rr_address(rr, rr_field(rr, HCR_CC), &env->cc, convert);
+  rr_address(rr, rr_field(rr, HCR_BCC), &env->bcc, convert);
+  rr_address(rr, rr_field(rr, HCR_REPLY_TO), &env->reply_to, convert);
 
-  serial_restore_int(&counter, d, off);
+  env->list_post = rr_intern(rr, rr_field(rr, HCR_LIST_POST), convert);
 
-  struct Parameter *np = NULL;
-  while (counter)
+  const bool c_auto_subscribe = cs_subset_bool(NeoMutt->sub, "auto_subscribe");
+  if (c_auto_subscribe)
+    mutt_auto_subscribe(env->list_post);
+
+  const uint32_t subj_off = rr_field(rr, HCR_SUBJECT);
+  const uint32_t real_subj_off = rr_field(rr, HCR_REAL_SUBJ);
+  env->subject = rr_dup(rr, subj_off, convert);
+  if (env->subject && (real_subj_off >= subj_off) &&
+      ((real_subj_off - subj_off) < strlen(env->subject)))
   {
-    np = mutt_param_new();
-    serial_restore_char(&np->attribute, d, off, false);
-    serial_restore_char(&np->value, d, off, convert);
-    TAILQ_INSERT_TAIL(pl, np, entries);
-    counter--;
+    env->real_subj = env->subject + (real_subj_off - subj_off);
   }
-}
-
-/**
- * serial_dump_body - Pack an Body into a binary blob
- * @param[in]     c       Body to pack
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
- */
-unsigned char *serial_dump_body(const struct Body *c, unsigned char *d, int *off, bool convert)
-{
-  struct Body nb;
-
-  memcpy(&nb, c, sizeof(struct Body));
-
-  /* some fields are not safe to cache */
-  nb.content = NULL;
-  nb.charset = NULL;
-  nb.next = NULL;
-  nb.parts = NULL;
-  nb.email = NULL;
-  nb.aptr = NULL;
-  nb.mime_headers = NULL;
-  nb.language = NULL;
 
-  lazy_realloc(&d, *off + sizeof(struct Body));
-  memcpy(d + *off, &nb, sizeof(struct Body));
-  *off += sizeof(struct Body);
+  env->message_id = rr_dup(rr, rr_field(rr, HCR_MESSAGE_ID), false);
+  env->supersedes = rr_dup(rr, rr_field(rr, HCR_SUPERSEDES), false);
+  env->x_label = rr_dup(rr, rr_field(rr, HCR_X_LABEL), convert);
 
-  d = serial_dump_char(nb.xtype, d, off, false);
-  d = serial_dump_char(nb.subtype, d, off, false);
-
-  d = serial_dump_parameter(&nb.parameter, d, off, convert);
+  char *spam = rr_dup(rr, rr_field(rr, HCR_SPAM), convert);
+  if (spam)
+  {
+    buf_strcpy(&env->spam, spam);
+    FREE(&spam);
+  }
 
-  d = serial_dump_char(nb.description, d, off, convert);
-  d = serial_dump_char(nb.form_name, d, off, convert);
-  d = serial_dump_char(nb.filename, d, off, convert);
-  d = serial_dump_char(nb.d_filename, d, off, convert);
+  rr_list(rr, rr_field(rr, HCR_REFERENCES), &env->references, false);
+  rr_list(rr, rr_field(rr, HCR_IN_REPLY_TO), &env->in_reply_to, false);
 
-  return d;
+#ifdef USE_NNTP
+  env->xref = rr_dup(rr, rr_field(rr, HCR_XREF), false);
+#endif
 }
 
 /**
- * serial_restore_body - Unpack a Body from a binary blob
- * @param[in]     c       Store the unpacked Body here
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted from utf-8
+ * rr_envelope_rest - Restore the Envelope fields the Index doesn't need
+ * @param rr      Record reader
+ * @param env     Envelope to fill in
+ * @param convert If true, the strings will be converted from utf-8
+ *
+ * @sa #LazyFields
  */
-void serial_restore_body(struct Body *c, const unsigned char *d, int *off, bool convert)
+static void rr_envelope_rest(const struct RecordReader *rr, struct Envelope *env, bool convert)
 {
-  memcpy(c, d + *off, sizeof(struct Body));
-  *off += sizeof(struct Body);
-  c->language = NULL;
+  rr_address(rr, rr_field(rr, HCR_RETURN_PATH), &env->return_path, convert);
+  rr_address(rr, rr_field(rr, HCR_SENDER), &env->sender, convert);
+  rr_address(rr, rr_field(rr, HCR_MAIL_FOLLOWUP_TO), &env->mail_followup_to, convert);
 
-  serial_restore_char(&c->xtype, d, off, false);
-  serial_restore_char(&c->subtype, d, off, false);
+  env->list_subscribe = rr_intern(rr, rr_field(rr, HCR_LIST_SUBSCRIBE), convert);
+  env->list_unsubscribe = rr_intern(rr, rr_field(rr, HCR_LIST_UNSUBSCRIBE), convert);
+  env->date = rr_dup(rr, rr_field(rr, HCR_DATE), false);
+  env->organization = rr_dup(rr, rr_field(rr, HCR_ORGANIZATION), convert);
 
-  TAILQ_INIT(&c->parameter);
-  serial_restore_parameter(&c->parameter, d, off, convert);
+  rr_list(rr, rr_field(rr, HCR_USERHDRS), &env->userhdrs, convert);
 
-  serial_restore_char(&c->description, d, off, convert);
-  serial_restore_char(&c->form_name, d, off, convert);
-  serial_restore_char(&c->filename, d, off, convert);
-  serial_restore_char(&c->d_filename, d, off, convert);
+#ifdef USE_NNTP
+  env->followup_to = rr_dup(rr, rr_field(rr, HCR_FOLLOWUP_TO), false);
+  env->x_comment_to = rr_dup(rr, rr_field(rr, HCR_X_COMMENT_TO), convert);
+#endif
 }
 
 /**
- * serial_dump_envelope - Pack an Envelope into a binary blob
- * @param[in]     env     Envelope to pack
- * @param[in]     d       Binary blob to add to
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted to utf-8
- * @retval ptr End of the newly packed binary
+ * LazyFields - Fields restored by rr_envelope_rest()
+ *
+ * The width and strings describe the layout, like rw_copy_list().
+ * A width of 0 means the field is a single string.
  */
-unsigned char *serial_dump_envelope(const struct Envelope *env,
-                                    unsigned char *d, int *off, bool convert)
+static const struct
 {
-  d = serial_dump_address(&env->return_path, d, off, convert);
-  d = serial_dump_address(&env->from, d, off, convert);
-  d = serial_dump_address(&env->to, d, off, convert);
-  d = serial_dump_address(&env->cc, d, off, convert);
-  d = serial_dump_address(&env->bcc, d, off, convert);
-  d = serial_dump_address(&env->sender, d, off, convert);
-  d = serial_dump_address(&env->reply_to, d, off, convert);
-  d = serial_dump_address(&env->mail_followup_to, d, off, convert);
-
-  d = serial_dump_char(env->list_post, d, off, convert);
-  d = serial_dump_char(env->list_subscribe, d, off, convert);
-  d = serial_dump_char(env->list_unsubscribe, d, off, convert);
-  d = serial_dump_char(env->subject, d, off, convert);
+  enum HcRecordField field; ///< Field, e.g. #HCR_REPLY_TO
+  size_t width;             ///< Number of `uint32_t` in each list entry
+  uint32_t strings;         ///< Bitmask of the entry members that are strings
+} LazyFields[] = {
+  // clang-format off
+  { HCR_RETURN_PATH,      3, 0x3 },
+  { HCR_SENDER,           3, 0x3 },
+  { HCR_MAIL_FOLLOWUP_TO, 3, 0x3 },
+  { HCR_LIST_SUBSCRIBE,   0, 0   },
+  { HCR_LIST_UNSUBSCRIBE, 0, 0   },
+  { HCR_DATE,             0, 0   },
+  { HCR_ORGANIZATION,     0, 0   },
+  { HCR_USERHDRS,         1, 0x1 },
+  { HCR_FOLLOWUP_TO,      0, 0   },
+  { HCR_X_COMMENT_TO,     0, 0   },
+  // clang-format on
+};
 
-  if (env->real_subj)
-    d = serial_dump_int(env->real_subj - env->subject, d, off);
-  else
-    d = serial_dump_int(-1, d, off);
+/**
+ * lazy_record - Copy the fields the Index doesn't need into a new record
+ * @param rr Record reader
+ * @retval ptr  New record, see rr_envelope_rest()
+ * @retval NULL None of the fields are present
+ *
+ * The strings are copied verbatim, i.e. they're still utf-8.
+ */
+static void *lazy_record(const struct RecordReader *rr)
+{
+  uint32_t fields[HCR_MAX] = { 0 };
+  bool found = false;
+  for (size_t i = 0; i < mutt_array_size(LazyFields); i++)
+  {
+    if (rr_field(rr, LazyFields[i].field) != 0)
+    {
+      found = true;
+      break;
+    }
+  }
+  if (!found)
+    return NULL;
 
-  d = serial_dump_char(env->message_id, d, off, false);
-  d = serial_dump_char(env->supersedes, d, off, false);
-  d = serial_dump_char(env->date, d, off, false);
-  d = serial_dump_char(env->x_label, d, off, convert);
-  d = serial_dump_char(env->organization, d, off, convert);
+  struct RecordWriter rw = { 0 };
+  rw.size = 256;
+  rw.data = mutt_mem_malloc(rw.size);
 
-  d = serial_dump_buffer(&env->spam, d, off, convert);
+  struct HcRecordHeader hdr = { 0 };
+  rw_append(&rw, NULL, sizeof(hdr));
+  const uint32_t table = rw_append(&rw, NULL, sizeof(fields));
 
-  d = serial_dump_stailq(&env->references, d, off, false);
-  d = serial_dump_stailq(&env->in_reply_to, d, off, false);
-  d = serial_dump_stailq(&env->userhdrs, d, off, convert);
+  for (size_t i = 0; i < mutt_array_size(LazyFields); i++)
+  {
+    const enum HcRecordField field = LazyFields[i].field;
+    const uint32_t off = rr_field(rr, field);
+    if (LazyFields[i].width == 0)
+      fields[field] = rw_str(&rw, rr_str(rr, off), false);
+    else
+      fields[field] = rw_copy_list(&rw, rr, off, LazyFields[i].width, LazyFields[i].strings);
+  }
 
-#ifdef USE_NNTP
-  d = serial_dump_char(env->xref, d, off, false);
-  d = serial_dump_char(env->followup_to, d, off, false);
-  d = serial_dump_char(env->x_comment_to, d, off, convert);
-#endif
+  hdr.version = HC_RECORD_VERSION;
+  hdr.num_fields = HCR_MAX;
+  hdr.size = rw.len;
+  memcpy(rw.data, &hdr, sizeof(hdr));
+  memcpy(rw.data + table, fields, sizeof(fields));
 
-  return d;
+  return rw.data;
 }
 
 /**
- * serial_restore_envelope - Unpack an Envelope from a binary blob
- * @param[in]     env     Store the unpacked Envelope here
- * @param[in]     d       Binary blob to read from
- * @param[in,out] off     Offset into the blob
- * @param[in]     convert If true, the strings will be converted from utf-8
+ * lazy_load - Decode the rest of the Envelope - Implements Email::lazy_load()
  */
-void serial_restore_envelope(struct Envelope *env, const unsigned char *d, int *off, bool convert)
+static void lazy_load(struct Email *e)
 {
-  int real_subj_off = 0;
-
-  serial_restore_address(&env->return_path, d, off, convert);
-  serial_restore_address(&env->from, d, off, convert);
-  serial_restore_address(&env->to, d, off, convert);
-  serial_restore_address(&env->cc, d, off, convert);
-  serial_restore_address(&env->bcc, d, off, convert);
-  serial_restore_address(&env->sender, d, off, convert);
-  serial_restore_address(&env->reply_to, d, off, convert);
-  serial_restore_address(&env->mail_followup_to, d, off, convert);
-
-  serial_restore_char(&env->list_post, d, off, convert);
-  serial_restore_char(&env->list_subscribe, d, off, convert);
-  serial_restore_char(&env->list_unsubscribe, d, off, convert);
+  struct RecordReader rr = { 0 };
+  const unsigned char *d = e->lazy_data;
+  if (e->env && rr_init(&rr, d, serial_record_size(d), NULL))
+    rr_envelope_rest(&rr, e->env, !CharsetIsUtf8);
 
-  const bool c_auto_subscribe = cs_subset_bool(NeoMutt->sub, "auto_subscribe");
-  if (c_auto_subscribe)
-    mutt_auto_subscribe(env->list_post);
-
-  serial_restore_char(&env->subject, d, off, convert);
-  serial_restore_int((unsigned int *) (&real_subj_off), d, off);
+  FREE(&e->lazy_data);
+}
 
-  size_t len = mutt_str_len(env->subject);
-  if ((real_subj_off < 0) || (real_subj_off >= len))
-    env->real_subj = NULL;
+/**
+ * serial_restore_email - Unpack an Email from a cache record
+ * @param d       Start of the record
+ * @param dlen    Length of the available data
+ * @param convert If true, the strings will be converted from utf-8
+ * @param lazy    If true, only restore the Envelope fields the Index needs
+ * @param ea      Arena for the Email, may be NULL
+ * @retval ptr  New Email
+ * @retval NULL The record is damaged, or was written in another format
+ *
+ * In lazy mode, the rest of the Envelope is kept in Email.lazy_data until
+ * email_materialize() is called.
+ */
+struct Email *serial_restore_email(const unsigned char *d, size_t dlen,
+                                   bool convert, bool lazy, struct EmailArena *ea)
+{
+  struct RecordReader rr = { 0 };
+  struct HcRecordHeader hdr = { 0 };
+  if (!rr_init(&rr, d, dlen, &hdr))
+    return NULL;
+
+  struct Email *e = email_new_arena(ea);
+
+  e->expired = (hdr.flags & HCR_F_EXPIRED);
+  e->flagged = (hdr.flags & HCR_F_FLAGGED);
+  e->mime = (hdr.flags & HCR_F_MIME);
+  e->old = (hdr.flags & HCR_F_OLD);
+  e->read = (hdr.flags & HCR_F_READ);
+  e->replied = (hdr.flags & HCR_F_REPLIED);
+  e->superseded = (hdr.flags & HCR_F_SUPERSEDED);
+  e->trash = (hdr.flags & HCR_F_TRASH);
+  e->active = (hdr.flags & HCR_F_ACTIVE);
+  e->deleted = (hdr.flags & HCR_F_DELETED);
+  e->purge = (hdr.flags & HCR_F_PURGE);
+  e->zoccident = (hdr.flags & HCR_F_ZOCCIDENT);
+  e->security = hdr.security;
+  e->date_sent = hdr.date_sent;
+  e->received = hdr.received;
+  e->offset = hdr.offset;
+  e->lines = hdr.lines;
+  e->zhours = hdr.zhours;
+  e->zminutes = hdr.zminutes;
+
+  e->env = mutt_env_new_arena(ea);
+  rr_envelope_index(&rr, e->env, convert);
+  if (lazy)
+  {
+    e->lazy_data = lazy_record(&rr);
+    e->lazy_load = lazy_load;
+  }
   else
-    env->real_subj = env->subject + real_subj_off;
-
-  serial_restore_char(&env->message_id, d, off, false);
-  serial_restore_char(&env->supersedes, d, off, false);
-  serial_restore_char(&env->date, d, off, false);
-  serial_restore_char(&env->x_label, d, off, convert);
-  serial_restore_char(&env->organization, d, off, convert);
+  {
+    rr_envelope_rest(&rr, e->env, convert);
+  }
 
-  serial_restore_buffer(&env->spam, d, off, convert);
+  rr_tags(&rr, rr_field(&rr, HCR_TAGS), &e->tags);
 
-  serial_restore_stailq(&env->references, d, off, false);
-  serial_restore_stailq(&env->in_reply_to, d, off, false);
-  serial_restore_stailq(&env->userhdrs, d, off, convert);
+  e->body = mutt_body_new_arena(ea);
+  rr_body(&rr, rr_field(&rr, HCR_BODY), e->body, convert);
 
-#ifdef USE_NNTP
-  serial_restore_char(&env->xref, d, off, false);
-  serial_restore_char(&env->followup_to, d, off, false);
-  serial_restore_char(&env->x_comment_to, d, off, convert);
-#endif
+  return e;
 }
 
 /**
- * serial_dump_tags - Pack a TagList into a binary blob
- * @param[in]     tags TagList to pack
- * @param[in]     d    Binary blob to add to
- * @param[in,out] off  Offset into the blob
- * @retval ptr End of the newly packed binary
+ * serial_record_size - Get the size of a cache record
+ * @param d Start of the record
+ * @retval num Size of the record
+ *
+ * @note The record isn't checked.  Only use this on records that were created
+ *       in memory, e.g. Email.lazy_data, never on data read from the cache.
  */
-unsigned char *serial_dump_tags(const struct TagList *tags, unsigned char *d, int *off)
+size_t serial_record_size(const unsigned char *d)
 {
-  unsigned int counter = 0;
-  unsigned int start_off = *off;
-
-  d = serial_dump_int(0xdeadbeef, d, off);
+  struct HcRecordHeader hdr = { 0 };
+  memcpy(&hdr, d, sizeof(hdr));
+  return hdr.size;
+}
 
-  struct Tag *t = NULL;
-  STAILQ_FOREACH(t, tags, entries)
-  {
-    d = serial_dump_char(t->name, d, off, false);
-    counter++;
-  }
+/**
+ * serial_record_header - Read the fixed part of a cache record
+ * @param[in]  d    Start of the record
+ * @param[in]  dlen Length of the available data
+ * @param[out] hdr  Header of the record
+ * @retval true  Success
+ * @retval false The record is damaged, or was written in another format
+ */
+bool serial_record_header(const unsigned char *d, size_t dlen, struct HcRecordHeader *hdr)
+{
+  struct RecordReader rr = { 0 };
+  return rr_init(&rr, d, dlen, hdr);
+}
 
-  memcpy(d + start_off, &counter, sizeof(int));
+/**
+ * serial_record_str - Read a string field of a cache record
+ * @param d     Start of the record
+ * @param dlen  Length of the available data
+ * @param field String field, e.g. #HCR_SUBJECT
+ * @retval ptr  String, pointing into the record
+ * @retval NULL The field is absent
+ *
+ * @note The string is in utf-8; it hasn't been converted to $charset
+ */
+const char *serial_record_str(const unsigned char *d, size_t dlen, enum HcRecordField field)
+{
+  struct RecordReader rr = { 0 };
+  if (!rr_init(&rr, d, dlen, NULL))
+    return NULL;
 
-  return d;
+  return rr_str(&rr, rr_field(&rr, field));
 }
 
 /**
- * serial_restore_tags - Unpack a TagList from a binary blob
- * @param[in]     tags TagList to unpack
- * @param[in]     d    Binary blob to add to
- * @param[in,out] off  Offset into the blob
+ * serial_record_count - Count the entries of a list field of a cache record
+ * @param d     Start of the record
+ * @param dlen  Length of the available data
+ * @param field List field, e.g. #HCR_FROM or #HCR_REFERENCES
+ * @retval num Number of entries
  */
-void serial_restore_tags(struct TagList *tags, const unsigned char *d, int *off)
+size_t serial_record_count(const unsigned char *d, size_t dlen, enum HcRecordField field)
 {
-  unsigned int counter = 0;
-
-  serial_restore_int(&counter, d, off);
+  struct RecordReader rr = { 0 };
+  if (!rr_init(&rr, d, dlen, NULL))
+    return 0;
+
+  const uint32_t off = rr_field(&rr, field);
+  if (off == 0)
+    return 0;
+  return rr_u32(&rr, off);
+}
 
-  while (counter)
-  {
-    char *name = NULL;
-    serial_restore_char(&name, d, off, false);
-    driver_tags_add(tags, name);
-    counter--;
-  }
+/**
+ * serial_record_address - Read an Address from a cache record
+ * @param[in]  d        Start of the record
+ * @param[in]  dlen     Length of the available data
+ * @param[in]  field    AddressList field, e.g. #HCR_FROM
+ * @param[in]  idx      Index of the Address in the list
+ * @param[out] personal Personal name, pointing into the record, may be NULL
+ * @param[out] mailbox  Email address, pointing into the record, may be NULL
+ * @retval true  Success
+ * @retval false There's no such Address
+ *
+ * @note The strings are in utf-8; they haven't been converted to $charset
+ */
+bool serial_record_address(const unsigned char *d, size_t dlen, enum HcRecordField field,
+                           size_t idx, const char **personal, const char **mailbox)
+{
+  struct RecordReader rr = { 0 };
+  if (!rr_init(&rr, d, dlen, NULL))
+    return false;
+
+  const uint32_t off = rr_field(&rr, field);
+  if (idx >= rr_count(&rr, off, 3))
+    return false;
+
+  const size_t entry = off + sizeof(uint32_t) + (idx * 3 * sizeof(uint32_t));
+  if (personal)
+    *personal = rr_str(&rr, rr_u32(&rr, entry));
+  if (mailbox)
+    *mailbox = rr_str(&rr, rr_u32(&rr, entry + sizeof(uint32_t)));
+  return true;
 }
@@ -27,40 +27,128 @@
 #define MUTT_HCACHE_SERIALIZE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <sys/types.h>
 
-struct AddressList;
-struct Body;
-struct Buffer;
-struct Envelope;
-struct ListHead;
-struct ParameterList;
-struct TagList;
+struct Email;
+struct EmailArena;
 
-unsigned char *serial_dump_address  (const struct AddressList *al,   unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_body     (const struct Body *c,           unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_tags     (const struct TagList *tags,     unsigned char *d, int *off);
-unsigned char *serial_dump_buffer   (const struct Buffer *buf,       unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_char     (const char *c,                  unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_char_size(const char *c, ssize_t size,    unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_envelope (const struct Envelope *env,     unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_int      (const unsigned int i,           unsigned char *d, int *off);
-unsigned char *serial_dump_uint32_t (const uint32_t s,               unsigned char *d, int *off);
-unsigned char *serial_dump_parameter(const struct ParameterList *pl, unsigned char *d, int *off, bool convert);
-unsigned char *serial_dump_stailq   (const struct ListHead *l,       unsigned char *d, int *off, bool convert);
+/// Version of the cached Email record format.
+/// Bump this whenever the meaning of an existing field changes.
+#define HC_RECORD_VERSION 1
 
-void serial_restore_address  (struct AddressList *al,   const unsigned char *d, int *off, bool convert);
-void serial_restore_body     (struct Body *c,           const unsigned char *d, int *off, bool convert);
-void serial_restore_tags     (struct TagList *tags,     const unsigned char *d, int *off);
-void serial_restore_buffer   (struct Buffer *buf,       const unsigned char *d, int *off, bool convert);
-void serial_restore_char     (char **c,                 const unsigned char *d, int *off, bool convert);
-void serial_restore_envelope (struct Envelope *env,     const unsigned char *d, int *off, bool convert);
-void serial_restore_int      (unsigned int *i,          const unsigned char *d, int *off);
-void serial_restore_uint32_t (uint32_t *s,              const unsigned char *d, int *off);
-void serial_restore_parameter(struct ParameterList *pl, const unsigned char *d, int *off, bool convert);
-void serial_restore_stailq   (struct ListHead *l,       const unsigned char *d, int *off, bool convert);
+/**
+ * enum HcRecordField - Entries in the offset table of a cached Email
+ *
+ * New fields may only be added at the end.  Records written by an older
+ * version simply have fewer entries; missing entries read as absent.
+ */
+enum HcRecordField
+{
+  HCR_SUBJECT = 0,          ///< String: Envelope.subject
+  HCR_REAL_SUBJ,            ///< String: Envelope.real_subj, points into the subject
+  HCR_FROM,                 ///< AddressList: Envelope.from
+  HCR_TO,                   ///< AddressList: Envelope.to
+  HCR_CC,                   ///< AddressList: Envelope.cc
+  HCR_BCC,                  ///< AddressList: Envelope.bcc
+  HCR_SENDER,               ///< AddressList: Envelope.sender
+  HCR_REPLY_TO,             ///< AddressList: Envelope.reply_to
+  HCR_MAIL_FOLLOWUP_TO,     ///< AddressList: Envelope.mail_followup_to
+  HCR_RETURN_PATH,          ///< AddressList: Envelope.return_path
+  HCR_MESSAGE_ID,           ///< String: Envelope.message_id
+  HCR_SUPERSEDES,           ///< String: Envelope.supersedes
+  HCR_DATE,                 ///< String: Envelope.date
+  HCR_X_LABEL,              ///< String: Envelope.x_label
+  HCR_ORGANIZATION,         ///< String: Envelope.organization
+  HCR_SPAM,                 ///< String: Envelope.spam
+  HCR_LIST_POST,            ///< String: Envelope.list_post
+  HCR_LIST_SUBSCRIBE,       ///< String: Envelope.list_subscribe
+  HCR_LIST_UNSUBSCRIBE,     ///< String: Envelope.list_unsubscribe
+  HCR_REFERENCES,           ///< StringList: Envelope.references
+  HCR_IN_REPLY_TO,          ///< StringList: Envelope.in_reply_to
+  HCR_USERHDRS,             ///< StringList: Envelope.userhdrs
+  HCR_XREF,                 ///< String: Envelope.xref
+  HCR_FOLLOWUP_TO,          ///< String: Envelope.followup_to
+  HCR_X_COMMENT_TO,         ///< String: Envelope.x_comment_to
+  HCR_TAGS,                 ///< StringList: Email.tags
+  HCR_BODY,                 ///< HcRecordBody: Email.body
+  HCR_MAX,
+};
+
+typedef uint32_t HcRecordFlags;          ///< Flags for HcRecordHeader.flags, e.g. #HCR_F_READ
+#define HCR_F_NO_FLAGS               0   ///< No flags are set
+#define HCR_F_EXPIRED          (1 << 0)  ///< Email.expired
+#define HCR_F_FLAGGED          (1 << 1)  ///< Email.flagged
+#define HCR_F_MIME             (1 << 2)  ///< Email.mime
+#define HCR_F_OLD              (1 << 3)  ///< Email.old
+#define HCR_F_READ             (1 << 4)  ///< Email.read
+#define HCR_F_REPLIED          (1 << 5)  ///< Email.replied
+#define HCR_F_SUPERSEDED       (1 << 6)  ///< Email.superseded
+#define HCR_F_TRASH            (1 << 7)  ///< Email.trash
+#define HCR_F_ACTIVE           (1 << 8)  ///< Email.active
+#define HCR_F_DELETED          (1 << 9)  ///< Email.deleted
+#define HCR_F_PURGE            (1 << 10) ///< Email.purge
+#define HCR_F_ZOCCIDENT        (1 << 11) ///< Email.zoccident
+
+/**
+ * struct HcRecordHeader - Fixed part of a cached Email
+ *
+ * A record is laid out as:
+ * - HcRecordHeader
+ * - Offset table: `uint32_t[num_fields]`, indexed by #HcRecordField
+ * - Arena: the NUL-terminated strings and lists the table points at
+ *
+ * All offsets are relative to the start of the record; 0 means "absent".
+ * A list is a `uint32_t` count followed by its entries:
+ * - AddressList: `{ personal, mailbox, group }` (3 x `uint32_t`)
+ * - StringList:  `{ string }` (1 x `uint32_t`)
+ * - Parameters:  `{ attribute, value }` (2 x `uint32_t`)
+ *
+ * Integers are stored in host byte order; the cache isn't portable.
+ */
+struct HcRecordHeader
+{
+  uint16_t version;    ///< Format version, #HC_RECORD_VERSION
+  uint16_t num_fields; ///< Number of entries in the offset table
+  uint32_t size;       ///< Size of the whole record
+  HcRecordFlags flags; ///< Email flags, e.g. #HCR_F_READ
+  uint32_t security;   ///< Email.security
+  int64_t date_sent;   ///< Email.date_sent
+  int64_t received;    ///< Email.received
+  int64_t offset;      ///< Email.offset
+  int32_t lines;       ///< Email.lines
+  uint8_t zhours;      ///< Email.zhours
+  uint8_t zminutes;    ///< Email.zminutes
+  uint16_t pad;        ///< Unused, always 0
+};
+
+/**
+ * struct HcRecordBody - Cached Body, pointed at by #HCR_BODY
+ *
+ * The strings and the parameter list are offsets, like in the offset table.
+ */
+struct HcRecordBody
+{
+  uint32_t flags;       ///< type (4 bits), encoding (3), disposition (2), then booleans
+  uint32_t xtype;       ///< String: Body.xtype
+  uint32_t subtype;     ///< String: Body.subtype
+  uint32_t description; ///< String: Body.description
+  uint32_t form_name;   ///< String: Body.form_name
+  uint32_t filename;    ///< String: Body.filename
+  uint32_t d_filename;  ///< String: Body.d_filename
+  uint32_t parameter;   ///< Parameters: Body.parameter
+  int64_t offset;       ///< Body.offset
+  int64_t length;       ///< Body.length
+  int64_t hdr_offset;   ///< Body.hdr_offset
+};
+
+void *        serial_dump_email     (const struct Email *e, size_t hlen, size_t *dlen, bool convert);
+struct Email *serial_restore_email  (const unsigned char *d, size_t dlen, bool convert, bool lazy, struct EmailArena *ea);
 
-void lazy_realloc(void *ptr, size_t size);
+size_t        serial_record_size    (const unsigned char *d);
+bool          serial_record_header  (const unsigned char *d, size_t dlen, struct HcRecordHeader *hdr);
+const char *  serial_record_str     (const unsigned char *d, size_t dlen, enum HcRecordField field);
+size_t        serial_record_count   (const unsigned char *d, size_t dlen, enum HcRecordField field);
+bool          serial_record_address (const unsigned char *d, size_t dlen, enum HcRecordField field, size_t idx, const char **personal, const char **mailbox);
 
 #endif /* MUTT_HCACHE_SERIALIZE_H */
@@ -60,6 +60,17 @@
 #include "notmuch/lib.h"
 #endif
 
+/// Config handle for $from_chars
+static struct ConfigHandle HandleFromChars = CONFIG_HANDLE("from_chars");
+/// Config handle for $crypt_chars
+static struct ConfigHandle HandleCryptChars = CONFIG_HANDLE("crypt_chars");
+/// Config handle for $flag_chars
+static struct ConfigHandle HandleFlagChars = CONFIG_HANDLE("flag_chars");
+/// Config handle for $to_chars
+static struct ConfigHandle HandleToChars = CONFIG_HANDLE("to_chars");
+/// Config handle for $date_format
+static struct ConfigHandle HandleDateFormat = CONFIG_HANDLE("date_format");
+
 /**
  * struct HdrFormatInfo - Data passed to index_format_str()
  */
@@ -191,7 +202,7 @@ static const char *make_from_prefix(enum FieldType disp)
     [DISP_FROM] = "",  [DISP_PLAIN] = "",
   };
 
-  const struct MbTable *c_from_chars = cs_subset_mbtable(NeoMutt->sub, "from_chars");
+  const struct MbTable *c_from_chars = ch_mbtable(NeoMutt->sub, &HandleFromChars);
 
   if (!c_from_chars || !c_from_chars->chars || (c_from_chars->len == 0))
     return long_prefixes[disp];
@@ -473,10 +484,10 @@ static const char *index_format_str(char *buf, size_t buflen, size_t col, int co
   const struct Address *to = TAILQ_FIRST(&e->env->to);
   const struct Address *cc = TAILQ_FIRST(&e->env->cc);
 
-  const struct MbTable *c_crypt_chars = cs_subset_mbtable(NeoMutt->sub, "crypt_chars");
-  const struct MbTable *c_flag_chars = cs_subset_mbtable(NeoMutt->sub, "flag_chars");
-  const struct MbTable *c_to_chars = cs_subset_mbtable(NeoMutt->sub, "to_chars");
-  const char *const c_date_format = cs_subset_string(NeoMutt->sub, "date_format");
+  const struct MbTable *c_crypt_chars = ch_mbtable(NeoMutt->sub, &HandleCryptChars);
+  const struct MbTable *c_flag_chars = ch_mbtable(NeoMutt->sub, &HandleFlagChars);
+  const struct MbTable *c_to_chars = ch_mbtable(NeoMutt->sub, &HandleToChars);
+  const char *const c_date_format = ch_string(NeoMutt->sub, &HandleDateFormat);
 
   buf[0] = '\0';
   switch (op)
@@ -1192,6 +1203,7 @@ static const char *index_format_str(char *buf, size_t buflen, size_t col, int co
       break;
 
     case 'W':
+      email_materialize(e);
       if (!optional)
       {
         mutt_format_s(buf, buflen, prec, e->env->organization ? e->env->organization : "");
@@ -1204,6 +1216,7 @@ static const char *index_format_str(char *buf, size_t buflen, size_t col, int co
 
 #ifdef USE_NNTP
     case 'x':
+      email_materialize(e);
       if (!optional)
       {
         mutt_format_s(buf, buflen, prec, e->env->x_comment_to ? e->env->x_comment_to : "");
@@ -53,7 +53,7 @@ void imap_adata_free(void **ptr)
   {
     if (adata->conn->close)
       adata->conn->close(adata->conn);
-    FREE(&adata->conn);
+    mutt_socket_free(&adata->conn);
   }
 
   FREE(ptr);
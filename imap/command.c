@@ -1143,42 +1143,30 @@ int imap_cmd_step(struct ImapAccountData *adata)
     return IMAP_RES_BAD;
   }
 
-  /* read into buffer, expanding buffer as necessary until we have a full
-   * line */
-  do
+  const char *line = mutt_socket_readln_borrow(adata->conn, &len, MUTT_SOCK_LOG_FULL);
+  if (!line)
   {
-    if (len == adata->blen)
-    {
-      mutt_mem_realloc(&adata->buf, adata->blen + IMAP_CMD_BUFSIZE);
-      adata->blen = adata->blen + IMAP_CMD_BUFSIZE;
-      mutt_debug(LL_DEBUG3, "grew buffer to %lu bytes\n", adata->blen);
-    }
-
-    /* back up over '\0' */
-    if (len)
-      len--;
-    c = mutt_socket_readln_d(adata->buf + len, adata->blen - len, adata->conn, MUTT_SOCK_LOG_FULL);
-    if (c <= 0)
-    {
-      mutt_debug(LL_DEBUG1, "Error reading server response\n");
-      cmd_handle_fatal(adata);
-      return IMAP_RES_BAD;
-    }
-
-    len += c;
+    mutt_debug(LL_DEBUG1, "Error reading server response\n");
+    cmd_handle_fatal(adata);
+    return IMAP_RES_BAD;
   }
-  /* if we've read all the way to the end of the buffer, we haven't read a
-   * full line (mutt_socket_readln strips the \r, so we always have at least
-   * one character free when we've read a full line) */
-  while (len == adata->blen);
 
+  /* the line is only borrowed from the connection, so copy it, expanding the
+   * buffer as necessary */
+  if (len >= adata->blen)
+  {
+    adata->blen = ((len / IMAP_CMD_BUFSIZE) + 1) * IMAP_CMD_BUFSIZE;
+    mutt_mem_realloc(&adata->buf, adata->blen);
+    mutt_debug(LL_DEBUG3, "grew buffer to %lu bytes\n", adata->blen);
+  }
   /* don't let one large string make cmd->buf hog memory forever */
-  if ((adata->blen > IMAP_CMD_BUFSIZE) && (len <= IMAP_CMD_BUFSIZE))
+  else if ((adata->blen > IMAP_CMD_BUFSIZE) && (len < IMAP_CMD_BUFSIZE))
   {
     mutt_mem_realloc(&adata->buf, IMAP_CMD_BUFSIZE);
     adata->blen = IMAP_CMD_BUFSIZE;
     mutt_debug(LL_DEBUG3, "shrank buffer to %lu bytes\n", adata->blen);
   }
+  memcpy(adata->buf, line, len + 1);
 
   adata->lastread = mutt_date_now();
 
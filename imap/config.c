@@ -83,6 +83,9 @@ static struct ConfigDef ImapVars[] = {
   { "imap_fetch_chunk_size", DT_LONG|DT_NOT_NEGATIVE, 0, 0, NULL,
     "(imap) Download headers in blocks of this size"
   },
+  { "imap_fetch_connections", DT_NUMBER|DT_NOT_NEGATIVE, 0, 0, NULL,
+    "(imap) Number of extra connections used to download headers"
+  },
   { "imap_headers", DT_STRING|R_INDEX, 0, 0, NULL,
     "(imap) Additional email headers to download when getting index"
   },
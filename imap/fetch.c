@@ -0,0 +1,296 @@
+/**
+ * @file
+ * Share out the headers to download between connections
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page imap_fetch Share out the headers to download between connections
+ *
+ * When a Mailbox is first opened, the headers that aren't in the header cache
+ * may be downloaded over several connections at once, see
+ * `$imap_fetch_connections`.  These functions decide how many connections are
+ * worth using, which messages each of them downloads, and whether an extra
+ * connection sees the same messages as the Mailbox's connection.
+ *
+ * Any headers that the extra connections don't download are left as holes in
+ * the MSN table, for imap_fetch_msn_seqset() to find.
+ */
+
+#include "config.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stdbool.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "fetch.h"
+#include "adata.h"
+#include "mdata.h"
+#include "msn.h"
+
+/**
+ * msn_is_wanted - Does a message's header need downloading?
+ * @param msn    MSN table
+ * @param evalhc If true, the header cache has been checked
+ * @param num    Message Sequence Number
+ * @retval true The header isn't in the cache
+ */
+static bool msn_is_wanted(const struct MSNArray *msn, bool evalhc, unsigned int num)
+{
+  return !evalhc || !imap_msn_get(msn, num - 1);
+}
+
+/**
+ * imap_fetch_count - Count the headers that need downloading
+ * @param msn       MSN table
+ * @param evalhc    If true, the header cache has been checked
+ * @param msn_begin First Message Sequence Number
+ * @param msn_end   Last Message Sequence Number
+ * @retval num Number of headers that aren't in the header cache
+ */
+unsigned int imap_fetch_count(const struct MSNArray *msn, bool evalhc,
+                              unsigned int msn_begin, unsigned int msn_end)
+{
+  if (!msn || (msn_begin == 0) || (msn_end < msn_begin))
+    return 0;
+
+  if (!evalhc)
+    return msn_end - msn_begin + 1;
+
+  unsigned int count = 0;
+  for (unsigned int num = msn_begin; num <= msn_end; num++)
+  {
+    if (msn_is_wanted(msn, evalhc, num))
+      count++;
+  }
+  return count;
+}
+
+/**
+ * imap_fetch_conns - How many extra connections are worth opening?
+ * @param count     Number of headers that need downloading
+ * @param max_conns Most extra connections allowed, `$imap_fetch_connections`
+ * @retval num Number of extra connections
+ *
+ * Every connection, including the Mailbox's own, should have at least
+ * #IMAP_FETCH_CONN_MIN headers to download.
+ */
+unsigned int imap_fetch_conns(unsigned int count, int max_conns)
+{
+  if ((max_conns <= 0) || (count < (2 * IMAP_FETCH_CONN_MIN)))
+    return 0;
+
+  return MIN((unsigned int) max_conns, (count / IMAP_FETCH_CONN_MIN) - 1);
+}
+
+/**
+ * imap_fetch_partition - Share out the headers between the connections
+ * @param msn         MSN table
+ * @param evalhc      If true, the header cache has been checked
+ * @param msn_begin   First Message Sequence Number
+ * @param msn_end     Last Message Sequence Number
+ * @param streams     Connections, the MSN range of each is set
+ * @param num_streams Number of connections
+ * @retval num Number of connections with some headers to download
+ *
+ * Only the headers that aren't in the header cache are counted, so each
+ * connection gets the same number of them to download, give or take one.
+ * A connection with nothing to do gets an empty range, msn_begin > msn_end.
+ */
+unsigned int imap_fetch_partition(const struct MSNArray *msn, bool evalhc,
+                                  unsigned int msn_begin, unsigned int msn_end,
+                                  struct FetchStream *streams, unsigned int num_streams)
+{
+  if (!streams)
+    return 0;
+
+  for (unsigned int i = 0; i < num_streams; i++)
+  {
+    streams[i].msn_begin = msn_end + 1;
+    streams[i].msn_end = msn_end;
+  }
+
+  const unsigned int count = imap_fetch_count(msn, evalhc, msn_begin, msn_end);
+  if ((count == 0) || (num_streams == 0))
+    return 0;
+
+  const unsigned int share = count / num_streams;
+  const unsigned int extra = count % num_streams;
+
+  unsigned int i = 0;
+  unsigned int seen = 0;
+  unsigned int want = share + ((extra > 0) ? 1 : 0);
+  for (unsigned int num = msn_begin; (num <= msn_end) && (i < num_streams); num++)
+  {
+    if (!msn_is_wanted(msn, evalhc, num))
+      continue;
+
+    if (seen == 0)
+      streams[i].msn_begin = num;
+
+    if (++seen < want)
+      continue;
+
+    streams[i].msn_end = num;
+    i++;
+    seen = 0;
+    want = share + ((i < extra) ? 1 : 0);
+  }
+
+  return i;
+}
+
+/**
+ * imap_fetch_examine_parse - Parse a response to an extra connection's EXAMINE
+ * @param fe Mailbox, as seen by the connection
+ * @param s  Untagged response, e.g. "* 42 EXISTS"
+ */
+void imap_fetch_examine_parse(struct FetchExamine *fe, const char *s)
+{
+  if (!fe || !mutt_str_startswith(s, "* "))
+    return;
+
+  s += 2;
+  size_t len = mutt_istr_startswith(s, "OK [UIDVALIDITY ");
+  if (len > 0)
+  {
+    mutt_str_atoui(s + len, &fe->uidvalidity);
+    return;
+  }
+
+  if (!isdigit((unsigned char) *s))
+    return;
+
+  unsigned int num = 0;
+  const char *end = mutt_str_atoui(s, &num);
+  if (end && mutt_istr_startswith(end, " EXISTS"))
+    fe->exists = num;
+}
+
+/**
+ * imap_fetch_examine_check - Can an extra connection be used?
+ * @param fe      Mailbox, as seen by the connection
+ * @param mdata   Mailbox, as seen by the Mailbox's connection
+ * @param msn_end Last MSN that will be downloaded
+ * @retval true The connections agree on the messages' numbers
+ */
+bool imap_fetch_examine_check(const struct FetchExamine *fe,
+                              const struct ImapMboxData *mdata, unsigned int msn_end)
+{
+  if (!fe || !mdata)
+    return false;
+
+  return (fe->uidvalidity != 0) && (fe->uidvalidity == mdata->uidvalidity) &&
+         (fe->exists >= msn_end);
+}
+
+/**
+ * imap_fetch_msn_seqset - Generate a sequence set
+ * @param[in]  buf           Buffer for the result
+ * @param[in]  adata         Imap Account data
+ * @param[in]  evalhc        If true, check the Header Cache
+ * @param[in]  msn_begin     First Message Sequence Number
+ * @param[in]  msn_end       Last Message Sequence Number
+ * @param[out] fetch_msn_end Highest Message Sequence Number fetched
+ * @retval num MSN count
+ *
+ * Generates a more complicated sequence set after using the header cache,
+ * in case there are missing MSNs in the middle.
+ *
+ * This can happen if during a sync/close, messages are deleted from
+ * the cache, but the server doesn't get the updates (via a dropped
+ * network connection, or just plain refusing the updates).
+ */
+unsigned int imap_fetch_msn_seqset(struct Buffer *buf, struct ImapAccountData *adata,
+                                   bool evalhc, unsigned int msn_begin,
+                                   unsigned int msn_end, unsigned int *fetch_msn_end)
+{
+  struct ImapMboxData *mdata = adata->mailbox->mdata;
+  unsigned int max_headers_per_fetch = UINT_MAX;
+  bool first_chunk = true;
+  int state = 0; /* 1: single msn, 2: range of msn */
+  unsigned int msn;
+  unsigned int range_begin = 0;
+  unsigned int range_end = 0;
+  unsigned int msn_count = 0;
+
+  buf_reset(buf);
+  if (msn_end < msn_begin)
+    return 0;
+
+  const long c_imap_fetch_chunk_size = cs_subset_long(NeoMutt->sub, "imap_fetch_chunk_size");
+  if (c_imap_fetch_chunk_size > 0)
+    max_headers_per_fetch = c_imap_fetch_chunk_size;
+
+  if (!evalhc)
+  {
+    if ((msn_end - msn_begin + 1) <= max_headers_per_fetch)
+      *fetch_msn_end = msn_end;
+    else
+      *fetch_msn_end = msn_begin + max_headers_per_fetch - 1;
+    buf_printf(buf, "%u:%u", msn_begin, *fetch_msn_end);
+    return (*fetch_msn_end - msn_begin + 1);
+  }
+
+  for (msn = msn_begin; msn <= (msn_end + 1); msn++)
+  {
+    if ((msn_count < max_headers_per_fetch) && (msn <= msn_end) &&
+        !imap_msn_get(&mdata->msn, msn - 1))
+    {
+      msn_count++;
+
+      switch (state)
+      {
+        case 1: /* single: convert to a range */
+          state = 2;
+        /* fallthrough */
+        case 2: /* extend range ending */
+          range_end = msn;
+          break;
+        default:
+          state = 1;
+          range_begin = msn;
+          break;
+      }
+    }
+    else if (state)
+    {
+      if (first_chunk)
+        first_chunk = false;
+      else
+        buf_addch(buf, ',');
+
+      if (state == 1)
+        buf_add_printf(buf, "%u", range_begin);
+      else if (state == 2)
+        buf_add_printf(buf, "%u:%u", range_begin, range_end);
+      state = 0;
+
+      if ((buf_len(buf) > 500) || (msn_count >= max_headers_per_fetch))
+        break;
+    }
+  }
+
+  /* The loop index goes one past to terminate the range if needed. */
+  *fetch_msn_end = msn - 1;
+
+  return msn_count;
+}
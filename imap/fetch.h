@@ -0,0 +1,68 @@
+/**
+ * @file
+ * Share out the headers to download between connections
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_IMAP_FETCH_H
+#define MUTT_IMAP_FETCH_H
+
+#include <stdbool.h>
+
+struct Buffer;
+struct ImapAccountData;
+struct ImapMboxData;
+struct MSNArray;
+
+/// Minimum number of headers worth downloading over an extra connection
+#define IMAP_FETCH_CONN_MIN 1000
+
+/**
+ * struct FetchStream - Headers being downloaded over one connection
+ *
+ * When `$imap_fetch_connections` is set, the range of new messages is shared
+ * out between the Mailbox's connection and some extra ones.
+ */
+struct FetchStream
+{
+  struct ImapAccountData *adata; ///< Connection to the server
+  unsigned int msn_begin;        ///< First MSN not yet requested
+  unsigned int msn_end;          ///< Last MSN of this connection's share
+  unsigned int fetch_msn_end;    ///< Last MSN of the FETCH in progress
+  bool busy;                     ///< A FETCH is in progress
+  bool done;                     ///< All the headers have been downloaded, or the connection failed
+};
+
+/**
+ * struct FetchExamine - The Mailbox, as seen by an extra connection
+ */
+struct FetchExamine
+{
+  unsigned int uidvalidity; ///< UIDVALIDITY of the Mailbox, 0 if unknown
+  unsigned int exists;      ///< Number of messages in the Mailbox
+};
+
+unsigned int imap_fetch_conns        (unsigned int count, int max_conns);
+unsigned int imap_fetch_count        (const struct MSNArray *msn, bool evalhc, unsigned int msn_begin, unsigned int msn_end);
+bool         imap_fetch_examine_check(const struct FetchExamine *fe, const struct ImapMboxData *mdata, unsigned int msn_end);
+void         imap_fetch_examine_parse(struct FetchExamine *fe, const char *s);
+unsigned int imap_fetch_msn_seqset   (struct Buffer *buf, struct ImapAccountData *adata, bool evalhc, unsigned int msn_begin, unsigned int msn_end, unsigned int *fetch_msn_end);
+unsigned int imap_fetch_partition    (const struct MSNArray *msn, bool evalhc, unsigned int msn_begin, unsigned int msn_end, struct FetchStream *streams, unsigned int num_streams);
+
+#endif /* MUTT_IMAP_FETCH_H */
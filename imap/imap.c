@@ -565,23 +565,34 @@ void imap_logout_all(void)
 }
 
 /**
- * imap_read_literal - Read bytes bytes from server into file
- * @param fp       File handle for email file
+ * literal_write - Save part of a literal
+ * @param fp   File to write to (or NULL)
+ * @param out  Buffer to append to (or NULL)
+ * @param data Text to save
+ * @param len  Length of the text
+ */
+static void literal_write(FILE *fp, struct Buffer *out, const char *data, size_t len)
+{
+  if (fp)
+    fwrite(data, 1, len, fp);
+  else
+    buf_addstr_n(out, data, len);
+}
+
+/**
+ * read_literal - Read bytes bytes from server into a file or a Buffer
+ * @param fp       File handle for email file (or NULL)
+ * @param out      Buffer to append to (if fp is NULL)
  * @param adata    Imap Account data
  * @param bytes    Number of bytes to read
  * @param progress Progress bar
  * @retval  0 Success
  * @retval -1 Failure
- *
- * Not explicitly buffered, relies on FILE buffering.
- *
- * @note Strips `\r` from `\r\n`.
- *       Apparently even literals use `\r\n`-terminated strings ?!
  */
-int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
-                      unsigned long bytes, struct Progress *progress)
+static int read_literal(FILE *fp, struct Buffer *out, struct ImapAccountData *adata,
+                        unsigned long bytes, struct Progress *progress)
 {
-  char c;
+  char chunk[4096] = { 0 };
   bool r = false;
   struct Buffer buf = { 0 }; // Do not allocate, maybe it won't be used
 
@@ -591,9 +602,11 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
 
   mutt_debug(LL_DEBUG2, "reading %lu bytes\n", bytes);
 
-  for (unsigned long pos = 0; pos < bytes; pos++)
+  for (unsigned long pos = 0; pos < bytes;)
   {
-    if (mutt_socket_readchar(adata->conn, &c) != 1)
+    const int n = mutt_socket_read_buffered(adata->conn, chunk,
+                                            MIN(sizeof(chunk), bytes - pos));
+    if (n <= 0)
     {
       mutt_debug(LL_DEBUG1, "error during read, %lu bytes read\n", pos);
       adata->status = IMAP_FATAL;
@@ -601,26 +614,34 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
       buf_dealloc(&buf);
       return -1;
     }
+    pos += n;
 
-    if (r && (c != '\n'))
-      fputc('\r', fp);
-
-    if (c == '\r')
-    {
-      r = true;
-      continue;
-    }
-    else
+    const char *p = chunk;
+    const char *end = chunk + n;
+    while (p < end)
     {
+      if (r && (*p != '\n'))
+        literal_write(fp, out, "\r", 1);
+
+      if (*p == '\r')
+      {
+        r = true;
+        p++;
+        continue;
+      }
       r = false;
-    }
 
-    fputc(c, fp);
+      /* copy everything up to the next \r */
+      const char *cr = memchr(p, '\r', end - p);
+      const char *stop = cr ? cr : end;
+      literal_write(fp, out, p, stop - p);
+      if (c_debug_level >= IMAP_LOG_LTRL)
+        buf_addstr_n(&buf, p, stop - p);
+      p = stop;
+    }
 
-    if (progress && !(pos % 1024))
+    if (progress)
       progress_update(progress, pos, -1);
-    if (c_debug_level >= IMAP_LOG_LTRL)
-      buf_addch(&buf, c);
   }
 
   if (c_debug_level >= IMAP_LOG_LTRL)
@@ -631,6 +652,49 @@ int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
   return 0;
 }
 
+/**
+ * imap_read_literal - Read bytes bytes from server into file
+ * @param fp       File handle for email file
+ * @param adata    Imap Account data
+ * @param bytes    Number of bytes to read
+ * @param progress Progress bar
+ * @retval  0 Success
+ * @retval -1 Failure
+ *
+ * The data is read in blocks, from the Connection's buffer.
+ *
+ * @note Strips `\r` from `\r\n`.
+ *       Apparently even literals use `\r\n`-terminated strings ?!
+ */
+int imap_read_literal(FILE *fp, struct ImapAccountData *adata,
+                      unsigned long bytes, struct Progress *progress)
+{
+  if (!fp)
+    return -1;
+
+  return read_literal(fp, NULL, adata, bytes, progress);
+}
+
+/**
+ * imap_read_literal_buf - Read bytes bytes from server into a Buffer
+ * @param buf   Buffer to append to
+ * @param adata Imap Account data
+ * @param bytes Number of bytes to read
+ * @retval  0 Success
+ * @retval -1 Failure
+ *
+ * This is the in-memory equivalent of imap_read_literal(), for small
+ * literals, e.g. the headers of an Email.
+ */
+int imap_read_literal_buf(struct Buffer *buf, struct ImapAccountData *adata,
+                          unsigned long bytes)
+{
+  if (!buf)
+    return -1;
+
+  return read_literal(NULL, buf, adata, bytes, NULL);
+}
+
 /**
  * imap_notify_delete_email - Inform IMAP that an Email has been deleted
  * @param m Mailbox
@@ -1194,6 +1258,73 @@ int imap_mailbox_status(struct Mailbox *m, bool queue)
   return imap_status(adata, mdata, queue);
 }
 
+/**
+ * status_adata - Get the Account data, if its STATUS commands can be sent early
+ * @param a Account
+ * @retval ptr  IMAP Account data
+ * @retval NULL The Account is busy, or not connected
+ *
+ * Only Accounts without a selected Mailbox qualify.  Otherwise the queue is
+ * sent by the Mailbox's next NOOP or IDLE.
+ */
+static struct ImapAccountData *status_adata(struct Account *a)
+{
+  if (!a || (a->type != MUTT_IMAP))
+    return NULL;
+
+  struct ImapAccountData *adata = a->adata;
+  if (!adata || !adata->conn || adata->mailbox ||
+      (adata->state != IMAP_AUTHENTICATED) || (adata->status == IMAP_FATAL))
+  {
+    return NULL;
+  }
+
+  return adata;
+}
+
+/**
+ * imap_status_send - Send the queued STATUS commands
+ * @param a Account
+ * @retval true Replies are expected, see imap_status_poll()
+ *
+ * The STATUS commands queued by imap_mbox_check_stats() are sent together,
+ * without waiting for the replies.
+ */
+bool imap_status_send(struct Account *a)
+{
+  struct ImapAccountData *adata = status_adata(a);
+  if (!adata)
+    return false;
+
+  if (!buf_is_empty(&adata->cmdbuf) && (imap_cmd_start(adata, NULL) < 0))
+    return false;
+
+  return adata->nextcmd != adata->lastcmd;
+}
+
+/**
+ * imap_status_poll - Read any replies to the STATUS commands
+ * @param a Account
+ * @retval true Replies are still expected
+ *
+ * Only the replies that have already arrived are read, so this doesn't wait
+ * for the server.  Each STATUS reply updates its Mailbox.
+ */
+bool imap_status_poll(struct Account *a)
+{
+  struct ImapAccountData *adata = status_adata(a);
+  if (!adata)
+    return false;
+
+  while ((adata->nextcmd != adata->lastcmd) && (mutt_socket_poll(adata->conn, 0) > 0))
+  {
+    if (imap_cmd_step(adata) != IMAP_RES_CONTINUE)
+      break;
+  }
+
+  return (adata->status != IMAP_FATAL) && (adata->nextcmd != adata->lastcmd);
+}
+
 /**
  * imap_subscribe - Subscribe to a mailbox
  * @param path      Mailbox path
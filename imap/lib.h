@@ -43,6 +43,7 @@
  * | imap/command.c    | @subpage imap_command    |
  * | imap/config.c     | @subpage imap_config     |
  * | imap/edata.c      | @subpage imap_edata      |
+ * | imap/fetch.c      | @subpage imap_fetch      |
  * | imap/imap.c       | @subpage imap_imap       |
  * | imap/mdata.c      | @subpage imap_mdata      |
  * | imap/message.c    | @subpage imap_message    |
@@ -79,6 +80,8 @@ int imap_delete_mailbox(struct Mailbox *m, char *path);
 enum MxStatus imap_sync_mailbox(struct Mailbox *m, bool expunge, bool close);
 int imap_path_status(const char *path, bool queue);
 int imap_mailbox_status(struct Mailbox *m, bool queue);
+bool imap_status_poll(struct Account *a);
+bool imap_status_send(struct Account *a);
 int imap_subscribe(char *path, bool subscribe);
 int imap_complete(char *buf, size_t buflen, const char *path);
 int imap_fast_trash(struct Mailbox *m, const char *dest);
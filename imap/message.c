@@ -32,6 +32,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <limits.h>
+#include <poll.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -53,11 +54,13 @@
 #include "adata.h"
 #include "edata.h"
 #include "external.h"
+#include "fetch.h"
 #include "globals.h" // IWYU pragma: keep
 #include "mdata.h"
 #include "msg_set.h"
 #include "msn.h"
 #include "mutt_logging.h"
+#include "mutt_socket.h"
 #include "mx.h"
 #include "protos.h"
 #ifdef ENABLE_NLS
@@ -399,22 +402,21 @@ static int msg_parse_fetch(struct ImapHeader *h, char *s)
 
 /**
  * msg_fetch_header - Import IMAP FETCH response into an ImapHeader
- * @param m   Mailbox
- * @param ih  ImapHeader
- * @param buf Server string containing FETCH response
- * @param fp  Connection to server
+ * @param adata Imap Account data of the connection the response came from
+ * @param ih    ImapHeader
+ * @param buf   Server string containing FETCH response
+ * @param hdr   Buffer for the Email's headers (or NULL)
  * @retval  0 Success
  * @retval -1 String is not a fetch response
  * @retval -2 String is a corrupt fetch response
  *
  * Expects string beginning with * n FETCH.
  */
-static int msg_fetch_header(struct Mailbox *m, struct ImapHeader *ih, char *buf, FILE *fp)
+static int msg_fetch_header(struct ImapAccountData *adata, struct ImapHeader *ih,
+                            char *buf, struct Buffer *hdr)
 {
   int rc = -1; /* default now is that string isn't FETCH response */
 
-  struct ImapAccountData *adata = imap_adata_get(m);
-
   if (buf[0] != '*')
     return rc;
 
@@ -439,13 +441,13 @@ static int msg_fetch_header(struct Mailbox *m, struct ImapHeader *ih, char *buf,
   int parse_rc = msg_parse_fetch(ih, buf);
   if (parse_rc == 0)
     return 0;
-  if ((parse_rc != -2) || !fp)
+  if ((parse_rc != -2) || !hdr)
     return rc;
 
   unsigned int bytes = 0;
   if (imap_get_literal_count(buf, &bytes) == 0)
   {
-    imap_read_literal(fp, adata, bytes, NULL);
+    imap_read_literal_buf(hdr, adata, bytes);
 
     /* we may have other fields of the FETCH _after_ the literal
      * (eg Domino puts FLAGS here). Nothing wrong with that, either.
@@ -522,99 +524,6 @@ static void imap_alloc_uid_hash(struct ImapAccountData *adata, unsigned int msn_
     mdata->uid_hash = mutt_hash_int_new(MAX(6 * msn_count / 5, 30), MUTT_HASH_NO_FLAGS);
 }
 
-/**
- * imap_fetch_msn_seqset - Generate a sequence set
- * @param[in]  buf           Buffer for the result
- * @param[in]  adata         Imap Account data
- * @param[in]  evalhc        If true, check the Header Cache
- * @param[in]  msn_begin     First Message Sequence Number
- * @param[in]  msn_end       Last Message Sequence Number
- * @param[out] fetch_msn_end Highest Message Sequence Number fetched
- * @retval num MSN count
- *
- * Generates a more complicated sequence set after using the header cache,
- * in case there are missing MSNs in the middle.
- *
- * This can happen if during a sync/close, messages are deleted from
- * the cache, but the server doesn't get the updates (via a dropped
- * network connection, or just plain refusing the updates).
- */
-static unsigned int imap_fetch_msn_seqset(struct Buffer *buf, struct ImapAccountData *adata,
-                                          bool evalhc, unsigned int msn_begin,
-                                          unsigned int msn_end, unsigned int *fetch_msn_end)
-{
-  struct ImapMboxData *mdata = adata->mailbox->mdata;
-  unsigned int max_headers_per_fetch = UINT_MAX;
-  bool first_chunk = true;
-  int state = 0; /* 1: single msn, 2: range of msn */
-  unsigned int msn;
-  unsigned int range_begin = 0;
-  unsigned int range_end = 0;
-  unsigned int msn_count = 0;
-
-  buf_reset(buf);
-  if (msn_end < msn_begin)
-    return 0;
-
-  const long c_imap_fetch_chunk_size = cs_subset_long(NeoMutt->sub, "imap_fetch_chunk_size");
-  if (c_imap_fetch_chunk_size > 0)
-    max_headers_per_fetch = c_imap_fetch_chunk_size;
-
-  if (!evalhc)
-  {
-    if ((msn_end - msn_begin + 1) <= max_headers_per_fetch)
-      *fetch_msn_end = msn_end;
-    else
-      *fetch_msn_end = msn_begin + max_headers_per_fetch - 1;
-    buf_printf(buf, "%u:%u", msn_begin, *fetch_msn_end);
-    return (*fetch_msn_end - msn_begin + 1);
-  }
-
-  for (msn = msn_begin; msn <= (msn_end + 1); msn++)
-  {
-    if ((msn_count < max_headers_per_fetch) && (msn <= msn_end) &&
-        !imap_msn_get(&mdata->msn, msn - 1))
-    {
-      msn_count++;
-
-      switch (state)
-      {
-        case 1: /* single: convert to a range */
-          state = 2;
-        /* fallthrough */
-        case 2: /* extend range ending */
-          range_end = msn;
-          break;
-        default:
-          state = 1;
-          range_begin = msn;
-          break;
-      }
-    }
-    else if (state)
-    {
-      if (first_chunk)
-        first_chunk = false;
-      else
-        buf_addch(buf, ',');
-
-      if (state == 1)
-        buf_add_printf(buf, "%u", range_begin);
-      else if (state == 2)
-        buf_add_printf(buf, "%u:%u", range_begin, range_end);
-      state = 0;
-
-      if ((buf_len(buf) > 500) || (msn_count >= max_headers_per_fetch))
-        break;
-    }
-  }
-
-  /* The loop index goes one past to terminate the range if needed. */
-  *fetch_msn_end = msn - 1;
-
-  return msn_count;
-}
-
 /**
  * set_changed_flag - Have the flags of an email changed
  * @param[in]  m              Mailbox
@@ -715,7 +624,7 @@ static int read_headers_normal_eval_cache(struct ImapAccountData *adata,
       if (rc != IMAP_RES_CONTINUE)
         break;
 
-      mfhrc = msg_fetch_header(m, &h, adata->buf, NULL);
+      mfhrc = msg_fetch_header(adata, &h, adata->buf, NULL);
       if (mfhrc < 0)
         continue;
 
@@ -923,11 +832,16 @@ static int read_headers_condstore_qresync_updates(struct ImapAccountData *adata,
 
   imap_cmd_start(adata, buf);
 
+  hcache_begin_batch(mdata->hcache);
+
   int rc = IMAP_RES_CONTINUE;
   for (int msgno = 1; rc == IMAP_RES_CONTINUE; msgno++)
   {
     if (SigInt && query_abort_header_download(adata))
-      goto fail;
+    {
+      rc = -1;
+      break;
+    }
 
     if (m->verbose)
       progress_update(progress, msgno, -1);
@@ -958,6 +872,8 @@ static int read_headers_condstore_qresync_updates(struct ImapAccountData *adata,
     imap_hcache_put(mdata, imap_msn_get(&mdata->msn, header_msn - 1));
   }
 
+  hcache_commit_batch(mdata->hcache);
+
   if (rc != IMAP_RES_OK)
     goto fail;
 
@@ -1066,6 +982,378 @@ fail:
 
 #endif /* USE_HCACHE */
 
+/// Maximum number of responses to read from one connection before checking the others
+#define IMAP_FETCH_BATCH 64
+
+/**
+ * read_headers_add_email - Add an Email to the Mailbox from a FETCH response
+ * @param[in]  m      Imap Selected Mailbox
+ * @param[in]  h      Parsed FETCH response
+ * @param[in]  hdr    Email's headers
+ * @param[out] maxuid Highest UID seen
+ */
+static void read_headers_add_email(struct Mailbox *m, struct ImapHeader *h,
+                                   struct Buffer *hdr, unsigned int *maxuid)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+
+  struct Email *e = email_new_arena(mailbox_arena(m));
+  mx_alloc_memory(m, m->msg_count);
+
+  m->emails[m->msg_count++] = e;
+
+  imap_msn_set(&mdata->msn, h->edata->msn - 1, e);
+  mutt_hash_int_insert(mdata->uid_hash, h->edata->uid, e);
+
+  e->index = h->edata->uid;
+  /* messages which have not been expunged are ACTIVE (borrowed from mh
+   * folders) */
+  e->active = true;
+  e->changed = false;
+  e->read = h->edata->read;
+  e->old = h->edata->old;
+  e->deleted = h->edata->deleted;
+  e->flagged = h->edata->flagged;
+  e->replied = h->edata->replied;
+  e->received = h->received;
+  e->edata = (void *) imap_edata_clone(h->edata);
+  e->edata_free = imap_edata_free;
+  STAILQ_INIT(&e->tags);
+
+  /* We take a copy of the tags so we can split the string */
+  char *tags_copy = mutt_str_dup(h->edata->flags_remote);
+  driver_tags_replace(&e->tags, tags_copy);
+  FREE(&tags_copy);
+
+  if (*maxuid < h->edata->uid)
+    *maxuid = h->edata->uid;
+
+  /* NOTE: if Date: header is missing, mutt_rfc822_read_header_mem depends
+   *   on h->received being set */
+  e->env = mutt_rfc822_read_header_mem(buf_string(hdr), buf_len(hdr), e, false, false);
+  /* body built as a side-effect of mutt_rfc822_read_header_mem */
+  e->body->length = h->content_length;
+  mailbox_size_add(m, e);
+
+#ifdef USE_HCACHE
+  imap_hcache_put(mdata, e);
+#endif /* USE_HCACHE */
+}
+
+/**
+ * read_headers_fetch_response - Read one response to a FETCH of new headers
+ * @param[in]  m             Imap Selected Mailbox
+ * @param[in]  adata         Connection the FETCH was sent on
+ * @param[in]  fetch_msn_end Highest MSN requested by the FETCH
+ * @param[in]  edata         Imap Email data to parse the response into
+ * @param[in]  hdr           Buffer for the email's headers
+ * @param[out] maxuid        Highest UID seen
+ * @retval  1 An Email was added to the Mailbox
+ * @retval  0 The response was ignored
+ * @retval -1 The FETCH is complete
+ * @retval -2 Error
+ */
+static int read_headers_fetch_response(struct Mailbox *m, struct ImapAccountData *adata,
+                                       unsigned int fetch_msn_end, struct ImapEmailData *edata,
+                                       struct Buffer *hdr, unsigned int *maxuid)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  struct ImapHeader h = { 0 };
+
+  buf_reset(hdr);
+  h.edata = edata;
+
+  const int rc = imap_cmd_step(adata);
+  if (rc != IMAP_RES_CONTINUE)
+    return (rc == IMAP_RES_OK) ? -1 : -2;
+
+  switch (msg_fetch_header(adata, &h, adata->buf, hdr))
+  {
+    case 0:
+      break;
+    case -1:
+      return 0;
+    case -2:
+      return -2;
+  }
+
+  if (buf_is_empty(hdr))
+  {
+    mutt_debug(LL_DEBUG2, "ignoring fetch response with no body\n");
+    return 0;
+  }
+
+  if ((h.edata->msn < 1) || (h.edata->msn > fetch_msn_end))
+  {
+    mutt_debug(LL_DEBUG1, "skipping FETCH response for unknown message number %d\n",
+               h.edata->msn);
+    return 0;
+  }
+
+  /* May receive FLAGS updates in a separate untagged response */
+  if (imap_msn_get(&mdata->msn, h.edata->msn - 1))
+  {
+    mutt_debug(LL_DEBUG2, "skipping FETCH response for duplicate message %d\n",
+               h.edata->msn);
+    return 0;
+  }
+
+  read_headers_add_email(m, &h, hdr, maxuid);
+  return 1;
+}
+
+/**
+ * fetch_conn_open - Open an extra connection for downloading headers
+ * @param m       Imap Selected Mailbox
+ * @param msn_end Last MSN that will be downloaded
+ * @retval ptr  Connection, with the Mailbox examined
+ * @retval NULL Error
+ *
+ * The Mailbox is opened read-only, using EXAMINE.  The connection stays in
+ * the #IMAP_AUTHENTICATED state, so the responses about the Mailbox are left
+ * for the caller, rather than being applied to the Mailbox.
+ */
+static struct ImapAccountData *fetch_conn_open(struct Mailbox *m, unsigned int msn_end)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+
+  struct ImapAccountData *fdata = imap_adata_new(m->account);
+  fdata->conn = mutt_conn_new(&adata->conn->account);
+  if (!fdata->conn || (imap_login(fdata) < 0))
+    goto fail;
+
+  char buf[PATH_MAX] = { 0 };
+  snprintf(buf, sizeof(buf), "EXAMINE %s", mdata->munge_name);
+  if (imap_cmd_start(fdata, buf) < 0)
+    goto fail;
+
+  struct FetchExamine fe = { 0 };
+  int rc;
+  while ((rc = imap_cmd_step(fdata)) == IMAP_RES_CONTINUE)
+    imap_fetch_examine_parse(&fe, fdata->buf);
+
+  /* The connections must agree on the messages' numbers */
+  if ((rc != IMAP_RES_OK) || !imap_fetch_examine_check(&fe, mdata, msn_end))
+  {
+    mutt_debug(LL_DEBUG1, "Can't use extra connection: UIDVALIDITY %u/%u, EXISTS %u/%u\n",
+               fe.uidvalidity, mdata->uidvalidity, fe.exists, msn_end);
+    goto fail;
+  }
+
+  return fdata;
+
+fail:
+  imap_adata_free((void **) &fdata);
+  return NULL;
+}
+
+/**
+ * fetch_conn_close - Close an extra connection
+ * @param ptr Connection to close
+ */
+static void fetch_conn_close(struct ImapAccountData **ptr)
+{
+  struct ImapAccountData *fdata = *ptr;
+
+  /* Don't wait for the reply, we're not going to use the connection again */
+  if ((fdata->state != IMAP_DISCONNECTED) && (fdata->status != IMAP_FATAL))
+  {
+    fdata->status = IMAP_BYE;
+    imap_cmd_start(fdata, "LOGOUT");
+  }
+
+  imap_adata_free((void **) ptr);
+}
+
+/**
+ * read_headers_fetch_parallel - Retrieve new messages over several connections
+ * @param[in]  m         Imap Selected Mailbox
+ * @param[in]  msn_begin First Message Sequence number
+ * @param[in]  msn_end   Last Message Sequence number
+ * @param[in]  evalhc    If true, check the Header Cache
+ * @param[in]  hdrreq    Headers to request, e.g. "BODY.PEEK[HEADER.FIELDS (...)]"
+ * @param[in]  hdr       Buffer for the headers
+ * @param[in]  progress  Progress bar, may be NULL
+ * @param[out] maxuid    Highest UID seen
+ * @retval num Number of extra connections used
+ * @retval  -1 Error
+ *
+ * Open up to `$imap_fetch_connections` extra connections, share out the
+ * headers that aren't in the header cache between them and the Mailbox's
+ * connection and download the headers over all of them at once.  If there are
+ * too few headers, no extra connections are opened.  The Emails are created, and stored in the header cache,
+ * by the caller's connection as the responses arrive.
+ *
+ * If an extra connection fails, its remaining headers are left for the caller
+ * to download.  Like the rest of the code, this assumes that the MSNs don't
+ * change while the headers are downloaded.
+ */
+static int read_headers_fetch_parallel(struct Mailbox *m, unsigned int msn_begin,
+                                       unsigned int msn_end, bool evalhc,
+                                       const char *hdrreq, struct Buffer *hdr,
+                                       struct Progress *progress, unsigned int *maxuid)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+
+  /* Only the headers that aren't in the header cache are shared out */
+  const short c_imap_fetch_connections = cs_subset_number(NeoMutt->sub, "imap_fetch_connections");
+  const unsigned int count = imap_fetch_count(&mdata->msn, evalhc, msn_begin, msn_end);
+  const unsigned int max_conns = imap_fetch_conns(count, c_imap_fetch_connections);
+  if (max_conns == 0)
+    return 0;
+
+  struct FetchStream *streams = mutt_mem_calloc(max_conns + 1, sizeof(struct FetchStream));
+  struct pollfd *pfds = mutt_mem_calloc(max_conns + 1, sizeof(struct pollfd));
+
+  streams[0].adata = adata;
+  unsigned int num_streams = 1;
+  for (unsigned int i = 0; i < max_conns; i++)
+  {
+    struct ImapAccountData *fdata = fetch_conn_open(m, msn_end);
+    if (!fdata)
+      break;
+    streams[num_streams++].adata = fdata;
+  }
+
+  if (num_streams == 1)
+  {
+    FREE(&pfds);
+    FREE(&streams);
+    return 0;
+  }
+
+  mutt_debug(LL_DEBUG2, "Fetching %u headers from %u:%u over %u connections\n",
+             count, msn_begin, msn_end, num_streams);
+
+  imap_fetch_partition(&mdata->msn, evalhc, msn_begin, msn_end, streams, num_streams);
+
+  int rc = -1;
+  int msgno = msn_begin;
+  unsigned int num_active = num_streams;
+  struct Buffer *buf = buf_pool_get();
+  struct ImapEmailData *edata = imap_edata_new();
+
+  while (num_active > 0)
+  {
+    if (SigInt && query_abort_header_download(adata))
+      goto done;
+
+    /* Request the next chunk of headers on each idle connection */
+    for (unsigned int i = 0; i < num_streams; i++)
+    {
+      struct FetchStream *fs = &streams[i];
+      if (fs->done || fs->busy)
+        continue;
+
+      if ((fs->msn_begin > fs->msn_end) ||
+          !imap_fetch_msn_seqset(buf, adata, evalhc, fs->msn_begin, fs->msn_end,
+                                 &fs->fetch_msn_end))
+      {
+        fs->done = true;
+        num_active--;
+        continue;
+      }
+
+      char *cmd = NULL;
+      mutt_str_asprintf(&cmd, "FETCH %s (UID FLAGS INTERNALDATE RFC822.SIZE %s)",
+                        buf_string(buf), hdrreq);
+      const int rc_start = imap_cmd_start(fs->adata, cmd);
+      FREE(&cmd);
+      if (rc_start < 0)
+      {
+        if (i == 0)
+          goto done;
+        mutt_debug(LL_DEBUG1, "Extra connection %u failed\n", i);
+        fs->done = true;
+        num_active--;
+        continue;
+      }
+      fs->busy = true;
+    }
+
+    /* Read the responses from any connection that has some waiting */
+    int num_fds = 0;
+    for (unsigned int i = 0; i < num_streams; i++)
+    {
+      struct FetchStream *fs = &streams[i];
+      if (!fs->busy)
+        continue;
+
+      if (mutt_socket_poll(fs->adata->conn, 0) <= 0)
+      {
+        pfds[num_fds].fd = fs->adata->conn->fd;
+        pfds[num_fds].events = POLLIN;
+        num_fds++;
+        continue;
+      }
+
+      for (int j = 0; j < IMAP_FETCH_BATCH; j++)
+      {
+        const int rc_resp = read_headers_fetch_response(m, fs->adata, fs->fetch_msn_end,
+                                                        edata, hdr, maxuid);
+        if (rc_resp == -2)
+        {
+          if (i == 0)
+            goto done;
+          mutt_debug(LL_DEBUG1, "Extra connection %u failed\n", i);
+          fs->busy = false;
+          fs->done = true;
+          num_active--;
+          break;
+        }
+
+        if (rc_resp == -1)
+        {
+          fs->busy = false;
+          fs->msn_begin = fs->fetch_msn_end + 1;
+          break;
+        }
+
+        if ((rc_resp == 1) && m->verbose)
+          progress_update(progress, msgno++, -1);
+
+        if (mutt_socket_poll(fs->adata->conn, 0) <= 0)
+          break;
+      }
+    }
+
+    /* Every connection is waiting for the server */
+    if ((num_fds > 0) && (num_fds == (int) num_active))
+      poll(pfds, num_fds, 1000);
+  }
+
+  rc = num_streams - 1;
+
+done:
+  for (unsigned int i = 1; i < num_streams; i++)
+    fetch_conn_close(&streams[i].adata);
+  imap_edata_free((void **) &edata);
+  buf_pool_release(&buf);
+  FREE(&pfds);
+  FREE(&streams);
+  return rc;
+}
+
+/**
+ * read_headers_new_mail - Make room for mail that arrived during the download
+ * @param[in]     m       Imap Selected Mailbox
+ * @param[in,out] msn_end Last Message Sequence number to download
+ */
+static void read_headers_new_mail(struct Mailbox *m, unsigned int *msn_end)
+{
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  if (!(mdata->reopen & IMAP_NEWMAIL_PENDING))
+    return;
+
+  *msn_end = mdata->new_mail_count;
+  mx_alloc_memory(m, *msn_end);
+  imap_msn_reserve(&mdata->msn, *msn_end);
+  mdata->reopen &= ~IMAP_NEWMAIL_PENDING;
+  mdata->new_mail_count = 0;
+}
+
 /**
  * read_headers_fetch_new - Retrieve new messages from the server
  * @param[in]  m                Imap Selected Mailbox
@@ -1085,10 +1373,9 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
   unsigned int fetch_msn_end = 0;
   struct Progress *progress = NULL;
   char *hdrreq = NULL;
-  struct Buffer *tempfile = NULL;
-  FILE *fp = NULL;
-  struct ImapHeader h;
+  struct Buffer *hdr = NULL;
   struct Buffer *buf = NULL;
+  struct ImapEmailData *edata = NULL;
   static const char *const want_headers = "DATE FROM SENDER SUBJECT TO CC MESSAGE-ID REFERENCES "
                                           "CONTENT-TYPE CONTENT-DESCRIPTION IN-REPLY-TO REPLY-TO "
                                           "LINES LIST-POST LIST-SUBSCRIBE LIST-UNSUBSCRIBE X-LABEL "
@@ -1100,6 +1387,11 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
   if (!adata || (adata->mailbox != m))
     return -1;
 
+#ifdef USE_HCACHE
+  /* Group the new headers into as few hcache writes as possible */
+  hcache_begin_batch(mdata->hcache);
+#endif /* USE_HCACHE */
+
   struct Buffer *hdr_list = buf_pool_get();
   buf_strcpy(hdr_list, want_headers);
   const char *const c_imap_headers = cs_subset_string(NeoMutt->sub, "imap_headers");
@@ -1135,22 +1427,28 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
 
   /* instead of downloading all headers and then parsing them, we parse them
    * as they come in. */
-  tempfile = buf_pool_get();
-  buf_mktemp(tempfile);
-  fp = mutt_file_fopen(buf_string(tempfile), "w+");
-  if (!fp)
-  {
-    mutt_error(_("Could not create temporary file %s"), buf_string(tempfile));
-    goto bail;
-  }
-  unlink(buf_string(tempfile));
-  buf_pool_release(&tempfile);
+  hdr = buf_pool_get();
 
   if (m->verbose)
   {
     progress = progress_new(_("Fetching message headers..."), MUTT_PROGRESS_READ, msn_end);
   }
 
+  /* Download as much as possible over several connections at once.
+   * Anything that was missed is fetched below. */
+  if (initial_download)
+  {
+    const int rc_par = read_headers_fetch_parallel(m, msn_begin, msn_end, evalhc,
+                                                   hdrreq, hdr, progress, maxuid);
+    if (rc_par < 0)
+      goto bail;
+    if (rc_par > 0)
+    {
+      evalhc = true;
+      read_headers_new_mail(m, &msn_end);
+    }
+  }
+
   buf = buf_pool_get();
 
   /* NOTE:
@@ -1163,7 +1461,7 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
    *   at the end of the loop makes the comparison unneeded, but to be
    *   cautious I'm keeping it.
    */
-  struct ImapEmailData *edata = imap_edata_new();
+  edata = imap_edata_new();
   while ((fetch_msn_end < msn_end) &&
          imap_fetch_msn_seqset(buf, adata, evalhc, msn_begin, msn_end, &fetch_msn_end))
   {
@@ -1177,117 +1475,26 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
 
     while (true)
     {
-      rewind(fp);
-      memset(&h, 0, sizeof(h));
-      h.edata = edata;
-
       if (initial_download && SigInt && query_abort_header_download(adata))
       {
         goto bail;
       }
 
-      const int rc2 = imap_cmd_step(adata);
-      if (rc2 != IMAP_RES_CONTINUE)
-      {
-        if (rc2 != IMAP_RES_OK)
-        {
-          goto bail;
-        }
+      const int rc2 = read_headers_fetch_response(m, adata, fetch_msn_end,
+                                                  edata, hdr, maxuid);
+      if (rc2 == -2)
+        goto bail;
+      if (rc2 == -1)
         break;
-      }
 
-      switch (msg_fetch_header(m, &h, adata->buf, fp))
-      {
-        case 0:
-          break;
-        case -1:
-          continue;
-        case -2:
-          goto bail;
-      }
-
-      if (!ftello(fp))
-      {
-        mutt_debug(LL_DEBUG2, "ignoring fetch response with no body\n");
-        continue;
-      }
-
-      /* make sure we don't get remnants from older larger message headers */
-      fputs("\n\n", fp);
-
-      if ((h.edata->msn < 1) || (h.edata->msn > fetch_msn_end))
-      {
-        mutt_debug(LL_DEBUG1, "skipping FETCH response for unknown message number %d\n",
-                   h.edata->msn);
-        continue;
-      }
-
-      /* May receive FLAGS updates in a separate untagged response */
-      if (imap_msn_get(&mdata->msn, h.edata->msn - 1))
-      {
-        mutt_debug(LL_DEBUG2, "skipping FETCH response for duplicate message %d\n",
-                   h.edata->msn);
-        continue;
-      }
-
-      if (m->verbose)
+      if ((rc2 == 1) && m->verbose)
       {
         progress_update(progress, msgno++, -1);
       }
-
-      struct Email *e = email_new();
-      mx_alloc_memory(m, m->msg_count);
-
-      m->emails[m->msg_count++] = e;
-
-      imap_msn_set(&mdata->msn, h.edata->msn - 1, e);
-      mutt_hash_int_insert(mdata->uid_hash, h.edata->uid, e);
-
-      e->index = h.edata->uid;
-      /* messages which have not been expunged are ACTIVE (borrowed from mh
-       * folders) */
-      e->active = true;
-      e->changed = false;
-      e->read = h.edata->read;
-      e->old = h.edata->old;
-      e->deleted = h.edata->deleted;
-      e->flagged = h.edata->flagged;
-      e->replied = h.edata->replied;
-      e->received = h.received;
-      e->edata = (void *) imap_edata_clone(h.edata);
-      e->edata_free = imap_edata_free;
-      STAILQ_INIT(&e->tags);
-
-      /* We take a copy of the tags so we can split the string */
-      char *tags_copy = mutt_str_dup(h.edata->flags_remote);
-      driver_tags_replace(&e->tags, tags_copy);
-      FREE(&tags_copy);
-
-      if (*maxuid < h.edata->uid)
-        *maxuid = h.edata->uid;
-
-      rewind(fp);
-      /* NOTE: if Date: header is missing, mutt_rfc822_read_header depends
-       *   on h.received being set */
-      e->env = mutt_rfc822_read_header(fp, e, false, false);
-      /* body built as a side-effect of mutt_rfc822_read_header */
-      e->body->length = h.content_length;
-      mailbox_size_add(m, e);
-
-#ifdef USE_HCACHE
-      imap_hcache_put(mdata, e);
-#endif /* USE_HCACHE */
     }
 
     /* In case we get new mail while fetching the headers. */
-    if (mdata->reopen & IMAP_NEWMAIL_PENDING)
-    {
-      msn_end = mdata->new_mail_count;
-      mx_alloc_memory(m, msn_end);
-      imap_msn_reserve(&mdata->msn, msn_end);
-      mdata->reopen &= ~IMAP_NEWMAIL_PENDING;
-      mdata->new_mail_count = 0;
-    }
+    read_headers_new_mail(m, &msn_end);
 
     /* Note: RFC3501 section 7.4.1 and RFC7162 section 3.2.10.2 say we
      * must not get any EXPUNGE/VANISHED responses in the middle of a
@@ -1304,10 +1511,12 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
   rc = 0;
 
 bail:
+#ifdef USE_HCACHE
+  hcache_commit_batch(mdata->hcache);
+#endif /* USE_HCACHE */
   buf_pool_release(&hdr_list);
   buf_pool_release(&buf);
-  buf_pool_release(&tempfile);
-  mutt_file_fclose(&fp);
+  buf_pool_release(&hdr);
   FREE(&hdrreq);
   imap_edata_free((void **) &edata);
   progress_free(&progress);
@@ -1366,6 +1575,8 @@ retry:
 
 #ifdef USE_HCACHE
   imap_hcache_open(adata, mdata);
+  if (mdata->hcache)
+    mdata->hcache->arena = mailbox_arena(m);
 
   if (mdata->hcache && initial_download)
   {
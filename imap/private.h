@@ -184,6 +184,7 @@ int imap_rename_mailbox(struct ImapAccountData *adata, char *oldname, const char
 int imap_open_connection(struct ImapAccountData *adata);
 void imap_close_connection(struct ImapAccountData *adata);
 int imap_read_literal(FILE *fp, struct ImapAccountData *adata, unsigned long bytes, struct Progress *progress);
+int imap_read_literal_buf(struct Buffer *buf, struct ImapAccountData *adata, unsigned long bytes);
 void imap_expunge_mailbox(struct Mailbox *m, bool resort);
 int imap_login(struct ImapAccountData *adata);
 int imap_sync_message_for_copy(struct Mailbox *m, struct Email *e, struct Buffer *cmd, enum QuadOption *err_continue);
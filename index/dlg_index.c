@@ -99,6 +99,9 @@
 #include "sidebar/lib.h"
 #endif
 
+/// Config handle for $index_format
+static struct ConfigHandle HandleIndexFormat = CONFIG_HANDLE("index_format");
+
 /// Help Bar for the Index dialog
 static const struct Mapping IndexHelp[] = {
   // clang-format off
@@ -882,10 +885,22 @@ void index_make_entry(struct Menu *menu, char *buf, size_t buflen, int line)
     }
   }
 
-  const char *const c_index_format = cs_subset_string(shared->sub, "index_format");
+  const int cols = menu->win->state.cols;
   int msg_in_pager = shared->mailbox_view ? shared->mailbox_view->msg_in_pager : 0;
-  mutt_make_string(buf, buflen, menu->win->state.cols, NONULL(c_index_format),
-                   m, msg_in_pager, e, flags, NULL);
+  const bool in_pager = (msg_in_pager == e->msgno);
+  const char *const c_index_format = ch_string(shared->sub, &HandleIndexFormat);
+  const bool cacheable = index_row_format_is_cacheable(c_index_format);
+  const char *row = cacheable ? index_row_get(e, cols, flags, in_pager) : NULL;
+  if (row)
+  {
+    mutt_str_copy(buf, row, buflen);
+    return;
+  }
+
+  mutt_make_string(buf, buflen, cols, NONULL(c_index_format), m, msg_in_pager,
+                   e, flags, NULL);
+  if (cacheable)
+    index_row_set(e, cols, flags, in_pager, buf);
 }
 
 /**
@@ -1379,6 +1394,9 @@ void mutt_set_header_color(struct Mailbox *m, struct Email *e)
   if (!e)
     return;
 
+  /* The Email has changed, so its index line needs formatting again */
+  FREE(&e->index_row);
+
   struct RegexColor *color = NULL;
   struct PatternCache cache = { 0 };
 
@@ -2602,6 +2602,7 @@ static int op_post(struct IndexSharedData *shared, struct IndexPrivateData *priv
   if (!shared->email)
     return FR_NO_ACTION;
 
+  email_materialize(shared->email);
   const enum QuadOption c_followup_to_poster = cs_subset_quad(shared->sub, "followup_to_poster");
   if ((op != OP_FOLLOWUP) || !shared->email->env->followup_to ||
       !mutt_istr_equal(shared->email->env->followup_to, "poster") ||
@@ -53,6 +53,7 @@
  * | #NT_ATTACH            | index_attach_observer() |
  * | #NT_COLOR             | index_color_observer()  |
  * | #NT_CONFIG            | index_config_observer() |
+ * | #NT_MAILBOX           | index_email_observer()  |
  * | #NT_MENU              | index_menu_observer()   |
  * | #NT_SCORE             | index_score_observer()  |
  * | #NT_SUBJRX            | index_subjrx_observer() |
@@ -73,6 +74,7 @@
 #include "email/lib.h"
 #include "core/lib.h"
 #include "gui/lib.h"
+#include "lib.h"
 #include "attach/lib.h"
 #include "color/lib.h"
 #include "menu/lib.h"
@@ -83,6 +85,7 @@
 #include "muttlib.h"
 #include "mview.h"
 #include "private_data.h"
+#include "row_cache.h"
 #include "score.h"
 #include "shared_data.h"
 #include "subjectrx.h"
@@ -240,6 +243,7 @@ static int index_altern_observer(struct NotifyCallback *nc)
   struct IndexSharedData *shared = dlg->wdata;
 
   mutt_alternates_reset(shared->mailbox_view);
+  index_row_flush();
   mutt_debug(LL_DEBUG5, "alternates done\n");
   return 0;
 }
@@ -259,6 +263,7 @@ static int index_attach_observer(struct NotifyCallback *nc)
   struct IndexSharedData *shared = dlg->wdata;
 
   mutt_attachments_reset(shared->mailbox_view);
+  index_row_flush();
   mutt_debug(LL_DEBUG5, "attachments done\n");
   return 0;
 }
@@ -299,6 +304,7 @@ static int index_color_observer(struct NotifyCallback *nc)
     return 0;
 
   // Force re-caching of index colours
+  index_row_flush();
   for (int i = 0; i < m->msg_count; i++)
   {
     struct Email *e = m->emails[i];
@@ -345,6 +351,8 @@ static int index_config_observer(struct NotifyCallback *nc)
   if (!(flags & R_INDEX))
     return 0;
 
+  index_row_flush();
+
   if (mutt_str_equal(ev_c->name, "reply_regex"))
   {
     struct MuttWindow *dlg = dialog_find(win);
@@ -367,6 +375,33 @@ static int index_config_observer(struct NotifyCallback *nc)
   return 0;
 }
 
+/**
+ * index_email_observer - Notification that the Emails of a Mailbox have changed - Implements ::observer_t - @ingroup observer_api
+ */
+static int index_email_observer(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_MAILBOX)
+    return 0;
+  if (!nc->global_data)
+    return -1;
+
+  struct MuttWindow *win = nc->global_data;
+  struct MuttWindow *dlg = dialog_find(win);
+  if (!dlg)
+    return 0;
+
+  // Only the Emails of this Index's Mailbox are drawn
+  struct IndexSharedData *shared = dlg->wdata;
+  struct EventMailbox *ev_m = nc->event_data;
+  if (!ev_m || (ev_m->mailbox != shared->mailbox))
+    return 0;
+
+  // The Emails may have been resorted, rethreaded or changed
+  index_row_flush();
+  mutt_debug(LL_DEBUG5, "email done\n");
+  return 0;
+}
+
 /**
  * index_global_observer - Notification that a Global event occurred - Implements ::observer_t - @ingroup observer_api
  */
@@ -387,6 +422,9 @@ static int index_global_observer(struct NotifyCallback *nc)
   struct IndexSharedData *shared = dlg->wdata;
   mutt_check_rescore(shared->mailbox);
 
+  /* The command may have changed anything, e.g. an alias or a hook */
+  index_row_flush();
+
   return 0;
 }
 
@@ -401,6 +439,10 @@ static int index_index_observer(struct NotifyCallback *nc)
   struct MuttWindow *win = nc->global_data;
   win->actions |= WA_RECALC;
 
+  // Only a change of the current Email leaves the lines unchanged
+  if ((nc->event_type != NT_INDEX) || (nc->event_subtype != NT_INDEX_EMAIL))
+    index_row_flush();
+
   struct Menu *menu = win->wdata;
   menu_queue_redraw(menu, MENU_REDRAW_INDEX);
   mutt_debug(LL_DEBUG5, "index done, request WA_RECALC\n");
@@ -484,6 +526,7 @@ static int index_subjrx_observer(struct NotifyCallback *nc)
   struct IndexSharedData *shared = dlg->wdata;
 
   subjrx_clear_mods(shared->mailbox_view);
+  index_row_flush();
   mutt_debug(LL_DEBUG5, "subjectrx done\n");
   return 0;
 }
@@ -517,6 +560,7 @@ static int index_window_observer(struct NotifyCallback *nc)
   notify_observer_remove(NeoMutt->notify, index_attach_observer, win);
   notify_observer_remove(NeoMutt->notify, index_color_observer, win);
   notify_observer_remove(NeoMutt->notify, index_config_observer, win);
+  notify_observer_remove(NeoMutt->notify, index_email_observer, win);
   notify_observer_remove(NeoMutt->notify, index_global_observer, win);
   notify_observer_remove(priv->shared->notify, index_index_observer, win);
   notify_observer_remove(menu->notify, index_menu_observer, win);
@@ -610,6 +654,7 @@ struct MuttWindow *index_window_new(struct IndexPrivateData *priv)
   notify_observer_add(NeoMutt->notify, NT_ATTACH, index_attach_observer, win);
   notify_observer_add(NeoMutt->notify, NT_COLOR, index_color_observer, win);
   notify_observer_add(NeoMutt->notify, NT_CONFIG, index_config_observer, win);
+  notify_observer_add(NeoMutt->notify, NT_MAILBOX, index_email_observer, win);
   notify_observer_add(NeoMutt->notify, NT_GLOBAL, index_global_observer, win);
   notify_observer_add(priv->shared->notify, NT_ALL, index_index_observer, win);
   notify_observer_add(menu->notify, NT_MENU, index_menu_observer, win);
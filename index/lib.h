@@ -34,6 +34,7 @@
  * | index/index.c        | @subpage index_index        |
  * | index/ipanel.c       | @subpage index_ipanel       |
  * | index/private_data.c | @subpage index_private_data |
+ * | index/row_cache.c    | @subpage index_row_cache    |
  * | index/shared_data.c  | @subpage index_shared_data  |
  */
 
@@ -47,6 +48,7 @@
 #include "core/lib.h"
 #include "functions.h"   // IWYU pragma: keep
 #include "mx.h"          // IWYU pragma: keep
+#include "row_cache.h"   // IWYU pragma: keep
 #include "shared_data.h" // IWYU pragma: keep
 
 struct Email;
@@ -0,0 +1,228 @@
+/**
+ * @file
+ * Cache of formatted Index lines
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page index_row_cache Cache of formatted Index lines
+ *
+ * Formatting a line of the Index, `$index_format`, and matching the patterns
+ * of its colours is expensive.  Scrolling the Index redraws every line, but
+ * few of them have changed.
+ *
+ * Each Email keeps a copy of its formatted line (#IndexRow) and the colours
+ * of its parts.  The copy is used as long as:
+ * - the Email hasn't changed, see mutt_set_header_color()
+ * - nothing global has changed, see index_row_flush()
+ * - the line is formatted in the same way, e.g. the width of the Index and
+ *   the thread tree are the same
+ *
+ * Lines that depend on the current time aren't cached, see
+ * index_row_format_is_cacheable().  Neither are colours whose patterns test
+ * the date, see get_color().
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "color/lib.h"
+#include "row_cache.h"
+
+/// Incremented whenever every cached line becomes invalid
+static unsigned int IndexRowGeneration = 0;
+
+/**
+ * index_row_flush - Invalidate all the cached Index lines
+ *
+ * The lines aren't freed, they'll be replaced when they're next formatted.
+ */
+void index_row_flush(void)
+{
+  IndexRowGeneration++;
+}
+
+/**
+ * index_row_format_is_cacheable - Can the lines of an Index format be cached?
+ * @param fmt Format string, e.g. `$index_format`
+ * @retval true The lines can be cached
+ *
+ * A date conditional, e.g. `%<[1d?...>` or `%?(2w?...?`, compares the Email's
+ * date with the current time, so its line can change while the Email doesn't.
+ */
+bool index_row_format_is_cacheable(const char *fmt)
+{
+  if (!fmt)
+    return true;
+
+  for (const char *p = strchr(fmt, '%'); p; p = strchr(p, '%'))
+  {
+    p++;
+    if (*p == '%')
+    {
+      p++;
+      continue;
+    }
+
+    if (((p[0] == '?') || (p[0] == '<')) && ((p[1] == '[') || (p[1] == '(')))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * row_is_current - Is the cached Index line still valid?
+ * @param row Cached line
+ * @param e   Email
+ * @retval true The line is valid
+ */
+static bool row_is_current(const struct IndexRow *row, const struct Email *e)
+{
+  return row && (row->generation == IndexRowGeneration) &&
+         (row->msgno == e->msgno) && (row->vnum == e->vnum) &&
+         mutt_str_equal(row->tree, e->tree);
+}
+
+/**
+ * row_color_index - Get the slot of a colour in the cache
+ * @param cid Colour, e.g. #MT_COLOR_INDEX_AUTHOR
+ * @retval num Index into IndexRow::colors
+ * @retval -1  Colour isn't cached
+ *
+ * The colour of a tag, #MT_COLOR_INDEX_TAG, depends on the tag's name, so it
+ * isn't cached.
+ */
+static int row_color_index(enum ColorId cid)
+{
+  if ((cid < MT_COLOR_INDEX_AUTHOR) || (cid > MT_COLOR_INDEX_TAGS) ||
+      (cid == MT_COLOR_INDEX_TAG))
+  {
+    return -1;
+  }
+
+  return cid - MT_COLOR_INDEX_AUTHOR;
+}
+
+/**
+ * index_row_get - Get the cached Index line of an Email
+ * @param e        Email
+ * @param cols     Width of the Index
+ * @param flags    Flags used to format the line, see #MuttFormatFlags
+ * @param in_pager Is the Email being shown in the Pager?
+ * @retval ptr  Formatted line
+ * @retval NULL Not cached, or out of date
+ */
+const char *index_row_get(struct Email *e, int cols, MuttFormatFlags flags, bool in_pager)
+{
+  if (!e)
+    return NULL;
+
+  const struct IndexRow *row = e->index_row;
+  if (!row_is_current(row, e) || (row->cols != cols) || (row->flags != flags) ||
+      (row->in_pager != in_pager))
+  {
+    return NULL;
+  }
+
+  return row->text;
+}
+
+/**
+ * index_row_set - Cache the Index line of an Email
+ * @param e        Email
+ * @param cols     Width of the Index
+ * @param flags    Flags used to format the line, see #MuttFormatFlags
+ * @param in_pager Is the Email being shown in the Pager?
+ * @param text     Formatted line
+ */
+void index_row_set(struct Email *e, int cols, MuttFormatFlags flags,
+                   bool in_pager, const char *text)
+{
+  if (!e || !text)
+    return;
+
+  const size_t text_len = strlen(text) + 1;
+  const size_t tree_len = e->tree ? (strlen(e->tree) + 1) : 0;
+
+  FREE(&e->index_row);
+  struct IndexRow *row = mutt_mem_calloc(1, sizeof(struct IndexRow) + text_len + tree_len);
+
+  row->generation = IndexRowGeneration;
+  row->cols = cols;
+  row->flags = flags;
+  row->in_pager = in_pager;
+  row->msgno = e->msgno;
+  row->vnum = e->vnum;
+  memcpy(row->text, text, text_len);
+  if (e->tree)
+  {
+    char *tree = row->text + text_len;
+    memcpy(tree, e->tree, tree_len);
+    row->tree = tree;
+  }
+
+  e->index_row = row;
+}
+
+/**
+ * index_row_color_get - Get the cached colour of part of an Index line
+ * @param[in]  e   Email
+ * @param[in]  cid Colour, e.g. #MT_COLOR_INDEX_AUTHOR
+ * @param[out] ac  Colour, may be NULL
+ * @retval true The colour was cached
+ */
+bool index_row_color_get(struct Email *e, enum ColorId cid, struct AttrColor **ac)
+{
+  const int idx = row_color_index(cid);
+  if (!e || !ac || (idx < 0))
+    return false;
+
+  const struct IndexRow *row = e->index_row;
+  if (!row_is_current(row, e) || !(row->colors_valid & (1U << idx)))
+    return false;
+
+  *ac = row->colors[idx];
+  return true;
+}
+
+/**
+ * index_row_color_set - Cache the colour of part of an Index line
+ * @param e   Email
+ * @param cid Colour, e.g. #MT_COLOR_INDEX_AUTHOR
+ * @param ac  Colour, may be NULL
+ *
+ * The colour is only stored if the Email's line is cached.
+ */
+void index_row_color_set(struct Email *e, enum ColorId cid, struct AttrColor *ac)
+{
+  const int idx = row_color_index(cid);
+  if (!e || (idx < 0))
+    return;
+
+  struct IndexRow *row = e->index_row;
+  if (!row_is_current(row, e))
+    return;
+
+  row->colors[idx] = ac;
+  row->colors_valid |= (1U << idx);
+}
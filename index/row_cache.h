@@ -0,0 +1,66 @@
+/**
+ * @file
+ * Cache of formatted Index lines
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_INDEX_ROW_CACHE_H
+#define MUTT_INDEX_ROW_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "color/lib.h"
+#include "format_flags.h"
+
+struct Email;
+
+/// Number of colours of the parts of an Index line, e.g. #MT_COLOR_INDEX_AUTHOR
+#define INDEX_ROW_COLORS (MT_COLOR_INDEX_TAGS - MT_COLOR_INDEX_AUTHOR + 1)
+
+/**
+ * struct IndexRow - A formatted Index line
+ *
+ * The cache belongs to the Email, see Email::index_row.
+ *
+ * It's discarded whenever the Email's colour is recalculated, because that's
+ * when its contents have changed.  Events that affect every line, e.g. config
+ * changes, call index_row_flush().
+ */
+struct IndexRow
+{
+  unsigned int generation;    ///< Value of the cache generation when formatted
+  int cols;                   ///< Width of the Index
+  MuttFormatFlags flags;      ///< Flags the line was formatted with
+  bool in_pager;              ///< Was the Email being shown in the Pager?
+  int msgno;                  ///< Email's number in the Mailbox
+  int vnum;                   ///< Email's number in the view
+  const char *tree;           ///< Copy of the thread tree, may be NULL
+  uint16_t colors_valid;      ///< Which of `colors` have been looked up
+  struct AttrColor *colors[INDEX_ROW_COLORS]; ///< Colours of the parts of the line
+  char text[];                ///< Formatted line, followed by `tree`
+};
+
+void              index_row_flush    (void);
+const char *      index_row_get      (struct Email *e, int cols, MuttFormatFlags flags, bool in_pager);
+bool              index_row_format_is_cacheable(const char *fmt);
+void              index_row_set      (struct Email *e, int cols, MuttFormatFlags flags, bool in_pager, const char *text);
+bool              index_row_color_get(struct Email *e, enum ColorId cid, struct AttrColor **ac);
+void              index_row_color_set(struct Email *e, enum ColorId cid, struct AttrColor *ac);
+
+#endif /* MUTT_INDEX_ROW_CACHE_H */
@@ -48,6 +48,7 @@
 #include "functions.h"
 #include "globals.h"
 #include "mutt_logging.h"
+#include "mutt_mailbox.h"
 #include "opcodes.h"
 #ifdef USE_IMAP
 #include "imap/lib.h"
@@ -657,9 +658,25 @@ struct KeyEvent km_dokey_event(enum MenuType mtype)
 #endif
 
   const short c_timeout = cs_subset_number(NeoMutt->sub, "timeout");
+  int polled = 0;
   while (true)
   {
     int i = (c_timeout > 0) ? c_timeout : 60;
+
+    /* While new mail is being checked in the background, wake up regularly
+     * to show the results.  Stop after `$timeout` seconds, as usual. */
+    if (mutt_mailbox_check_poll())
+    {
+      tmp = mutt_getch_timeout(MUTT_MAILBOX_CHECK_POLL);
+      polled += MUTT_MAILBOX_CHECK_POLL;
+      if ((tmp.op == OP_TIMEOUT) && !SigWinch && (polled < (i * 1000)) &&
+          mutt_mailbox_check_poll())
+      {
+        continue;
+      }
+      goto gotkey;
+    }
+
 #ifdef USE_IMAP
     /* keep_alive may need to run more frequently than `$timeout` allows */
     if (c_imap_keep_alive != 0)
@@ -691,9 +708,7 @@ struct KeyEvent km_dokey_event(enum MenuType mtype)
 
     tmp = mutt_getch_timeout(i * 1000);
 
-#ifdef USE_IMAP
   gotkey:
-#endif
     /* hide timeouts, but not window resizes, from the line editor. */
     if ((mtype == MENU_EDITOR) && (tmp.op == OP_TIMEOUT) && !SigWinch)
       continue;
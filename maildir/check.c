@@ -0,0 +1,537 @@
+/**
+ * @file
+ * Check Maildir mailboxes for new mail in the background
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page maildir_check Check Maildir mailboxes for new mail in the background
+ *
+ * Checking a Maildir mailbox for new mail means reading its `new` and `cur`
+ * directories.  With many mailboxes, or slow disks, this can take a while.
+ *
+ * The checks are run by a pool of worker threads.  Each check (#MdCheckJob)
+ * works on a copy of the Mailbox's details, and the results are copied back
+ * to the Mailbox by the main thread, see maildir_check_apply().  The workers
+ * only read; they never touch the Mailbox, the config, or the logs, and they
+ * don't create any missing directories.  That's left to the main thread, see
+ * maildir_check_job_apply().
+ *
+ * If no threads can be started, the mailboxes are checked by
+ * maildir_check_apply().
+ */
+
+#include "config.h"
+#include <dirent.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "check.h"
+#include "lib.h"
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+/**
+ * struct MdCheck - A pool of threads checking Maildir mailboxes
+ */
+struct MdCheck
+{
+  struct MdCheckJobArray jobs; ///< Mailboxes to check
+  size_t next;                 ///< Index of the next job to run
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_t lock;        ///< Protects next and MdCheckJob::done
+  pthread_cond_t cond_done;    ///< Signalled when a job has finished
+  pthread_t *threads;          ///< Worker threads
+  int num_threads;             ///< Number of worker threads
+  bool waiting;                ///< The caller is waiting for cond_done
+  bool stop;                   ///< Tell the workers to finish
+#endif
+};
+
+/**
+ * check_dir - Check one directory of a Maildir
+ * @param job       Check to run
+ * @param dir_name  Directory, "new" or "cur"
+ * @param check_new Look for new mail
+ * @param mode      How to open the directory, e.g. #MUTT_OPENDIR_CREATE
+ *
+ * @note This is called from worker threads, so it mustn't log or use any
+ *       shared state.
+ */
+static void check_dir(struct MdCheckJob *job, const char *dir_name,
+                      bool check_new, enum MuttOpenDirMode mode)
+{
+  struct dirent *de = NULL;
+  char *p = NULL;
+  struct stat st = { 0 };
+  struct Buffer path = buf_make(0);
+  struct Buffer msgpath = buf_make(0);
+
+  buf_printf(&path, "%s/%s", job->path, dir_name);
+
+  /* when $mail_check_recent is set, if the new/ directory hasn't been modified since
+   * the user last exited the mailbox, then we know there is no recent mail.  */
+  if (check_new && job->check_recent)
+  {
+    if ((stat(buf_string(&path), &st) == 0) &&
+        (mutt_file_stat_timespec_compare(&st, MUTT_STAT_MTIME, &job->last_visited) < 0))
+    {
+      check_new = false;
+    }
+  }
+
+  if (!(check_new || job->check_stats))
+    goto cleanup;
+
+  DIR *dir = mutt_file_opendir(buf_string(&path), mode);
+  if (!dir)
+  {
+    job->missing = (errno == ENOENT);
+    job->error = true;
+    goto cleanup;
+  }
+
+  while ((de = readdir(dir)))
+  {
+    if (*de->d_name == '.')
+      continue;
+
+    p = strstr(de->d_name, ":2,");
+    if (p && strchr(p + 3, 'T'))
+      continue;
+
+    if (job->check_stats)
+    {
+      job->msg_count++;
+      if (p && strchr(p + 3, 'F'))
+        job->msg_flagged++;
+    }
+    if (!p || !strchr(p + 3, 'S'))
+    {
+      if (job->check_stats)
+        job->msg_unread++;
+      if (check_new)
+      {
+        if (job->check_recent)
+        {
+          buf_printf(&msgpath, "%s/%s", buf_string(&path), de->d_name);
+          /* ensure this message was received since leaving this mailbox */
+          if ((stat(buf_string(&msgpath), &st) == 0) &&
+              (mutt_file_stat_timespec_compare(&st, MUTT_STAT_CTIME, &job->last_visited) <= 0))
+          {
+            continue;
+          }
+        }
+        job->has_new = true;
+        if (job->check_stats)
+        {
+          job->msg_new++;
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+  }
+
+  closedir(dir);
+
+cleanup:
+  buf_dealloc(&path);
+  buf_dealloc(&msgpath);
+}
+
+/**
+ * maildir_check_job_init - Prepare to check a Maildir mailbox
+ * @param job         Check to initialise
+ * @param m           Mailbox
+ * @param check_stats Count the messages, too
+ *
+ * The Mailbox's details and the config are copied into the job.
+ * Free the job's path when it's finished with.
+ */
+void maildir_check_job_init(struct MdCheckJob *job, struct Mailbox *m, bool check_stats)
+{
+  if (!job || !m)
+    return;
+
+  memset(job, 0, sizeof(*job));
+  job->mailbox = m;
+  job->path = mutt_str_dup(mailbox_path(m));
+  job->last_visited = m->last_visited;
+  job->had_new = m->has_new;
+  job->check_stats = check_stats;
+  job->check_cur = cs_subset_bool(NeoMutt->sub, "maildir_check_cur");
+  job->check_recent = cs_subset_bool(NeoMutt->sub, "mail_check_recent");
+}
+
+/**
+ * check_job_run - Check a Maildir mailbox for new mail
+ * @param job  Check to run
+ * @param mode How to open the directories, e.g. #MUTT_OPENDIR_CREATE
+ */
+static void check_job_run(struct MdCheckJob *job, enum MuttOpenDirMode mode)
+{
+  check_dir(job, "new", true, mode);
+
+  const bool check_new = !job->had_new && !job->has_new && job->check_cur;
+  if (check_new || job->check_stats)
+    check_dir(job, "cur", check_new, mode);
+}
+
+/**
+ * maildir_check_job_run - Check a Maildir mailbox for new mail
+ * @param job Check to run
+ *
+ * Missing directories aren't created, see maildir_check_job_apply().
+ *
+ * @note This may be called from a worker thread
+ */
+void maildir_check_job_run(struct MdCheckJob *job)
+{
+  if (!job)
+    return;
+
+  check_job_run(job, MUTT_OPENDIR_NONE);
+}
+
+/**
+ * maildir_check_job_apply - Copy the results of a check to the Mailbox
+ * @param job Finished check
+ * @param m   Mailbox
+ *
+ * If one of the Maildir's directories was missing, it's created and the
+ * Mailbox is checked again.
+ */
+void maildir_check_job_apply(struct MdCheckJob *job, struct Mailbox *m)
+{
+  if (!job || !m)
+    return;
+
+  if (job->missing)
+  {
+    job->has_new = false;
+    job->msg_count = 0;
+    job->msg_unread = 0;
+    job->msg_flagged = 0;
+    job->msg_new = 0;
+    job->error = false;
+    job->missing = false;
+    check_job_run(job, MUTT_OPENDIR_CREATE);
+  }
+
+  if (job->error)
+    m->type = MUTT_UNKNOWN;
+
+  if (job->has_new)
+    m->has_new = true;
+
+  if (job->check_stats)
+  {
+    m->msg_count = job->msg_count;
+    m->msg_unread = job->msg_unread;
+    m->msg_flagged = job->msg_flagged;
+    m->msg_new = job->msg_new;
+  }
+}
+
+/**
+ * maildir_check_observer - Notification that a Mailbox has changed - Implements ::observer_t - @ingroup observer_api
+ *
+ * If a Mailbox is deleted, forget about it.  Its check will still finish.
+ */
+static int maildir_check_observer(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_MAILBOX)
+    return 0;
+  if (!nc->global_data || !nc->event_data)
+    return -1;
+  if (nc->event_subtype != NT_MAILBOX_DELETE)
+    return 0;
+
+  struct MdCheck *mc = nc->global_data;
+  struct EventMailbox *ev_m = nc->event_data;
+
+  struct MdCheckJob *job = NULL;
+  ARRAY_FOREACH(job, &mc->jobs)
+  {
+    if (job->mailbox == ev_m->mailbox)
+      job->mailbox = NULL;
+  }
+
+  mutt_debug(LL_DEBUG5, "mailbox done\n");
+  return 0;
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+/**
+ * check_worker - Check mailboxes until there are none left
+ * @param arg Maildir Check
+ * @retval NULL Always
+ */
+static void *check_worker(void *arg)
+{
+  struct MdCheck *mc = arg;
+
+  pthread_mutex_lock(&mc->lock);
+  while (!mc->stop && (mc->next < ARRAY_SIZE(&mc->jobs)))
+  {
+    struct MdCheckJob *job = ARRAY_GET(&mc->jobs, mc->next);
+    mc->next++;
+    pthread_mutex_unlock(&mc->lock);
+
+    maildir_check_job_run(job);
+
+    pthread_mutex_lock(&mc->lock);
+    job->done = true;
+    if (mc->waiting)
+      pthread_cond_broadcast(&mc->cond_done);
+  }
+  pthread_mutex_unlock(&mc->lock);
+
+  return NULL;
+}
+#endif
+
+/**
+ * maildir_check_new - Create a new Maildir Check
+ * @retval ptr New Maildir Check
+ */
+struct MdCheck *maildir_check_new(void)
+{
+  struct MdCheck *mc = mutt_mem_calloc(1, sizeof(struct MdCheck));
+  ARRAY_INIT(&mc->jobs);
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_init(&mc->lock, NULL);
+  pthread_cond_init(&mc->cond_done, NULL);
+#endif
+  return mc;
+}
+
+/**
+ * maildir_check_free - Free a Maildir Check
+ * @param ptr Maildir Check to free
+ *
+ * Any running workers are stopped.  Results that haven't been applied are
+ * discarded.
+ */
+void maildir_check_free(struct MdCheck **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct MdCheck *mc = *ptr;
+
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_lock(&mc->lock);
+  mc->stop = true;
+  pthread_mutex_unlock(&mc->lock);
+
+  for (int i = 0; i < mc->num_threads; i++)
+    pthread_join(mc->threads[i], NULL);
+  FREE(&mc->threads);
+
+  pthread_cond_destroy(&mc->cond_done);
+  pthread_mutex_destroy(&mc->lock);
+#endif
+
+  struct MdCheckJob *job = NULL;
+  ARRAY_FOREACH(job, &mc->jobs)
+  {
+    if (job->mailbox && !job->applied)
+      notify_observer_remove(job->mailbox->notify, maildir_check_observer, mc);
+    FREE(&job->path);
+  }
+  ARRAY_FREE(&mc->jobs);
+
+  FREE(ptr);
+}
+
+/**
+ * maildir_check_add - Add a Mailbox to a Maildir Check
+ * @param mc          Maildir Check
+ * @param m           Mailbox
+ * @param check_stats Count the messages, too
+ *
+ * @note Mailboxes can only be added before maildir_check_start() is called.
+ */
+void maildir_check_add(struct MdCheck *mc, struct Mailbox *m, bool check_stats)
+{
+  if (!mc || !m)
+    return;
+
+  struct MdCheckJob job = { 0 };
+  maildir_check_job_init(&job, m, check_stats);
+  ARRAY_ADD(&mc->jobs, job);
+
+  notify_observer_add(m->notify, NT_MAILBOX, maildir_check_observer, mc);
+}
+
+/**
+ * maildir_check_start - Start checking the Mailboxes
+ * @param mc          Maildir Check
+ * @param num_threads Number of worker threads to use
+ */
+void maildir_check_start(struct MdCheck *mc, int num_threads)
+{
+  if (!mc)
+    return;
+
+#ifdef HAVE_PTHREAD_CREATE
+  num_threads = MIN(num_threads, (int) ARRAY_SIZE(&mc->jobs));
+  if (num_threads <= 0)
+    return;
+
+  /* Signals must be handled by the main thread */
+  sigset_t all = { 0 };
+  sigset_t old = { 0 };
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+
+  mc->threads = mutt_mem_calloc(num_threads, sizeof(pthread_t));
+  for (int i = 0; i < num_threads; i++)
+  {
+    int rc = pthread_create(&mc->threads[mc->num_threads], NULL, check_worker, mc);
+    if (rc != 0)
+    {
+      mutt_debug(LL_DEBUG1, "pthread_create: %s (errno %d)\n", strerror(rc), rc);
+      break;
+    }
+    mc->num_threads++;
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  mutt_debug(LL_DEBUG2, "checking %zu mailboxes with %d threads\n",
+             ARRAY_SIZE(&mc->jobs), mc->num_threads);
+#endif
+}
+
+/**
+ * check_finish - Has a check finished?
+ * @param mc   Maildir Check
+ * @param job  Check
+ * @param wait Wait for the check to finish
+ * @retval true The check has finished
+ *
+ * If there are no workers, the check is run immediately.  While waiting, the
+ * caller runs checks that no worker has started.
+ */
+static bool check_finish(struct MdCheck *mc, struct MdCheckJob *job, bool wait)
+{
+#ifdef HAVE_PTHREAD_CREATE
+  if (mc->num_threads > 0)
+  {
+    pthread_mutex_lock(&mc->lock);
+    while (wait && !job->done)
+    {
+      if (mc->next < ARRAY_SIZE(&mc->jobs))
+      {
+        /* Help the workers, rather than waiting for them */
+        struct MdCheckJob *job_next = ARRAY_GET(&mc->jobs, mc->next);
+        mc->next++;
+        pthread_mutex_unlock(&mc->lock);
+        maildir_check_job_run(job_next);
+        pthread_mutex_lock(&mc->lock);
+        job_next->done = true;
+        continue;
+      }
+
+      mc->waiting = true;
+      pthread_cond_wait(&mc->cond_done, &mc->lock);
+      mc->waiting = false;
+    }
+    const bool done = job->done;
+    pthread_mutex_unlock(&mc->lock);
+    return done;
+  }
+#endif
+
+  if (!job->done)
+  {
+    maildir_check_job_run(job);
+    job->done = true;
+  }
+
+  return true;
+}
+
+/**
+ * maildir_check_apply - Copy the results of a finished check to its Mailbox
+ * @param mc   Maildir Check
+ * @param wait Wait for a check to finish
+ * @retval ptr  Mailbox that was updated
+ * @retval NULL No more results, yet
+ *
+ * Call this repeatedly to collect all the finished checks.  Mailboxes that
+ * have been opened, or deleted, since they were added are skipped.
+ */
+struct Mailbox *maildir_check_apply(struct MdCheck *mc, bool wait)
+{
+  if (!mc)
+    return NULL;
+
+  struct MdCheckJob *job = NULL;
+  ARRAY_FOREACH(job, &mc->jobs)
+  {
+    if (job->applied || !check_finish(mc, job, wait))
+      continue;
+
+    job->applied = true;
+    struct Mailbox *m = job->mailbox;
+    if (!m)
+      continue;
+
+    notify_observer_remove(m->notify, maildir_check_observer, mc);
+    if ((m->opened > 0) || (m->type != MUTT_MAILDIR))
+      continue;
+
+    maildir_check_job_apply(job, m);
+    return m;
+  }
+
+  return NULL;
+}
+
+/**
+ * maildir_check_busy - Are any checks still running?
+ * @param mc Maildir Check
+ * @retval true Some results haven't been applied yet
+ */
+bool maildir_check_busy(struct MdCheck *mc)
+{
+  if (!mc)
+    return false;
+
+  struct MdCheckJob *job = NULL;
+  ARRAY_FOREACH(job, &mc->jobs)
+  {
+    if (!job->applied)
+      return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * Check Maildir mailboxes for new mail in the background
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MAILDIR_CHECK_H
+#define MUTT_MAILDIR_CHECK_H
+
+#include <stdbool.h>
+#include <time.h>
+#include "mutt/lib.h"
+
+struct Mailbox;
+
+/**
+ * struct MdCheckJob - Check one Maildir mailbox for new mail
+ *
+ * The inputs are copied from the Mailbox and the config by
+ * maildir_check_job_init(), so the check can be run by any thread.
+ */
+struct MdCheckJob
+{
+  struct Mailbox *mailbox;      ///< Mailbox, NULL if it's been deleted
+  char *path;                   ///< Path of the Maildir
+  struct timespec last_visited; ///< Time of the last exit from the Mailbox
+  bool had_new;                 ///< Mailbox already had new mail
+  bool check_stats;             ///< Count the messages
+  bool check_cur;               ///< Look in cur/ for new mail, `$maildir_check_cur`
+  bool check_recent;            ///< Only new mail since the last visit, `$mail_check_recent`
+
+  bool has_new;                 ///< New mail was found
+  int msg_count;                ///< Total number of messages
+  int msg_unread;               ///< Number of unread messages
+  int msg_flagged;              ///< Number of flagged messages
+  int msg_new;                  ///< Number of new messages
+  bool error;                   ///< A directory couldn't be read
+  bool missing;                 ///< A directory doesn't exist
+
+  bool done;                    ///< The check has been run
+  bool applied;                 ///< The results have been copied to the Mailbox
+};
+ARRAY_HEAD(MdCheckJobArray, struct MdCheckJob);
+
+void maildir_check_job_apply(struct MdCheckJob *job, struct Mailbox *m);
+void maildir_check_job_init (struct MdCheckJob *job, struct Mailbox *m, bool check_stats);
+void maildir_check_job_run  (struct MdCheckJob *job);
+
+#endif /* MUTT_MAILDIR_CHECK_H */
@@ -42,6 +42,9 @@ static struct ConfigDef MaildirVars[] = {
   { "maildir_check_cur", DT_BOOL, false, 0, NULL,
     "Check both 'new' and 'cur' directories for new mail"
   },
+  { "maildir_read_threads", DT_NUMBER|DT_NOT_NEGATIVE, 4, 0, NULL,
+    "(maildir,mh) Number of threads used to read messages when opening a mailbox"
+  },
   { "maildir_trash", DT_BOOL, false, 0, NULL,
     "Use the maildir 'trashed' flag, rather than deleting"
   },
@@ -25,16 +25,18 @@
  *
  * Maildir local mailbox type
  *
- * | File               | Description               |
- * | :----------------- | :------------------------ |
- * | maildir/config.c   | @subpage maildir_config   |
- * | maildir/edata.c    | @subpage maildir_edata    |
- * | maildir/maildir.c  | @subpage maildir_maildir  |
- * | maildir/mdata.c    | @subpage maildir_mdata    |
- * | maildir/mdemail.c  | @subpage maildir_mdemail  |
- * | maildir/mh.c       | @subpage maildir_mh       |
- * | maildir/sequence.c | @subpage maildir_sequence |
- * | maildir/shared.c   | @subpage maildir_shared   |
+ * | File                | Description                |
+ * | :------------------ | :------------------------- |
+ * | maildir/check.c     | @subpage maildir_check     |
+ * | maildir/config.c    | @subpage maildir_config    |
+ * | maildir/edata.c     | @subpage maildir_edata     |
+ * | maildir/maildir.c   | @subpage maildir_maildir   |
+ * | maildir/mdata.c     | @subpage maildir_mdata     |
+ * | maildir/mdemail.c   | @subpage maildir_mdemail   |
+ * | maildir/mh.c        | @subpage maildir_mh        |
+ * | maildir/readahead.c | @subpage maildir_readahead |
+ * | maildir/sequence.c  | @subpage maildir_sequence  |
+ * | maildir/shared.c    | @subpage maildir_shared    |
  */
 
 #ifndef MUTT_MAILDIR_LIB_H
@@ -45,13 +47,22 @@
 #include "core/lib.h"
 
 struct Email;
+struct EmailArena;
 struct HeaderCache;
+struct MdCheck;
 
 extern const struct MxOps MxMaildirOps;
 extern const struct MxOps MxMhOps;
 
+void            maildir_check_add        (struct MdCheck *mc, struct Mailbox *m, bool check_stats);
+struct Mailbox *maildir_check_apply      (struct MdCheck *mc, bool wait);
+bool            maildir_check_busy       (struct MdCheck *mc);
+void            maildir_check_free       (struct MdCheck **ptr);
+struct MdCheck *maildir_check_new        (void);
+void            maildir_check_start      (struct MdCheck *mc, int num_threads);
+
 int           maildir_check_empty      (const char *path);
-struct Email *maildir_email_new        (void);
+struct Email *maildir_email_new        (struct EmailArena *ea);
 void          maildir_gen_flags        (char *dest, size_t destlen, struct Email *e);
 bool          maildir_msg_open_new     (struct Mailbox *m, struct Message *msg, const struct Email *e);
 FILE *        maildir_open_find_message(const char *folder, const char *msg, char **newname);
@@ -50,15 +50,19 @@
 #include "email/lib.h"
 #include "core/lib.h"
 #include "lib.h"
+#include "pattern/lib.h"
 #include "progress/lib.h"
+#include "check.h"
 #include "copy.h"
 #include "edata.h"
 #include "globals.h" // IWYU pragma: keep
 #include "mdata.h"
 #include "mdemail.h"
 #include "mx.h"
+#include "readahead.h"
 #include "sort.h"
 #ifdef USE_INOTIFY
+#include <sys/inotify.h>
 #include "monitor.h"
 #endif
 #ifdef USE_HCACHE
@@ -77,115 +81,22 @@ struct Progress;
 
 /**
  * maildir_email_new - Create a Maildir Email
+ * @param ea Arena for the Email, may be NULL
  * @retval ptr Newly created Email
  *
  * Create a new Email and attach MaildirEmailData.
  *
  * @note This should be freed using email_free()
  */
-struct Email *maildir_email_new(void)
+struct Email *maildir_email_new(struct EmailArena *ea)
 {
-  struct Email *e = email_new();
+  struct Email *e = email_new_arena(ea);
   e->edata = maildir_edata_new();
   e->edata_free = maildir_edata_free;
 
   return e;
 }
 
-/**
- * maildir_check_dir - Check for new mail / mail counts
- * @param m           Mailbox to check
- * @param dir_name    Path to Mailbox
- * @param check_new   if true, check for new mail
- * @param check_stats if true, count total, new, and flagged messages
- *
- * Checks the specified maildir subdir (cur or new) for new mail or mail counts.
- */
-static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
-                              bool check_new, bool check_stats)
-{
-  DIR *dir = NULL;
-  struct dirent *de = NULL;
-  char *p = NULL;
-  struct stat st = { 0 };
-
-  struct Buffer *path = buf_pool_get();
-  struct Buffer *msgpath = buf_pool_get();
-  buf_printf(path, "%s/%s", mailbox_path(m), dir_name);
-
-  /* when $mail_check_recent is set, if the new/ directory hasn't been modified since
-   * the user last exited the mailbox, then we know there is no recent mail.  */
-  const bool c_mail_check_recent = cs_subset_bool(NeoMutt->sub, "mail_check_recent");
-  if (check_new && c_mail_check_recent)
-  {
-    if ((stat(buf_string(path), &st) == 0) &&
-        (mutt_file_stat_timespec_compare(&st, MUTT_STAT_MTIME, &m->last_visited) < 0))
-    {
-      check_new = false;
-    }
-  }
-
-  if (!(check_new || check_stats))
-    goto cleanup;
-
-  dir = mutt_file_opendir(buf_string(path), MUTT_OPENDIR_CREATE);
-  if (!dir)
-  {
-    m->type = MUTT_UNKNOWN;
-    goto cleanup;
-  }
-
-  while ((de = readdir(dir)))
-  {
-    if (*de->d_name == '.')
-      continue;
-
-    p = strstr(de->d_name, ":2,");
-    if (p && strchr(p + 3, 'T'))
-      continue;
-
-    if (check_stats)
-    {
-      m->msg_count++;
-      if (p && strchr(p + 3, 'F'))
-        m->msg_flagged++;
-    }
-    if (!p || !strchr(p + 3, 'S'))
-    {
-      if (check_stats)
-        m->msg_unread++;
-      if (check_new)
-      {
-        if (c_mail_check_recent)
-        {
-          buf_printf(msgpath, "%s/%s", buf_string(path), de->d_name);
-          /* ensure this message was received since leaving this m */
-          if ((stat(buf_string(msgpath), &st) == 0) &&
-              (mutt_file_stat_timespec_compare(&st, MUTT_STAT_CTIME, &m->last_visited) <= 0))
-          {
-            continue;
-          }
-        }
-        m->has_new = true;
-        if (check_stats)
-        {
-          m->msg_new++;
-        }
-        else
-        {
-          break;
-        }
-      }
-    }
-  }
-
-  closedir(dir);
-
-cleanup:
-  buf_pool_release(&path);
-  buf_pool_release(&msgpath);
-}
-
 /**
  * maildir_sort_flags - Compare two flag characters - Implements ::sort_t - @ingroup sort_api
  * @param a First  character to compare
@@ -551,7 +462,7 @@ static int maildir_parse_dir(struct Mailbox *m, struct MdEmailArray *mda,
 
     mutt_debug(LL_DEBUG2, "queueing %s\n", de->d_name);
 
-    e = maildir_email_new();
+    e = maildir_email_new(mailbox_arena(m));
     e->old = is_old;
     maildir_parse_flags(e, de->d_name);
 
@@ -598,20 +509,71 @@ static size_t maildir_hcache_keylen(const char *fn)
 }
 #endif
 
+/**
+ * maildir_parse_read - Parse a Maildir message that has been read into memory
+ * @param type   Mailbox type, e.g. #MUTT_MAILDIR
+ * @param mr     Start of the message file
+ * @param is_old true, if the email is old (read)
+ * @param e      Email
+ * @retval true Success
+ *
+ * This is the in-memory equivalent of maildir_parse_stream().
+ */
+static bool maildir_parse_read(enum MailboxType type, const struct MdRead *mr,
+                               bool is_old, struct Email *e)
+{
+  if (mr->err != 0)
+  {
+    mutt_debug(LL_DEBUG1, "%s: %s (errno %d)\n", mr->path, strerror(mr->err), mr->err);
+    return false;
+  }
+
+  if (mr->size == 0)
+    return false;
+
+  e->env = mutt_rfc822_read_header_mem(mr->data, mr->len, e, false, false);
+
+  if (e->received == 0)
+    e->received = e->date_sent;
+
+  /* always update the length since we have fresh information available. */
+  e->body->length = mr->size - e->body->offset;
+
+  e->index = -1;
+
+  if (type == MUTT_MAILDIR)
+  {
+    /* maildir stores its flags in the filename, so ignore the
+     * flags in the header of the message */
+
+    e->old = is_old;
+    maildir_parse_flags(e, mr->path);
+  }
+  return true;
+}
+
 /**
  * maildir_delayed_parsing - This function does the second parsing pass
  * @param[in]  m   Mailbox
  * @param[out] mda Maildir array to parse
  * @param[in]  progress Progress bar
+ *
+ * Emails that aren't in the header cache are read by a pool of threads, see
+ * $maildir_read_threads, then parsed here.
  */
 static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
                                     struct Progress *progress)
 {
   char fn[PATH_MAX] = { 0 };
+  struct MdReadahead *ra = maildir_readahead_new();
+  struct MdEmailArray mda_read = ARRAY_HEAD_INITIALIZER;
+  size_t count = 0;
 
 #ifdef USE_HCACHE
   const char *const c_header_cache = cs_subset_path(NeoMutt->sub, "header_cache");
   struct HeaderCache *hc = hcache_open(c_header_cache, mailbox_path(m), NULL);
+  if (hc)
+    hc->arena = mailbox_arena(m);
   const bool c_maildir_header_cache_verify = cs_subset_bool(NeoMutt->sub, "maildir_header_cache_verify");
 #endif
 
@@ -623,9 +585,6 @@ static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
     if (!md || !md->email || md->header_parsed)
       continue;
 
-    if (m->verbose && progress)
-      progress_update(progress, ARRAY_FOREACH_IDX, -1);
-
     snprintf(fn, sizeof(fn), "%s/%s", mailbox_path(m), md->email->path);
 
 #ifdef USE_HCACHE
@@ -648,6 +607,9 @@ static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
 
     if (hce.email && (rc == 0) && (st_lastchanged.st_mtime <= hce.uidvalidity))
     {
+      if (m->verbose && progress)
+        progress_update(progress, ++count, -1);
+
       hce.email->edata = maildir_edata_new();
       hce.email->edata_free = maildir_edata_free;
       hce.email->old = md->email->old;
@@ -659,22 +621,45 @@ static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
     else
 #endif
     {
-      if (maildir_parse_message(m->type, fn, md->email->old, md->email))
-      {
-        md->header_parsed = true;
+      maildir_readahead_add(ra, fn);
+      ARRAY_ADD(&mda_read, md);
+    }
+  }
+
+  const short c_maildir_read_threads = cs_subset_number(NeoMutt->sub, "maildir_read_threads");
+  maildir_readahead_start(ra, c_maildir_read_threads);
 #ifdef USE_HCACHE
-        key = md->email->path + 3;
-        keylen = maildir_hcache_keylen(key);
-        hcache_store(hc, key, keylen, md->email, 0);
+  hcache_begin_batch(hc);
 #endif
-      }
-      else
-      {
-        email_free(&md->email);
-      }
+
+  ARRAY_FOREACH(mdp, &mda_read)
+  {
+    md = *mdp;
+
+    if (m->verbose && progress)
+      progress_update(progress, ++count, -1);
+
+    const struct MdRead *mr = maildir_readahead_get(ra, ARRAY_FOREACH_IDX);
+    if (maildir_parse_read(m->type, mr, md->email->old, md->email))
+    {
+      md->header_parsed = true;
+#ifdef USE_HCACHE
+      const char *key = md->email->path + 3;
+      size_t keylen = maildir_hcache_keylen(key);
+      hcache_store(hc, key, keylen, md->email, 0);
+#endif
+    }
+    else
+    {
+      email_free(&md->email);
     }
+    maildir_readahead_release(ra, ARRAY_FOREACH_IDX);
   }
+
+  maildir_readahead_free(&ra);
+  ARRAY_FREE(&mda_read);
 #ifdef USE_HCACHE
+  hcache_commit_batch(hc);
   hcache_close(&hc);
 #endif
 }
@@ -1170,6 +1155,80 @@ static bool maildir_mbox_open_append(struct Mailbox *m, OpenMailboxFlags flags)
   return true;
 }
 
+#ifdef USE_INOTIFY
+/**
+ * maildir_check_events - Find the files that the Monitor has seen change
+ * @param[in]  m       Mailbox
+ * @param[out] mda     Array for the files that have been added
+ * @param[out] touched Hash Table of the canonical names of the changed files
+ * @retval  0 Success, @a mda and @a touched describe every change
+ * @retval -1 The Mailbox isn't being monitored
+ * @retval -2 Some changes were missed, the Mailbox must be scanned
+ *
+ * This is the incremental equivalent of maildir_parse_dir().  Rather than
+ * reading the directories, only the files named by the inotify events are
+ * looked at.  If there are no changes, @a touched will be NULL.
+ */
+static int maildir_check_events(struct Mailbox *m, struct MdEmailArray *mda,
+                                struct HashTable **touched)
+{
+  struct MonitorEventArray events = ARRAY_HEAD_INITIALIZER;
+  int rc = mutt_monitor_events(m, &events);
+  if ((rc != 0) || ARRAY_EMPTY(&events))
+  {
+    mutt_monitor_events_clear(&events);
+    return rc;
+  }
+
+  struct Buffer *buf = buf_pool_get();
+  struct stat st = { 0 };
+  // Hash Table: "subdir/filename" -> Mailbox, files that have been looked at
+  struct HashTable *seen = mutt_hash_new(ARRAY_SIZE(&events), MUTT_HASH_STRDUP_KEYS);
+  *touched = mutt_hash_new(ARRAY_SIZE(&events), MUTT_HASH_STRDUP_KEYS);
+
+  struct MonitorEvent *ev = NULL;
+  ARRAY_FOREACH(ev, &events)
+  {
+    const char *fname = ev->name + 4;
+    if (*fname == '.')
+      continue;
+
+    maildir_canon_filename(buf, fname);
+    if (!mutt_hash_find(*touched, buf_string(buf)))
+      mutt_hash_insert(*touched, buf_string(buf), m);
+
+    /* A file that has been removed will be noticed because it's missing.
+     * A file that has been added may have been moved again since. */
+    if (!(ev->mask & (IN_CREATE | IN_MOVED_TO)) || mutt_hash_find(seen, ev->name))
+      continue;
+    mutt_hash_insert(seen, ev->name, m);
+
+    buf_printf(buf, "%s/%s", mailbox_path(m), ev->name);
+    if ((stat(buf_string(buf), &st) != 0) || !S_ISREG(st.st_mode))
+      continue;
+
+    mutt_debug(LL_DEBUG2, "queueing %s\n", ev->name);
+
+    struct Email *e = maildir_email_new(mailbox_arena(m));
+    e->old = mutt_strn_equal(ev->name, "cur/", 4);
+    maildir_parse_flags(e, fname);
+    e->path = mutt_str_dup(ev->name);
+
+    struct MdEmail *entry = maildir_entry_new();
+    entry->email = e;
+    entry->inode = st.st_ino;
+    ARRAY_ADD(mda, entry);
+  }
+
+  ARRAY_SORT(mda, maildir_sort_inode);
+
+  mutt_hash_free(&seen);
+  buf_pool_release(&buf);
+  mutt_monitor_events_clear(&events);
+  return 0;
+}
+#endif
+
 /**
  * maildir_check - Check for new mail
  * @param m Mailbox
@@ -1191,6 +1250,7 @@ static enum MxStatus maildir_check(struct Mailbox *m)
   int num_new = 0;            /* number of new messages added to the mailbox */
   bool flags_changed = false; /* message flags were changed in the mailbox */
   struct HashTable *hash_names = NULL; // Hash Table: "base-filename" -> MdEmail
+  struct HashTable *hash_touched = NULL; // Hash Table: "base-filename" -> Mailbox, changed files
   struct MaildirMboxData *mdata = maildir_mdata_get(m);
 
   /* XXX seems like this check belongs in mx_mbox_check() rather than here.  */
@@ -1213,13 +1273,31 @@ static enum MxStatus maildir_check(struct Mailbox *m)
     return MX_STATUS_ERROR;
   }
 
+  struct MdEmailArray mda = ARRAY_HEAD_INITIALIZER;
+  int rc_events = -1;
+#ifdef USE_INOTIFY
+  /* If the Monitor has seen every change to the files, there's no need to
+   * scan the subdirectories.  Its events are read after the stat()s above. */
+  rc_events = maildir_check_events(m, &mda, &hash_touched);
+  if (rc_events == 0)
+    MonitorContextChanged = false;
+  else if (rc_events == -2)
+    changed = MMC_NEW_DIR | MMC_CUR_DIR;
+#endif
+
   /* determine which subdirectories need to be scanned */
-  if (mutt_file_stat_timespec_compare(&st_new, MUTT_STAT_MTIME, &mdata->mtime) > 0)
-    changed = MMC_NEW_DIR;
-  if (mutt_file_stat_timespec_compare(&st_cur, MUTT_STAT_MTIME, &mdata->mtime_cur) > 0)
+  if ((rc_events != 0) &&
+      (mutt_file_stat_timespec_compare(&st_new, MUTT_STAT_MTIME, &mdata->mtime) > 0))
+  {
+    changed |= MMC_NEW_DIR;
+  }
+  if ((rc_events != 0) &&
+      (mutt_file_stat_timespec_compare(&st_cur, MUTT_STAT_MTIME, &mdata->mtime_cur) > 0))
+  {
     changed |= MMC_CUR_DIR;
+  }
 
-  if (changed == MMC_NO_DIRS)
+  if ((changed == MMC_NO_DIRS) && !hash_touched)
   {
     buf_pool_release(&buf);
     return MX_STATUS_OK; /* nothing to do */
@@ -1245,7 +1323,6 @@ static enum MxStatus maildir_check(struct Mailbox *m)
 
   /* do a fast scan of just the filenames in
    * the subdirectories that have changed.  */
-  struct MdEmailArray mda = ARRAY_HEAD_INITIALIZER;
   if (changed & MMC_NEW_DIR)
     maildir_parse_dir(m, &mda, "new", NULL);
   if (changed & MMC_CUR_DIR)
@@ -1307,11 +1384,12 @@ static enum MxStatus maildir_check(struct Mailbox *m)
      * Check to see if we have enough information to know if the
      * message has disappeared out from underneath us.  */
     else if (((changed & MMC_NEW_DIR) && mutt_strn_equal(e->path, "new/", 4)) ||
-             ((changed & MMC_CUR_DIR) && mutt_strn_equal(e->path, "cur/", 4)))
+             ((changed & MMC_CUR_DIR) && mutt_strn_equal(e->path, "cur/", 4)) ||
+             (hash_touched && mutt_hash_find(hash_touched, buf_string(buf))))
     {
       /* This message disappeared, so we need to simulate a "reopen"
        * event.  We know it disappeared because we just scanned the
-       * subdirectory it used to reside in.  */
+       * subdirectory it used to reside in, or the Monitor saw it go.  */
       occult = true;
       e->deleted = true;
       e->purge = true;
@@ -1324,8 +1402,9 @@ static enum MxStatus maildir_check(struct Mailbox *m)
     }
   }
 
-  /* destroy the file name hash */
+  /* destroy the file name hashes */
   mutt_hash_free(&hash_names);
+  mutt_hash_free(&hash_touched);
 
   /* If we didn't just get new mail, update the tables. */
   if (occult)
@@ -1342,6 +1421,7 @@ static enum MxStatus maildir_check(struct Mailbox *m)
   {
     mailbox_changed(m, NT_MAILBOX_INVALID);
     m->changed = true;
+    body_index_update(m, m->msg_count - num_new);
   }
 
   buf_pool_release(&buf);
@@ -1369,23 +1449,11 @@ static enum MxStatus maildir_mbox_check(struct Mailbox *m)
  */
 static enum MxStatus maildir_mbox_check_stats(struct Mailbox *m, uint8_t flags)
 {
-  bool check_stats = flags & MUTT_MAILBOX_CHECK_FORCE_STATS;
-  bool check_new = true;
-
-  if (check_stats)
-  {
-    m->msg_new = 0;
-    m->msg_count = 0;
-    m->msg_unread = 0;
-    m->msg_flagged = 0;
-  }
-
-  maildir_check_dir(m, "new", check_new, check_stats);
-
-  const bool c_maildir_check_cur = cs_subset_bool(NeoMutt->sub, "maildir_check_cur");
-  check_new = !m->has_new && c_maildir_check_cur;
-  if (check_new || check_stats)
-    maildir_check_dir(m, "cur", check_new, check_stats);
+  struct MdCheckJob job = { 0 };
+  maildir_check_job_init(&job, m, flags & MUTT_MAILBOX_CHECK_FORCE_STATS);
+  maildir_check_job_run(&job);
+  maildir_check_job_apply(&job, m);
+  FREE(&job.path);
 
   return m->msg_new ? MX_STATUS_NEW_MAIL : MX_STATUS_OK;
 }
@@ -49,6 +49,7 @@
 #include "email/lib.h"
 #include "core/lib.h"
 #include "lib.h"
+#include "pattern/lib.h"
 #include "progress/lib.h"
 #include "copy.h"
 #include "edata.h"
@@ -57,6 +58,7 @@
 #include "mdata.h"
 #include "mdemail.h"
 #include "mx.h"
+#include "readahead.h"
 #include "sequence.h"
 #ifdef USE_INOTIFY
 #include "monitor.h"
@@ -515,7 +517,7 @@ static int mh_parse_dir(struct Mailbox *m, struct MdEmailArray *mda, struct Prog
 
     mutt_debug(LL_DEBUG2, "queueing %s\n", de->d_name);
 
-    e = email_new();
+    e = email_new_arena(mailbox_arena(m));
     e->edata = maildir_edata_new();
     e->edata_free = maildir_edata_free;
 
@@ -554,46 +556,32 @@ static int mh_sort_path(const void *a, const void *b)
 }
 
 /**
- * mh_parse_message - Actually parse an MH message
- * @param fname  Message filename
- * @param e      Email to populate (OPTIONAL)
- * @retval ptr Populated Email
- *
- * This may also be used to fill out a fake header structure generated by lazy
- * maildir parsing.
+ * mh_parse_read - Parse an MH message that has been read into memory
+ * @param mr Start of the message file
+ * @param e  Email to populate
+ * @retval true Success
  */
-static struct Email *mh_parse_message(const char *fname, struct Email *e)
+static bool mh_parse_read(const struct MdRead *mr, struct Email *e)
 {
-  FILE *fp = fopen(fname, "r");
-  if (!fp)
+  if (mr->err != 0)
   {
-    return NULL;
+    mutt_debug(LL_DEBUG1, "%s: %s (errno %d)\n", mr->path, strerror(mr->err), mr->err);
+    return false;
   }
 
-  const long size = mutt_file_get_size_fp(fp);
-  if (size == 0)
-  {
-    mutt_file_fclose(&fp);
-    return NULL;
-  }
+  if (mr->size == 0)
+    return false;
 
-  if (!e)
-  {
-    e = email_new();
-    e->edata = maildir_edata_new();
-    e->edata_free = maildir_edata_free;
-  }
-  e->env = mutt_rfc822_read_header(fp, e, false, false);
+  e->env = mutt_rfc822_read_header_mem(mr->data, mr->len, e, false, false);
 
   if (e->received != 0)
     e->received = e->date_sent;
 
   /* always update the length since we have fresh information available. */
-  e->body->length = size - e->body->offset;
+  e->body->length = mr->size - e->body->offset;
   e->index = -1;
 
-  mutt_file_fclose(&fp);
-  return e;
+  return true;
 }
 
 /**
@@ -601,15 +589,23 @@ static struct Email *mh_parse_message(const char *fname, struct Email *e)
  * @param[in]  m   Mailbox
  * @param[out] mda Maildir array to parse
  * @param[in]  progress Progress bar
+ *
+ * Emails that aren't in the header cache are read by a pool of threads, see
+ * $maildir_read_threads, then parsed here.
  */
 static void mh_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
                                struct Progress *progress)
 {
   char fn[PATH_MAX] = { 0 };
+  struct MdReadahead *ra = maildir_readahead_new();
+  struct MdEmailArray mda_read = ARRAY_HEAD_INITIALIZER;
+  size_t count = 0;
 
 #ifdef USE_HCACHE
   const char *const c_header_cache = cs_subset_path(NeoMutt->sub, "header_cache");
   struct HeaderCache *hc = hcache_open(c_header_cache, mailbox_path(m), NULL);
+  if (hc)
+    hc->arena = mailbox_arena(m);
 #endif
 
   struct MdEmail *md = NULL;
@@ -620,9 +616,6 @@ static void mh_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
     if (!md || !md->email || md->header_parsed)
       continue;
 
-    if (m->verbose && progress)
-      progress_update(progress, ARRAY_FOREACH_IDX, -1);
-
     snprintf(fn, sizeof(fn), "%s/%s", mailbox_path(m), md->email->path);
 
 #ifdef USE_HCACHE
@@ -640,6 +633,9 @@ static void mh_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
 
     if (hce.email && (rc == 0) && (st_lastchanged.st_mtime <= hce.uidvalidity))
     {
+      if (m->verbose && progress)
+        progress_update(progress, ++count, -1);
+
       hce.email->edata = maildir_edata_new();
       hce.email->edata_free = maildir_edata_free;
       hce.email->old = md->email->old;
@@ -650,22 +646,45 @@ static void mh_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
     else
 #endif
     {
-      if (mh_parse_message(fn, md->email))
-      {
-        md->header_parsed = true;
+      maildir_readahead_add(ra, fn);
+      ARRAY_ADD(&mda_read, md);
+    }
+  }
+
+  const short c_maildir_read_threads = cs_subset_number(NeoMutt->sub, "maildir_read_threads");
+  maildir_readahead_start(ra, c_maildir_read_threads);
 #ifdef USE_HCACHE
-        key = md->email->path;
-        keylen = strlen(key);
-        hcache_store(hc, key, keylen, md->email, 0);
+  hcache_begin_batch(hc);
+#endif
+
+  ARRAY_FOREACH(mdp, &mda_read)
+  {
+    md = *mdp;
+
+    if (m->verbose && progress)
+      progress_update(progress, ++count, -1);
+
+    const struct MdRead *mr = maildir_readahead_get(ra, ARRAY_FOREACH_IDX);
+    if (mh_parse_read(mr, md->email))
+    {
+      md->header_parsed = true;
+#ifdef USE_HCACHE
+      const char *key = md->email->path;
+      size_t keylen = strlen(key);
+      hcache_store(hc, key, keylen, md->email, 0);
 #endif
-      }
-      else
-      {
-        email_free(&md->email);
-      }
     }
+    else
+    {
+      email_free(&md->email);
+    }
+    maildir_readahead_release(ra, ARRAY_FOREACH_IDX);
   }
+
+  maildir_readahead_free(&ra);
+  ARRAY_FREE(&mda_read);
 #ifdef USE_HCACHE
+  hcache_commit_batch(hc);
   hcache_close(&hc);
 #endif
 
@@ -1007,6 +1026,7 @@ static enum MxStatus mh_check(struct Mailbox *m)
   {
     mailbox_changed(m, NT_MAILBOX_INVALID);
     m->changed = true;
+    body_index_update(m, m->msg_count - num_new);
   }
 
   ARRAY_FREE(&mda);
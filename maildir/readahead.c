@@ -0,0 +1,402 @@
+/**
+ * @file
+ * Read Maildir messages in the background
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page maildir_readahead Read Maildir messages in the background
+ *
+ * When a Maildir or MH mailbox is opened, every message that isn't in the
+ * header cache has to be opened and its header parsed.  On a cold cache, the
+ * time is dominated by waiting for the disk.
+ *
+ * The Readahead opens the files using a pool of worker threads and reads the
+ * start of each message into memory.  The caller parses the headers, in
+ * order, on the main thread.  The workers only do I/O; they never touch the
+ * Email, the config or the header cache.
+ *
+ * To limit memory use, the workers stay at most #READAHEAD_WINDOW files
+ * ahead of the caller.
+ *
+ * If $maildir_read_threads is 0, or threads aren't available, the files are
+ * read on demand by the caller.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "readahead.h"
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+/**
+ * struct MdReadahead - A pool of threads reading message files
+ */
+struct MdReadahead
+{
+  struct MdReadArray reads;   ///< Files to read
+  size_t next;                ///< Index of the next file to read
+  size_t consumed;            ///< Number of files released by the caller
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_t lock;       ///< Protects everything below and MdRead.done
+  pthread_cond_t cond_done;   ///< Signalled when a file has been read
+  pthread_cond_t cond_space;  ///< Signalled when the caller releases a file
+  pthread_t *threads;         ///< Worker threads
+  int num_threads;            ///< Number of worker threads
+  int num_idle;               ///< Number of workers waiting for cond_space
+  bool waiting;               ///< The caller is waiting for cond_done
+  bool stop;                  ///< Tell the workers to finish
+#endif
+};
+
+/**
+ * header_end - Find the end of a message header
+ * @param data  Message text
+ * @param len   Length of data
+ * @param start Offset to start searching from
+ * @retval true The blank line ending the header has been found
+ */
+static bool header_end(const char *data, size_t len, size_t start)
+{
+  if ((len > 0) && ((data[0] == '\n') || ((len > 1) && (data[0] == '\r') && (data[1] == '\n'))))
+    return true;
+
+  const char *end = data + len;
+  const char *p = data + start;
+  while ((p < end) && (p = memchr(p, '\n', end - p)))
+  {
+    p++;
+    if ((p < end) && (*p == '\n'))
+      return true;
+    if (((end - p) > 1) && (p[0] == '\r') && (p[1] == '\n'))
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * read_message - Read the start of a message file
+ * @param mr Message file to read
+ *
+ * At least the whole of the header will be read, unless there's an error.
+ *
+ * @note This is called from worker threads, so it mustn't log or use any
+ *       shared state.
+ */
+static void read_message(struct MdRead *mr)
+{
+  int fd = open(mr->path, O_RDONLY);
+  if (fd < 0)
+  {
+    mr->err = errno;
+    return;
+  }
+
+  struct stat st = { 0 };
+  if (fstat(fd, &st) != 0)
+  {
+    mr->err = errno;
+    close(fd);
+    return;
+  }
+  mr->size = st.st_size;
+
+  size_t alloc = 4096;
+  mr->data = mutt_mem_malloc(alloc);
+  mr->len = 0;
+
+  while (true)
+  {
+    if (mr->len == alloc)
+    {
+      alloc *= 2;
+      mutt_mem_realloc(&mr->data, alloc);
+    }
+
+    ssize_t rc = read(fd, mr->data + mr->len, alloc - mr->len);
+    if (rc < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      mr->err = errno;
+      FREE(&mr->data);
+      mr->len = 0;
+      break;
+    }
+    if (rc == 0)
+      break;
+
+    /* Search again from the end of the previous read (it may have split "\n\r\n") */
+    size_t start = (mr->len > 2) ? (mr->len - 2) : 0;
+    mr->len += rc;
+    if (header_end(mr->data, mr->len, start))
+      break;
+  }
+
+  close(fd);
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+/**
+ * readahead_worker - Read message files until there are none left
+ * @param arg Readahead
+ * @retval NULL Always
+ */
+static void *readahead_worker(void *arg)
+{
+  struct MdReadahead *ra = arg;
+
+  pthread_mutex_lock(&ra->lock);
+  while (!ra->stop && (ra->next < ARRAY_SIZE(&ra->reads)))
+  {
+    if (ra->next >= (ra->consumed + READAHEAD_WINDOW))
+    {
+      ra->num_idle++;
+      pthread_cond_wait(&ra->cond_space, &ra->lock);
+      ra->num_idle--;
+      continue;
+    }
+
+    struct MdRead *mr = ARRAY_GET(&ra->reads, ra->next);
+    ra->next++;
+    pthread_mutex_unlock(&ra->lock);
+
+    read_message(mr);
+
+    pthread_mutex_lock(&ra->lock);
+    mr->done = true;
+    if (ra->waiting)
+      pthread_cond_broadcast(&ra->cond_done);
+  }
+  pthread_mutex_unlock(&ra->lock);
+
+  return NULL;
+}
+#endif
+
+/**
+ * maildir_readahead_new - Create a new Readahead
+ * @retval ptr New Readahead
+ */
+struct MdReadahead *maildir_readahead_new(void)
+{
+  struct MdReadahead *ra = mutt_mem_calloc(1, sizeof(struct MdReadahead));
+  ARRAY_INIT(&ra->reads);
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_init(&ra->lock, NULL);
+  pthread_cond_init(&ra->cond_done, NULL);
+  pthread_cond_init(&ra->cond_space, NULL);
+#endif
+  return ra;
+}
+
+/**
+ * maildir_readahead_free - Free a Readahead
+ * @param ptr Readahead to free
+ *
+ * Any running workers are stopped.
+ */
+void maildir_readahead_free(struct MdReadahead **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct MdReadahead *ra = *ptr;
+
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_lock(&ra->lock);
+  ra->stop = true;
+  pthread_cond_broadcast(&ra->cond_space);
+  pthread_mutex_unlock(&ra->lock);
+
+  for (int i = 0; i < ra->num_threads; i++)
+    pthread_join(ra->threads[i], NULL);
+  FREE(&ra->threads);
+
+  pthread_cond_destroy(&ra->cond_space);
+  pthread_cond_destroy(&ra->cond_done);
+  pthread_mutex_destroy(&ra->lock);
+#endif
+
+  struct MdRead *mr = NULL;
+  ARRAY_FOREACH(mr, &ra->reads)
+  {
+    FREE(&mr->path);
+    FREE(&mr->data);
+  }
+  ARRAY_FREE(&ra->reads);
+
+  FREE(ptr);
+}
+
+/**
+ * maildir_readahead_add - Add a file to a Readahead
+ * @param ra   Readahead
+ * @param path Full path of the message file
+ *
+ * @note Files can only be added before maildir_readahead_start() is called.
+ */
+void maildir_readahead_add(struct MdReadahead *ra, const char *path)
+{
+  if (!ra || !path)
+    return;
+
+  struct MdRead mr = { 0 };
+  mr.path = mutt_str_dup(path);
+  ARRAY_ADD(&ra->reads, mr);
+}
+
+/**
+ * maildir_readahead_start - Start reading the files
+ * @param ra          Readahead
+ * @param num_threads Number of worker threads to use
+ *
+ * If no threads can be started, the files are read by
+ * maildir_readahead_get().
+ */
+void maildir_readahead_start(struct MdReadahead *ra, int num_threads)
+{
+  if (!ra)
+    return;
+
+#ifdef HAVE_PTHREAD_CREATE
+  num_threads = MIN(num_threads, (int) ARRAY_SIZE(&ra->reads));
+  if (num_threads <= 0)
+    return;
+
+  /* Signals must be handled by the main thread */
+  sigset_t all = { 0 };
+  sigset_t old = { 0 };
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+
+  ra->threads = mutt_mem_calloc(num_threads, sizeof(pthread_t));
+  for (int i = 0; i < num_threads; i++)
+  {
+    int rc = pthread_create(&ra->threads[ra->num_threads], NULL, readahead_worker, ra);
+    if (rc != 0)
+    {
+      mutt_debug(LL_DEBUG1, "pthread_create: %s (errno %d)\n", strerror(rc), rc);
+      break;
+    }
+    ra->num_threads++;
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  mutt_debug(LL_DEBUG2, "reading %zu files with %d threads\n",
+             ARRAY_SIZE(&ra->reads), ra->num_threads);
+#endif
+}
+
+/**
+ * maildir_readahead_get - Get a file that has been read
+ * @param ra  Readahead
+ * @param idx Index of the file
+ * @retval ptr  File contents
+ * @retval NULL Invalid index
+ *
+ * Wait until the file has been read.  If no worker has started reading it
+ * yet, it's read immediately.
+ *
+ * @note Files must be fetched and released in order.
+ */
+const struct MdRead *maildir_readahead_get(struct MdReadahead *ra, size_t idx)
+{
+  if (!ra)
+    return NULL;
+
+  struct MdRead *mr = ARRAY_GET(&ra->reads, idx);
+  if (!mr)
+    return NULL;
+
+#ifdef HAVE_PTHREAD_CREATE
+  if (ra->num_threads > 0)
+  {
+    pthread_mutex_lock(&ra->lock);
+    if (!mr->done && (ra->next == idx))
+    {
+      /* The workers have fallen behind, so read it ourselves */
+      ra->next++;
+      pthread_mutex_unlock(&ra->lock);
+      read_message(mr);
+      pthread_mutex_lock(&ra->lock);
+      mr->done = true;
+    }
+
+    while (!mr->done)
+    {
+      ra->waiting = true;
+      pthread_cond_wait(&ra->cond_done, &ra->lock);
+      ra->waiting = false;
+    }
+    pthread_mutex_unlock(&ra->lock);
+
+    return mr;
+  }
+#endif
+
+  if (!mr->done)
+  {
+    read_message(mr);
+    mr->done = true;
+  }
+
+  return mr;
+}
+
+/**
+ * maildir_readahead_release - Release a file that has been read
+ * @param ra  Readahead
+ * @param idx Index of the file
+ *
+ * The file's data is freed, allowing the workers to read further ahead.
+ */
+void maildir_readahead_release(struct MdReadahead *ra, size_t idx)
+{
+  if (!ra)
+    return;
+
+  struct MdRead *mr = ARRAY_GET(&ra->reads, idx);
+  if (!mr)
+    return;
+
+  FREE(&mr->data);
+  mr->len = 0;
+
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_lock(&ra->lock);
+  ra->consumed = idx + 1;
+  /* Wake the workers in batches, rather than for every file */
+  if ((ra->num_idle > 0) && (ra->next <= (ra->consumed + (READAHEAD_WINDOW / 2))))
+    pthread_cond_broadcast(&ra->cond_space);
+  pthread_mutex_unlock(&ra->lock);
+#else
+  ra->consumed = idx + 1;
+#endif
+}
@@ -0,0 +1,56 @@
+/**
+ * @file
+ * Read Maildir messages in the background
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MAILDIR_READAHEAD_H
+#define MUTT_MAILDIR_READAHEAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+
+/// Maximum number of files read, but not yet released by the caller
+#define READAHEAD_WINDOW 256
+
+/**
+ * struct MdRead - The start of a message file, read into memory
+ */
+struct MdRead
+{
+  char *path;       ///< Full path of the message file
+  char *data;       ///< Start of the message, including the whole header
+  size_t len;       ///< Length of data
+  LOFF_T size;      ///< Size of the message file
+  int err;          ///< errno, if the file couldn't be read
+  bool done;        ///< The file has been read
+};
+ARRAY_HEAD(MdReadArray, struct MdRead);
+
+struct MdReadahead;
+
+void                 maildir_readahead_add    (struct MdReadahead *ra, const char *path);
+void                 maildir_readahead_free   (struct MdReadahead **ptr);
+const struct MdRead *maildir_readahead_get    (struct MdReadahead *ra, size_t idx);
+struct MdReadahead * maildir_readahead_new    (void);
+void                 maildir_readahead_release(struct MdReadahead *ra, size_t idx);
+void                 maildir_readahead_start  (struct MdReadahead *ra, int num_threads);
+
+#endif /* MUTT_MAILDIR_READAHEAD_H */
@@ -1403,6 +1403,7 @@ main_exit:
   buf_pool_cleanup();
   envlist_free(&EnvList);
   mutt_browser_cleanup();
+  mutt_mailbox_cleanup();
   external_cleanup();
   menu_cleanup();
   crypt_cleanup();
@@ -1414,6 +1415,7 @@ main_exit:
   mutt_keys_cleanup();
   mutt_prex_cleanup();
   config_cache_cleanup();
+  config_handle_cleanup();
   neomutt_free(&NeoMutt);
   cs_free(&cs);
   log_queue_flush(log_disp_terminal);
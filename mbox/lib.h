@@ -30,6 +30,7 @@
  * | :------------ | :------------------- |
  * | mbox/config.c | @subpage mbox_config |
  * | mbox/mbox.c   | @subpage mbox_mbox   |
+ * | mbox/status.c | @subpage mbox_status |
  */
 
 #ifndef MUTT_MBOX_LIB_H
@@ -40,6 +41,7 @@
 #include <time.h>
 #include "core/lib.h"
 
+struct Email;
 struct stat;
 
 /**
@@ -62,6 +64,7 @@ extern const struct MxOps MxMmdfOps;
 #define MMDF_SEP "\001\001\001\001\n"
 
 enum MxStatus    mbox_check(struct Mailbox *m, struct stat *st, bool check_stats);
+int              mbox_patch_status(struct Mailbox *m, struct Email *e);
 enum MailboxType mbox_path_probe(const char *path, const struct stat *st);
 void             mbox_reset_atime(struct Mailbox *m, struct stat *st);
 
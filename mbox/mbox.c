@@ -41,6 +41,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
@@ -51,6 +52,7 @@
 #include "core/lib.h"
 #include "mutt.h"
 #include "lib.h"
+#include "pattern/lib.h"
 #include "progress/lib.h"
 #include "copy.h"
 #include "globals.h" // IWYU pragma: keep
@@ -59,6 +61,9 @@
 #include "muttlib.h"
 #include "mx.h"
 #include "protos.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
 
 /**
  * struct MUpdate - Store of new offsets, used by mutt_sync_mailbox()
@@ -174,6 +179,246 @@ static void mbox_unlock_mailbox(struct Mailbox *m)
   }
 }
 
+#ifdef USE_HCACHE
+/**
+ * mbox_hcache_open - Open the header cache for an mbox/mmdf Mailbox
+ * @param m Mailbox
+ * @retval ptr  Header cache
+ * @retval NULL Header caching is disabled
+ */
+static struct HeaderCache *mbox_hcache_open(struct Mailbox *m)
+{
+  const char *const c_header_cache = cs_subset_path(NeoMutt->sub, "header_cache");
+  struct HeaderCache *hc = hcache_open(c_header_cache, mailbox_path(m), NULL);
+  if (hc)
+    hc->arena = mailbox_arena(m);
+  return hc;
+}
+
+/**
+ * mbox_hcache_key - Create a header cache key for a message
+ * @param offset Offset of the message in the mailbox
+ * @param buf    Buffer for the key
+ * @param buflen Length of the buffer
+ * @retval num Length of the key
+ *
+ * Messages in an mbox are identified by the byte offset of their separator.
+ */
+static size_t mbox_hcache_key(LOFF_T offset, char *buf, size_t buflen)
+{
+  return snprintf(buf, buflen, "/%" PRId64, (int64_t) offset);
+}
+
+/**
+ * mbox_hcache_fingerprint - Create a fingerprint of a message's first line
+ * @param line "From " line (mbox), or first line after the separator (mmdf)
+ * @retval num Fingerprint (never 0)
+ */
+static uint32_t mbox_hcache_fingerprint(const char *line)
+{
+  union
+  {
+    unsigned char charval[16]; ///< MD5 digest as a string
+    uint32_t intval;           ///< MD5 digest as an integer
+  } digest;
+
+  mutt_md5(line, digest.charval);
+  return (digest.intval != 0) ? digest.intval : 1;
+}
+
+/**
+ * mbox_hcache_valid_size - How much of the Mailbox is described by the cache?
+ * @param m  Mailbox
+ * @param hc Header cache
+ * @retval num Length of the unchanged prefix of the Mailbox file
+ *
+ * The cache records the size and mtime of the file when it was last read.
+ * This uses the same heuristics as mbox_mbox_check(): if the file still has
+ * the same size and mtime it is unchanged; if it has grown and there's a
+ * message separator exactly where it used to end, mail has been appended.
+ */
+static LOFF_T mbox_hcache_valid_size(struct Mailbox *m, struct HeaderCache *hc)
+{
+  struct MboxAccountData *adata = m->account->adata;
+  int64_t size = 0;
+  struct timespec mtime = { 0 };
+
+  if (!hcache_fetch_obj(hc, "/MBOXSIZE", 9, &size) ||
+      !hcache_fetch_obj(hc, "/MBOXMTIME", 10, &mtime))
+  {
+    return 0;
+  }
+
+  if ((size <= 0) || (size > m->size))
+    return 0;
+
+  if (size == m->size)
+    return (mutt_file_timespec_compare(&mtime, &adata->mtime) == 0) ? size : 0;
+
+  LOFF_T pos = ftello(adata->fp);
+  if (pos < 0)
+    return 0;
+
+  char buf[1024] = { 0 };
+  bool valid = mutt_file_seek(adata->fp, size, SEEK_SET) &&
+               fgets(buf, sizeof(buf), adata->fp) &&
+               (((m->type == MUTT_MBOX) && mutt_str_startswith(buf, "From ")) ||
+                ((m->type == MUTT_MMDF) && mutt_str_equal(buf, MMDF_SEP)));
+
+  if (!mutt_file_seek(adata->fp, pos, SEEK_SET))
+    return 0;
+
+  return valid ? size : 0;
+}
+
+/**
+ * mbox_hcache_save_size - Record how much of the Mailbox is in the cache
+ * @param hc    Header cache
+ * @param size  Size of the Mailbox file
+ * @param mtime Modification time of the Mailbox file
+ */
+static void mbox_hcache_save_size(struct HeaderCache *hc, LOFF_T size,
+                                  struct timespec *mtime)
+{
+  int64_t size64 = size;
+  hcache_store_raw(hc, "/MBOXSIZE", 9, &size64, sizeof(size64));
+  hcache_store_raw(hc, "/MBOXMTIME", 10, mtime, sizeof(*mtime));
+}
+
+/**
+ * mbox_hcache_lookup - Look up a message in the header cache
+ * @param hc          Header cache
+ * @param loc         Offset of the message
+ * @param pos         Offset of the line following the message separator
+ * @param fingerprint Fingerprint of the message's first line
+ * @retval ptr  Email restored from the cache
+ * @retval NULL Cache miss
+ *
+ * The caller must still check that the message ends on a message separator.
+ */
+static struct Email *mbox_hcache_lookup(struct HeaderCache *hc, LOFF_T loc,
+                                        LOFF_T pos, uint32_t fingerprint)
+{
+  char key[32] = { 0 };
+  size_t keylen = mbox_hcache_key(loc, key, sizeof(key));
+  struct HCacheEntry hce = hcache_fetch(hc, key, keylen, fingerprint);
+  struct Email *e = hce.email;
+  if (!e)
+    return NULL;
+
+  if ((e->offset != loc) || (e->body->length < 0) || (e->body->offset < pos))
+    email_free(&e);
+
+  return e;
+}
+
+/**
+ * mbox_hcache_fetch - Restore a message from the header cache
+ * @param m           Mailbox
+ * @param hc          Header cache
+ * @param loc         Offset of the message
+ * @param valid_size  Length of the unchanged prefix of the Mailbox file
+ * @param fingerprint Fingerprint of the message's first line
+ * @retval ptr  Email restored from the cache
+ * @retval NULL Cache miss, the file position is unchanged
+ *
+ * The cached Email is only used if it lies within the unchanged part of the
+ * file and its length still ends on a message separator (or at the end of
+ * the file).  On success the file is positioned where the parser expects the
+ * next message.
+ */
+static struct Email *mbox_hcache_fetch(struct Mailbox *m, struct HeaderCache *hc,
+                                       LOFF_T loc, LOFF_T valid_size, uint32_t fingerprint)
+{
+  if (loc >= valid_size)
+    return NULL;
+
+  struct MboxAccountData *adata = m->account->adata;
+  char buf[1024] = { 0 };
+
+  LOFF_T pos = ftello(adata->fp);
+  if (pos < 0)
+    return NULL;
+
+  struct Email *e = mbox_hcache_lookup(hc, loc, pos, fingerprint);
+  if (!e)
+    return NULL;
+
+  LOFF_T end = e->body->offset + e->body->length;
+  if (m->type == MUTT_MBOX)
+  {
+    /* The next separator follows the blank line that ends the message */
+    end++;
+    if (end > valid_size)
+      goto miss;
+    if (end < m->size)
+    {
+      if (!mutt_file_seek(adata->fp, end, SEEK_SET) ||
+          !fgets(buf, sizeof(buf), adata->fp) || !mutt_str_startswith(buf, "From "))
+      {
+        goto miss;
+      }
+    }
+    if (!mutt_file_seek(adata->fp, end, SEEK_SET))
+      goto miss;
+  }
+  else
+  {
+    /* Consume the separator that closes the message */
+    if ((end >= valid_size) || !mutt_file_seek(adata->fp, end, SEEK_SET) ||
+        !fgets(buf, sizeof(buf), adata->fp) || !mutt_str_equal(buf, MMDF_SEP))
+    {
+      goto miss;
+    }
+  }
+
+  return e;
+
+miss:
+  email_free(&e);
+  (void) mutt_file_seek(adata->fp, pos, SEEK_SET);
+  return NULL;
+}
+
+/**
+ * mbox_hcache_store - Save a message to the header cache
+ * @param hc          Header cache
+ * @param e           Email to save
+ * @param fingerprint Fingerprint of the message's first line
+ */
+static void mbox_hcache_store(struct HeaderCache *hc, struct Email *e, uint32_t fingerprint)
+{
+  if (!hc || !e)
+    return;
+
+  char key[32] = { 0 };
+  size_t keylen = mbox_hcache_key(e->offset, key, sizeof(key));
+  hcache_store(hc, key, keylen, e, fingerprint);
+}
+
+/**
+ * mbox_hcache_update - Refresh the cached copy of a message
+ * @param m  Mailbox
+ * @param hc Header cache
+ * @param e  Email whose flags have been changed in place
+ *
+ * The message hasn't moved, so it's stored under the same key and
+ * fingerprint that the parser will look for.
+ */
+static void mbox_hcache_update(struct Mailbox *m, struct HeaderCache *hc, struct Email *e)
+{
+  struct MboxAccountData *adata = m->account->adata;
+  char buf[8192] = { 0 };
+
+  /* Read as much of the line as the parsers do */
+  const int buflen = (m->type == MUTT_MMDF) ? sizeof(buf) - 1 : sizeof(buf);
+  if (!mutt_file_seek(adata->fp, e->offset, SEEK_SET) || !fgets(buf, buflen, adata->fp))
+    return;
+
+  mbox_hcache_store(hc, e, mbox_hcache_fingerprint(buf));
+}
+#endif
+
 /**
  * mmdf_parse_mailbox - Read a mailbox in MMDF format
  * @param m Mailbox
@@ -198,6 +443,11 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
   struct stat st = { 0 };
   struct Progress *progress = NULL;
   enum MxOpenReturns rc = MX_OPEN_ERROR;
+#ifdef USE_HCACHE
+  struct HeaderCache *hc = NULL;
+  LOFF_T valid_size = 0;
+  uint32_t fingerprint = 0;
+#endif
 
   if (stat(mailbox_path(m), &st) == -1)
   {
@@ -217,6 +467,13 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
     progress = progress_new(msg, MUTT_PROGRESS_READ, 0);
   }
 
+#ifdef USE_HCACHE
+  hc = mbox_hcache_open(m);
+  if (hc)
+    valid_size = mbox_hcache_valid_size(m, hc);
+  hcache_begin_batch(hc);
+#endif
+
   while (true)
   {
     if (!fgets(buf, sizeof(buf) - 1, adata->fp))
@@ -236,7 +493,7 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
         progress_update(progress, count, (int) (loc / (m->size / 100 + 1)));
 
       mx_alloc_memory(m, m->msg_count);
-      e = email_new();
+      e = email_new_arena(mailbox_arena(m));
       m->emails[m->msg_count] = e;
       e->offset = loc;
       e->index = m->msg_count;
@@ -248,6 +505,23 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
         break;
       }
 
+#ifdef USE_HCACHE
+      if (hc)
+      {
+        fingerprint = mbox_hcache_fingerprint(buf);
+        struct Email *e_cache = mbox_hcache_fetch(m, hc, loc, valid_size, fingerprint);
+        if (e_cache)
+        {
+          email_free(&e);
+          e = e_cache;
+          e->index = m->msg_count;
+          m->emails[m->msg_count] = e;
+          m->msg_count++;
+          continue;
+        }
+      }
+#endif
+
       return_path[0] = '\0';
 
       if (!is_from(buf, return_path, sizeof(return_path), &t))
@@ -315,6 +589,9 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
       if (TAILQ_EMPTY(&e->env->from))
         mutt_addrlist_copy(&e->env->from, &e->env->return_path, false);
 
+#ifdef USE_HCACHE
+      mbox_hcache_store(hc, e, fingerprint);
+#endif
       m->msg_count++;
     }
     else
@@ -332,12 +609,270 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
     goto fail;
   }
 
+#ifdef USE_HCACHE
+  if (hc)
+    mbox_hcache_save_size(hc, m->size, &adata->mtime);
+#endif
+
   rc = MX_OPEN_OK;
 fail:
+#ifdef USE_HCACHE
+  hcache_commit_batch(hc);
+  hcache_close(&hc);
+#endif
   progress_free(&progress);
   return rc;
 }
 
+/**
+ * mbox_map_next_from - Find the next message separator in a mapped mbox file
+ * @param[in]  map         Mapped file
+ * @param[in]  size        Size of the mapped file
+ * @param[in]  pos         Offset of the start of a line
+ * @param[out] buf         Buffer for the separator line
+ * @param[in]  buflen      Length of buf
+ * @param[out] return_path Buffer for the sender's address
+ * @param[in]  pathlen     Length of return_path
+ * @param[out] tp          Time from the separator
+ * @retval num Offset of the separator
+ * @retval -1  No more separators
+ *
+ * Only lines starting with "From " are copied out and checked with is_from(),
+ * the rest of the file is skipped using memchr().
+ */
+static LOFF_T mbox_map_next_from(const char *map, LOFF_T size, LOFF_T pos,
+                                 char *buf, size_t buflen, char *return_path,
+                                 size_t pathlen, time_t *tp)
+{
+  while (pos < size)
+  {
+    const char *line = map + pos;
+    const char *nl = memchr(line, '\n', size - pos);
+
+    if (((size - pos) >= 5) && (memcmp(line, "From ", 5) == 0))
+    {
+      size_t len = nl ? (nl - line + 1) : (size - pos);
+      len = MIN(len, buflen - 1);
+      memcpy(buf, line, len);
+      buf[len] = '\0';
+      if (is_from(buf, return_path, pathlen, tp))
+        return pos;
+    }
+
+    if (!nl)
+      break;
+    pos = nl - map + 1;
+  }
+
+  return -1;
+}
+
+/**
+ * mbox_map_count_lines - Count the lines in part of a mapped mbox file
+ * @param data Start of the text
+ * @param len  Length of the text
+ * @retval num Number of newline characters
+ */
+static int mbox_map_count_lines(const char *data, size_t len)
+{
+  const char *end = data + len;
+  int lines = 0;
+
+  while ((data < end) && (data = memchr(data, '\n', end - data)))
+  {
+    lines++;
+    data++;
+  }
+
+  return lines;
+}
+
+/**
+ * mbox_parse_mapped - Read a memory-mapped mailbox in mbox format
+ * @param m          Mailbox
+ * @param map        Mapped file, m->size bytes long
+ * @param loc        Offset at which to start parsing
+ * @param progress   Progress bar (optional)
+ * @param hc         Header cache (optional)
+ * @param valid_size Length of the part of the file covered by the cache
+ * @retval enum #MxOpenReturns
+ *
+ * This is equivalent to the stdio loop in mbox_parse_mailbox(), but the
+ * separators are found by scanning the mapped file and the headers are parsed
+ * in place, without copying.
+ */
+static enum MxOpenReturns mbox_parse_mapped(struct Mailbox *m, const char *map,
+                                            LOFF_T loc, struct Progress *progress,
+                                            struct HeaderCache *hc, LOFF_T valid_size)
+{
+  const LOFF_T size = m->size;
+  char buf[8192], return_path[256];
+  struct Email *e_cur = NULL;
+  time_t t = 0;
+  int count = 0, lines = 0;
+  LOFF_T pos = loc;
+#ifdef USE_HCACHE
+  struct Email *e_pending = NULL; /* parsed, but not yet in the cache */
+  uint32_t fingerprint = 0;
+  uint32_t pending_fingerprint = 0;
+#endif
+
+  while (!SigInt)
+  {
+    loc = mbox_map_next_from(map, size, pos, buf, sizeof(buf), return_path,
+                             sizeof(return_path), &t);
+    lines += mbox_map_count_lines(map + pos, ((loc < 0) ? size : loc) - pos);
+    if (loc < 0)
+      break;
+
+    /* Save the Content-Length of the previous message */
+    if (count > 0)
+    {
+      struct Email *e = m->emails[m->msg_count - 1];
+      if (e->body->length < 0)
+      {
+        e->body->length = loc - e->body->offset - 1;
+        if (e->body->length < 0)
+          e->body->length = 0;
+      }
+      if (e->lines == 0)
+        e->lines = lines ? lines - 1 : 0;
+    }
+
+#ifdef USE_HCACHE
+    /* The previous message's length is now known, so it can be cached */
+    mbox_hcache_store(hc, e_pending, pending_fingerprint);
+    e_pending = NULL;
+#endif
+
+    count++;
+    lines = 0;
+    pos = loc + mutt_str_len(buf);
+
+    if (m->verbose)
+      progress_update(progress, count, (int) (pos / (size / 100 + 1)));
+
+    mx_alloc_memory(m, m->msg_count);
+
+#ifdef USE_HCACHE
+    if (hc)
+      fingerprint = mbox_hcache_fingerprint(buf);
+    if (hc && (loc < valid_size))
+    {
+      e_cur = mbox_hcache_lookup(hc, loc, pos, fingerprint);
+      if (e_cur)
+      {
+        /* The next separator follows the blank line that ends the message */
+        LOFF_T end = e_cur->body->offset + e_cur->body->length + 1;
+        if ((end <= valid_size) &&
+            ((end >= size) || (((size - end) >= 5) && (memcmp(map + end, "From ", 5) == 0))))
+        {
+          e_cur->index = m->msg_count;
+          m->emails[m->msg_count] = e_cur;
+          m->msg_count++;
+          pos = MIN(end, size);
+          continue;
+        }
+        email_free(&e_cur);
+      }
+    }
+#endif
+
+    m->emails[m->msg_count] = email_new_arena(mailbox_arena(m));
+    e_cur = m->emails[m->msg_count];
+    e_cur->received = t - mutt_date_local_tz(t);
+    e_cur->offset = loc;
+    e_cur->index = m->msg_count;
+
+    e_cur->env = mutt_rfc822_read_header_mem(map + loc, size - loc, e_cur, false, false);
+    pos = e_cur->body->offset;
+
+    /* if we know how long this message is, either just skip over the body,
+     * or if we don't know how many lines there are, count them now (this will
+     * save time by not having to search for the next message marker).  */
+    if (e_cur->body->length > 0)
+    {
+      /* The test below avoids a potential integer overflow if the
+       * content-length is huge (thus necessarily invalid).  */
+      LOFF_T tmploc = (e_cur->body->length < size) ? (pos + e_cur->body->length + 1) : -1;
+
+      if ((tmploc > 0) && (tmploc < size))
+      {
+        /* check to see if the content-length looks valid.  we expect to
+         * to see a valid message separator at this point in the stream */
+        if (((size - tmploc) < 5) || (memcmp(map + tmploc, "From ", 5) != 0))
+        {
+          mutt_debug(LL_DEBUG1, "bad content-length in message %d (cl=" OFF_T_FMT ")\n",
+                     e_cur->index, e_cur->body->length);
+          e_cur->body->length = -1;
+        }
+      }
+      else if (tmploc != size)
+      {
+        /* content-length would put us past the end of the file, so it
+         * must be wrong */
+        e_cur->body->length = -1;
+      }
+
+      if (e_cur->body->length != -1)
+      {
+        /* good content-length.  check to see if we know how many lines
+         * are in this message.  */
+        if (e_cur->lines == 0)
+          e_cur->lines = mbox_map_count_lines(map + pos, e_cur->body->length);
+
+        /* skip to the offset of the next message separator */
+        pos = tmploc;
+      }
+    }
+
+    m->msg_count++;
+
+    if (TAILQ_EMPTY(&e_cur->env->return_path) && return_path[0])
+    {
+      mutt_addrlist_parse(&e_cur->env->return_path, return_path);
+    }
+
+    if (TAILQ_EMPTY(&e_cur->env->from))
+      mutt_addrlist_copy(&e_cur->env->from, &e_cur->env->return_path, false);
+
+#ifdef USE_HCACHE
+    e_pending = e_cur;
+    pending_fingerprint = fingerprint;
+#endif
+  }
+
+  /* Only set the content-length of the previous message if we have read more
+   * than one message during _this_ invocation.  If this routine is called
+   * when new mail is received, we need to make sure not to clobber what
+   * previously was the last message since the headers may be sorted.  */
+  if (count > 0)
+  {
+    struct Email *e = m->emails[m->msg_count - 1];
+    if (e->body->length < 0)
+    {
+      e->body->length = size - e->body->offset - 1;
+      if (e->body->length < 0)
+        e->body->length = 0;
+    }
+
+    if (e->lines == 0)
+      e->lines = lines ? lines - 1 : 0;
+  }
+
+  if (SigInt)
+  {
+    SigInt = false;
+    return MX_OPEN_ABORT; /* action aborted */
+  }
+
+#ifdef USE_HCACHE
+  mbox_hcache_store(hc, e_pending, pending_fingerprint);
+#endif
+
+  return MX_OPEN_OK;
+}
+
 /**
  * mbox_parse_mailbox - Read a mailbox from disk
  * @param m Mailbox
@@ -366,6 +901,13 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
   LOFF_T loc;
   struct Progress *progress = NULL;
   enum MxOpenReturns rc = MX_OPEN_ERROR;
+  struct HeaderCache *hc = NULL;
+  LOFF_T valid_size = 0;
+#ifdef USE_HCACHE
+  struct Email *e_pending = NULL; /* parsed, but not yet in the cache */
+  uint32_t fingerprint = 0;
+  uint32_t pending_fingerprint = 0;
+#endif
 
   /* Save information about the folder at the time we opened it. */
   if (stat(mailbox_path(m), &st) == -1)
@@ -395,6 +937,30 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
     loc = 0;
   }
 
+#ifdef USE_HCACHE
+  hc = mbox_hcache_open(m);
+  if (hc)
+    valid_size = mbox_hcache_valid_size(m, hc);
+  hcache_begin_batch(hc);
+#endif
+
+  /* Prefer scanning the file in memory; fall back to stdio if it can't be mapped */
+  if ((loc < m->size) && ((size_t) m->size == m->size))
+  {
+    void *map = mmap(NULL, m->size, PROT_READ, MAP_PRIVATE, fileno(adata->fp), 0);
+    if (map != MAP_FAILED)
+    {
+      posix_madvise(map, m->size, POSIX_MADV_SEQUENTIAL);
+      rc = mbox_parse_mapped(m, map, loc, progress, hc, valid_size);
+      munmap(map, m->size);
+      (void) mutt_file_seek(adata->fp, m->size, SEEK_SET);
+      if (rc != MX_OPEN_OK)
+        goto fail;
+      goto done;
+    }
+    mutt_debug(LL_DEBUG1, "mmap: %s (errno %d)\n", strerror(errno), errno);
+  }
+
   while ((fgets(buf, sizeof(buf), adata->fp)) && !SigInt)
   {
     if (is_from(buf, return_path, sizeof(return_path), &t))
@@ -413,6 +979,12 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
           e->lines = lines ? lines - 1 : 0;
       }
 
+#ifdef USE_HCACHE
+      /* The previous message's length is now known, so it can be cached */
+      mbox_hcache_store(hc, e_pending, pending_fingerprint);
+      e_pending = NULL;
+#endif
+
       count++;
 
       if (m->verbose)
@@ -422,7 +994,24 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
 
       mx_alloc_memory(m, m->msg_count);
 
-      m->emails[m->msg_count] = email_new();
+#ifdef USE_HCACHE
+      if (hc)
+      {
+        fingerprint = mbox_hcache_fingerprint(buf);
+        e_cur = mbox_hcache_fetch(m, hc, loc, valid_size, fingerprint);
+        if (e_cur)
+        {
+          e_cur->index = m->msg_count;
+          m->emails[m->msg_count] = e_cur;
+          m->msg_count++;
+          lines = 0;
+          loc = ftello(adata->fp);
+          continue;
+        }
+      }
+#endif
+
+      m->emails[m->msg_count] = email_new_arena(mailbox_arena(m));
       e_cur = m->emails[m->msg_count];
       e_cur->received = t - mutt_date_local_tz(t);
       e_cur->offset = loc;
@@ -502,6 +1091,10 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
       if (TAILQ_EMPTY(&e_cur->env->from))
         mutt_addrlist_copy(&e_cur->env->from, &e_cur->env->return_path, false);
 
+#ifdef USE_HCACHE
+      e_pending = e_cur;
+      pending_fingerprint = fingerprint;
+#endif
       lines = 0;
     }
     else
@@ -537,8 +1130,22 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
     goto fail; /* action aborted */
   }
 
+#ifdef USE_HCACHE
+  mbox_hcache_store(hc, e_pending, pending_fingerprint);
+#endif
+
+done:
+#ifdef USE_HCACHE
+  if (hc)
+    mbox_hcache_save_size(hc, m->size, &adata->mtime);
+#endif
+
   rc = MX_OPEN_OK;
 fail:
+#ifdef USE_HCACHE
+  hcache_commit_batch(hc);
+  hcache_close(&hc);
+#endif
   progress_free(&progress);
   return rc;
 }
@@ -1019,6 +1626,8 @@ static enum MxStatus mbox_mbox_check(struct Mailbox *m)
             mutt_sig_unblock();
           }
 
+          body_index_update(m, old_msg_count);
+
           return MX_STATUS_NEW_MAIL; /* signal that new mail arrived */
         }
         else
@@ -1062,6 +1671,53 @@ error:
   return MX_STATUS_ERROR;
 }
 
+/**
+ * mbox_copy_back - Copy the rewritten messages into the Mailbox
+ * @param fp_in  Temporary file of rewritten messages
+ * @param fp_out Mailbox file, positioned where the copy should start
+ * @retval  0 Success
+ * @retval -1 Error
+ *
+ * If possible, let the kernel copy the data with copy_file_range().
+ * If the files are on different filesystems, fall back to a buffered copy.
+ */
+static int mbox_copy_back(FILE *fp_in, FILE *fp_out)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+  if (fflush(fp_out) != 0)
+    return -1;
+
+  off_t off_in = ftello(fp_in);
+  off_t off_out = ftello(fp_out);
+  if ((off_in < 0) || (off_out < 0))
+    return -1;
+
+  while (true)
+  {
+    ssize_t rc = copy_file_range(fileno(fp_in), &off_in, fileno(fp_out),
+                                 &off_out, 1 << 30, 0);
+    if (rc > 0)
+      continue;
+    if (rc == 0)
+      return mutt_file_seek(fp_out, off_out, SEEK_SET) ? 0 : -1;
+    if (errno == EINTR)
+      continue;
+    if ((errno != EXDEV) && (errno != ENOSYS) && (errno != EINVAL) &&
+        (errno != EOPNOTSUPP))
+    {
+      return -1;
+    }
+    break;
+  }
+
+  mutt_debug(LL_DEBUG2, "copy_file_range() failed, errno %d\n", errno);
+  if (!mutt_file_seek(fp_in, off_in, SEEK_SET) || !mutt_file_seek(fp_out, off_out, SEEK_SET))
+    return -1;
+#endif
+
+  return (mutt_file_copy_stream(fp_in, fp_out) < 0) ? -1 : 0;
+}
+
 /**
  * mbox_mbox_sync - Save changes to the Mailbox - Implements MxOps::mbox_sync() - @ingroup mx_mbox_sync
  */
@@ -1077,6 +1733,7 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
   bool unlink_tempfile = false;
   bool need_sort = false; /* flag to resort mailbox if new mail arrives */
   int first = -1;         /* first message to be written */
+  int first_patched = -1; /* first message to be updated in place */
   LOFF_T offset;          /* location in mailbox to write changed messages */
   struct stat st = { 0 };
   struct MUpdate *new_offset = NULL;
@@ -1130,22 +1787,6 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
     goto fatal;
   }
 
-  /* Create a temporary file to write the new version of the mailbox in. */
-  tempfile = buf_pool_get();
-  buf_mktemp(tempfile);
-  int fd = open(buf_string(tempfile), O_WRONLY | O_EXCL | O_CREAT, 0600);
-  if ((fd == -1) || !(fp = fdopen(fd, "w")))
-  {
-    if (fd != -1)
-    {
-      close(fd);
-      unlink_tempfile = true;
-    }
-    mutt_error(_("Could not create temporary file"));
-    goto bail;
-  }
-  unlink_tempfile = true;
-
   /* find the first deleted/changed message.  we save a lot of time by only
    * rewriting the mailbox from the point where it has actually changed.  */
   int i = 0;
@@ -1163,8 +1804,65 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
     mutt_debug(LL_DEBUG1, "no modified messages\n");
     goto bail;
   }
+  first_patched = i;
+
+  /* Save the state of this folder. */
+  if (stat(mailbox_path(m), &st) == -1)
+  {
+    mutt_perror(mailbox_path(m));
+    goto bail;
+  }
+
+  /* messages whose flags are all that changed can be updated in place.
+   * only the rest of the mailbox, from the first message that can't, needs
+   * to be rewritten.  */
+  for (; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e->deleted && !e->changed && !e->attach_del)
+      continue;
+
+    const int rc_patch = mbox_patch_status(m, e);
+    if (rc_patch == 0)
+      break;
+    if (rc_patch < 0)
+    {
+      mutt_perror(mailbox_path(m));
+      goto bail;
+    }
+  }
+  if (fflush(adata->fp) != 0)
+  {
+    mutt_perror(mailbox_path(m));
+    goto bail;
+  }
+
+  if (i == m->msg_count)
+  {
+    mutt_debug(LL_DEBUG2, "updated the flags of %s in place\n", mailbox_path(m));
+    mbox_unlock_mailbox(m);
+    mbox_reset_atime(m, &st);
+    offset = m->size;
+    goto done;
+  }
 
-  /* save the index of the first changed/deleted message */
+  /* Create a temporary file to write the new version of the mailbox in. */
+  tempfile = buf_pool_get();
+  buf_mktemp(tempfile);
+  int fd = open(buf_string(tempfile), O_WRONLY | O_EXCL | O_CREAT, 0600);
+  if ((fd == -1) || !(fp = fdopen(fd, "w")))
+  {
+    if (fd != -1)
+    {
+      close(fd);
+      unlink_tempfile = true;
+    }
+    mutt_error(_("Could not create temporary file"));
+    goto bail;
+  }
+  unlink_tempfile = true;
+
+  /* save the index of the first message to be rewritten */
   first = i;
   /* where to start overwriting */
   offset = m->emails[i]->offset;
@@ -1218,7 +1916,7 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
 
       struct Message *msg = mx_msg_open(m, m->emails[i]);
       const int rc2 = mutt_copy_message(fp, m->emails[i], msg, MUTT_CM_UPDATE,
-                                        CH_FROM | CH_UPDATE | CH_UPDATE_LEN, 0);
+                                        CH_FROM | CH_UPDATE | CH_UPDATE_LEN | CH_PAD_STATUS, 0);
       mx_msg_close(m, &msg);
       if (rc2 != 0)
       {
@@ -1260,13 +1958,6 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
     goto bail;
   }
 
-  /* Save the state of this folder. */
-  if (stat(mailbox_path(m), &st) == -1)
-  {
-    mutt_perror(mailbox_path(m));
-    goto bail;
-  }
-
   unlink_tempfile = false;
 
   fp = fopen(buf_string(tempfile), "r");
@@ -1303,7 +1994,7 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
        * change/deleted message */
       if (m->verbose)
         mutt_message(_("Committing changes..."));
-      i = mutt_file_copy_stream(fp, adata->fp);
+      i = mbox_copy_back(fp, adata->fp);
 
       if (ferror(adata->fp))
         i = -1;
@@ -1374,9 +2065,33 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
       m->emails[i]->index = j++;
     }
   }
+
   FREE(&new_offset);
   FREE(&old_offset);
   unlink(buf_string(tempfile)); /* remove partial copy of the mailbox */
+
+done:
+#ifdef USE_HCACHE
+  /* Only the messages before the first rewritten one are where the cache
+   * expects, but those updated in place have new flags */
+  struct HeaderCache *hc = mbox_hcache_open(m);
+  struct stat st_hc = { 0 };
+  if (hc && (stat(mailbox_path(m), &st_hc) == 0))
+  {
+    const int last = (first >= 0) ? first : m->msg_count;
+    for (i = first_patched; i < last; i++)
+    {
+      if (m->emails[i]->changed)
+        mbox_hcache_update(m, hc, m->emails[i]);
+    }
+
+    struct timespec mtime = { 0 };
+    mutt_file_get_stat_timespec(&mtime, &st_hc, MUTT_STAT_MTIME);
+    mbox_hcache_save_size(hc, offset, &mtime);
+  }
+  hcache_close(&hc);
+#endif
+
   buf_pool_release(&tempfile);
   mutt_sig_unblock();
 
@@ -0,0 +1,188 @@
+/**
+ * @file
+ * Update the flags of an mbox message in place
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mbox_status Update the flags of an mbox message in place
+ *
+ * Update the flags of an mbox message in place
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "lib.h"
+#include "copy.h"
+
+#define MBOX_PATCH_MAX_HEADER (64 * 1024) ///< Largest header mbox_patch_status() will search
+
+/**
+ * struct StatusField - The value of a Status: or X-Status: header in an mbox
+ */
+struct StatusField
+{
+  LOFF_T offset; ///< Offset of the value in the file, -1 if the header is missing
+  size_t room;   ///< Length of the value, up to the end of the line
+};
+
+/**
+ * status_field_find - Find the value of a header that may be patched
+ * @param[in]  line   Header line, followed by the rest of the header
+ * @param[in]  len    Length of the text, from line to the end of the header
+ * @param[in]  hdr    Header name, followed by a space, e.g. "Status: "
+ * @param[in]  offset Offset of line in the file
+ * @param[out] sf     Location of the value
+ * @retval true  The header can be patched
+ * @retval false The header isn't in the expected form, or it's a duplicate
+ *
+ * The text must be NUL-terminated.
+ */
+static bool status_field_find(const char *line, size_t len, const char *hdr,
+                              LOFF_T offset, struct StatusField *sf)
+{
+  const size_t hdrlen = mutt_str_len(hdr);
+  const char *nl = memchr(line, '\n', len);
+
+  /* Only a single copy of the header, on a single line */
+  if ((sf->offset >= 0) || !nl || !mutt_str_startswith(line, hdr) ||
+      (nl[1] == ' ') || (nl[1] == '\t'))
+  {
+    return false;
+  }
+
+  const char *end = nl;
+  if ((end > (line + hdrlen)) && (end[-1] == '\r'))
+    end--;
+
+  sf->offset = offset + hdrlen;
+  sf->room = end - line - hdrlen;
+  return true;
+}
+
+/**
+ * status_field_patch - Overwrite the value of a header
+ * @param fp    Mailbox file
+ * @param sf    Location of the value
+ * @param value New value, no longer than the room available
+ * @retval true Success
+ *
+ * The value is padded with spaces, which the parser ignores.
+ */
+static bool status_field_patch(FILE *fp, const struct StatusField *sf, const char *value)
+{
+  if (sf->offset < 0)
+    return true;
+
+  if (!mutt_file_seek(fp, sf->offset, SEEK_SET))
+    return false;
+
+  return fprintf(fp, "%-*s", (int) sf->room, value) == (int) sf->room;
+}
+
+/**
+ * mbox_patch_status - Update the flags of a message in place
+ * @param m Mailbox
+ * @param e Email
+ * @retval  1 Success, the flags were rewritten
+ * @retval  0 The message has to be rewritten
+ * @retval -1 Error
+ *
+ * If the flags are all that has changed, and the message's Status: and
+ * X-Status: headers have room for the new values, the values are written over
+ * the old ones, leaving the rest of the file untouched.  A header that's
+ * missing, but now needed, means that the message has to be rewritten.
+ *
+ * Messages written by NeoMutt have fixed-width headers, see #CH_PAD_STATUS,
+ * so their flags can always be changed in place.
+ */
+int mbox_patch_status(struct Mailbox *m, struct Email *e)
+{
+  if (!m || !m->account || !e || !e->body)
+    return -1;
+
+  struct MboxAccountData *adata = m->account->adata;
+
+  if (e->deleted || e->attach_del || (e->env && e->env->changed))
+    return 0;
+
+  const LOFF_T start = e->offset;
+  const LOFF_T end = e->body->offset;
+  if ((end <= start) || ((end - start) > MBOX_PATCH_MAX_HEADER))
+    return 0;
+
+  const size_t len = end - start;
+  char *hdr = mutt_mem_malloc(len + 1);
+  struct StatusField status = { -1, 0 };
+  struct StatusField xstatus = { -1, 0 };
+  int rc = 0;
+
+  if (!mutt_file_seek(adata->fp, start, SEEK_SET) || (fread(hdr, 1, len, adata->fp) != len))
+    goto done;
+  hdr[len] = '\0';
+
+  for (size_t pos = 0; pos < len;)
+  {
+    const char *line = hdr + pos;
+    const char *nl = memchr(line, '\n', len - pos);
+    const size_t linelen = nl ? (nl - line + 1) : (len - pos);
+
+    if (mutt_istr_startswith(line, "status:"))
+    {
+      if (!status_field_find(line, len - pos, "Status: ", start + pos, &status))
+        goto done;
+    }
+    else if (mutt_istr_startswith(line, "x-status:"))
+    {
+      if (!status_field_find(line, len - pos, "X-Status: ", start + pos, &xstatus))
+        goto done;
+    }
+
+    pos += linelen;
+  }
+
+  char flags[STATUS_FLAGS_SIZE] = { 0 };
+  char xflags[STATUS_FLAGS_SIZE] = { 0 };
+  mutt_copy_status_flags(e, flags, xflags);
+
+  /* Each header must already be there, with room for its new value */
+  if (((status.offset < 0) && (flags[0] != '\0')) || (mutt_str_len(flags) > status.room) ||
+      ((xstatus.offset < 0) && (xflags[0] != '\0')) || (mutt_str_len(xflags) > xstatus.room))
+  {
+    goto done;
+  }
+
+  rc = -1;
+  if (!status_field_patch(adata->fp, &status, flags) ||
+      !status_field_patch(adata->fp, &xstatus, xflags))
+  {
+    goto done;
+  }
+
+  rc = 1;
+
+done:
+  FREE(&hdr);
+  return rc;
+}
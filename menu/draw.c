@@ -43,6 +43,13 @@
 #include "mview.h"
 #include "opcodes.h"
 
+/// Config handle for $ascii_chars
+static struct ConfigHandle HandleAsciiChars = CONFIG_HANDLE("ascii_chars");
+/// Config handle for $arrow_cursor
+static struct ConfigHandle HandleArrowCursor = CONFIG_HANDLE("arrow_cursor");
+/// Config handle for $arrow_string
+static struct ConfigHandle HandleArrowString = CONFIG_HANDLE("arrow_string");
+
 /**
  * get_color - Choose a colour for a line of the index
  * @param index Index number
@@ -85,6 +92,10 @@ static struct AttrColor *get_color(int index, unsigned char *s)
   }
 
   struct AttrColor *ac_merge = NULL;
+  if (index_row_color_get(e, type, &ac_merge))
+    return ac_merge;
+
+  bool cacheable = true;
   STAILQ_FOREACH(np, rcl, entries)
   {
     if (mutt_pattern_exec(SLIST_FIRST(np->color_pattern),
@@ -92,8 +103,14 @@ static struct AttrColor *get_color(int index, unsigned char *s)
     {
       ac_merge = merged_color_overlay(ac_merge, &np->attr_color);
     }
+
+    /* Date tests are cheap, but their result depends on when they're run */
+    if (mutt_pattern_has_date(np->color_pattern))
+      cacheable = false;
   }
 
+  if (cacheable)
+    index_row_color_set(e, type, ac_merge);
   return ac_merge;
 }
 
@@ -115,7 +132,7 @@ static void print_enriched_string(struct MuttWindow *win, int index,
   size_t n = mutt_str_len((char *) s);
   mbstate_t mbstate = { 0 };
 
-  const bool c_ascii_chars = cs_subset_bool(sub, "ascii_chars");
+  const bool c_ascii_chars = ch_bool(sub, &HandleAsciiChars);
   while (*s)
   {
     if (*s < MUTT_TREE_MAX)
@@ -290,8 +307,8 @@ static void print_enriched_string(struct MuttWindow *win, int index,
 static void menu_pad_string(struct Menu *menu, char *buf, size_t buflen)
 {
   char *scratch = mutt_str_dup(buf);
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
-  const char *const c_arrow_string = cs_subset_string(menu->sub, "arrow_string");
+  const bool c_arrow_cursor = ch_bool(menu->sub, &HandleArrowCursor);
+  const char *const c_arrow_string = ch_string(menu->sub, &HandleArrowString);
   int shift = c_arrow_cursor ? mutt_strwidth(c_arrow_string) + 1 : 0;
   int cols = menu->win->state.cols - shift;
 
@@ -324,8 +341,8 @@ void menu_redraw_index(struct Menu *menu)
   char buf[1024] = { 0 };
   struct AttrColor *ac = NULL;
 
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
-  const char *const c_arrow_string = cs_subset_string(menu->sub, "arrow_string");
+  const bool c_arrow_cursor = ch_bool(menu->sub, &HandleArrowCursor);
+  const char *const c_arrow_string = ch_string(menu->sub, &HandleArrowString);
   struct AttrColor *ac_ind = simple_color_get(MT_COLOR_INDICATOR);
   for (int i = menu->top; i < (menu->top + menu->page_len); i++)
   {
@@ -388,8 +405,8 @@ void menu_redraw_motion(struct Menu *menu)
   mutt_window_move(menu->win, 0, menu->old_current - menu->top);
   mutt_curses_set_color(old_color);
 
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
-  const char *const c_arrow_string = cs_subset_string(menu->sub, "arrow_string");
+  const bool c_arrow_cursor = ch_bool(menu->sub, &HandleArrowCursor);
+  const char *const c_arrow_string = ch_string(menu->sub, &HandleArrowString);
   struct AttrColor *ac_ind = simple_color_get(MT_COLOR_INDICATOR);
   if (c_arrow_cursor)
   {
@@ -445,8 +462,8 @@ void menu_redraw_current(struct Menu *menu)
   menu_pad_string(menu, buf, sizeof(buf));
 
   struct AttrColor *ac_ind = simple_color_get(MT_COLOR_INDICATOR);
-  const bool c_arrow_cursor = cs_subset_bool(menu->sub, "arrow_cursor");
-  const char *const c_arrow_string = cs_subset_string(menu->sub, "arrow_string");
+  const bool c_arrow_cursor = ch_bool(menu->sub, &HandleArrowCursor);
+  const char *const c_arrow_string = ch_string(menu->sub, &HandleArrowString);
   if (c_arrow_cursor)
   {
     mutt_curses_set_color(ac_ind);
@@ -25,6 +25,11 @@
  * @page neo_monitor Monitor files for changes
  *
  * Monitor files for changes
+ *
+ * The directories of the current Maildir mailbox, 'new' and 'cur', are both
+ * watched.  The names of the files that are created, moved or deleted are
+ * recorded, so that the Mailbox can be updated without scanning the
+ * directories, see mutt_monitor_events().
  */
 
 #include "config.h"
@@ -63,10 +68,27 @@ static size_t PollFdsLen = 0;
 static struct pollfd *PollFds = NULL;
 /// Monitor file descriptor of the current mailbox
 static int MonitorContextDescriptor = -1;
+/// Monitor file descriptor of the 'cur' directory of the current Maildir
+static int MonitorContextCurDescriptor = -1;
+/// Path of the current Maildir, if its files are being monitored
+static char *MonitorContextPath = NULL;
+/// Files of the current Maildir that have changed
+static struct MonitorEventArray MonitorContextEvents = ARRAY_HEAD_INITIALIZER;
+/// Set to true once the Maildir has been checked, since monitoring began
+static bool MonitorContextSynced = false;
+/// Set to true when some events have been lost
+static bool MonitorContextLost = false;
+/// Set to true when mutt_monitor_events() reads a change to another file
+static bool MonitorFilesPending = false;
 
 #define INOTIFY_MASK_DIR (IN_MOVED_TO | IN_ATTRIB | IN_CLOSE_WRITE | IN_ISDIR)
+/// Events that change the list of files in a directory, only for the current Maildir
+#define INOTIFY_MASK_NAMES (IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE)
 #define INOTIFY_MASK_FILE IN_CLOSE_WRITE
 
+/// Maximum number of events to record, before giving up and rescanning
+#define MONITOR_EVENTS_MAX 16384
+
 #define EVENT_BUFLEN MAX(4096, sizeof(struct inotify_event) + NAME_MAX + 1)
 
 /**
@@ -191,6 +213,135 @@ static int monitor_init(void)
   return 0;
 }
 
+/**
+ * mutt_monitor_events_clear - Empty an array of Monitor Events
+ * @param events Events to free
+ */
+void mutt_monitor_events_clear(struct MonitorEventArray *events)
+{
+  if (!events)
+    return;
+
+  struct MonitorEvent *ev = NULL;
+  ARRAY_FOREACH(ev, events)
+  {
+    FREE(&ev->name);
+  }
+  ARRAY_FREE(events);
+}
+
+/**
+ * monitor_context_remove - Stop recording the changes to the current Maildir
+ *
+ * The watch on 'new' is kept for the Mailbox's new mail checks, but it no
+ * longer needs the names of the files.
+ */
+static void monitor_context_remove(void)
+{
+  if ((MonitorContextCurDescriptor != -1) && (INotifyFd != -1))
+  {
+    inotify_rm_watch(INotifyFd, MonitorContextCurDescriptor);
+    mutt_debug(LL_DEBUG3, "inotify_rm_watch for '%s/cur' descriptor=%d\n",
+               MonitorContextPath, MonitorContextCurDescriptor);
+  }
+
+  struct Monitor *iter = Monitor;
+  while (iter && (iter->desc != MonitorContextDescriptor))
+    iter = iter->next;
+
+  if (iter && MonitorContextPath && (INotifyFd != -1))
+  {
+    struct Buffer *path = buf_pool_get();
+    buf_printf(path, "%s/new", MonitorContextPath);
+    int desc = inotify_add_watch(INotifyFd, buf_string(path), INOTIFY_MASK_DIR);
+    if ((desc != -1) && (desc != MonitorContextDescriptor))
+      inotify_rm_watch(INotifyFd, desc);
+    buf_pool_release(&path);
+  }
+
+  MonitorContextCurDescriptor = -1;
+  FREE(&MonitorContextPath);
+  mutt_monitor_events_clear(&MonitorContextEvents);
+  MonitorContextSynced = false;
+  MonitorContextLost = false;
+}
+
+/**
+ * monitor_context_add - Record the changes to the current Maildir
+ *
+ * Watch the 'cur' directory of the current Mailbox, if it's a Maildir.
+ * The 'new' directory is watched by mutt_monitor_add(), but it needs the
+ * events that name the files, too.
+ */
+static void monitor_context_add(void)
+{
+  struct Mailbox *m = get_current_mailbox();
+  if (!m || (m->type != MUTT_MAILDIR) || (INotifyFd == -1))
+  {
+    monitor_context_remove();
+    return;
+  }
+
+  if ((MonitorContextCurDescriptor != -1) && mutt_str_equal(MonitorContextPath, m->realpath))
+    return;
+
+  monitor_context_remove();
+
+  struct Buffer *path = buf_pool_get();
+  buf_printf(path, "%s/new", m->realpath);
+  int desc = inotify_add_watch(INotifyFd, buf_string(path), INOTIFY_MASK_DIR | INOTIFY_MASK_NAMES);
+  if (desc != MonitorContextDescriptor)
+  {
+    mutt_debug(LL_DEBUG2, "can't watch the files of '%s'\n", buf_string(path));
+    if (desc != -1)
+      inotify_rm_watch(INotifyFd, desc);
+    buf_pool_release(&path);
+    return;
+  }
+
+  buf_printf(path, "%s/cur", m->realpath);
+  desc = inotify_add_watch(INotifyFd, buf_string(path), INOTIFY_MASK_DIR | INOTIFY_MASK_NAMES);
+  if (desc == -1)
+  {
+    mutt_debug(LL_DEBUG2, "inotify_add_watch failed for '%s', errno=%d %s\n",
+               buf_string(path), errno, strerror(errno));
+  }
+  else
+  {
+    mutt_debug(LL_DEBUG3, "inotify_add_watch descriptor=%d for '%s'\n",
+               desc, buf_string(path));
+    MonitorContextCurDescriptor = desc;
+    MonitorContextPath = mutt_str_dup(m->realpath);
+  }
+  buf_pool_release(&path);
+}
+
+/**
+ * monitor_context_event - Record a change to the current Maildir
+ * @param event inotify event
+ */
+static void monitor_context_event(const struct inotify_event *event)
+{
+  if (!MonitorContextPath || MonitorContextLost || (event->len == 0) ||
+      !(event->mask & INOTIFY_MASK_NAMES) || (event->mask & IN_ISDIR))
+  {
+    return;
+  }
+
+  if (ARRAY_SIZE(&MonitorContextEvents) >= MONITOR_EVENTS_MAX)
+  {
+    mutt_debug(LL_DEBUG2, "too many events, the mailbox will be scanned\n");
+    mutt_monitor_events_clear(&MonitorContextEvents);
+    MonitorContextLost = true;
+    return;
+  }
+
+  const char *subdir = (event->wd == MonitorContextCurDescriptor) ? "cur" : "new";
+  struct MonitorEvent ev = { NULL, event->mask };
+  mutt_str_asprintf(&ev.name, "%s/%s", subdir, event->name);
+  ARRAY_ADD(&MonitorContextEvents, ev);
+}
+
 /**
  * monitor_check_cleanup - Close down file monitoring
  */
@@ -198,10 +349,12 @@ static void monitor_check_cleanup(void)
 {
   if (!Monitor && (INotifyFd != -1))
   {
+    monitor_context_remove();
     mutt_poll_fd_remove(INotifyFd);
     close(INotifyFd);
     INotifyFd = -1;
     MonitorFilesChanged = false;
+    MonitorFilesPending = false;
   }
 }
 
@@ -311,7 +464,10 @@ static int monitor_handle_ignore(int desc)
     }
 
     if (MonitorContextDescriptor == desc)
+    {
       MonitorContextDescriptor = new_desc;
+      MonitorContextLost = true;
+    }
 
     if (new_desc == -1)
     {
@@ -390,6 +546,71 @@ static enum ResolveResult monitor_resolve(struct MonitorInfo *info, struct Mailb
   return iter ? RESOLVE_RES_OK_EXISTING : RESOLVE_RES_OK_NOTEXISTING;
 }
 
+/**
+ * monitor_read_events - Read all the waiting inotify events
+ * @retval true A file, other than the current Mailbox's, has changed
+ */
+static bool monitor_read_events(void)
+{
+  char buf[EVENT_BUFLEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+  const struct inotify_event *event = NULL;
+  bool changed = false;
+
+  while (INotifyFd != -1)
+  {
+    int len = read(INotifyFd, buf, sizeof(buf));
+    if (len == -1)
+    {
+      if (errno != EAGAIN)
+      {
+        mutt_debug(LL_DEBUG2, "read inotify events failed, errno=%d %s\n",
+                   errno, strerror(errno));
+      }
+      break;
+    }
+
+    for (char *ptr = buf; ptr < (buf + len);
+         ptr += sizeof(struct inotify_event) + event->len)
+    {
+      event = (const struct inotify_event *) ptr;
+      mutt_debug(LL_DEBUG3, "+ detail: descriptor=%d mask=0x%x\n", event->wd, event->mask);
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        mutt_debug(LL_DEBUG2, "inotify queue overflow\n");
+        mutt_monitor_events_clear(&MonitorContextEvents);
+        MonitorContextLost = true;
+        MonitorContextChanged = true;
+        changed = true;
+      }
+      else if (event->mask & IN_IGNORED)
+      {
+        if (event->wd == MonitorContextCurDescriptor)
+        {
+          MonitorContextCurDescriptor = -1;
+          MonitorContextLost = true;
+        }
+        else
+        {
+          monitor_handle_ignore(event->wd);
+          changed = true;
+        }
+      }
+      else if ((event->wd == MonitorContextDescriptor) ||
+               (event->wd == MonitorContextCurDescriptor))
+      {
+        MonitorContextChanged = true;
+        monitor_context_event(event);
+      }
+      else
+      {
+        changed = true;
+      }
+    }
+  }
+
+  return changed;
+}
+
 /**
  * mutt_monitor_poll - Check for filesystem changes
  * @retval -3 unknown/unexpected events: poll timeout / fds not handled by us
@@ -400,6 +621,8 @@ static enum ResolveResult monitor_resolve(struct MonitorInfo *info, struct Mailb
  * Wait for I/O ready file descriptors or signals.
  *
  * MonitorFilesChanged also reflects changes to monitored files.
+ * This includes the changes that mutt_monitor_events() has already read,
+ * in which case poll() doesn't wait.
  *
  * Only STDIN and INotify file handles currently expected/supported.
  * More would ask for common infrastructure (sockets?).
@@ -407,13 +630,13 @@ static enum ResolveResult monitor_resolve(struct MonitorInfo *info, struct Mailb
 int mutt_monitor_poll(void)
 {
   int rc = 0;
-  char buf[EVENT_BUFLEN] __attribute__((aligned(__alignof__(struct inotify_event))));
 
-  MonitorFilesChanged = false;
+  MonitorFilesChanged = MonitorFilesPending;
+  MonitorFilesPending = false;
 
   if (INotifyFd != -1)
   {
-    int fds = poll(PollFds, PollFdsCount, MuttGetchTimeout);
+    int fds = poll(PollFds, PollFdsCount, MonitorFilesChanged ? 0 : MuttGetchTimeout);
 
     if (fds == -1)
     {
@@ -439,34 +662,7 @@ int mutt_monitor_poll(void)
           {
             MonitorFilesChanged = true;
             mutt_debug(LL_DEBUG3, "file change(s) detected\n");
-            char *ptr = buf;
-            const struct inotify_event *event = NULL;
-
-            while (true)
-            {
-              int len = read(INotifyFd, buf, sizeof(buf));
-              if (len == -1)
-              {
-                if (errno != EAGAIN)
-                {
-                  mutt_debug(LL_DEBUG2, "read inotify events failed, errno=%d %s\n",
-                             errno, strerror(errno));
-                }
-                break;
-              }
-
-              while (ptr < (buf + len))
-              {
-                event = (const struct inotify_event *) ptr;
-                mutt_debug(LL_DEBUG3, "+ detail: descriptor=%d mask=0x%x\n",
-                           event->wd, event->mask);
-                if (event->mask & IN_IGNORED)
-                  monitor_handle_ignore(event->wd);
-                else if (event->wd == MonitorContextDescriptor)
-                  MonitorContextChanged = true;
-                ptr += sizeof(struct inotify_event) + event->len;
-              }
-            }
+            monitor_read_events();
           }
         }
       }
@@ -478,6 +674,50 @@ int mutt_monitor_poll(void)
   return rc;
 }
 
+/**
+ * mutt_monitor_events - Get the files of a Maildir that have changed
+ * @param[in]  m      Mailbox
+ * @param[out] events Changed files, see mutt_monitor_events_clear()
+ * @retval  0 Success, @a events contains every change since the last call
+ * @retval -1 The Mailbox isn't being monitored, or this is the first call
+ * @retval -2 Some events were lost, the Mailbox must be scanned
+ *
+ * Only the current Mailbox is monitored in this way.  The caller should
+ * stat() the Mailbox's directories first, because any waiting events are read
+ * before they're returned.
+ */
+int mutt_monitor_events(struct Mailbox *m, struct MonitorEventArray *events)
+{
+  if (!m || !events || !MonitorContextPath || !mutt_str_equal(m->realpath, MonitorContextPath))
+    return -1;
+
+  /* Changes to other Mailboxes are reported by the next mutt_monitor_poll() */
+  if (monitor_read_events())
+    MonitorFilesPending = true;
+
+  int rc = 0;
+  if ((MonitorContextDescriptor == -1) || (MonitorContextCurDescriptor == -1))
+    rc = -1;
+  else if (!MonitorContextSynced)
+    rc = -1;
+  else if (MonitorContextLost)
+    rc = -2;
+
+  if (rc == 0)
+  {
+    *events = MonitorContextEvents;
+    ARRAY_INIT(&MonitorContextEvents);
+  }
+  else
+  {
+    mutt_monitor_events_clear(&MonitorContextEvents);
+  }
+
+  MonitorContextSynced = true;
+  MonitorContextLost = false;
+  return rc;
+}
+
 /**
  * mutt_monitor_add - Add a watch for a mailbox
  * @param m Mailbox to watch
@@ -496,7 +736,10 @@ int mutt_monitor_add(struct Mailbox *m)
   if (desc != RESOLVE_RES_OK_NOTEXISTING)
   {
     if (!m && (desc == RESOLVE_RES_OK_EXISTING))
+    {
       MonitorContextDescriptor = info.monitor->desc;
+      monitor_context_add();
+    }
     rc = (desc == RESOLVE_RES_OK_EXISTING) ? 0 : -1;
     goto cleanup;
   }
@@ -512,10 +755,12 @@ int mutt_monitor_add(struct Mailbox *m)
   }
 
   mutt_debug(LL_DEBUG3, "inotify_add_watch descriptor=%d for '%s'\n", desc, info.path);
+  monitor_new(&info, desc);
   if (!m)
+  {
     MonitorContextDescriptor = desc;
-
-  monitor_new(&info, desc);
+    monitor_context_add();
+  }
 
 cleanup:
   monitor_info_free(&info);
@@ -541,6 +786,7 @@ int mutt_monitor_remove(struct Mailbox *m)
 
   if (!m)
   {
+    monitor_context_remove();
     MonitorContextDescriptor = -1;
     MonitorContextChanged = false;
   }
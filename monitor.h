@@ -24,14 +24,28 @@
 #define MUTT_MONITOR_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "mutt/lib.h"
 
 struct Mailbox;
 
+/**
+ * struct MonitorEvent - A file that has changed in the current Mailbox
+ */
+struct MonitorEvent
+{
+  char *name;    ///< Path relative to the Mailbox, e.g. "new/1234.host"
+  uint32_t mask; ///< inotify event, e.g. IN_MOVED_TO
+};
+ARRAY_HEAD(MonitorEventArray, struct MonitorEvent);
+
 extern bool MonitorFilesChanged;   ///< true after a monitored file has changed
 extern bool MonitorContextChanged; ///< true after the current mailbox has changed
 
 int mutt_monitor_add(struct Mailbox *m);
 int mutt_monitor_remove(struct Mailbox *m);
 int mutt_monitor_poll(void);
+int mutt_monitor_events(struct Mailbox *m, struct MonitorEventArray *events);
+void mutt_monitor_events_clear(struct MonitorEventArray *events);
 
 #endif /* MUTT_MONITOR_H */
@@ -72,6 +72,43 @@ const int Index64[128] = {
   // clang-format on
 };
 
+/// Decode64 value of a character that isn't part of the base64 alphabet
+#define B64_SKIP 0x80
+/// Decode64 value of the padding character, '='
+#define B64_PAD 0x40
+
+/**
+ * Decode64 - Lookup table for decoding streams of Base64 characters
+ *
+ * Unlike Index64, this covers all byte values, so the lookup needs no range
+ * check.  Characters outside the alphabet map to #B64_SKIP, the padding
+ * character to #B64_PAD.
+ */
+static const unsigned char Decode64[256] = {
+  // clang-format off
+#define XX B64_SKIP
+#define PD B64_PAD
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, 62, XX, XX, XX, 63,
+  52, 53, 54, 55, 56, 57, 58, 59, 60, 61, XX, XX, XX, PD, XX, XX,
+  XX,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, XX, XX, XX, XX, XX,
+  XX, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+  41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+  XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+#undef XX
+#undef PD
+  // clang-format on
+};
+
 /**
  * mutt_b64_encode - Convert raw bytes to null-terminated base64 string
  * @param in     Input buffer for the raw bytes
@@ -189,6 +226,95 @@ int mutt_b64_decode(const char *in, char *out, size_t olen)
   return len;
 }
 
+/**
+ * mutt_b64_decode_stream - Decode a block of a base64 stream
+ * @param dec   Decoder state, zeroed before the first block
+ * @param in    Base64 text
+ * @param inlen Length of the text
+ * @param out   Buffer for the raw bytes
+ * @retval num Number of bytes written to the buffer
+ *
+ * Decode a stream of base64 text in blocks of any size.  Groups of four
+ * characters may be split across blocks.  Characters outside the base64
+ * alphabet, e.g. line breaks, are skipped.  Once the padding has been seen,
+ * the decoder ignores any further input and sets Base64Decoder::done.
+ *
+ * The output buffer must be at least `(inlen / 4 + 1) * 3` bytes.
+ *
+ * @note An incomplete group at the end of the stream is discarded
+ */
+size_t mutt_b64_decode_stream(struct Base64Decoder *dec, const char *in,
+                              size_t inlen, char *out)
+{
+  if (!dec || !in || !out)
+    return 0;
+
+  const unsigned char *s = (const unsigned char *) in;
+  const unsigned char *end = s + inlen;
+  unsigned char *d = (unsigned char *) out;
+
+  while (!dec->done && (s < end))
+  {
+    if (dec->count == 0)
+    {
+      /* Fast path: whole groups of four valid characters */
+      while ((end - s) >= 4)
+      {
+        const unsigned int c1 = Decode64[s[0]];
+        const unsigned int c2 = Decode64[s[1]];
+        const unsigned int c3 = Decode64[s[2]];
+        const unsigned int c4 = Decode64[s[3]];
+        if ((c1 | c2 | c3 | c4) & (B64_SKIP | B64_PAD))
+          break;
+
+        const unsigned int bits = (c1 << 18) | (c2 << 12) | (c3 << 6) | c4;
+        d[0] = bits >> 16;
+        d[1] = bits >> 8;
+        d[2] = bits;
+        d += 3;
+        s += 4;
+      }
+      if (s == end)
+        break;
+    }
+
+    const unsigned int c = Decode64[*s++];
+    if (c == B64_SKIP)
+      continue;
+
+    if (c == B64_PAD)
+    {
+      /* "xx==" ends with one byte, "xxx=" with two */
+      if (dec->count == 2)
+      {
+        *d++ = dec->bits >> 4;
+      }
+      else if (dec->count == 3)
+      {
+        *d++ = dec->bits >> 10;
+        *d++ = dec->bits >> 2;
+      }
+      dec->bits = 0;
+      dec->count = 0;
+      dec->done = true;
+      break;
+    }
+
+    dec->bits = (dec->bits << 6) | c;
+    if (++dec->count == 4)
+    {
+      d[0] = dec->bits >> 16;
+      d[1] = dec->bits >> 8;
+      d[2] = dec->bits;
+      d += 3;
+      dec->bits = 0;
+      dec->count = 0;
+    }
+  }
+
+  return d - (unsigned char *) out;
+}
+
 /**
  * mutt_b64_buffer_encode - Convert raw bytes to null-terminated base64 string
  * @param buf    Buffer for the result
@@ -21,15 +21,27 @@
 #ifndef MUTT_MUTT_BASE64_H
 #define MUTT_MUTT_BASE64_H
 
+#include <stdbool.h>
 #include <stdio.h>
 
 struct Buffer;
 
+/**
+ * struct Base64Decoder - State of a streaming base64 decoder
+ */
+struct Base64Decoder
+{
+  unsigned int bits; ///< Bits of the incomplete group of characters
+  int count;         ///< Number of characters in the incomplete group
+  bool done;         ///< Padding has been seen; the stream has ended
+};
+
 extern const int Index64[];
 
 #define base64val(ch) Index64[(unsigned int) (ch)]
 
 int    mutt_b64_decode(const char *in, char *out, size_t olen);
+size_t mutt_b64_decode_stream(struct Base64Decoder *dec, const char *in, size_t inlen, char *out);
 size_t mutt_b64_encode(const char *in, size_t inlen, char *out, size_t outlen);
 
 int    mutt_b64_buffer_decode(struct Buffer *buf, const char *in);
@@ -83,14 +83,53 @@ struct IconvCacheEntry
   char *fromcode1; ///< Source character set
   char *tocode1;   ///< Destination character set
   iconv_t cd;      ///< iconv conversion descriptor
+  long hits;       ///< Number of times the descriptor was reused
+  long last_used;  ///< When the descriptor was last used, see IconvCacheTick
 };
 
-/// Max size of the iconv cache
-#define ICONV_CACHE_SIZE 16
-/// Cache of iconv conversion descriptors
-static struct IconvCacheEntry IconvCache[ICONV_CACHE_SIZE];
+/// Max number of iconv descriptors in the cache
+#define ICONV_CACHE_SIZE 128
+/// Cache of iconv conversion descriptors, keyed by the names passed to iconv_open()
+static struct HashTable *IconvCache = NULL;
 /// Number of iconv descriptors in the cache
 static int IconvCacheUsed = 0;
+/// Counter for IconvCacheEntry.last_used
+static long IconvCacheTick = 0;
+/// Number of lookups that reused a cached descriptor
+static long IconvCacheHits = 0;
+/// Number of times iconv_open() was called
+static long IconvCacheMisses = 0;
+/// Number of descriptors dropped to make room
+static long IconvCacheEvictions = 0;
+
+/**
+ * IconvNames - Cache of resolved charset names
+ *
+ * Map the charset names, exactly as the caller passed them, to the
+ * IconvCacheEntry that mutt_ch_iconv_open() chose for them.  This saves
+ * canonicalising the names and running the charset-hooks every time.
+ */
+static struct HashTable *IconvNames = NULL;
+/// Number of lookups that skipped the canonicalisation
+static long IconvNameHits = 0;
+/// Number of lookups that needed the canonicalisation
+static long IconvNameMisses = 0;
+/// Number of times the resolved names were forgotten
+static long IconvNameFlushes = 0;
+
+/**
+ * iconv_names_flush - Forget the resolved charset names
+ *
+ * The descriptors in the IconvCache are kept.
+ */
+static void iconv_names_flush(void)
+{
+  if (!IconvNames)
+    return;
+
+  mutt_hash_free(&IconvNames);
+  IconvNameFlushes++;
+}
 
 /**
  * struct MimeNames - MIME name lookup entry
@@ -521,6 +560,9 @@ bool mutt_ch_lookup_add(enum LookupType type, const char *pat,
 
   TAILQ_INSERT_TAIL(&Lookups, l, entries);
 
+  /* The hooks may change how names are resolved.  Keep the descriptors,
+   * because callers may still be using them. */
+  iconv_names_flush();
   return true;
 }
 
@@ -539,6 +581,9 @@ void mutt_ch_lookup_remove(void)
     TAILQ_REMOVE(&Lookups, l, entries);
     lookup_free(&l);
   }
+
+  /* Forget the resolved names, but keep the descriptors */
+  iconv_names_flush();
 }
 
 /**
@@ -556,36 +601,87 @@ const char *mutt_ch_charset_lookup(const char *chs)
 }
 
 /**
- * mutt_ch_iconv_open - Set up iconv for conversions
+ * iconv_cache_entry_free - Free an IconvCacheEntry - Implements ::hash_hdata_free_t - @ingroup hash_hdata_free_api
+ */
+static void iconv_cache_entry_free(int type, void *obj, intptr_t data)
+{
+  struct IconvCacheEntry *ice = obj;
+
+  mutt_debug(LL_DEBUG2, "iconv: %s -> %s: %ld hits\n", ice->fromcode1,
+             ice->tocode1, ice->hits);
+  FREE(&ice->fromcode1);
+  FREE(&ice->tocode1);
+  if (iconv_t_valid(ice->cd))
+    iconv_close(ice->cd);
+  FREE(&ice);
+}
+
+/**
+ * iconv_cache_key - Create a key for the iconv caches
+ * @param buf    Buffer for the key
+ * @param buflen Length of the buffer
+ * @param to     Destination character set
+ * @param from   Source character set
+ * @param flags  Flags, e.g. #MUTT_ICONV_HOOK_FROM
+ * @retval true  Success
+ * @retval false The names are too long to be cached
+ */
+static bool iconv_cache_key(char *buf, size_t buflen, const char *to,
+                            const char *from, uint8_t flags)
+{
+  int len = snprintf(buf, buflen, "%d\t%s\t%s", flags & MUTT_ICONV_HOOK_FROM,
+                     NONULL(to), NONULL(from));
+  return (len > 0) && (len < buflen);
+}
+
+/**
+ * iconv_cache_evict - Drop the least recently used descriptor from the cache
+ */
+static void iconv_cache_evict(void)
+{
+  struct IconvCacheEntry *lru = NULL;
+  char key[256] = { 0 };
+
+  struct HashWalkState state = { 0 };
+  struct HashElem *he = NULL;
+  while ((he = mutt_hash_walk(IconvCache, &state)))
+  {
+    struct IconvCacheEntry *ice = he->data;
+    if (!lru || (ice->last_used < lru->last_used))
+    {
+      lru = ice;
+      mutt_str_copy(key, he->key.strkey, sizeof(key));
+    }
+  }
+
+  if (!lru)
+    return;
+
+  mutt_debug(LL_DEBUG2, "iconv: dropping %s -> %s from the cache\n",
+             lru->fromcode1, lru->tocode1);
+
+  /* Some of the names may refer to it */
+  iconv_names_flush();
+
+  mutt_hash_delete(IconvCache, key, lru);
+  IconvCacheUsed--;
+  IconvCacheEvictions++;
+}
+
+/**
+ * iconv_cache_get - Get a cached iconv descriptor, creating it if necessary
  * @param tocode   Current character set
  * @param fromcode Target character set
  * @param flags    Flags, e.g. #MUTT_ICONV_HOOK_FROM
- * @retval ptr iconv handle for the conversion
- *
- * Like iconv_open, but canonicalises the charsets, applies charset-hooks,
- * recanonicalises, and finally applies iconv-hooks. Parameter flags=0 skips
- * charset-hooks, while MUTT_ICONV_HOOK_FROM applies them to fromcode. Callers
- * should use flags=0 when fromcode can safely be considered true, either some
- * constant, or some value provided by the user; MUTT_ICONV_HOOK_FROM should be
- * used only when fromcode is unsure, taken from a possibly wrong incoming MIME
- * label, or such. Misusing MUTT_ICONV_HOOK_FROM leads to unwanted interactions
- * in some setups.
- *
- * Since calling iconv_open() repeatedly can be expensive, we keep a cache of
- * the most recently used iconv_t objects, kept in LRU order. This means that
- * you should not call iconv_close() on the object yourself. All remaining
- * objects in the cache will exit when main() calls mutt_ch_cache_cleanup().
- *
- * @note By design charset-hooks should never be, and are never, applied
- * to tocode.
+ * @retval ptr Cache entry for the conversion
  *
- * @note The top-well-named MUTT_ICONV_HOOK_FROM acts on charset-hooks,
- * not at all on iconv-hooks.
+ * @sa mutt_ch_iconv_open()
  */
-iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, uint8_t flags)
+static struct IconvCacheEntry *iconv_cache_get(const char *tocode,
+                                               const char *fromcode, uint8_t flags)
 {
-  char tocode1[128];
-  char fromcode1[128];
+  char tocode1[128] = { 0 };
+  char fromcode1[128] = { 0 };
   const char *tocode2 = NULL, *fromcode2 = NULL;
   const char *tmp = NULL;
 
@@ -603,70 +699,116 @@ iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, uint8_t fla
       mutt_ch_canonical_charset(fromcode1, sizeof(fromcode1), tmp);
   }
 
-  /* check if we have this pair cached already */
-  for (int i = 0; i < IconvCacheUsed; ++i)
-  {
-    if (strcmp(tocode1, IconvCache[i].tocode1) == 0 &&
-        strcmp(fromcode1, IconvCache[i].fromcode1) == 0)
-    {
-      iconv_t cd = IconvCache[i].cd;
-
-      /* make room for this one at the top */
-      struct IconvCacheEntry top = IconvCache[i];
-      for (int j = i; j-- > 0;)
-      {
-        IconvCache[j + 1] = IconvCache[j];
-      }
-      IconvCache[0] = top;
-
-      if (iconv_t_valid(cd))
-      {
-        /* reset state */
-        iconv(cd, NULL, NULL, NULL, NULL);
-      }
-      return cd;
-    }
-  }
-
-  /* not found in cache */
   /* always apply iconv-hooks to suit system's iconv tastes */
   tocode2 = mutt_ch_iconv_lookup(tocode1);
   tocode2 = tocode2 ? tocode2 : tocode1;
   fromcode2 = mutt_ch_iconv_lookup(fromcode1);
   fromcode2 = fromcode2 ? fromcode2 : fromcode1;
 
+  /* check if we have this pair cached already */
+  char key[256] = { 0 };
+  iconv_cache_key(key, sizeof(key), tocode2, fromcode2, MUTT_ICONV_NO_FLAGS);
+  struct IconvCacheEntry *ice = IconvCache ? mutt_hash_find(IconvCache, key) : NULL;
+  if (ice)
+  {
+    IconvCacheHits++;
+    ice->hits++;
+    ice->last_used = ++IconvCacheTick;
+    return ice;
+  }
+
+  /* not found in cache */
   /* call system iconv with names it appreciates */
   iconv_t cd = iconv_open(tocode2, fromcode2);
+  IconvCacheMisses++;
 
   if (IconvCacheUsed == ICONV_CACHE_SIZE)
+    iconv_cache_evict();
+
+  if (!IconvCache)
+  {
+    IconvCache = mutt_hash_new(ICONV_CACHE_SIZE, MUTT_HASH_STRDUP_KEYS);
+    mutt_hash_set_destructor(IconvCache, iconv_cache_entry_free, 0);
+  }
+
+  mutt_debug(LL_DEBUG2, "iconv: adding %s -> %s to the cache\n", fromcode1, tocode1);
+  ice = mutt_mem_calloc(1, sizeof(struct IconvCacheEntry));
+  ice->fromcode1 = mutt_str_dup(fromcode1);
+  ice->tocode1 = mutt_str_dup(tocode1);
+  ice->cd = cd;
+  ice->last_used = ++IconvCacheTick;
+  mutt_hash_insert(IconvCache, key, ice);
+  IconvCacheUsed++;
+
+  return ice;
+}
+
+/**
+ * mutt_ch_iconv_open - Set up iconv for conversions
+ * @param tocode   Current character set
+ * @param fromcode Target character set
+ * @param flags    Flags, e.g. #MUTT_ICONV_HOOK_FROM
+ * @retval ptr iconv handle for the conversion
+ *
+ * Like iconv_open, but canonicalises the charsets, applies charset-hooks,
+ * recanonicalises, and finally applies iconv-hooks. Parameter flags=0 skips
+ * charset-hooks, while MUTT_ICONV_HOOK_FROM applies them to fromcode. Callers
+ * should use flags=0 when fromcode can safely be considered true, either some
+ * constant, or some value provided by the user; MUTT_ICONV_HOOK_FROM should be
+ * used only when fromcode is unsure, taken from a possibly wrong incoming MIME
+ * label, or such. Misusing MUTT_ICONV_HOOK_FROM leads to unwanted interactions
+ * in some setups.
+ *
+ * Since calling iconv_open() repeatedly can be expensive, we keep a cache of
+ * iconv_t objects, hashed by the charset names given to iconv_open().  The
+ * names that the callers use are cached too, so a repeated call doesn't have
+ * to canonicalise them again.  This means that you should not call
+ * iconv_close() on the object yourself. All remaining objects in the cache
+ * will exit when main() calls mutt_ch_cache_cleanup().  Changing the
+ * charset-hooks or iconv-hooks only forgets the callers' names; the
+ * descriptors stay valid.
+ *
+ * @note By design charset-hooks should never be, and are never, applied
+ * to tocode.
+ *
+ * @note The top-well-named MUTT_ICONV_HOOK_FROM acts on charset-hooks,
+ * not at all on iconv-hooks.
+ */
+iconv_t mutt_ch_iconv_open(const char *tocode, const char *fromcode, uint8_t flags)
+{
+  struct IconvCacheEntry *ice = NULL;
+
+  /* check if we've seen these names before */
+  char key[256] = { 0 };
+  const bool use_names = iconv_cache_key(key, sizeof(key), tocode, fromcode, flags);
+  if (use_names && IconvNames)
+    ice = mutt_hash_find(IconvNames, key);
+
+  if (ice)
+  {
+    IconvNameHits++;
+    IconvCacheHits++;
+    ice->hits++;
+    ice->last_used = ++IconvCacheTick;
+  }
+  else
   {
-    mutt_debug(LL_DEBUG2, "iconv: dropping %s -> %s from the cache\n",
-               IconvCache[IconvCacheUsed - 1].fromcode1,
-               IconvCache[IconvCacheUsed - 1].tocode1);
-    /* get rid of the oldest entry */
-    FREE(&IconvCache[IconvCacheUsed - 1].fromcode1);
-    FREE(&IconvCache[IconvCacheUsed - 1].tocode1);
-    if (iconv_t_valid(IconvCache[IconvCacheUsed - 1].cd))
+    IconvNameMisses++;
+    ice = iconv_cache_get(tocode, fromcode, flags);
+    if (use_names)
     {
-      iconv_close(IconvCache[IconvCacheUsed - 1].cd);
+      if (!IconvNames)
+        IconvNames = mutt_hash_new(ICONV_CACHE_SIZE * 2, MUTT_HASH_STRDUP_KEYS);
+      mutt_hash_insert(IconvNames, key, ice);
     }
-    --IconvCacheUsed;
   }
 
-  /* make room for this one at the top */
-  for (int j = IconvCacheUsed; j-- > 0;)
+  if (iconv_t_valid(ice->cd))
   {
-    IconvCache[j + 1] = IconvCache[j];
+    /* reset state */
+    iconv(ice->cd, NULL, NULL, NULL, NULL);
   }
-
-  ++IconvCacheUsed;
-
-  mutt_debug(LL_DEBUG2, "iconv: adding %s -> %s to the cache\n", fromcode1, tocode1);
-  IconvCache[0].fromcode1 = strdup(fromcode1);
-  IconvCache[0].tocode1 = strdup(tocode1);
-  IconvCache[0].cd = cd;
-
-  return cd;
+  return ice->cd;
 }
 
 /**
@@ -1168,14 +1310,44 @@ char *mutt_ch_choose(const char *fromcode, const struct Slist *charsets,
  */
 void mutt_ch_cache_cleanup(void)
 {
-  for (int i = 0; i < IconvCacheUsed; ++i)
+  if (IconvCache)
   {
-    FREE(&IconvCache[i].fromcode1);
-    FREE(&IconvCache[i].tocode1);
-    if (iconv_t_valid(IconvCache[i].cd))
-    {
-      iconv_close(IconvCache[i].cd);
-    }
+    struct IconvCacheStats stats = { 0 };
+    mutt_ch_cache_stats(&stats);
+    mutt_debug(LL_DEBUG1, "iconv: %d descriptors, %ld hits, %ld misses, %ld evictions\n",
+               stats.descriptors, stats.hits, stats.misses, stats.evictions);
+    mutt_debug(LL_DEBUG1, "iconv: names: %ld hits, %ld misses, %ld flushes\n",
+               stats.name_hits, stats.name_misses, stats.name_flushes);
   }
+
+  mutt_hash_free(&IconvNames);
+  mutt_hash_free(&IconvCache);
   IconvCacheUsed = 0;
+  IconvCacheHits = 0;
+  IconvCacheMisses = 0;
+  IconvCacheEvictions = 0;
+  IconvNameHits = 0;
+  IconvNameMisses = 0;
+  IconvNameFlushes = 0;
+}
+
+/**
+ * mutt_ch_cache_stats - Get the statistics of the iconv descriptor cache
+ * @param[out] stats Statistics
+ *
+ * The counts cover all the calls to mutt_ch_iconv_open() since the cache was
+ * last cleaned up, by mutt_ch_cache_cleanup().
+ */
+void mutt_ch_cache_stats(struct IconvCacheStats *stats)
+{
+  if (!stats)
+    return;
+
+  stats->descriptors = IconvCacheUsed;
+  stats->hits = IconvCacheHits;
+  stats->misses = IconvCacheMisses;
+  stats->evictions = IconvCacheEvictions;
+  stats->name_hits = IconvNameHits;
+  stats->name_misses = IconvNameMisses;
+  stats->name_flushes = IconvNameFlushes;
 }
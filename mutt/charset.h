@@ -68,6 +68,20 @@ enum LookupType
   MUTT_LOOKUP_ICONV,   ///< Character set conversion
 };
 
+/**
+ * struct IconvCacheStats - Statistics of the iconv descriptor cache
+ */
+struct IconvCacheStats
+{
+  int  descriptors;  ///< Number of descriptors in the cache
+  long hits;         ///< Lookups that reused a cached descriptor
+  long misses;       ///< Lookups that called iconv_open()
+  long evictions;    ///< Descriptors dropped to make room
+  long name_hits;    ///< Lookups that skipped the canonicalisation
+  long name_misses;  ///< Lookups that needed the canonicalisation
+  long name_flushes; ///< Times the resolved names were forgotten
+};
+
 #define MUTT_ICONV_NO_FLAGS  0 ///< No flags are set
 #define MUTT_ICONV_HOOK_FROM 1 ///< apply charset-hooks to fromcode
 
@@ -92,6 +106,7 @@ bool             mutt_ch_lookup_add(enum LookupType type, const char *pat, const
 void             mutt_ch_lookup_remove(void);
 void             mutt_ch_set_charset(const char *charset);
 void             mutt_ch_cache_cleanup(void);
+void             mutt_ch_cache_stats(struct IconvCacheStats *stats);
 
 #define mutt_ch_is_utf8(str)     mutt_ch_chscmp(str, "utf-8")
 #define mutt_ch_is_us_ascii(str) mutt_ch_chscmp(str, "us-ascii")
@@ -25,34 +25,97 @@
  * @page mutt_hash Hash Table data structure
  *
  * Hash Table data structure.
+ *
+ * The table uses open addressing.  Each slot holds the HashElems with one
+ * key, linked by HashElem::next.  If a key's slot is taken, the key is stored
+ * in the next free slot.  When the table is 3/4 full, it doubles in size.
+ *
+ * Each slot keeps the hash id of its key.  Integer keys are their own hash
+ * ids, so finding one only reads the slots, not the HashElems.
+ *
+ * The HashElems are allocated in blocks and never move, so callers can keep
+ * pointers to them.
  */
 
 #include "config.h"
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include "hash.h"
 #include "memory.h"
 #include "string2.h"
 
-#define SOME_PRIME 149711
+/// Multiplier for the hash functions, a 64-bit odd number
+#define HASH_MULTIPLIER 0x9e3779b97f4a7c15ULL
+
+/// Smallest number of slots in a Hash Table
+#define HASH_MIN_SLOTS 8
+
+/// Number of HashElems in the first block
+#define HASH_SLAB_MIN 16
+/// Maximum number of HashElems in a block
+#define HASH_SLAB_MAX 1024
+
+/**
+ * struct HashSlab - A block of HashElems
+ */
+struct HashSlab
+{
+  struct HashSlab *next;    ///< Next block
+  size_t size;              ///< Number of HashElems in the block
+  size_t used;              ///< Number of HashElems handed out
+  struct HashElem elems[];  ///< HashElems
+};
+
+/**
+ * hash_mix - Mix the bits of a hash id
+ * @param h Hash id
+ * @retval num Mixed hash id
+ *
+ * Every bit of the input affects every bit of the output, so the low bits can
+ * be used to pick a slot.
+ */
+static size_t hash_mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
 
 /**
  * gen_string_hash - Generate a hash from a string - Implements hash_gen_hash_t - @ingroup hash_gen_hash_api
  *
- * @note If the key is NULL or empty, the retval will be 0
+ * The string is hashed eight bytes at a time.
+ *
+ * @note If the key is NULL, the retval will be 0
  */
-static size_t gen_string_hash(union HashKey key, size_t num_elems)
+static size_t gen_string_hash(union HashKey key)
 {
-  size_t hash = 0;
-  const unsigned char *s = (const unsigned char *) key.strkey;
+  const char *s = key.strkey;
   if (!s)
     return 0;
 
-  while (*s != '\0')
-    hash += ((hash << 7) + *s++);
-  hash = (hash * SOME_PRIME) % num_elems;
+  const size_t len = strlen(s);
+  uint64_t h = len * HASH_MULTIPLIER;
+  uint64_t word = 0;
+
+  size_t i = 0;
+  for (; (i + sizeof(word)) <= len; i += sizeof(word))
+  {
+    memcpy(&word, s + i, sizeof(word));
+    h = (h ^ word) * HASH_MULTIPLIER;
+    h ^= h >> 32;
+  }
+
+  word = 0;
+  memcpy(&word, s + i, len - i);
+  h = (h ^ word) * HASH_MULTIPLIER;
 
-  return hash;
+  return hash_mix(h);
 }
 
 /**
@@ -66,20 +129,32 @@ static int cmp_string_key(union HashKey a, union HashKey b)
 /**
  * gen_case_string_hash - Generate a hash from a string (ignore the case) - Implements hash_gen_hash_t - @ingroup hash_gen_hash_api
  *
- * @note If the key is NULL or empty, the retval will be 0
+ * @note If the key is NULL, the retval will be 0
  */
-static size_t gen_case_string_hash(union HashKey key, size_t num_elems)
+static size_t gen_case_string_hash(union HashKey key)
 {
-  size_t hash = 0;
   const unsigned char *s = (const unsigned char *) key.strkey;
   if (!s)
     return 0;
 
-  while (*s != '\0')
-    hash += ((hash << 7) + tolower(*s++));
-  hash = (hash * SOME_PRIME) % num_elems;
+  uint64_t h = 0;
+  uint64_t word = 0;
+  size_t i = 0;
+
+  for (; s[i] != '\0'; i++)
+  {
+    word |= (uint64_t) tolower(s[i]) << (8 * (i % sizeof(word)));
+    if ((i % sizeof(word)) == (sizeof(word) - 1))
+    {
+      h = (h ^ word) * HASH_MULTIPLIER;
+      h ^= h >> 32;
+      word = 0;
+    }
+  }
+
+  h = (h ^ word ^ i) * HASH_MULTIPLIER;
 
-  return hash;
+  return hash_mix(h);
 }
 
 /**
@@ -92,10 +167,13 @@ static int cmp_case_string_key(union HashKey a, union HashKey b)
 
 /**
  * gen_int_hash - Generate a hash from an integer - Implements hash_gen_hash_t - @ingroup hash_gen_hash_api
+ *
+ * The integer is used as it is.  The keys are IMAP UIDs, which are mostly
+ * sequential, so they fill neighbouring slots without colliding.
  */
-static size_t gen_int_hash(union HashKey key, size_t num_elems)
+static size_t gen_int_hash(union HashKey key)
 {
-  return (key.intkey % num_elems);
+  return key.intkey;
 }
 
 /**
@@ -115,19 +193,185 @@ static int cmp_int_key(union HashKey a, union HashKey b)
  * @param num_elems Number of elements it should contain
  * @retval ptr New Hash Table
  *
- * The Hash Table can contain more elements than num_elems, but they will be
- * chained together.
+ * The number of slots is num_elems, rounded up to a power of two.
+ * The Hash Table will grow if it needs to.
  */
 static struct HashTable *hash_new(size_t num_elems)
 {
   struct HashTable *table = mutt_mem_calloc(1, sizeof(struct HashTable));
-  if (num_elems == 0)
-    num_elems = 2;
-  table->num_elems = num_elems;
-  table->table = mutt_mem_calloc(num_elems, sizeof(struct HashElem *));
+
+  size_t slots = HASH_MIN_SLOTS;
+  while (slots < num_elems)
+    slots *= 2;
+
+  table->num_elems = slots;
+  table->table = mutt_mem_calloc(slots, sizeof(struct HashSlot));
   return table;
 }
 
+/**
+ * hash_gen - Generate the hash id of a key
+ * @param table Hash Table
+ * @param key   Key (either string or integer)
+ * @retval num Hash id
+ *
+ * Integer keys are their own hash ids, so gen_int_hash() needn't be called.
+ */
+static inline size_t hash_gen(const struct HashTable *table, union HashKey key)
+{
+  if (table->int_keys)
+    return key.intkey;
+  return table->gen_hash(key);
+}
+
+/**
+ * hash_grow - Double the size of a Hash Table
+ * @param table Hash Table to grow
+ */
+static void hash_grow(struct HashTable *table)
+{
+  const size_t old_slots = table->num_elems;
+  struct HashSlot *old_table = table->table;
+
+  const size_t slots = old_slots * 2;
+  const size_t mask = slots - 1;
+  table->num_elems = slots;
+  table->table = mutt_mem_calloc(slots, sizeof(struct HashSlot));
+
+  /* The keys are unique, so there's no need to compare them */
+  for (size_t i = 0; i < old_slots; i++)
+  {
+    if (!old_table[i].elems)
+      continue;
+
+    size_t idx = old_table[i].hash & mask;
+    while (table->table[idx].elems)
+      idx = (idx + 1) & mask;
+
+    table->table[idx] = old_table[i];
+  }
+
+  FREE(&old_table);
+}
+
+/**
+ * hash_find_slot - Find the slot of a key
+ * @param[in]  table Hash Table to search
+ * @param[in]  key   Key (either string or integer)
+ * @param[in]  hash  Hash id of the key
+ * @param[out] slot  Slot of the key, or the free slot where it would go
+ * @retval true The key was found
+ */
+static inline bool hash_find_slot(const struct HashTable *table, union HashKey key,
+                                  size_t hash, size_t *slot)
+{
+  const struct HashSlot *slots = table->table;
+  const size_t mask = table->num_elems - 1;
+  size_t idx = hash & mask;
+
+  if (table->int_keys)
+  {
+    /* The hash id is the key, so the HashElems needn't be read */
+    for (; slots[idx].elems; idx = (idx + 1) & mask)
+    {
+      if (slots[idx].hash == hash)
+      {
+        *slot = idx;
+        return true;
+      }
+    }
+  }
+  else
+  {
+    for (; slots[idx].elems; idx = (idx + 1) & mask)
+    {
+      if ((slots[idx].hash == hash) && (table->cmp_key(slots[idx].elems->key, key) == 0))
+      {
+        *slot = idx;
+        return true;
+      }
+    }
+  }
+
+  *slot = idx;
+  return false;
+}
+
+/**
+ * hash_remove_slot - Empty a slot of a Hash Table
+ * @param table Hash Table
+ * @param slot  Slot to empty
+ *
+ * The keys that follow the slot are moved back, so that every key can still
+ * be reached from its home slot.
+ */
+static void hash_remove_slot(struct HashTable *table, size_t slot)
+{
+  const size_t mask = table->num_elems - 1;
+
+  for (size_t idx = (slot + 1) & mask; table->table[idx].elems; idx = (idx + 1) & mask)
+  {
+    /* Can the key move back to the empty slot? */
+    const size_t home = table->table[idx].hash & mask;
+    if (((idx - home) & mask) >= ((idx - slot) & mask))
+    {
+      table->table[slot] = table->table[idx];
+      slot = idx;
+    }
+  }
+
+  table->table[slot].elems = NULL;
+  table->table[slot].hash = 0;
+  table->num_keys--;
+}
+
+/**
+ * hash_elem_new - Get an unused HashElem
+ * @param table Hash Table
+ * @retval ptr Empty HashElem
+ */
+static struct HashElem *hash_elem_new(struct HashTable *table)
+{
+  struct HashElem *he = table->free_elems;
+  if (he)
+  {
+    table->free_elems = he->next;
+    he->next = NULL;
+    return he;
+  }
+
+  struct HashSlab *slab = table->slabs;
+  if (!slab || (slab->used == slab->size))
+  {
+    const size_t size = slab ? MIN(slab->size * 2, HASH_SLAB_MAX) : HASH_SLAB_MIN;
+    slab = mutt_mem_calloc(1, sizeof(struct HashSlab) + (size * sizeof(struct HashElem)));
+    slab->size = size;
+    slab->next = table->slabs;
+    table->slabs = slab;
+  }
+
+  return &slab->elems[slab->used++];
+}
+
+/**
+ * hash_elem_free - Free a HashElem and its data
+ * @param table Hash Table
+ * @param he    HashElem to free
+ *
+ * The HashElem is kept for reuse.
+ */
+static void hash_elem_free(struct HashTable *table, struct HashElem *he)
+{
+  if (table->hdata_free && he->data)
+    table->hdata_free(he->type, he->data, table->hdata);
+  if (table->strdup_keys)
+    FREE(&he->key.strkey);
+
+  memset(he, 0, sizeof(*he));
+  he->next = table->free_elems;
+  table->free_elems = he;
+}
+
 /**
  * union_hash_insert - Insert into a hash table using a union as a key
  * @param table Hash Table to update
@@ -142,38 +386,36 @@ static struct HashElem *union_hash_insert(struct HashTable *table,
   if (!table)
     return NULL; // LCOV_EXCL_LINE
 
-  struct HashElem *he = mutt_mem_calloc(1, sizeof(struct HashElem));
-  size_t hash = table->gen_hash(key, table->num_elems);
+  if (((table->num_keys + 1) * 4) > (table->num_elems * 3))
+    hash_grow(table);
+
+  const size_t hash = hash_gen(table, key);
+  size_t slot = 0;
+  const bool found = hash_find_slot(table, key, hash, &slot);
+
+  if (found && !table->allow_dups)
+  {
+    if (table->strdup_keys)
+      FREE(&key.strkey);
+    return NULL;
+  }
+
+  struct HashElem *he = hash_elem_new(table);
   he->key = key;
   he->data = data;
   he->type = type;
 
-  if (table->allow_dups)
+  if (found)
   {
-    he->next = table->table[hash];
-    table->table[hash] = he;
+    he->next = table->table[slot].elems;
   }
   else
   {
-    struct HashElem *tmp = NULL, *last = NULL;
-
-    for (tmp = table->table[hash], last = NULL; tmp; last = tmp, tmp = tmp->next)
-    {
-      const int rc = table->cmp_key(tmp->key, key);
-      if (rc == 0)
-      {
-        FREE(&he);
-        return NULL;
-      }
-      if (rc > 0)
-        break;
-    }
-    if (last)
-      last->next = he;
-    else
-      table->table[hash] = he;
-    he->next = tmp;
+    table->table[slot].hash = hash;
+    table->num_keys++;
   }
+  table->table[slot].elems = he;
+
   return he;
 }
 
@@ -183,19 +425,17 @@ static struct HashElem *union_hash_insert(struct HashTable *table,
  * @param key   Key (either string or integer)
  * @retval ptr HashElem matching the key
  */
-static struct HashElem *union_hash_find_elem(const struct HashTable *table, union HashKey key)
+static inline struct HashElem *union_hash_find_elem(const struct HashTable *table,
+                                                   union HashKey key)
 {
   if (!table)
     return NULL; // LCOV_EXCL_LINE
 
-  size_t hash = table->gen_hash(key, table->num_elems);
-  struct HashElem *he = table->table[hash];
-  for (; he; he = he->next)
-  {
-    if (table->cmp_key(key, he->key) == 0)
-      return he;
-  }
-  return NULL;
+  size_t slot = 0;
+  if (!hash_find_slot(table, key, hash_gen(table, key), &slot))
+    return NULL;
+
+  return table->table[slot].elems;
 }
 
 /**
@@ -225,21 +465,19 @@ static void union_hash_delete(struct HashTable *table, union HashKey key, const
   if (!table)
     return; // LCOV_EXCL_LINE
 
-  size_t hash = table->gen_hash(key, table->num_elems);
-  struct HashElem *he = table->table[hash];
-  struct HashElem **he_last = &table->table[hash];
+  size_t slot = 0;
+  if (!hash_find_slot(table, key, hash_gen(table, key), &slot))
+    return;
+
+  struct HashElem *he = table->table[slot].elems;
+  struct HashElem **he_last = &table->table[slot].elems;
 
   while (he)
   {
-    if (((data == he->data) || !data) && (table->cmp_key(he->key, key) == 0))
+    if ((data == he->data) || !data)
     {
       *he_last = he->next;
-      if (table->hdata_free)
-        table->hdata_free(he->type, he->data, table->hdata);
-      if (table->strdup_keys)
-        FREE(&he->key.strkey);
-      FREE(&he);
-
+      hash_elem_free(table, he);
       he = *he_last;
     }
     else
@@ -248,6 +486,9 @@ static void union_hash_delete(struct HashTable *table, union HashKey key, const
       he = he->next;
     }
   }
+
+  if (!table->table[slot].elems)
+    hash_remove_slot(table, slot);
 }
 
 /**
@@ -287,6 +528,7 @@ struct HashTable *mutt_hash_int_new(size_t num_elems, HashFlags flags)
   struct HashTable *table = hash_new(num_elems);
   table->gen_hash = gen_int_hash;
   table->cmp_key = cmp_int_key;
+  table->int_keys = true;
   if (flags & MUTT_HASH_ALLOW_DUPS)
     table->allow_dups = true;
   return table;
@@ -404,7 +646,8 @@ void *mutt_hash_int_find(const struct HashTable *table, unsigned int intkey)
  * @param strkey String key to search for
  * @retval ptr HashElem matching the key
  *
- * Unlike mutt_hash_find_elem(), this will return the first matching entry.
+ * The HashElems with the same key, see #MUTT_HASH_ALLOW_DUPS, are linked by
+ * HashElem::next.
  */
 struct HashElem *mutt_hash_find_bucket(const struct HashTable *table, const char *strkey)
 {
@@ -412,10 +655,8 @@ struct HashElem *mutt_hash_find_bucket(const struct HashTable *table, const char
     return NULL;
 
   union HashKey key;
-
   key.strkey = strkey;
-  size_t hash = table->gen_hash(key, table->num_elems);
-  return table->table[hash];
+  return union_hash_find_elem(table, key);
 }
 
 /**
@@ -460,21 +701,28 @@ void mutt_hash_free(struct HashTable **ptr)
     return;
 
   struct HashTable *table = *ptr;
-  struct HashElem *he = NULL, *tmp = NULL;
 
-  for (size_t i = 0; i < table->num_elems; i++)
+  /* The HashElems only need visiting if they own something */
+  for (size_t i = 0; (table->hdata_free || table->strdup_keys) && (i < table->num_elems); i++)
   {
-    for (he = table->table[i]; he;)
+    for (struct HashElem *he = table->table[i].elems; he;)
     {
-      tmp = he;
+      struct HashElem *tmp = he;
       he = he->next;
       if (table->hdata_free && tmp->data)
         table->hdata_free(tmp->type, tmp->data, table->hdata);
       if (table->strdup_keys)
         FREE(&tmp->key.strkey);
-      FREE(&tmp);
     }
   }
+
+  while (table->slabs)
+  {
+    struct HashSlab *slab = table->slabs;
+    table->slabs = slab->next;
+    FREE(&slab);
+  }
+
   FREE(&table->table);
   FREE(ptr);
 }
@@ -502,9 +750,9 @@ struct HashElem *mutt_hash_walk(const struct HashTable *table, struct HashWalkSt
 
   while (state->index < table->num_elems)
   {
-    if (table->table[state->index])
+    if (table->table[state->index].elems)
     {
-      state->last = table->table[state->index];
+      state->last = table->table[state->index].elems;
       return state->last;
     }
     state->index++;
@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+struct HashSlab;
+
 /**
  * union HashKey - The data item stored in a HashElem
  */
@@ -45,7 +47,7 @@ struct HashElem
   int type;              ///< Type of data stored in Hash Table, e.g. #DT_STRING
   union HashKey key;     ///< Key representing the data
   void *data;            ///< User-supplied data
-  struct HashElem *next; ///< Linked List
+  struct HashElem *next; ///< Next element with the same key
 };
 
 /**
@@ -66,13 +68,13 @@ typedef void (*hash_hdata_free_t)(int type, void *obj, intptr_t data);
  *
  * Prototype for a Key hashing function
  *
- * @param key       Key to hash
- * @param num_elems Number of elements in the Hash Table
+ * @param key Key to hash
  *
  * Turn a Key (a string or an integer) into a hash id.
- * The hash id will be a number between 0 and (num_elems-1).
+ * The Hash Table only uses as many of the low bits as it needs, so they
+ * should vary between keys.
  */
-typedef size_t (*hash_gen_hash_t)(union HashKey key, size_t num_elems);
+typedef size_t (*hash_gen_hash_t)(union HashKey key);
 
 /**
  * @defgroup hash_cmp_key_api Hash Table Compare API
@@ -89,21 +91,38 @@ typedef size_t (*hash_gen_hash_t)(union HashKey key, size_t num_elems);
  */
 typedef int (*hash_cmp_key_t)(union HashKey a, union HashKey b);
 
+/**
+ * struct HashSlot - A slot of a Hash Table
+ *
+ * The hash id is kept next to the HashElems, so a probe only touches the
+ * slot array.
+ */
+struct HashSlot
+{
+  size_t hash;            ///< Hash id of the key
+  struct HashElem *elems; ///< HashElems with the key, NULL if the slot is free
+};
+
 /**
  * struct HashTable - A Hash Table
  *
- * @note The number of actual elements in the HashTable isn't recorded.
+ * Each slot holds the HashElems with one key.  Colliding keys are stored in
+ * the following free slot.  The table doubles in size when it's 3/4 full.
  */
 struct HashTable
 {
-  size_t num_elems;             ///< Number of buckets in the Hash Table
+  size_t num_elems;             ///< Number of slots in the Hash Table, a power of two
+  size_t num_keys;              ///< Number of slots in use
   bool strdup_keys : 1;         ///< if set, the key->strkey is strdup()'d
   bool allow_dups  : 1;         ///< if set, duplicate keys are allowed
-  struct HashElem **table;      ///< Array of Hash keys
+  bool int_keys    : 1;         ///< if set, the keys are integers and their own hash ids
+  struct HashSlot *table;       ///< Array of slots
   hash_gen_hash_t gen_hash;     ///< Function to generate hash id from the key
   hash_cmp_key_t cmp_key;       ///< Function to compare two Hash keys
   intptr_t hdata;               ///< Data to pass to the hdata_free() function
   hash_hdata_free_t hdata_free; ///< Function to free a Hash element
+  struct HashSlab *slabs;       ///< Blocks of memory for the HashElems
+  struct HashElem *free_elems;  ///< HashElems that can be reused
 };
 
 typedef uint8_t HashFlags;             ///< Flags for mutt_hash_new(), e.g. #MUTT_HASH_STRCASECMP
@@ -132,7 +151,7 @@ struct HashElem * mutt_hash_typed_insert  (struct HashTable *table, const char *
 struct HashWalkState
 {
   size_t index;          ///< Current position in table
-  struct HashElem *last; ///< Current element in linked list
+  struct HashElem *last; ///< Current element in the slot
 };
 
 struct HashElem *mutt_hash_walk(const struct HashTable *table, struct HashWalkState *state);
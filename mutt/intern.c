@@ -0,0 +1,168 @@
+/**
+ * @file
+ * Shared copies of common strings
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mutt_intern Shared copies of common strings
+ *
+ * Many strings are repeated in every Email of a Mailbox, e.g. the MIME subtype
+ * "plain", the charset "utf-8", or a mailing list's `List-Post` address.
+ *
+ * mutt_intern_get() returns a shared, reference-counted copy of a string.
+ * Equal strings get the same pointer, so they can be compared cheaply, see
+ * mutt_str_equal().
+ *
+ * A shared string must not be changed.  It must be released with
+ * mutt_intern_free(), which also frees ordinary strings.  This means that a
+ * field can hold either kind of string, as long as it's always freed with
+ * mutt_intern_free().
+ *
+ * @note The pool isn't thread-safe.  It should only be used by the main thread.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <string.h>
+#include "intern.h"
+#include "hash.h"
+#include "memory.h"
+
+/**
+ * struct InternString - A shared string
+ */
+struct InternString
+{
+  size_t refs; ///< Number of users of the string
+  char str[];  ///< String
+};
+
+/// Shared strings: String -> InternString
+static struct HashTable *InternStrings = NULL;
+
+/**
+ * intern_find - Find the shared copy of a string
+ * @param str String to find
+ * @retval ptr  Shared string
+ * @retval NULL String isn't shared
+ */
+static struct InternString *intern_find(const char *str)
+{
+  if (!InternStrings)
+    return NULL;
+
+  return mutt_hash_find(InternStrings, str);
+}
+
+/**
+ * mutt_intern_get - Get a shared copy of a string
+ * @param str String to share
+ * @retval ptr  Shared string
+ * @retval NULL @a str was NULL
+ *
+ * @note The string must not be changed.
+ * @note The string must be freed using mutt_intern_free()
+ */
+char *mutt_intern_get(const char *str)
+{
+  if (!str)
+    return NULL;
+
+  // The Hash Table can't delete an empty key, so don't share it
+  if (str[0] == '\0')
+    return mutt_mem_calloc(1, 1);
+
+  struct InternString *is = intern_find(str);
+  if (is)
+  {
+    is->refs++;
+    return is->str;
+  }
+
+  if (!InternStrings)
+    InternStrings = mutt_hash_new(256, MUTT_HASH_NO_FLAGS);
+
+  const size_t len = strlen(str) + 1;
+  is = mutt_mem_malloc(sizeof(struct InternString) + len);
+  is->refs = 1;
+  memcpy(is->str, str, len);
+
+  mutt_hash_insert(InternStrings, is->str, is);
+  return is->str;
+}
+
+/**
+ * mutt_intern_free - Free a string that may be shared
+ * @param[out] ptr String to free
+ *
+ * A shared string is freed when its last user releases it.  Any other string
+ * is freed immediately.
+ */
+void mutt_intern_free(char **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct InternString *is = intern_find(*ptr);
+  if (!is || (is->str != *ptr))
+  {
+    FREE(ptr);
+    return;
+  }
+
+  *ptr = NULL;
+  if (--is->refs > 0)
+    return;
+
+  mutt_hash_delete(InternStrings, is->str, is);
+  FREE(&is);
+
+  if (mutt_intern_count() == 0)
+    mutt_hash_free(&InternStrings);
+}
+
+/**
+ * mutt_intern_replace - Replace a string with a shared copy of another
+ * @param[out] ptr String to replace
+ * @param[in]  str New string, may be NULL
+ *
+ * @a str may point into the old string.
+ */
+void mutt_intern_replace(char **ptr, const char *str)
+{
+  if (!ptr)
+    return;
+
+  char *old = *ptr;
+  *ptr = mutt_intern_get(str);
+  mutt_intern_free(&old);
+}
+
+/**
+ * mutt_intern_count - How many different strings are shared?
+ * @retval num Number of shared strings
+ */
+size_t mutt_intern_count(void)
+{
+  if (!InternStrings)
+    return 0;
+
+  return InternStrings->num_keys;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file
+ * Shared copies of common strings
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MUTT_INTERN_H
+#define MUTT_MUTT_INTERN_H
+
+#include <stddef.h>
+
+size_t mutt_intern_count  (void);
+void   mutt_intern_free   (char **ptr);
+char * mutt_intern_get    (const char *str);
+void   mutt_intern_replace(char **ptr, const char *str);
+
+#endif /* MUTT_MUTT_INTERN_H */
@@ -41,6 +41,7 @@
  * | mutt/file.c      | @subpage mutt_file      |
  * | mutt/filter.c    | @subpage mutt_filter    |
  * | mutt/hash.c      | @subpage mutt_hash      |
+ * | mutt/intern.c    | @subpage mutt_intern    |
  * | mutt/list.c      | @subpage mutt_list      |
  * | mutt/logging.c   | @subpage mutt_logging   |
  * | mutt/mapping.c   | @subpage mutt_mapping   |
@@ -81,6 +82,7 @@
 #include "file.h"
 #include "filter.h"
 #include "hash.h"
+#include "intern.h"
 #include "list.h"
 #include "logging2.h"
 #include "mapping.h"
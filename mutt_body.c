@@ -75,6 +75,7 @@ int mutt_body_copy(FILE *fp, struct Body **tgt, struct Body *src)
   b = *tgt;
 
   memcpy(b, src, sizeof(struct Body));
+  b->arena = NULL;
   TAILQ_INIT(&b->parameter);
   b->parts = NULL;
   b->next = NULL;
@@ -326,6 +326,9 @@ static struct ConfigDef MainVars[] = {
   { "mail_check_stats_interval", DT_NUMBER|DT_NOT_NEGATIVE, 60, 0, NULL,
     "How often to check for new mail"
   },
+  { "mail_check_threads", DT_NUMBER|DT_NOT_NEGATIVE, 4, 0, NULL,
+    "Number of threads used to check Maildir mailboxes for new mail"
+  },
   { "mailcap_path", DT_SLIST|SLIST_SEP_COLON, IP "~/.mailcap:" PKGDATADIR "/mailcap:" SYSCONFDIR "/mailcap:/etc/mailcap:/usr/etc/mailcap:/usr/local/etc/mailcap", 0, NULL,
     "List of mailcap files (colon-separated)"
   },
@@ -35,14 +35,21 @@
 #include "core/lib.h"
 #include "gui/lib.h"
 #include "mutt_mailbox.h"
+#include "maildir/lib.h"
 #include "postpone/lib.h"
+#include "globals.h"
 #include "muttlib.h"
 #include "mx.h"
+#ifdef USE_IMAP
+#include "imap/lib.h"
+#endif
 
 static time_t MailboxTime = 0; ///< last time we started checking for mail
 static time_t MailboxStatsTime = 0; ///< last time we check performed mail_check_stats
 static short MailboxCount = 0;  ///< how many boxes with new mail
 static short MailboxNotify = 0; ///< # of unnotified new boxes
+static struct MdCheck *MailboxChecks = NULL; ///< Maildir mailboxes being checked in the background
+static bool MailboxStatusPending = false; ///< IMAP STATUS replies are awaited
 
 /**
  * is_same_mailbox - Compare two Mailboxes to see if they're equal
@@ -77,9 +84,10 @@ static bool is_same_mailbox(struct Mailbox *m1, struct Mailbox *m2,
  * @param m_check Mailbox to check
  * @param st_cur  stat() info for the current Mailbox
  * @param flags   Flags, e.g. #MUTT_MAILBOX_CHECK_FORCE
+ * @param mc      Background checks of Maildir mailboxes (OPTIONAL)
  */
 static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
-                          struct stat *st_cur, CheckStatsFlags flags)
+                          struct stat *st_cur, CheckStatsFlags flags, struct MdCheck *mc)
 {
   struct stat st = { 0 };
 
@@ -129,10 +137,16 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
       case MUTT_IMAP:
       case MUTT_MBOX:
       case MUTT_MMDF:
-      case MUTT_MAILDIR:
       case MUTT_MH:
         mx_mbox_check_stats(m_check, flags);
         break;
+      case MUTT_MAILDIR:
+        /* If an earlier background check is still running, it'll do */
+        if (mc)
+          maildir_check_add(mc, m_check, (flags & MUTT_MAILBOX_CHECK_FORCE_STATS));
+        else if (!MailboxChecks)
+          mx_mbox_check_stats(m_check, flags);
+        break;
       default:; /* do nothing */
     }
   }
@@ -140,11 +154,115 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
   {
     m_check->size = (off_t) st.st_size; /* update the size of current folder */
   }
+}
+
+/**
+ * mailbox_count_new - Count the Mailboxes with new mail
+ *
+ * This updates MailboxCount and MailboxNotify.
+ */
+static void mailbox_count_new(void)
+{
+  MailboxCount = 0;
+  MailboxNotify = 0;
+
+  struct MailboxList ml = STAILQ_HEAD_INITIALIZER(ml);
+  neomutt_mailboxlist_get_all(&ml, NeoMutt, MUTT_MAILBOX_ANY);
+  struct MailboxNode *np = NULL;
+  STAILQ_FOREACH(np, &ml, entries)
+  {
+    struct Mailbox *m = np->mailbox;
+    if (!m->visible)
+      continue;
 
-  if (!m_check->has_new)
-    m_check->notified = false;
-  else if (!m_check->notified)
-    MailboxNotify++;
+    if (!m->has_new)
+    {
+      m->notified = false;
+      continue;
+    }
+
+    MailboxCount++;
+    if (!m->notified)
+      MailboxNotify++;
+  }
+  neomutt_mailboxlist_clear(&ml);
+}
+
+/**
+ * mailbox_check_collect - Collect the results of the background checks
+ * @param wait Wait for the Maildir checks to finish
+ * @retval true Some results are still awaited
+ *
+ * @note Emits: #NT_MAILBOX_CHANGE
+ */
+static bool mailbox_check_collect(bool wait)
+{
+  bool changed = false;
+
+  if (MailboxChecks)
+  {
+    struct Mailbox *m = NULL;
+    while ((m = maildir_check_apply(MailboxChecks, wait)))
+    {
+      struct EventMailbox ev_m = { m };
+      notify_send(m->notify, NT_MAILBOX, NT_MAILBOX_CHANGE, &ev_m);
+      changed = true;
+    }
+
+    if (!maildir_check_busy(MailboxChecks))
+      maildir_check_free(&MailboxChecks);
+  }
+
+#ifdef USE_IMAP
+  if (MailboxStatusPending)
+  {
+    /* Each STATUS reply updates its Mailbox */
+    MailboxStatusPending = false;
+    struct Account *a = NULL;
+    TAILQ_FOREACH(a, &NeoMutt->accounts, entries)
+    {
+      if (imap_status_poll(a))
+        MailboxStatusPending = true;
+    }
+    changed = true;
+  }
+#endif
+
+  if (changed)
+    mailbox_count_new();
+
+  return MailboxChecks || MailboxStatusPending;
+}
+
+/**
+ * mutt_mailbox_check_poll - Collect the results of the background mail checks
+ * @retval true Some results are still awaited
+ *
+ * mutt_mailbox_check() checks Maildir mailboxes in the background, and
+ * doesn't wait for the replies from IMAP servers.  Call this regularly, while
+ * waiting for the user, to update the Mailboxes as the results arrive.
+ */
+bool mutt_mailbox_check_poll(void)
+{
+  return mailbox_check_collect(false);
+}
+
+/**
+ * mutt_mailbox_check_busy - Are the background mail checks running?
+ * @retval true Worker threads may still be running
+ */
+bool mutt_mailbox_check_busy(void)
+{
+  return MailboxChecks != NULL;
+}
+
+/**
+ * mutt_mailbox_cleanup - Stop the background mail checks
+ */
+void mutt_mailbox_cleanup(void)
+{
+  maildir_check_free(&MailboxChecks);
+  MailboxStatusPending = false;
 }
 
 /**
@@ -154,6 +272,11 @@ static void mailbox_check(struct Mailbox *m_cur, struct Mailbox *m_check,
  * @retval num Number of mailboxes with new mail
  *
  * Check all all Mailboxes for new mail and total/new/flagged messages
+ *
+ * Unless #MUTT_MAILBOX_CHECK_IMMEDIATE is set, Maildir mailboxes are checked
+ * in the background, see `$mail_check_threads`, and the replies to IMAP
+ * STATUS commands aren't waited for.  Their results are collected by
+ * mutt_mailbox_check_poll().
  */
 int mutt_mailbox_check(struct Mailbox *m_cur, CheckStatsFlags flags)
 {
@@ -168,6 +291,10 @@ int mutt_mailbox_check(struct Mailbox *m_cur, CheckStatsFlags flags)
   const short c_mail_check = cs_subset_number(NeoMutt->sub, "mail_check");
   const bool c_mail_check_stats = cs_subset_bool(NeoMutt->sub, "mail_check_stats");
   const short c_mail_check_stats_interval = cs_subset_number(NeoMutt->sub, "mail_check_stats_interval");
+  const short c_mail_check_threads = cs_subset_number(NeoMutt->sub, "mail_check_threads");
+
+  const bool wait = (flags & MUTT_MAILBOX_CHECK_IMMEDIATE) || OptNoCurses;
+  mailbox_check_collect(wait);
 
   time_t t = mutt_date_now();
   if ((flags == MUTT_MAILBOX_CHECK_NO_FLAGS) && (t - MailboxTime < c_mail_check))
@@ -181,8 +308,6 @@ int mutt_mailbox_check(struct Mailbox *m_cur, CheckStatsFlags flags)
   }
 
   MailboxTime = t;
-  MailboxCount = 0;
-  MailboxNotify = 0;
 
   /* check device ID and serial number instead of comparing paths */
   struct stat st_cur = { 0 };
@@ -196,6 +321,10 @@ int mutt_mailbox_check(struct Mailbox *m_cur, CheckStatsFlags flags)
     st_cur.st_ino = 0;
   }
 
+  struct MdCheck *mc = NULL;
+  if ((c_mail_check_threads > 0) && !MailboxChecks)
+    mc = maildir_check_new();
+
   struct MailboxList ml = STAILQ_HEAD_INITIALIZER(ml);
   neomutt_mailboxlist_get_all(&ml, NeoMutt, MUTT_MAILBOX_ANY);
   struct MailboxNode *np = NULL;
@@ -209,13 +338,30 @@ int mutt_mailbox_check(struct Mailbox *m_cur, CheckStatsFlags flags)
     {
       m_flags |= MUTT_MAILBOX_CHECK_FORCE_STATS;
     }
-    mailbox_check(m_cur, np->mailbox, &st_cur, m_flags);
-    if (np->mailbox->has_new)
-      MailboxCount++;
+    mailbox_check(m_cur, np->mailbox, &st_cur, m_flags, mc);
     np->mailbox->first_check_stats_done = true;
   }
   neomutt_mailboxlist_clear(&ml);
 
+  if (mc)
+  {
+    maildir_check_start(mc, c_mail_check_threads);
+    MailboxChecks = mc;
+  }
+
+#ifdef USE_IMAP
+  /* Send the queued STATUS commands now, rather than with the next command */
+  struct Account *a = NULL;
+  TAILQ_FOREACH(a, &NeoMutt->accounts, entries)
+  {
+    if (imap_status_send(a))
+      MailboxStatusPending = true;
+  }
+#endif
+
+  mailbox_check_collect(wait);
+  mailbox_count_new();
+
   return MailboxCount;
 }
 
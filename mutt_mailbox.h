@@ -28,7 +28,13 @@
 struct Buffer;
 struct stat;
 
+/// How often to collect the results of background mail checks, in milliseconds
+#define MUTT_MAILBOX_CHECK_POLL 250
+
 int  mutt_mailbox_check       (struct Mailbox *m_cur, CheckStatsFlags flags);
+void mutt_mailbox_cleanup     (void);
+bool mutt_mailbox_check_poll  (void);
+bool mutt_mailbox_check_busy  (void);
 void mailbox_restore_timestamp(const char *path, struct stat *st);
 bool mutt_mailbox_list        (void);
 struct Mailbox *mutt_mailbox_next(struct Mailbox *m_cur, struct Buffer *s);
@@ -44,6 +44,23 @@
 #include "protos.h"
 #include "sort.h"
 
+/// Config handle for $use_threads
+static struct ConfigHandle HandleUseThreads = CONFIG_HANDLE("use_threads");
+/// Config handle for $sort
+static struct ConfigHandle HandleSort = CONFIG_HANDLE("sort");
+/// Config handle for $hide_thread_subject
+static struct ConfigHandle HandleHideThreadSubject = CONFIG_HANDLE("hide_thread_subject");
+/// Config handle for $thread_received
+static struct ConfigHandle HandleThreadReceived = CONFIG_HANDLE("thread_received");
+/// Config handle for $sort_re
+static struct ConfigHandle HandleSortRe = CONFIG_HANDLE("sort_re");
+/// Config handle for $collapse_flagged
+static struct ConfigHandle HandleCollapseFlagged = CONFIG_HANDLE("collapse_flagged");
+/// Config handle for $collapse_unread
+static struct ConfigHandle HandleCollapseUnread = CONFIG_HANDLE("collapse_unread");
+
+ARRAY_HEAD(MuttThreadArray, struct MuttThread *);
+
 /**
  * UseThreadsMethods - Choices for '$use_threads' for the index
  */
@@ -78,8 +95,8 @@ const struct EnumDef UseThreadsTypeDef = {
  */
 enum UseThreads mutt_thread_style(void)
 {
-  const unsigned char c_use_threads = cs_subset_enum(NeoMutt->sub, "use_threads");
-  const enum SortType c_sort = cs_subset_sort(NeoMutt->sub, "sort");
+  const unsigned char c_use_threads = ch_enum(NeoMutt->sub, &HandleUseThreads);
+  const enum SortType c_sort = ch_sort(NeoMutt->sub, &HandleSort);
   if (c_use_threads > UT_FLAT)
     return c_use_threads;
   if ((c_sort & SORT_MASK) != SORT_THREADS)
@@ -134,7 +151,7 @@ static bool need_display_subject(struct Email *e)
   struct MuttThread *tree = e->thread;
 
   /* if the user disabled subject hiding, display it */
-  const bool c_hide_thread_subject = cs_subset_bool(NeoMutt->sub, "hide_thread_subject");
+  const bool c_hide_thread_subject = ch_bool(NeoMutt->sub, &HandleHideThreadSubject);
   if (!c_hide_thread_subject)
     return true;
 
@@ -525,8 +542,8 @@ static void make_subject_list(struct ListHead *subjects, struct MuttThread *cur,
   time_t thisdate;
   int rc = 0;
 
-  const bool c_thread_received = cs_subset_bool(NeoMutt->sub, "thread_received");
-  const bool c_sort_re = cs_subset_bool(NeoMutt->sub, "sort_re");
+  const bool c_thread_received = ch_bool(NeoMutt->sub, &HandleThreadReceived);
+  const bool c_sort_re = ch_bool(NeoMutt->sub, &HandleSortRe);
   while (true)
   {
     while (!cur->message)
@@ -565,6 +582,25 @@ static void make_subject_list(struct ListHead *subjects, struct MuttThread *cur,
   }
 }
 
+/**
+ * is_later - Was one Email sent after another?
+ * @param a        First Email
+ * @param b        Second Email
+ * @param received If true, compare the received dates
+ * @retval true @a a is later than @a b
+ *
+ * If the dates are the same, the Email that arrived later wins.  This doesn't
+ * depend on the order of the Emails in the Mailbox.
+ */
+static bool is_later(const struct Email *a, const struct Email *b, bool received)
+{
+  const time_t date_a = received ? a->received : a->date_sent;
+  const time_t date_b = received ? b->received : b->date_sent;
+  if (date_a != date_b)
+    return date_a > date_b;
+  return a->index > b->index;
+}
+
 /**
  * find_subject - Find the best possible match for a parent based on subject
  * @param m   Mailbox
@@ -587,7 +623,7 @@ static struct MuttThread *find_subject(struct Mailbox *m, struct MuttThread *cur
   make_subject_list(&subjects, cur, &date);
 
   struct ListNode *np = NULL;
-  const bool c_thread_received = cs_subset_bool(NeoMutt->sub, "thread_received");
+  const bool c_thread_received = ch_bool(NeoMutt->sub, &HandleThreadReceived);
   STAILQ_FOREACH(np, &subjects, entries)
   {
     for (he = mutt_hash_find_bucket(m->subj_hash, np->data); he; he = he->next)
@@ -598,9 +634,7 @@ static struct MuttThread *find_subject(struct Mailbox *m, struct MuttThread *cur
           tmp->message->subject_changed && /* only match interesting replies */
           !is_descendant(tmp, cur) &&      /* don't match in the same thread */
           (date >= (c_thread_received ? tmp->message->received : tmp->message->date_sent)) &&
-          (!last || (c_thread_received ?
-                         (last->message->received < tmp->message->received) :
-                         (last->message->date_sent < tmp->message->date_sent))) &&
+          (!last || is_later(tmp->message, last->message, c_thread_received)) &&
           tmp->message->env->real_subj &&
           mutt_str_equal(np->data, tmp->message->env->real_subj))
       {
@@ -637,11 +671,121 @@ static struct HashTable *make_subj_hash(struct Mailbox *m)
   return hash;
 }
 
+/**
+ * pseudo_thread - Thread a message by subject
+ * @param m   Mailbox
+ * @param top Top of the thread tree
+ * @param cur Top-level thread to attach
+ */
+static void pseudo_thread(struct Mailbox *m, struct MuttThread **top, struct MuttThread *cur)
+{
+  struct MuttThread *tmp = NULL, *curchild = NULL, *nextchild = NULL;
+
+  struct MuttThread *parent = find_subject(m, cur);
+  if (!parent)
+    return;
+
+  cur->fake_thread = true;
+  unlink_message(top, cur);
+  insert_message(&parent->child, parent, cur);
+  parent->sort_children = true;
+  tmp = cur;
+  while (true)
+  {
+    while (!tmp->message)
+      tmp = tmp->child;
+
+    /* if the message we're attaching has pseudo-children, they
+     * need to be attached to its parent, so move them up a level.
+     * but only do this if they have the same real subject as the
+     * parent, since otherwise they rightly belong to the message
+     * we're attaching. */
+    if ((tmp == cur) || mutt_str_equal(tmp->message->env->real_subj,
+                                       parent->message->env->real_subj))
+    {
+      tmp->message->subject_changed = false;
+
+      for (curchild = tmp->child; curchild;)
+      {
+        nextchild = curchild->next;
+        if (curchild->fake_thread)
+        {
+          unlink_message(&tmp->child, curchild);
+          insert_message(&parent->child, parent, curchild);
+        }
+        curchild = nextchild;
+      }
+    }
+
+    while (!tmp->next && (tmp != cur))
+    {
+      tmp = tmp->parent;
+    }
+    if (tmp == cur)
+      break;
+    tmp = tmp->next;
+  }
+}
+
+/**
+ * struct PseudoRoot - A top-level thread to be threaded by subject
+ */
+struct PseudoRoot
+{
+  struct MuttThread *thread; ///< Top-level thread
+  int first;                 ///< Lowest Email index in the thread
+};
+ARRAY_HEAD(PseudoRootArray, struct PseudoRoot);
+
+/**
+ * thread_first_index - Find the first Email of a thread to arrive
+ * @param thread Top of the thread
+ * @retval num Lowest Email.index in the thread
+ */
+static int thread_first_index(const struct MuttThread *thread)
+{
+  int first = INT_MAX;
+  const struct MuttThread *tmp = thread;
+  while (true)
+  {
+    if (tmp->message && (tmp->message->index < first))
+      first = tmp->message->index;
+
+    if (tmp->child)
+    {
+      tmp = tmp->child;
+      continue;
+    }
+
+    while (!tmp->next && (tmp != thread))
+      tmp = tmp->parent;
+    if (tmp == thread)
+      break;
+    tmp = tmp->next;
+  }
+
+  return first;
+}
+
+/**
+ * pseudo_root_sort - Compare two top-level threads - Implements ::sort_t - @ingroup sort_api
+ */
+static int pseudo_root_sort(const void *a, const void *b)
+{
+  const struct PseudoRoot *ra = a;
+  const struct PseudoRoot *rb = b;
+  return rb->first - ra->first;
+}
+
 /**
  * pseudo_threads - Thread messages by subject
  * @param tctx Threading context
  *
  * Thread by subject things that didn't get threaded by message-id
+ *
+ * The threads are visited in a fixed order, the most recent arrival first, so
+ * the result doesn't depend on how the Mailbox was sorted.  This allows new
+ * mail to be threaded without starting from scratch.
  */
 static void pseudo_threads(struct ThreadsContext *tctx)
 {
@@ -650,64 +794,63 @@ static void pseudo_threads(struct ThreadsContext *tctx)
 
   struct Mailbox *m = tctx->mailbox_view->mailbox;
 
-  struct MuttThread *tree = tctx->tree;
-  struct MuttThread *top = tree;
-  struct MuttThread *tmp = NULL, *cur = NULL, *parent = NULL, *curchild = NULL,
-                    *nextchild = NULL;
-
   if (!m->subj_hash)
     m->subj_hash = make_subj_hash(m);
 
-  while (tree)
+  struct PseudoRootArray roots = ARRAY_HEAD_INITIALIZER;
+  for (struct MuttThread *tree = tctx->tree; tree; tree = tree->next)
   {
-    cur = tree;
-    tree = tree->next;
-    parent = find_subject(m, cur);
-    if (parent)
-    {
-      cur->fake_thread = true;
-      unlink_message(&top, cur);
-      insert_message(&parent->child, parent, cur);
-      parent->sort_children = true;
-      tmp = cur;
-      while (true)
-      {
-        while (!tmp->message)
-          tmp = tmp->child;
+    struct PseudoRoot root = { tree, thread_first_index(tree) };
+    ARRAY_ADD(&roots, root);
+  }
+  ARRAY_SORT(&roots, pseudo_root_sort);
 
-        /* if the message we're attaching has pseudo-children, they
-         * need to be attached to its parent, so move them up a level.
-         * but only do this if they have the same real subject as the
-         * parent, since otherwise they rightly belong to the message
-         * we're attaching. */
-        if ((tmp == cur) || mutt_str_equal(tmp->message->env->real_subj,
-                                           parent->message->env->real_subj))
-        {
-          tmp->message->subject_changed = false;
+  struct PseudoRoot *root = NULL;
+  ARRAY_FOREACH(root, &roots)
+  {
+    pseudo_thread(m, &tctx->tree, root->thread);
+  }
+  ARRAY_FREE(&roots);
+}
 
-          for (curchild = tmp->child; curchild;)
-          {
-            nextchild = curchild->next;
-            if (curchild->fake_thread)
-            {
-              unlink_message(&tmp->child, curchild);
-              insert_message(&parent->child, parent, curchild);
-            }
-            curchild = nextchild;
-          }
-        }
+/**
+ * release_pseudo_threads - Detach all the threads that were attached by subject
+ * @param tctx Threading context
+ *
+ * The threads are moved back to the top level, leaving the tree as it was
+ * after threading by message-id.  New mail may change which threads match.
+ */
+static void release_pseudo_threads(struct ThreadsContext *tctx)
+{
+  struct MuttThreadArray fakes = ARRAY_HEAD_INITIALIZER;
 
-        while (!tmp->next && (tmp != cur))
-        {
-          tmp = tmp->parent;
-        }
-        if (tmp == cur)
-          break;
-        tmp = tmp->next;
-      }
+  struct MuttThread *tmp = tctx->tree;
+  while (tmp)
+  {
+    if (tmp->fake_thread)
+      ARRAY_ADD(&fakes, tmp);
+
+    if (tmp->child)
+    {
+      tmp = tmp->child;
+      continue;
     }
+
+    while (tmp && !tmp->next)
+      tmp = tmp->parent;
+    if (tmp)
+      tmp = tmp->next;
   }
-  tctx->tree = top;
+
+  struct MuttThread **tp = NULL;
+  ARRAY_FOREACH(tp, &fakes)
+  {
+    struct MuttThread *thread = *tp;
+    unlink_message(&thread->parent->child, thread);
+    insert_message(&tctx->tree, NULL, thread);
+    thread->fake_thread = false;
+  }
+  ARRAY_FREE(&fakes);
 }
 
 /**
@@ -738,9 +881,48 @@ void mutt_clear_threads(struct ThreadsContext *tctx)
     e->threaded = false;
   }
   tctx->tree = NULL;
+  tctx->num_threaded = 0;
   mutt_hash_free(&tctx->hash);
 }
 
+/**
+ * mutt_thread_first_new - Find the first Email that hasn't been threaded
+ * @param tctx Threading context
+ * @retval num Index of the first new Email, or the number of Emails
+ * @retval -1  The threads must be rebuilt from scratch
+ *
+ * If Emails have only been appended to the Mailbox since it was last threaded,
+ * mutt_sort_threads() can link the new ones into the existing threads.
+ */
+int mutt_thread_first_new(struct ThreadsContext *tctx)
+{
+  if (!tctx || !tctx->tree || !tctx->hash || !tctx->mailbox_view)
+    return -1;
+
+  struct Mailbox *m = tctx->mailbox_view->mailbox;
+  if (!m || !m->emails || (m->msg_count < tctx->num_threaded))
+    return -1;
+
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e)
+      return -1;
+
+    if (i < tctx->num_threaded)
+    {
+      if (!e->thread || (e->thread->message != e))
+        return -1;
+    }
+    else if (e->thread)
+    {
+      return -1;
+    }
+  }
+
+  return tctx->num_threaded;
+}
+
 /**
  * compare_threads - qsort_r() function for comparing email threads
  * @param a   First thread to compare
@@ -773,6 +955,73 @@ static int compare_threads(const void *a, const void *b, void *arg)
   }
 }
 
+/**
+ * sort_siblings - Sort an array of sibling threads
+ * @param array Siblings, last one first
+ * @param num   Number of siblings
+ * @param tctx  Threading context
+ *
+ * Siblings that haven't moved and whose sort keys haven't changed are still in
+ * order.  Only the others need sorting, before they're merged back in.  When a
+ * few messages arrive, this saves re-sorting every thread in the mailbox.
+ */
+static void sort_siblings(struct MuttThread **array, int num, struct ThreadsContext *tctx)
+{
+  int num_dirty = 0;
+  for (int i = 0; i < num; i++)
+    if (array[i]->sort_dirty)
+      num_dirty++;
+
+  if (num_dirty == num)
+  {
+    mutt_qsort_r((void *) array, num, sizeof(struct MuttThread *), compare_threads, tctx);
+    for (int i = 0; i < num; i++)
+      array[i]->sort_dirty = false;
+    return;
+  }
+
+  const int num_clean = num - num_dirty;
+  struct MuttThread **clean = mutt_mem_malloc(num * sizeof(struct MuttThread *));
+  struct MuttThread **dirty = clean + num_clean;
+
+  for (int i = 0, c = 0, d = 0; i < num; i++)
+  {
+    if (array[i]->sort_dirty)
+      dirty[d++] = array[i];
+    else
+      clean[c++] = array[i];
+    array[i]->sort_dirty = false;
+  }
+
+  mutt_qsort_r((void *) dirty, num_dirty, sizeof(struct MuttThread *), compare_threads, tctx);
+
+  int n = 0;
+  int c = 0;
+  for (int d = 0; d < num_dirty; d++)
+  {
+    /* binary search for the first clean sibling that sorts after it */
+    int lo = c;
+    int hi = num_clean;
+    while (lo < hi)
+    {
+      const int mid = lo + ((hi - lo) / 2);
+      if (compare_threads(&clean[mid], &dirty[d], tctx) < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+    while (c < lo)
+      array[n++] = clean[c++];
+    array[n++] = dirty[d];
+  }
+
+  while (c < num_clean)
+    array[n++] = clean[c++];
+
+  FREE(&clean);
+}
+
 /**
  * mutt_sort_subthreads - Sort the children of a thread
  * @param tctx Threading context
@@ -822,7 +1071,11 @@ static void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
     {
       thread->sort_thread_key = NULL;
       thread->sort_aux_key = NULL;
+      thread->sort_dirty = true;
+    }
 
+    if (thread->sort_dirty)
+    {
       if (thread->parent)
         thread->parent->sort_children = true;
       else
@@ -863,7 +1116,7 @@ static void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
           array[i] = thread;
         }
 
-        mutt_qsort_r((void *) array, i, sizeof(struct MuttThread *), compare_threads, tctx);
+        sort_siblings(array, i, tctx);
 
         /* attach them back together.  make thread the last sibling. */
         thread = array[0];
@@ -881,6 +1134,11 @@ static void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
           array[i]->next = array[i - 1];
         }
       }
+      else if (!thread->prev)
+      {
+        /* an only child is always in order */
+        thread->sort_dirty = false;
+      }
 
       if (thread->parent)
       {
@@ -955,6 +1213,7 @@ static void mutt_sort_subthreads(struct ThreadsContext *tctx, bool init)
           if ((oldsort_aux_key != thread->sort_aux_key) ||
               (oldsort_thread_key != thread->sort_thread_key))
           {
+            thread->sort_dirty = true;
             if (thread->parent)
               thread->parent->sort_children = true;
             else
@@ -1055,6 +1314,11 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
     mutt_hash_set_destructor(tctx->hash, thread_hash_destructor, 0);
   }
 
+  /* the threading by subject will be redone, see pseudo_threads() */
+  const bool c_strict_threads = cs_subset_bool(NeoMutt->sub, "strict_threads");
+  if (!init && !c_strict_threads)
+    release_pseudo_threads(tctx);
+
   /* we want a quick way to see if things are actually attached to the top of the
    * thread tree or if they're just dangling, so we attach everything to a top
    * node temporarily */
@@ -1078,88 +1342,71 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
       continue;
 
     if (e->thread)
+      continue;
+
+    if ((!init || c_duplicate_threads) && e->env->message_id)
+      thread = mutt_hash_find(tctx->hash, e->env->message_id);
+    else
+      thread = NULL;
+
+    if (thread && !thread->message)
     {
-      /* unlink pseudo-threads because they might be children of newly
-       * arrived messages */
-      thread = e->thread;
-      for (tnew = thread->child; tnew;)
+      /* this is a message which was missing before */
+      thread->message = e;
+      e->thread = thread;
+      thread->check_subject = true;
+
+      /* mark descendants as needing subject_changed checked */
+      for (tmp = (thread->child ? thread->child : thread); tmp != thread;)
       {
-        tmp = tnew->next;
-        if (tnew->fake_thread)
+        while (!tmp->message)
+          tmp = tmp->child;
+        tmp->check_subject = true;
+        while (!tmp->next && (tmp != thread))
+          tmp = tmp->parent;
+        if (tmp != thread)
+          tmp = tmp->next;
+      }
+
+      if (thread->parent)
+      {
+        /* remove threading info above it based on its children, which we'll
+         * recalculate based on its headers.  make sure not to leave
+         * dangling missing messages.  note that we haven't kept track
+         * of what info came from its children and what from its siblings'
+         * children, so we just remove the stuff that's definitely from it */
+        do
         {
-          unlink_message(&thread->child, tnew);
-          insert_message(&top.child, &top, tnew);
-          tnew->fake_thread = false;
-        }
-        tnew = tmp;
+          tmp = thread->parent;
+          unlink_message(&tmp->child, thread);
+          thread->parent = NULL;
+          thread->sort_thread_key = NULL;
+          thread->sort_aux_key = NULL;
+          thread->fake_thread = false;
+          thread = tmp;
+        } while (thread != &top && !thread->child && !thread->message);
       }
     }
     else
     {
-      if ((!init || c_duplicate_threads) && e->env->message_id)
-        thread = mutt_hash_find(tctx->hash, e->env->message_id);
-      else
-        thread = NULL;
+      tnew = (c_duplicate_threads ? thread : NULL);
 
-      if (thread && !thread->message)
-      {
-        /* this is a message which was missing before */
-        thread->message = e;
-        e->thread = thread;
-        thread->check_subject = true;
+      thread = mutt_mem_calloc(1, sizeof(struct MuttThread));
+      thread->message = e;
+      thread->check_subject = true;
+      e->thread = thread;
+      mutt_hash_insert(tctx->hash, e->env->message_id ? e->env->message_id : "", thread);
 
-        /* mark descendants as needing subject_changed checked */
-        for (tmp = (thread->child ? thread->child : thread); tmp != thread;)
-        {
-          while (!tmp->message)
-            tmp = tmp->child;
-          tmp->check_subject = true;
-          while (!tmp->next && (tmp != thread))
-            tmp = tmp->parent;
-          if (tmp != thread)
-            tmp = tmp->next;
-        }
-
-        if (thread->parent)
-        {
-          /* remove threading info above it based on its children, which we'll
-           * recalculate based on its headers.  make sure not to leave
-           * dangling missing messages.  note that we haven't kept track
-           * of what info came from its children and what from its siblings'
-           * children, so we just remove the stuff that's definitely from it */
-          do
-          {
-            tmp = thread->parent;
-            unlink_message(&tmp->child, thread);
-            thread->parent = NULL;
-            thread->sort_thread_key = NULL;
-            thread->sort_aux_key = NULL;
-            thread->fake_thread = false;
-            thread = tmp;
-          } while (thread != &top && !thread->child && !thread->message);
-        }
-      }
-      else
+      if (tnew)
       {
-        tnew = (c_duplicate_threads ? thread : NULL);
-
-        thread = mutt_mem_calloc(1, sizeof(struct MuttThread));
-        thread->message = e;
-        thread->check_subject = true;
-        e->thread = thread;
-        mutt_hash_insert(tctx->hash, e->env->message_id ? e->env->message_id : "", thread);
-
-        if (tnew)
-        {
-          if (tnew->duplicate_thread)
-            tnew = tnew->parent;
+        if (tnew->duplicate_thread)
+          tnew = tnew->parent;
 
-          thread = e->thread;
+        thread = e->thread;
 
-          insert_message(&tnew->child, tnew, thread);
-          thread->duplicate_thread = true;
-          thread->message->threaded = true;
-        }
+        insert_message(&tnew->child, tnew, thread);
+        thread->duplicate_thread = true;
+        thread->message->threaded = true;
       }
     }
   }
@@ -1258,12 +1505,14 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
   }
   tctx->tree = top.child;
 
-  check_subjects(mv, init);
+  /* without $strict_threads, every pseudo-thread has been released */
+  check_subjects(mv, init || !c_strict_threads);
 
-  const bool c_strict_threads = cs_subset_bool(NeoMutt->sub, "strict_threads");
   if (!c_strict_threads)
     pseudo_threads(tctx);
 
+  tctx->num_threaded = m->msg_count;
+
   /* if $sort_aux or similar changed after the mailbox is sorted, then
    * all the subthreads need to be resorted */
   if (tctx->tree)
@@ -1815,8 +2064,8 @@ void mutt_thread_collapse(struct ThreadsContext *tctx, bool collapse)
  */
 bool mutt_thread_can_collapse(struct Email *e)
 {
-  const bool c_collapse_flagged = cs_subset_bool(NeoMutt->sub, "collapse_flagged");
-  const bool c_collapse_unread = cs_subset_bool(NeoMutt->sub, "collapse_unread");
+  const bool c_collapse_flagged = ch_bool(NeoMutt->sub, &HandleCollapseFlagged);
+  const bool c_collapse_unread = ch_bool(NeoMutt->sub, &HandleCollapseUnread);
   return (c_collapse_unread || !mutt_thread_contains_unread(e)) &&
          (c_collapse_flagged || !mutt_thread_contains_flagged(e));
 }
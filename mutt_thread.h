@@ -44,6 +44,7 @@ struct ThreadsContext
   struct HashTable   *hash;         ///< Hash Table: "message-id" -> MuttThread
   enum SortType       c_sort;       ///< Last sort method
   enum SortType       c_sort_aux;   ///< Last sort_aux method
+  int                 num_threaded; ///< Number of Emails in the thread tree
 };
 
 /**
@@ -125,6 +126,7 @@ void                   mutt_thread_ctx_free          (struct ThreadsContext **pt
 void                   mutt_thread_collapse_collapsed(struct ThreadsContext *tctx);
 void                   mutt_thread_collapse          (struct ThreadsContext *tctx, bool collapse);
 bool                   mutt_thread_can_collapse      (struct Email *e);
+int                    mutt_thread_first_new         (struct ThreadsContext *tctx);
 
 void                   mutt_clear_threads     (struct ThreadsContext *tctx);
 void                   mutt_draw_tree         (struct ThreadsContext *tctx);
@@ -121,6 +121,9 @@ static void mview_clean(struct MailboxView *mv)
  * @param mv Mailbox View
  *
  * this routine is called to update the counts in the MailboxView structure
+ *
+ * If Emails have only been appended to the Mailbox, they're added to the
+ * existing hash tables and linked into the existing threads.
  */
 void mview_update(struct MailboxView *mv)
 {
@@ -129,8 +132,15 @@ void mview_update(struct MailboxView *mv)
 
   struct Mailbox *m = mv->mailbox;
 
-  mutt_hash_free(&m->subj_hash);
-  mutt_hash_free(&m->id_hash);
+  int first_new = mutt_thread_first_new(mv->threads);
+  const bool rethread = (first_new < 0);
+  if (rethread)
+  {
+    mutt_hash_free(&m->subj_hash);
+    mutt_hash_free(&m->id_hash);
+    mutt_clear_threads(mv->threads);
+    first_new = 0;
+  }
 
   /* reset counters */
   m->msg_unread = 0;
@@ -141,8 +151,6 @@ void mview_update(struct MailboxView *mv)
   m->vcount = 0;
   m->changed = false;
 
-  mutt_clear_threads(mv->threads);
-
   const bool c_score = cs_subset_bool(NeoMutt->sub, "score");
   struct Email *e = NULL;
   for (int msgno = 0; msgno < m->msg_count; msgno++)
@@ -168,31 +176,35 @@ void mview_update(struct MailboxView *mv)
     }
     e->msgno = msgno;
 
-    if (e->env->supersedes)
+    /* Emails that were already threaded are in the hash tables */
+    if (msgno >= first_new)
     {
-      struct Email *e2 = NULL;
-
-      if (!m->id_hash)
-        m->id_hash = mutt_make_id_hash(m);
-
-      e2 = mutt_hash_find(m->id_hash, e->env->supersedes);
-      if (e2)
+      if (e->env->supersedes)
       {
-        e2->superseded = true;
-        if (c_score)
-          mutt_score_message(mv->mailbox, e2, true);
+        struct Email *e2 = NULL;
+
+        if (!m->id_hash)
+          m->id_hash = mutt_make_id_hash(m);
+
+        e2 = mutt_hash_find(m->id_hash, e->env->supersedes);
+        if (e2)
+        {
+          e2->superseded = true;
+          if (c_score)
+            mutt_score_message(mv->mailbox, e2, true);
+        }
       }
-    }
 
-    /* add this message to the hash tables */
-    if (m->id_hash && e->env->message_id)
-      mutt_hash_insert(m->id_hash, e->env->message_id, e);
-    if (m->subj_hash && e->env->real_subj)
-      mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
-    mutt_label_hash_add(m, e);
+      /* add this message to the hash tables */
+      if (m->id_hash && e->env->message_id)
+        mutt_hash_insert(m->id_hash, e->env->message_id, e);
+      if (m->subj_hash && e->env->real_subj)
+        mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
+      mutt_label_hash_add(m, e);
 
-    if (c_score)
-      mutt_score_message(mv->mailbox, e, false);
+      if (c_score)
+        mutt_score_message(mv->mailbox, e, false);
+    }
 
     if (e->changed)
       m->changed = true;
@@ -210,8 +222,8 @@ void mview_update(struct MailboxView *mv)
     }
   }
 
-  /* rethread from scratch */
-  mutt_sort_headers(mv, true);
+  /* rethread from scratch, unless the new Emails can be linked in */
+  mutt_sort_headers(mv, rethread);
 }
 
 /**
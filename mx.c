@@ -460,6 +460,7 @@ void mx_fastclose_mailbox(struct Mailbox *m, bool keep_account)
       email_free(&m->emails[i]);
     }
   }
+  email_arena_free(&m->arena);
 
   if (!m->visible)
   {
@@ -1172,6 +1173,9 @@ struct Message *mx_msg_open(struct Mailbox *m, struct Email *e)
     return NULL;
   }
 
+  // Anything reading the message will want the whole Envelope
+  email_materialize(e);
+
   struct Message *msg = message_new();
   if (!m->mx_ops->msg_open(m, msg, e))
     message_free(&msg);
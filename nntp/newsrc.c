@@ -1214,7 +1214,7 @@ struct NntpAccountData *nntp_select_server(struct Mailbox *m, const char *server
     FREE(&adata->authenticators);
     FREE(&adata);
     mutt_socket_close(conn);
-    FREE(&conn);
+    mutt_socket_free(&conn);
     return NULL;
   }
 
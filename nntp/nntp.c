@@ -101,6 +101,15 @@ struct FetchCtx
   struct HeaderCache *hc;
 };
 
+/**
+ * struct HeadCtx - Keep track of the header of an article
+ */
+struct HeadCtx
+{
+  struct Buffer *buf; ///< Header of the article
+  bool done;          ///< The response has ended, a new one replaces it
+};
+
 /**
  * struct ChildCtx - Keep track of the children of an article
  */
@@ -789,9 +798,7 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
   while (!done)
   {
     char buf[1024] = { 0 };
-    char *line = NULL;
     unsigned int lines = 0;
-    size_t off = 0;
     struct Progress *progress = NULL;
 
     mutt_str_copy(buf, query, sizeof(buf));
@@ -803,7 +810,6 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
       return 1;
     }
 
-    line = mutt_mem_malloc(sizeof(buf));
     rc = 0;
 
     if (msg)
@@ -811,45 +817,30 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
 
     while (true)
     {
-      char *p = NULL;
-      int chunk = mutt_socket_readln_d(buf, sizeof(buf), mdata->adata->conn, MUTT_SOCK_LOG_FULL);
-      if (chunk < 0)
+      char *line = mutt_socket_readln_borrow(mdata->adata->conn, NULL, MUTT_SOCK_LOG_FULL);
+      if (!line)
       {
         mdata->adata->status = NNTP_NONE;
         break;
       }
 
-      p = buf;
-      if (!off && (buf[0] == '.'))
+      if (line[0] == '.')
       {
-        if (buf[1] == '\0')
+        if (line[1] == '\0')
         {
           done = true;
           break;
         }
-        if (buf[1] == '.')
-          p++;
-      }
-
-      mutt_str_copy(line + off, p, sizeof(buf));
-
-      if (chunk >= sizeof(buf))
-      {
-        off += strlen(p);
+        if (line[1] == '.')
+          line++;
       }
-      else
-      {
-        if (msg)
-          progress_update(progress, ++lines, -1);
 
-        if ((rc == 0) && (func(line, data) < 0))
-          rc = -2;
-        off = 0;
-      }
+      if (msg)
+        progress_update(progress, ++lines, -1);
 
-      mutt_mem_realloc(&line, off + sizeof(buf));
+      if ((rc == 0) && (func(line, data) < 0))
+        rc = -2;
     }
-    FREE(&line);
     func(NULL, data);
     progress_free(&progress);
   }
@@ -984,6 +975,34 @@ static int fetch_tempfile(char *line, void *data)
   return 0;
 }
 
+/**
+ * fetch_head - Append line to the header of an article
+ * @param line Text to append
+ * @param data HeadCtx
+ * @retval 0 Always
+ */
+static int fetch_head(char *line, void *data)
+{
+  struct HeadCtx *hctx = data;
+
+  if (!line)
+  {
+    hctx->done = true;
+    return 0;
+  }
+
+  /* the command has been resent, e.g. after reconnecting */
+  if (hctx->done)
+  {
+    buf_reset(hctx->buf);
+    hctx->done = false;
+  }
+
+  buf_addstr(hctx->buf, line);
+  buf_addch(hctx->buf, '\n');
+  return 0;
+}
+
 /**
  * fetch_numbers - Parse article number
  * @param line Article number
@@ -1050,9 +1069,7 @@ static int parse_overview_line(char *line, void *data)
   }
 
   /* convert overview line to header */
-  FILE *fp = mutt_file_mkstemp();
-  if (!fp)
-    return -1;
+  struct Buffer *hdr = buf_pool_get();
 
   header = mdata->adata->overview_fmt;
   while (field)
@@ -1061,24 +1078,17 @@ static int parse_overview_line(char *line, void *data)
 
     if (*header)
     {
-      if (!strstr(header, ":full") && (fputs(header, fp) == EOF))
-      {
-        mutt_file_fclose(&fp);
-        return -1;
-      }
+      if (!strstr(header, ":full"))
+        buf_addstr(hdr, header);
       header = strchr(header, '\0') + 1;
     }
 
     field = strchr(field, '\t');
     if (field)
       *field++ = '\0';
-    if ((fputs(b, fp) == EOF) || (fputc('\n', fp) == EOF))
-    {
-      mutt_file_fclose(&fp);
-      return -1;
-    }
+    buf_addstr(hdr, b);
+    buf_addch(hdr, '\n');
   }
-  rewind(fp);
 
   /* allocate memory for headers */
   mx_alloc_memory(m, m->msg_count);
@@ -1086,10 +1096,10 @@ static int parse_overview_line(char *line, void *data)
   /* parse header */
   m->emails[m->msg_count] = email_new();
   e = m->emails[m->msg_count];
-  e->env = mutt_rfc822_read_header(fp, e, false, false);
+  e->env = mutt_rfc822_read_header_mem(buf_string(hdr), buf_len(hdr), e, false, false);
   e->env->newsgroups = mutt_str_dup(mdata->group);
   e->received = e->date_sent;
-  mutt_file_fclose(&fp);
+  buf_pool_release(&hdr);
 
 #ifdef USE_HCACHE
   if (fc->hc)
@@ -1198,6 +1208,12 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
   if (!fc.messages)
     return -1;
   fc.hc = hc;
+  struct Buffer *hdr = buf_pool_get();
+
+#ifdef USE_HCACHE
+  /* Group the cache updates into as few writes as possible */
+  hcache_begin_batch(fc.hc);
+#endif
 
   /* fetch list of articles */
   const bool c_nntp_listgroup = cs_subset_bool(NeoMutt->sub, "nntp_listgroup");
@@ -1314,19 +1330,12 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
     else
     {
       /* fetch header from server */
-      FILE *fp = mutt_file_mkstemp();
-      if (!fp)
-      {
-        mutt_perror(_("Can't create temporary file"));
-        rc = -1;
-        break;
-      }
-
+      buf_reset(hdr);
+      struct HeadCtx hctx = { hdr, false };
       snprintf(buf, sizeof(buf), "HEAD " ANUM "\r\n", current);
-      rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_tempfile, fp);
+      rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_head, &hctx);
       if (rc)
       {
-        mutt_file_fclose(&fp);
         if (rc < 0)
           break;
 
@@ -1351,9 +1360,8 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
       /* parse header */
       m->emails[m->msg_count] = email_new();
       e = m->emails[m->msg_count];
-      e->env = mutt_rfc822_read_header(fp, e, false, false);
+      e->env = mutt_rfc822_read_header_mem(buf_string(hdr), buf_len(hdr), e, false, false);
       e->received = e->date_sent;
-      mutt_file_fclose(&fp);
     }
 
     /* save header in context */
@@ -1394,8 +1402,13 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
     }
   }
 
+#ifdef USE_HCACHE
+  hcache_commit_batch(fc.hc);
+#endif
+
   FREE(&fc.messages);
   progress_free(&fc.progress);
+  buf_pool_release(&hdr);
   if (rc != 0)
     return -1;
   mutt_clear_error();
@@ -2176,19 +2189,14 @@ int nntp_check_msgid(struct Mailbox *m, const char *msgid)
 
   struct NntpMboxData *mdata = m->mdata;
   char buf[1024] = { 0 };
-
-  FILE *fp = mutt_file_mkstemp();
-  if (!fp)
-  {
-    mutt_perror(_("Can't create temporary file"));
-    return -1;
-  }
+  struct Buffer *hdr = buf_pool_get();
+  struct HeadCtx hctx = { hdr, false };
 
   snprintf(buf, sizeof(buf), "HEAD %s\r\n", msgid);
-  int rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_tempfile, fp);
+  int rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_head, &hctx);
   if (rc)
   {
-    mutt_file_fclose(&fp);
+    buf_pool_release(&hdr);
     if (rc < 0)
       return -1;
     if (mutt_str_startswith(buf, "430"))
@@ -2203,8 +2211,8 @@ int nntp_check_msgid(struct Mailbox *m, const char *msgid)
   struct Email *e = m->emails[m->msg_count];
   e->edata = nntp_edata_new();
   e->edata_free = nntp_edata_free;
-  e->env = mutt_rfc822_read_header(fp, e, false, false);
-  mutt_file_fclose(&fp);
+  e->env = mutt_rfc822_read_header_mem(buf_string(hdr), buf_len(hdr), e, false, false);
+  buf_pool_release(&hdr);
 
   /* get article number */
   if (e->env->xref)
@@ -778,7 +778,7 @@ static void append_message(struct HeaderCache *hc, struct Mailbox *m,
     {
       /* We pass is_old=false as argument here, but e->old will be updated later
        * by update_message_path() (called by init_email() below).  */
-      e = maildir_email_new();
+      e = maildir_email_new(NULL);
       if (!maildir_parse_message(MUTT_MAILDIR, path, false, e))
         email_free(&e);
     }
@@ -792,7 +792,7 @@ static void append_message(struct HeaderCache *hc, struct Mailbox *m,
         FILE *fp = maildir_open_find_message(folder, path, &newpath);
         if (fp)
         {
-          e = maildir_email_new();
+          e = maildir_email_new(NULL);
           if (!maildir_parse_stream(MUTT_MAILDIR, fp, newpath, false, e))
             email_free(&e);
           mutt_file_fclose(&fp);
@@ -2162,7 +2162,7 @@ static enum MxStatus nm_mbox_check(struct Mailbox *m)
     {
       /* if the user hasn't modified the flags on this message, update the
        * flags we just detected.  */
-      struct Email *e_tmp = maildir_email_new();
+      struct Email *e_tmp = maildir_email_new(NULL);
       maildir_parse_flags(e_tmp, new_file);
       e_tmp->old = e->old;
       maildir_update_flags(m, e, e_tmp);
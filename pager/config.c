@@ -67,6 +67,9 @@ static struct ConfigDef PagerVars[] = {
   { "pager_stop", DT_BOOL, false, 0, NULL,
     "Don't automatically open the next message when at the end of a message"
   },
+  { "pager_stream_size", DT_LONG|DT_NOT_NEGATIVE, 1048576, 0, NULL,
+    "Display messages larger than this while they're being decoded"
+  },
   { "prompt_after", DT_BOOL, true, 0, NULL,
     "Pause after running an external pager"
   },
@@ -62,6 +62,7 @@
 #include "private_data.h"
 #include "protos.h"
 #include "status.h"
+#include "stream.h"
 #ifdef USE_SIDEBAR
 #include "sidebar/lib.h"
 #endif
@@ -330,6 +331,8 @@ int mutt_pager(struct PagerView *pview)
   priv->lines_max = LINES; // number of lines on screen, from curses
   priv->lines = mutt_mem_calloc(priv->lines_max, sizeof(struct Line));
   priv->fp = fopen(pview->pdata->fname, "r");
+  const bool stream = (pview->pdata->pid > 0);
+  priv->stream = pager_stream_new(pview->pdata);
   priv->has_types = ((pview->mode == PAGER_MODE_EMAIL) || (pview->flags & MUTT_SHOWCOLOR)) ?
                         MUTT_TYPES :
                         0; // main message or rfc822 attachment
@@ -347,12 +350,21 @@ int mutt_pager(struct PagerView *pview)
   if (!priv->fp)
   {
     mutt_perror(pview->pdata->fname);
+    pager_stream_free(&priv->stream);
+    return -1;
+  }
+
+  if (stream && !priv->stream)
+  {
+    // pager_stream_new() has reported the error
+    mutt_file_fclose(&priv->fp);
     return -1;
   }
 
   if (stat(pview->pdata->fname, &priv->st) != 0)
   {
     mutt_perror(pview->pdata->fname);
+    pager_stream_free(&priv->stream);
     mutt_file_fclose(&priv->fp);
     return -1;
   }
@@ -581,6 +593,7 @@ int mutt_pager(struct PagerView *pview)
   // END OF ACT 3: Read user input loop - while (op != OP_ABORT)
   //-------------------------------------------------------------------------
 
+  pager_stream_free(&priv->stream);
   mutt_file_fclose(&priv->fp);
   if (pview->mode == PAGER_MODE_EMAIL)
   {
@@ -48,6 +48,7 @@
 #include "opcodes.h"
 #include "private_data.h"
 #include "protos.h"
+#include "stream.h"
 
 /// Error message for unavailable functions
 static const char *Not_available_in_this_menu = N_("Not available in this menu");
@@ -102,6 +103,7 @@ static int up_n_lines(int nlines, struct Line *info, int cur, bool hiding)
  */
 bool jump_to_bottom(struct PagerPrivateData *priv, struct PagerView *pview)
 {
+  pager_stream_finish(priv);
   if (!(priv->lines[priv->cur_line].offset < (priv->st.st_size - 1)))
   {
     return false;
@@ -144,7 +146,7 @@ static int op_pager_half_down(struct IndexSharedData *shared,
                               struct PagerPrivateData *priv, int op)
 {
   const bool c_pager_stop = cs_subset_bool(NeoMutt->sub, "pager_stop");
-  if (priv->lines[priv->cur_line].offset < (priv->st.st_size - 1))
+  if (pager_stream_read(priv, priv->lines[priv->cur_line].offset + 1))
   {
     priv->top_line = up_n_lines(priv->pview->win_pager->state.rows / 2,
                                 priv->lines, priv->cur_line, priv->hide_quoted);
@@ -211,7 +213,7 @@ static int op_pager_hide_quoted(struct IndexSharedData *shared,
 static int op_pager_next_line(struct IndexSharedData *shared,
                               struct PagerPrivateData *priv, int op)
 {
-  if (priv->lines[priv->cur_line].offset < (priv->st.st_size - 1))
+  if (pager_stream_read(priv, priv->lines[priv->cur_line].offset + 1))
   {
     priv->top_line++;
     if (priv->hide_quoted)
@@ -238,7 +240,7 @@ static int op_pager_next_page(struct IndexSharedData *shared,
                               struct PagerPrivateData *priv, int op)
 {
   const bool c_pager_stop = cs_subset_bool(NeoMutt->sub, "pager_stop");
-  if (priv->lines[priv->cur_line].offset < (priv->st.st_size - 1))
+  if (pager_stream_read(priv, priv->lines[priv->cur_line].offset + 1))
   {
     const short c_pager_context = cs_subset_number(NeoMutt->sub, "pager_context");
     priv->top_line = up_n_lines(c_pager_context, priv->lines, priv->cur_line, priv->hide_quoted);
@@ -372,6 +374,7 @@ static int op_pager_search(struct IndexSharedData *shared,
   else
   {
     priv->search_compiled = true;
+    pager_stream_finish(priv);
     /* update the search pointers */
     int line_num = 0;
     while (display_line(priv->fp, &priv->bytes_read, &priv->lines, line_num,
@@ -554,6 +557,8 @@ static int op_pager_skip_headers(struct IndexSharedData *shared,
   if (!priv->has_types)
     return FR_NO_ACTION;
 
+  pager_stream_finish(priv);
+
   int rc = 0;
   int new_topline = 0;
 
@@ -593,6 +598,8 @@ static int op_pager_skip_quoted(struct IndexSharedData *shared,
   if (!priv->has_types)
     return FR_NO_ACTION;
 
+  pager_stream_finish(priv);
+
   const short c_pager_skip_quoted_context = cs_subset_number(NeoMutt->sub, "pager_skip_quoted_context");
   int rc = 0;
   int new_topline = priv->top_line;
@@ -750,6 +757,9 @@ static int op_view_attachments(struct IndexSharedData *shared,
 
   if (!assert_pager_mode(pview->mode == PAGER_MODE_EMAIL))
     return FR_NOT_IMPL;
+
+  // The decoding process is still reading the Email's file
+  pager_stream_finish(priv);
   dlg_select_attachment(NeoMutt->sub, shared->mailbox_view, shared->email,
                         pview->pdata->fp);
   if (shared->email->attach_del)
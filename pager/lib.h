@@ -37,6 +37,7 @@
  * | pager/pbar.c         | @subpage pager_pbar         |
  * | pager/ppanel.c       | @subpage pager_ppanel       |
  * | pager/private_data.c | @subpage pager_private_data |
+ * | pager/stream.c       | @subpage pager_stream       |
  */
 
 #ifndef MUTT_PAGER_LIB_H
@@ -46,6 +47,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/types.h>
 #include "mutt/lib.h"
 
 struct Email;
@@ -161,6 +163,8 @@ struct PagerData
   FILE             *fp;     ///< Source stream
   struct AttachCtx *actx;   ///< Attachment information
   const char       *fname;  ///< Name of the file to read
+  pid_t             pid;    ///< Process still decoding the Email, see $pager_stream_size
+  int               fd;     ///< Pipe carrying the rest of the decoded Email (if pid is set)
 };
 
 /**
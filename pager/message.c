@@ -28,8 +28,11 @@
 
 #include "config.h"
 #include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <sys/types.h>
 #include <unistd.h>
 #include "mutt/lib.h"
 #include "config/lib.h"
@@ -49,6 +52,7 @@
 #include "hdrline.h"
 #include "hook.h"
 #include "keymap.h"
+#include "mutt_mailbox.h"
 #include "mview.h"
 #include "mx.h"
 #include "protos.h"
@@ -158,6 +162,147 @@ static void process_protected_headers(struct Mailbox *m, struct Email *e)
 #endif
 }
 
+/**
+ * display_header_flags - Get the flags for copying an Email's headers for display
+ * @param m Mailbox
+ * @retval num Flags, see #CopyHeaderFlags
+ */
+static CopyHeaderFlags display_header_flags(struct Mailbox *m)
+{
+  const bool c_weed = cs_subset_bool(NeoMutt->sub, "weed");
+  CopyHeaderFlags chflags = (c_weed ? (CH_WEED | CH_REORDER) : CH_NO_FLAGS) |
+                            CH_DECODE | CH_FROM | CH_DISPLAY;
+#ifdef USE_NOTMUCH
+  if (m->type == MUTT_NOTMUCH)
+    chflags |= CH_VIRTUAL;
+#endif
+  return chflags;
+}
+
+/**
+ * email_can_stream - Can an Email be displayed while it's being decoded?
+ * @param m       Mailbox
+ * @param e       Email to display
+ * @param cmflags Message flags, e.g. #MUTT_CM_DECODE
+ * @retval true The Email can be streamed, see @ref pager_stream
+ */
+static bool email_can_stream(struct Mailbox *m, struct Email *e, CopyMessageFlags cmflags)
+{
+  const long c_pager_stream_size = cs_subset_long(NeoMutt->sub, "pager_stream_size");
+  if ((c_pager_stream_size == 0) || (e->body->length < c_pager_stream_size))
+    return false;
+
+  /* All the Emails in an mbox share one file, which the child would be using */
+  if ((m->type == MUTT_MBOX) || (m->type == MUTT_MMDF) || (m->type == MUTT_COMPRESSED))
+    return false;
+
+  /* Decoding updates the crypto state of the Email */
+  if ((WithCrypto != 0) &&
+      (e->security || (cmflags & MUTT_CM_VERIFY) || crypt_query(e->body)))
+  {
+    return false;
+  }
+
+  /* Forking while other threads are running could leave the child holding a
+   * lock that will never be released.  The other worker pools, e.g. the
+   * Maildir readahead, finish before their callers return. */
+  if (mutt_mailbox_check_busy())
+    return false;
+
+  /* The user needs to see any errors from the filter */
+  const char *const c_display_filter = cs_subset_string(NeoMutt->sub, "display_filter");
+  return !c_display_filter;
+}
+
+/**
+ * email_to_stream - Decode and weed an Email in the background
+ * @param[in]  msg      Raw Email
+ * @param[out] tempfile Temporary filename for result
+ * @param[in]  m        Mailbox
+ * @param[in]  e        Email to display
+ * @param[in]  wrap_len Width to wrap lines
+ * @param[in]  cmflags  Message flags, e.g. #MUTT_CM_DECODE
+ * @param[out] pdata    Pager Data, for the decoding process
+ * @retval  0 Success
+ * @retval -1 Error
+ *
+ * A child process decodes the Email into a pipe.  The temporary file starts
+ * empty, the Pager adds to it as it reads the pipe, see @ref pager_stream.
+ */
+static int email_to_stream(struct Message *msg, struct Buffer *tempfile,
+                           struct Mailbox *m, struct Email *e, int wrap_len,
+                           CopyMessageFlags cmflags, struct PagerData *pdata)
+{
+  buf_mktemp(tempfile);
+  FILE *fp_out = mutt_file_fopen(buf_string(tempfile), "w");
+  if (!fp_out)
+  {
+    mutt_error(_("Could not create temporary file"));
+    return -1;
+  }
+  mutt_file_fclose(&fp_out);
+
+  int fd[2];
+  if (pipe(fd) == -1)
+  {
+    mutt_perror("pipe");
+    mutt_file_unlink(buf_string(tempfile));
+    return -1;
+  }
+
+  const CopyHeaderFlags chflags = display_header_flags(m);
+
+  /* Don't let the child write out our buffered data, too */
+  fflush(NULL);
+
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    /* Keep the child away from the terminal and its signals */
+    setsid();
+    const int fd_null = open("/dev/null", O_RDWR);
+    if ((fd_null < 0) || (dup2(fd_null, STDIN_FILENO) < 0) ||
+        (dup2(fd_null, STDOUT_FILENO) < 0) || (dup2(fd_null, STDERR_FILENO) < 0))
+    {
+      _exit(127);
+    }
+    close(fd_null);
+    close(fd[0]);
+    OptKeepQuiet = true;
+    OptNoCurses = true;
+
+    /* Stop when the Pager closes the pipe, or asks us to */
+    struct sigaction act = { 0 };
+    sigemptyset(&act.sa_mask);
+    act.sa_handler = SIG_DFL;
+    sigaction(SIGPIPE, &act, NULL);
+    sigaction(SIGTERM, &act, NULL);
+
+    int rc = -1;
+    fp_out = fdopen(fd[1], "w");
+    if (fp_out)
+      rc = mutt_copy_message(fp_out, e, msg, cmflags, chflags, wrap_len);
+    if (mutt_file_fclose(&fp_out) != 0)
+      rc = -1;
+    _exit((rc < 0) ? 1 : 0);
+  }
+
+  close(fd[1]);
+  if (pid == -1)
+  {
+    mutt_perror("fork");
+    close(fd[0]);
+    mutt_file_unlink(buf_string(tempfile));
+    return -1;
+  }
+
+  fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+
+  pdata->pid = pid;
+  pdata->fd = fd[0];
+  return 0;
+}
+
 /**
  * email_to_file - Decrypt, decode and weed an Email into a file
  * @param msg      Raw Email
@@ -167,6 +312,7 @@ static void process_protected_headers(struct Mailbox *m, struct Email *e)
  * @param header   Header to prefix output (OPTIONAL)
  * @param wrap_len Width to wrap lines
  * @param cmflags  Message flags, e.g. #MUTT_CM_DECODE
+ * @param pdata    Pager Data, if the Email may be decoded in the background (OPTIONAL)
  * @retval  0 Success
  * @retval -1 Error
  *
@@ -174,7 +320,7 @@ static void process_protected_headers(struct Mailbox *m, struct Email *e)
  */
 static int email_to_file(struct Message *msg, struct Buffer *tempfile,
                          struct Mailbox *m, struct Email *e, const char *header,
-                         int wrap_len, CopyMessageFlags *cmflags)
+                         int wrap_len, CopyMessageFlags *cmflags, struct PagerData *pdata)
 {
   int rc = 0;
   pid_t filterpid = -1;
@@ -225,6 +371,12 @@ static int email_to_file(struct Message *msg, struct Buffer *tempfile,
       crypt_invoke_message(APPLICATION_SMIME);
   }
 
+  if (pdata && email_can_stream(m, e, *cmflags))
+  {
+    rc = email_to_stream(msg, tempfile, m, e, wrap_len, *cmflags, pdata);
+    goto cleanup;
+  }
+
   FILE *fp_filter_out = NULL;
   buf_mktemp(tempfile);
   FILE *fp_out = mutt_file_fopen(buf_string(tempfile), "w");
@@ -256,14 +408,7 @@ static int email_to_file(struct Message *msg, struct Buffer *tempfile,
     fputs("\n\n", fp_out);
   }
 
-  const bool c_weed = cs_subset_bool(NeoMutt->sub, "weed");
-  CopyHeaderFlags chflags = (c_weed ? (CH_WEED | CH_REORDER) : CH_NO_FLAGS) |
-                            CH_DECODE | CH_FROM | CH_DISPLAY;
-#ifdef USE_NOTMUCH
-  if (m->type == MUTT_NOTMUCH)
-    chflags |= CH_VIRTUAL;
-#endif
-  rc = mutt_copy_message(fp_out, e, msg, *cmflags, chflags, wrap_len);
+  rc = mutt_copy_message(fp_out, e, msg, *cmflags, display_header_flags(m), wrap_len);
 
   if (((mutt_file_fclose(&fp_out) != 0) && (errno != EPIPE)) || (rc < 0))
   {
@@ -328,7 +473,7 @@ int external_pager(struct MailboxView *mv, struct Email *e, const char *command)
   struct Buffer *tempfile = buf_pool_get();
 
   CopyMessageFlags cmflags = MUTT_CM_DECODE | MUTT_CM_DISPLAY | MUTT_CM_CHARCONV;
-  int rc = email_to_file(msg, tempfile, m, e, buf, screen_width, &cmflags);
+  int rc = email_to_file(msg, tempfile, m, e, buf, screen_width, &cmflags, NULL);
   if (rc < 0)
     goto cleanup;
 
@@ -474,19 +619,19 @@ int mutt_display_message(struct MuttWindow *win_index, struct IndexSharedData *s
 
     CopyMessageFlags cmflags = MUTT_CM_DECODE | MUTT_CM_DISPLAY | MUTT_CM_CHARCONV;
 
+    /* Invoke the builtin pager */
+    struct PagerData pdata = { 0 };
+    struct PagerView pview = { &pdata };
+
     buf_reset(tempfile);
     // win_pager might not be visible and have a size yet, so use win_index
     rc = email_to_file(msg, tempfile, shared->mailbox, shared->email, NULL,
-                       win_index->state.cols, &cmflags);
+                       win_index->state.cols, &cmflags, &pdata);
     if (rc < 0)
       break;
 
     notify_crypto(shared->email, msg, cmflags);
 
-    /* Invoke the builtin pager */
-    struct PagerData pdata = { 0 };
-    struct PagerView pview = { &pdata };
-
     pdata.fp = msg->fp;
     pdata.fname = buf_string(tempfile);
 
@@ -73,6 +73,7 @@
 #include "display.h"
 #include "opcodes.h"
 #include "private_data.h"
+#include "stream.h"
 
 /**
  * config_pager_index_lines - React to changes to $pager_index_lines
@@ -197,7 +198,7 @@ static int pager_repaint(struct MuttWindow *win)
       priv->force_redraw = false;
 
       while ((priv->win_height < priv->pview->win_pager->state.rows) &&
-             (priv->lines[priv->cur_line].offset <= priv->st.st_size - 1))
+             pager_stream_read(priv, priv->lines[priv->cur_line].offset))
       {
         if (display_line(priv->fp, &priv->bytes_read, &priv->lines,
                          priv->cur_line, &priv->lines_used, &priv->lines_max,
@@ -108,7 +108,12 @@ static int pbar_recalc(struct MuttWindow *win)
   else
     offset = priv->bytes_read;
 
-  if (offset < (priv->st.st_size - 1))
+  if (priv->stream)
+  {
+    /* The end of the email hasn't been decoded yet */
+    mutt_str_copy(pager_progress_str, "...", sizeof(pager_progress_str));
+  }
+  else if (offset < (priv->st.st_size - 1))
   {
     const long percent = (100 * offset) / priv->st.st_size;
     /* L10N: Pager position percentage.
@@ -33,6 +33,7 @@
 #include "color/lib.h"
 
 struct MuttWindow;
+struct PagerStream;
 
 /**
  * struct PagerPrivateData - Private state data for the Pager
@@ -43,6 +44,7 @@ struct PagerPrivateData
 
   FILE *fp;                    ///< File containing decrypted/decoded/weeded Email
   struct stat st;              ///< Stats about Email file
+  struct PagerStream *stream;  ///< Email still being decoded, see pager_stream_read()
   LOFF_T bytes_read;           ///< Number of bytes read from file
 
   struct Line *lines;          ///< Array of text lines in pager
@@ -0,0 +1,272 @@
+/**
+ * @file
+ * Display an Email while it's being decoded
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page pager_stream Display an Email while it's being decoded
+ *
+ * Decoding a large Email, e.g. a long digest, can take a while.  Rather than
+ * waiting for all of it, the Pager can display the start of the Email while
+ * the rest is being decoded, see `$pager_stream_size`.
+ *
+ * The Email is decoded by a child process, see mutt_display_message(), which
+ * writes to a pipe.  The Pager reads from the pipe only when it needs more
+ * lines, e.g. to fill the screen, or scroll down.  When the pipe is full, the
+ * child waits.
+ *
+ * Only complete lines are added to the Pager's file, so the rest of the Pager
+ * can treat the end of the file as the end of the Email.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "stream.h"
+#include "lib.h"
+#include "private_data.h"
+
+/// Size of the blocks read from the decoding process
+#define STREAM_BLOCK_SIZE 8192
+
+/**
+ * struct PagerStream - An Email that's still being decoded
+ */
+struct PagerStream
+{
+  pid_t pid;             ///< Process decoding the Email
+  int fd;                ///< Pipe carrying the decoded Email
+  FILE *fp;              ///< Pager's file, opened for appending
+  struct Buffer partial; ///< Incomplete line, waiting for the rest
+};
+
+/**
+ * stream_close - Close the pipe and wait for the decoding process
+ * @param ps   Pager Stream
+ * @param stop Stop the process first
+ * @retval  0 Success
+ * @retval -1 The process failed
+ */
+static int stream_close(struct PagerStream *ps, bool stop)
+{
+  if (ps->fd >= 0)
+  {
+    close(ps->fd);
+    ps->fd = -1;
+  }
+
+  if (ps->pid <= 0)
+    return 0;
+
+  if (stop)
+    kill(ps->pid, SIGTERM);
+
+  int status = 0;
+  pid_t rc;
+  do
+  {
+    rc = waitpid(ps->pid, &status, 0);
+  } while ((rc < 0) && (errno == EINTR));
+  ps->pid = 0;
+
+  if ((rc < 0) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+    return -1;
+
+  return 0;
+}
+
+/**
+ * stream_append - Add some decoded text to the Pager's file
+ * @param priv Private Pager data
+ * @param data Text to add
+ * @param len  Length of the text
+ * @retval true Success
+ */
+static bool stream_append(struct PagerPrivateData *priv, const char *data, size_t len)
+{
+  struct PagerStream *ps = priv->stream;
+
+  if (!buf_is_empty(&ps->partial))
+  {
+    const size_t plen = buf_len(&ps->partial);
+    if (fwrite(ps->partial.data, 1, plen, ps->fp) != plen)
+      return false;
+    priv->st.st_size += plen;
+    buf_reset(&ps->partial);
+  }
+
+  if ((len > 0) && (fwrite(data, 1, len, ps->fp) != len))
+    return false;
+  priv->st.st_size += len;
+
+  if (fflush(ps->fp) != 0)
+    return false;
+
+  // The Pager may have read to the old end of the file
+  clearerr(priv->fp);
+  return true;
+}
+
+/**
+ * stream_read_block - Read a block of the decoded Email
+ * @param priv Private Pager data
+ * @retval true  The Email is still being decoded
+ * @retval false The Email is complete
+ */
+static bool stream_read_block(struct PagerPrivateData *priv)
+{
+  struct PagerStream *ps = priv->stream;
+  char buf[STREAM_BLOCK_SIZE];
+
+  ssize_t len;
+  do
+  {
+    len = read(ps->fd, buf, sizeof(buf));
+  } while ((len < 0) && (errno == EINTR));
+
+  if (len <= 0)
+  {
+    /* The last line may not have a newline */
+    bool ok = (len == 0) && stream_append(priv, NULL, 0);
+    if (stream_close(ps, false) != 0)
+      ok = false;
+    if (!ok)
+      mutt_error(_("Could not copy message"));
+    pager_stream_free(&priv->stream);
+    return false;
+  }
+
+  /* Hold back an incomplete line, until the rest of it arrives */
+  ssize_t end = len;
+  while ((end > 0) && (buf[end - 1] != '\n'))
+    end--;
+
+  if (end == 0)
+  {
+    buf_addstr_n(&ps->partial, buf, len);
+    return true;
+  }
+
+  if (!stream_append(priv, buf, end))
+  {
+    mutt_perror(_("Could not copy message"));
+    pager_stream_free(&priv->stream);
+    return false;
+  }
+
+  buf_addstr_n(&ps->partial, buf + end, len - end);
+  return true;
+}
+
+/**
+ * pager_stream_read - Read the decoded Email, up to an offset
+ * @param priv   Private Pager data
+ * @param offset Offset into the Pager's file
+ * @retval true  The file contains data at @a offset
+ * @retval false @a offset is past the end of the Email
+ *
+ * Read from the decoding process until the line containing @a offset is
+ * complete, or the Email ends.
+ */
+bool pager_stream_read(struct PagerPrivateData *priv, LOFF_T offset)
+{
+  if (!priv)
+    return false;
+
+  while (priv->stream && (offset >= priv->st.st_size))
+  {
+    if (!stream_read_block(priv))
+      break;
+  }
+
+  return offset < priv->st.st_size;
+}
+
+/**
+ * pager_stream_finish - Read the rest of the decoded Email
+ * @param priv Private Pager data
+ *
+ * After this, the Pager's file contains the whole Email.
+ */
+void pager_stream_finish(struct PagerPrivateData *priv)
+{
+  if (!priv)
+    return;
+
+  while (priv->stream && stream_read_block(priv))
+    ; // do nothing
+}
+
+/**
+ * pager_stream_free - Stop decoding an Email
+ * @param ptr Pager Stream to free
+ *
+ * If the decoding process is still running, it will be stopped.
+ */
+void pager_stream_free(struct PagerStream **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct PagerStream *ps = *ptr;
+
+  stream_close(ps, true);
+  mutt_file_fclose(&ps->fp);
+  buf_dealloc(&ps->partial);
+
+  FREE(ptr);
+}
+
+/**
+ * pager_stream_new - Take over the decoding of an Email
+ * @param pdata Pager Data, see PagerData::pid
+ * @retval ptr  New Pager Stream
+ * @retval NULL Error, the decoding has been stopped
+ *
+ * This must be called before the Pager's file, PagerData::fname, is unlinked.
+ */
+struct PagerStream *pager_stream_new(struct PagerData *pdata)
+{
+  if (!pdata || (pdata->pid <= 0))
+    return NULL;
+
+  struct PagerStream *ps = mutt_mem_calloc(1, sizeof(struct PagerStream));
+  ps->pid = pdata->pid;
+  ps->fd = pdata->fd;
+  buf_init(&ps->partial);
+
+  pdata->pid = 0;
+  pdata->fd = -1;
+
+  ps->fp = mutt_file_fopen(pdata->fname, "a");
+  if (!ps->fp)
+  {
+    mutt_perror(pdata->fname);
+    pager_stream_free(&ps);
+  }
+
+  return ps;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * Display an Email while it's being decoded
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_PAGER_STREAM_H
+#define MUTT_PAGER_STREAM_H
+
+#include "config.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+
+struct PagerData;
+struct PagerPrivateData;
+struct PagerStream;
+
+void                pager_stream_finish(struct PagerPrivateData *priv);
+void                pager_stream_free  (struct PagerStream **ptr);
+struct PagerStream *pager_stream_new   (struct PagerData *pdata);
+bool                pager_stream_read  (struct PagerPrivateData *priv, LOFF_T offset);
+
+#endif /* MUTT_PAGER_STREAM_H */
@@ -0,0 +1,801 @@
+/**
+ * @file
+ * Index of the text of the messages, for body searches
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page pattern_body_index Index of the text of the messages
+ *
+ * Searching the bodies of the messages, `~b` and `~B`, means reading and
+ * decoding every message.  If $body_index is set, a summary of the decoded
+ * text of each message is kept in the header cache of local mailboxes.
+ *
+ * The summary is a bitmap of the trigrams (runs of three characters) in each
+ * line of the text.  Before a message is read, the trigrams of the text that
+ * the search needs are looked up.  If any are missing, the message can't
+ * match, so it's skipped.  Otherwise, the message is searched as usual.
+ *
+ * The summaries are keyed by Message-ID, so they survive the message being
+ * renamed (Maildir) or moved (mbox).  They are written when a message is
+ * searched, and when new mail arrives.
+ *
+ * Encrypted messages are never indexed.
+ */
+
+#include "config.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "lib.h"
+#include "attach/lib.h"
+#include "ncrypt/lib.h"
+#include "copy.h"
+#include "handler.h"
+#include "mx.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
+
+/// Version of the index records, change this if BodyIndexRecord changes
+#define BODY_INDEX_VERSION 1
+
+/// Prefix of the header cache keys of the index records
+#define BODY_INDEX_KEY "/BODYINDEX/"
+
+/// Size of the header's bitmap, log2 of the number of bits
+#define HEAD_BITS_LOG2 10
+
+/// Size of the body's bitmap, log2 of the number of bits
+#define BODY_BITS_LOG2 12
+
+/// Number of 64-bit words in a bitmap of 2^bits bits
+#define BITMAP_WORDS(bits) ((1 << (bits)) / 64)
+
+ARRAY_HEAD(TrigramArray, uint32_t);
+
+/**
+ * struct BodyIndexRecord - The trigrams of a message's text
+ *
+ * This is stored in the header cache, so it mustn't contain pointers.
+ */
+struct BodyIndexRecord
+{
+  uint32_t version;                              ///< #BODY_INDEX_VERSION
+  uint32_t charset;                              ///< Hash of $charset when the text was decoded
+  uint32_t parts;                                ///< Parts that have been indexed, e.g. #BODY_INDEX_BODY
+  uint32_t padding;                              ///< Unused
+  int64_t length;                                ///< Length of the raw body
+  int64_t date_sent;                             ///< Date the message was sent
+  uint64_t head[BITMAP_WORDS(HEAD_BITS_LOG2)];   ///< Trigrams of the decoded header
+  uint64_t body[BITMAP_WORDS(BODY_BITS_LOG2)];   ///< Trigrams of the decoded body
+};
+
+#define BODY_INDEX_HEAD (1 << 0) ///< The header has been indexed
+#define BODY_INDEX_BODY (1 << 1) ///< The body has been indexed
+
+/**
+ * struct BodyIndex - Index of the text of a Mailbox's messages
+ */
+struct BodyIndex
+{
+#ifdef USE_HCACHE
+  struct HeaderCache *hc; ///< Header cache holding the index
+#endif
+  uint32_t charset;       ///< Hash of $charset
+};
+
+/**
+ * struct BodyIndexQuery - Text that a body search needs
+ */
+struct BodyIndexQuery
+{
+  struct BodyIndex *index;       ///< Index to use, only set while a Mailbox is searched
+  struct TrigramArray trigrams;  ///< Trigrams that a matching line must contain
+  bool ign_case;                 ///< The search ignores case
+};
+
+/**
+ * fold_case - Lowercase an ASCII character
+ * @param c Character
+ * @retval num Lowercase character
+ *
+ * Only ASCII is folded, so the index doesn't depend on the locale.
+ */
+static inline unsigned char fold_case(unsigned char c)
+{
+  return ((c >= 'A') && (c <= 'Z')) ? (c + ('a' - 'A')) : c;
+}
+
+/**
+ * bitmap_bit - Pick the bit of a bitmap for a trigram
+ * @param trigram Trigram, three characters
+ * @param bits    Size of the bitmap, log2 of the number of bits
+ * @retval num Bit number
+ */
+static inline uint32_t bitmap_bit(uint32_t trigram, int bits)
+{
+  return (uint32_t) (trigram * 2654435761U) >> (32 - bits);
+}
+
+/**
+ * struct TrigramState - Progress through some text being indexed
+ */
+struct TrigramState
+{
+  uint32_t trigram; ///< Last three characters seen
+  int count;        ///< Number of characters seen on this line
+};
+
+/**
+ * bitmap_add_text - Add the trigrams of some text to a bitmap
+ * @param bitmap Bitmap
+ * @param bits   Size of the bitmap, log2 of the number of bits
+ * @param ts     Progress through the text
+ * @param text   Text
+ * @param len    Length of the text
+ *
+ * Trigrams don't cross lines, because the searches match one line at a time.
+ */
+static void bitmap_add_text(uint64_t *bitmap, int bits, struct TrigramState *ts,
+                            const unsigned char *text, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    if (text[i] == '\n')
+    {
+      ts->count = 0;
+      continue;
+    }
+
+    ts->trigram = ((ts->trigram << 8) | fold_case(text[i])) & 0xffffff;
+    if (++ts->count < 3)
+      continue;
+
+    const uint32_t bit = bitmap_bit(ts->trigram, bits);
+    bitmap[bit / 64] |= (1ULL << (bit % 64));
+  }
+}
+
+/**
+ * bitmap_add_file - Add the trigrams of part of a file to a bitmap
+ * @param bitmap Bitmap
+ * @param bits   Size of the bitmap, log2 of the number of bits
+ * @param fp     File to read
+ * @param len    Number of bytes to read
+ */
+static void bitmap_add_file(uint64_t *bitmap, int bits, FILE *fp, long len)
+{
+  unsigned char buf[4096];
+  struct TrigramState ts = { 0 };
+
+  while (len > 0)
+  {
+    size_t got = fread(buf, 1, MIN(sizeof(buf), (size_t) len), fp);
+    if (got == 0)
+      break;
+    len -= got;
+    bitmap_add_text(bitmap, bits, &ts, buf, got);
+  }
+}
+
+/**
+ * bitmap_has_all - Does a bitmap contain all of a query's trigrams?
+ * @param bitmap Bitmap
+ * @param bits   Size of the bitmap, log2 of the number of bits
+ * @param q      Query
+ * @retval true All the trigrams may be present
+ */
+static bool bitmap_has_all(const uint64_t *bitmap, int bits, const struct BodyIndexQuery *q)
+{
+  const uint32_t *tp = NULL;
+  ARRAY_FOREACH(tp, &q->trigrams)
+  {
+    const uint32_t bit = bitmap_bit(*tp, bits);
+    if (!(bitmap[bit / 64] & (1ULL << (bit % 64))))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * query_add_run - Add the trigrams of a run of literal text to a query
+ * @param q   Query
+ * @param run Literal text
+ */
+static void query_add_run(struct BodyIndexQuery *q, struct Buffer *run)
+{
+  const unsigned char *s = (const unsigned char *) buf_string(run);
+  const size_t len = buf_len(run);
+
+  for (size_t i = 0; (i + 2) < len; i++)
+  {
+    const unsigned char a = s[i];
+    const unsigned char b = s[i + 1];
+    const unsigned char c = s[i + 2];
+
+    if ((a == '\n') || (b == '\n') || (c == '\n'))
+      continue;
+
+    /* Only ASCII is folded, so other characters may have another case */
+    if (q->ign_case && ((a | b | c) & 0x80))
+      continue;
+
+    const uint32_t trigram = (fold_case(a) << 16) | (fold_case(b) << 8) | fold_case(c);
+    ARRAY_ADD(&q->trigrams, trigram);
+  }
+
+  buf_reset(run);
+}
+
+/**
+ * skip_bracket - Skip over a bracket expression in a regex
+ * @param s Regex, pointing at the '['
+ * @retval ptr Character after the closing ']'
+ */
+static const char *skip_bracket(const char *s)
+{
+  s++;
+  if (*s == '^')
+    s++;
+  if (*s == ']')
+    s++;
+
+  while (*s && (*s != ']'))
+  {
+    if ((s[0] == '[') && ((s[1] == ':') || (s[1] == '.') || (s[1] == '=')))
+    {
+      const char delim = s[1];
+      s += 2;
+      while (*s && !((s[0] == delim) && (s[1] == ']')))
+        s++;
+      if (*s)
+        s += 2;
+      continue;
+    }
+    s++;
+  }
+
+  return *s ? s + 1 : s;
+}
+
+/**
+ * skip_group - Skip over a parenthesised group in a regex
+ * @param s Regex, pointing at the '('
+ * @retval ptr Character after the closing ')'
+ */
+static const char *skip_group(const char *s)
+{
+  int depth = 0;
+  while (*s)
+  {
+    if ((s[0] == '\\') && s[1])
+    {
+      s += 2;
+      continue;
+    }
+    if (s[0] == '[')
+    {
+      s = skip_bracket(s);
+      continue;
+    }
+    if (s[0] == '(')
+    {
+      depth++;
+    }
+    else if (s[0] == ')')
+    {
+      depth--;
+      if (depth == 0)
+        return s + 1;
+    }
+    s++;
+  }
+  return s;
+}
+
+/**
+ * skip_quantifier - Skip over a quantifier in a regex
+ * @param s Regex, pointing at the '*', '+', '?' or '{'
+ * @retval ptr Character after the quantifier
+ */
+static const char *skip_quantifier(const char *s)
+{
+  if (*s != '{')
+    return s + 1;
+
+  while (*s && (*s != '}'))
+    s++;
+  return *s ? s + 1 : s;
+}
+
+/**
+ * query_add_regex - Add the literal text that a regex needs to a query
+ * @param q  Query
+ * @param re Extended regular expression
+ *
+ * This is conservative: only text that every match must contain is added.
+ * Anything that isn't understood, e.g. alternation, is skipped.
+ */
+static void query_add_regex(struct BodyIndexQuery *q, const char *re)
+{
+  /* Any alternative might match, so nothing is certain */
+  if (strchr(re, '|'))
+    return;
+
+  struct Buffer *run = buf_pool_get();
+  const char *s = re;
+  while (*s)
+  {
+    char c = *s;
+    if (c == '\\')
+    {
+      /* Classes, anchors and back-references, e.g. \w \b \1 */
+      if ((s[1] == '\0') || isalnum((unsigned char) s[1]) || strchr("<>`'", s[1]))
+      {
+        query_add_run(q, run);
+        s += (s[1] == '\0') ? 1 : 2;
+        continue;
+      }
+      c = s[1];
+      s += 2;
+    }
+    else if (c == '[')
+    {
+      query_add_run(q, run);
+      s = skip_bracket(s);
+      continue;
+    }
+    else if (c == '(')
+    {
+      query_add_run(q, run);
+      s = skip_group(s);
+      continue;
+    }
+    else if ((c == '*') || (c == '+') || (c == '?') || (c == '{'))
+    {
+      /* Quantifier of a group or bracket expression */
+      query_add_run(q, run);
+      s = skip_quantifier(s);
+      continue;
+    }
+    else if ((c == '.') || (c == '^') || (c == '$') || (c == ')'))
+    {
+      query_add_run(q, run);
+      s++;
+      continue;
+    }
+    else
+    {
+      s++;
+    }
+
+    /* The character is optional, so the run ends before it */
+    if ((*s == '*') || (*s == '?') || (*s == '{'))
+    {
+      query_add_run(q, run);
+      s = skip_quantifier(s);
+      continue;
+    }
+
+    buf_addch(run, c);
+
+    /* The character may be repeated, so a new run starts with it */
+    if (*s == '+')
+    {
+      query_add_run(q, run);
+      buf_addch(run, c);
+      s++;
+    }
+  }
+
+  query_add_run(q, run);
+  buf_pool_release(&run);
+}
+
+/**
+ * body_index_query_new - Create a query for a body search
+ * @param str      Text or regex to search for
+ * @param is_regex True if str is an extended regular expression
+ * @param ign_case True if the search ignores case
+ * @retval ptr New BodyIndexQuery
+ */
+struct BodyIndexQuery *body_index_query_new(const char *str, bool is_regex, bool ign_case)
+{
+  struct BodyIndexQuery *q = mutt_mem_calloc(1, sizeof(struct BodyIndexQuery));
+  ARRAY_INIT(&q->trigrams);
+  q->ign_case = ign_case;
+
+  if (!str)
+    return q;
+
+  if (is_regex)
+  {
+    query_add_regex(q, str);
+  }
+  else
+  {
+    struct Buffer *run = buf_pool_get();
+    buf_strcpy(run, str);
+    query_add_run(q, run);
+    buf_pool_release(&run);
+  }
+
+  return q;
+}
+
+/**
+ * body_index_query_free - Free a BodyIndexQuery
+ * @param[out] ptr BodyIndexQuery to free
+ */
+void body_index_query_free(struct BodyIndexQuery **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct BodyIndexQuery *q = *ptr;
+  ARRAY_FREE(&q->trigrams);
+  FREE(ptr);
+}
+
+/**
+ * body_index_text_may_match - Could some text match a query?
+ * @param q    Query
+ * @param text Text to test
+ * @retval true The text contains all the query's trigrams
+ *
+ * This indexes the text, just like a message body, then checks the query.
+ */
+bool body_index_text_may_match(const struct BodyIndexQuery *q, const char *text)
+{
+  if (!q || !text)
+    return true;
+
+  uint64_t bitmap[BITMAP_WORDS(BODY_BITS_LOG2)] = { 0 };
+  struct TrigramState ts = { 0 };
+  bitmap_add_text(bitmap, BODY_BITS_LOG2, &ts, (const unsigned char *) text,
+                  strlen(text));
+
+  return bitmap_has_all(bitmap, BODY_BITS_LOG2, q);
+}
+
+#ifdef USE_HCACHE
+/**
+ * record_key - Create the header cache key for an Email's index record
+ * @param e   Email
+ * @param buf Buffer for the result
+ * @retval true Success, the Email has a Message-ID
+ */
+static bool record_key(const struct Email *e, struct Buffer *buf)
+{
+  if (!e->env || !e->env->message_id || !e->body)
+    return false;
+
+  buf_printf(buf, BODY_INDEX_KEY "%s", e->env->message_id);
+  return true;
+}
+
+/**
+ * record_fetch - Fetch an Email's index record
+ * @param[in]  bi  Body index
+ * @param[in]  e   Email
+ * @param[out] rec Record
+ * @retval true Success, the record is valid for this Email
+ */
+static bool record_fetch(struct BodyIndex *bi, const struct Email *e,
+                         struct BodyIndexRecord *rec)
+{
+  struct Buffer *key = buf_pool_get();
+  bool rc = record_key(e, key) &&
+            hcache_fetch_obj(bi->hc, buf_string(key), buf_len(key), rec);
+  buf_pool_release(&key);
+
+  return rc && (rec->version == BODY_INDEX_VERSION) && (rec->charset == bi->charset) &&
+         (rec->length == e->body->length) && (rec->date_sent == e->date_sent);
+}
+#endif
+
+/**
+ * body_index_open - Open the body index of a Mailbox
+ * @param m Mailbox
+ * @retval ptr  Body index
+ * @retval NULL $body_index is unset, or the Mailbox can't be indexed
+ *
+ * Only local Mailboxes with a header cache are indexed.
+ */
+struct BodyIndex *body_index_open(struct Mailbox *m)
+{
+#ifdef USE_HCACHE
+  const bool c_body_index = cs_subset_bool(NeoMutt->sub, "body_index");
+  if (!c_body_index || !m)
+    return NULL;
+
+  if ((m->type != MUTT_MBOX) && (m->type != MUTT_MMDF) &&
+      (m->type != MUTT_MAILDIR) && (m->type != MUTT_MH))
+  {
+    return NULL;
+  }
+
+  const char *const c_header_cache = cs_subset_path(NeoMutt->sub, "header_cache");
+  struct HeaderCache *hc = hcache_open(c_header_cache, mailbox_path(m), NULL);
+  if (!hc)
+    return NULL;
+
+  struct BodyIndex *bi = mutt_mem_calloc(1, sizeof(struct BodyIndex));
+  bi->hc = hc;
+  const char *const c_charset = cs_subset_string(NeoMutt->sub, "charset");
+  for (const char *s = NONULL(c_charset); *s; s++)
+    bi->charset = (bi->charset * 31) + (unsigned char) *s;
+
+  hcache_begin_batch(hc);
+  return bi;
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * body_index_close - Close a body index
+ * @param[out] ptr Body index to close
+ */
+void body_index_close(struct BodyIndex **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+#ifdef USE_HCACHE
+  struct BodyIndex *bi = *ptr;
+  hcache_commit_batch(bi->hc);
+  hcache_close(&bi->hc);
+#endif
+  FREE(ptr);
+}
+
+/**
+ * body_index_needed - Does a Pattern contain any indexable searches?
+ * @param pat Pattern
+ * @retval true The Pattern, or one of its children, has a BodyIndexQuery
+ */
+bool body_index_needed(const struct Pattern *pat)
+{
+  if (!pat)
+    return false;
+
+  if (pat->bquery)
+    return true;
+
+  const struct Pattern *np = NULL;
+  if (pat->child)
+  {
+    SLIST_FOREACH(np, pat->child, entries)
+    {
+      if (body_index_needed(np))
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * body_index_attach - Set the body index for all of a Pattern's searches
+ * @param pat Pattern
+ * @param bi  Body index, NULL to detach it
+ */
+void body_index_attach(struct Pattern *pat, struct BodyIndex *bi)
+{
+  if (!pat)
+    return;
+
+  if (pat->bquery)
+    pat->bquery->index = bi;
+
+  struct Pattern *np = NULL;
+  if (pat->child)
+  {
+    SLIST_FOREACH(np, pat->child, entries)
+    {
+      body_index_attach(np, bi);
+    }
+  }
+}
+
+/**
+ * body_index_may_match - Could an Email match a body search?
+ * @param q  Query
+ * @param e  Email
+ * @param op Search, #MUTT_PAT_BODY or #MUTT_PAT_WHOLE_MSG
+ * @retval true  The Email must be searched
+ * @retval false The Email can't match
+ */
+bool body_index_may_match(const struct BodyIndexQuery *q, struct Email *e, int op)
+{
+  if (!q || !q->index || !e || ARRAY_EMPTY(&q->trigrams))
+    return true;
+
+#ifdef USE_HCACHE
+  struct BodyIndexRecord rec = { 0 };
+  if (!record_fetch(q->index, e, &rec))
+    return true;
+
+  const bool body = !(rec.parts & BODY_INDEX_BODY) ||
+                    bitmap_has_all(rec.body, BODY_BITS_LOG2, q);
+  if (body || (op != MUTT_PAT_WHOLE_MSG))
+    return body;
+
+  return !(rec.parts & BODY_INDEX_HEAD) || bitmap_has_all(rec.head, HEAD_BITS_LOG2, q);
+#else
+  return true;
+#endif
+}
+
+/**
+ * index_add - Index the decoded text of an Email
+ * @param bi       Body index
+ * @param e        Email
+ * @param fp       Decoded text, the header followed by the body
+ * @param head_len Length of the header, -1 if it isn't in the file
+ * @param body_len Length of the body, -1 if it isn't in the file
+ *
+ * The text is read from the current position of the file.
+ */
+static void index_add(struct BodyIndex *bi, struct Email *e, FILE *fp,
+                      long head_len, long body_len)
+{
+  if (!bi || !e || !fp || (e->security & SEC_ENCRYPT))
+    return;
+
+#ifdef USE_HCACHE
+  struct BodyIndexRecord rec = { 0 };
+  if (!record_fetch(bi, e, &rec))
+  {
+    memset(&rec, 0, sizeof(rec));
+    rec.version = BODY_INDEX_VERSION;
+    rec.charset = bi->charset;
+    rec.length = e->body->length;
+    rec.date_sent = e->date_sent;
+  }
+
+  uint32_t parts = rec.parts;
+  if (head_len >= 0)
+    parts |= BODY_INDEX_HEAD;
+  if (body_len >= 0)
+    parts |= BODY_INDEX_BODY;
+  if (parts == rec.parts)
+    return;
+
+  if (head_len >= 0)
+  {
+    memset(rec.head, 0, sizeof(rec.head));
+    bitmap_add_file(rec.head, HEAD_BITS_LOG2, fp, head_len);
+  }
+  if (body_len >= 0)
+  {
+    memset(rec.body, 0, sizeof(rec.body));
+    bitmap_add_file(rec.body, BODY_BITS_LOG2, fp, body_len);
+  }
+  rec.parts = parts;
+
+  struct Buffer *key = buf_pool_get();
+  if (record_key(e, key))
+    hcache_store_raw(bi->hc, buf_string(key), buf_len(key), &rec, sizeof(rec));
+  buf_pool_release(&key);
+#endif
+}
+
+/**
+ * body_index_add - Index the decoded text of a searched Email
+ * @param q        Query of the search
+ * @param e        Email
+ * @param fp       Decoded text, the header followed by the body
+ * @param head_len Length of the header, -1 if it isn't in the file
+ * @param body_len Length of the body, -1 if it isn't in the file
+ *
+ * The text is read from the current position of the file.  Nothing is done
+ * unless the search is using a body index.
+ */
+void body_index_add(const struct BodyIndexQuery *q, struct Email *e, FILE *fp,
+                    long head_len, long body_len)
+{
+  if (!q || !q->index)
+    return;
+
+  index_add(q->index, e, fp, head_len, body_len);
+}
+
+/**
+ * index_email - Decode and index an Email
+ * @param bi Body index
+ * @param m  Mailbox
+ * @param e  Email
+ */
+static void index_email(struct BodyIndex *bi, struct Mailbox *m, struct Email *e)
+{
+#ifdef USE_HCACHE
+  struct BodyIndexRecord rec = { 0 };
+  if (record_fetch(bi, e, &rec) && (rec.parts == (BODY_INDEX_HEAD | BODY_INDEX_BODY)))
+    return;
+#endif
+
+  struct Message *msg = mx_msg_open(m, e);
+  if (!msg)
+    return;
+
+  FILE *fp = mutt_file_mkstemp();
+  if (!fp)
+    goto done;
+
+  mutt_copy_header(msg->fp, e, fp, CH_FROM | CH_DECODE, NULL, 0);
+  const long head_len = ftell(fp);
+
+  mutt_parse_mime_message(e, msg->fp);
+  if ((e->security & SEC_ENCRYPT) || !mutt_file_seek(msg->fp, e->offset, SEEK_SET))
+    goto done;
+
+  struct State state = { 0 };
+  state.fp_in = msg->fp;
+  state.fp_out = fp;
+  state.flags = STATE_CHARCONV;
+  mutt_body_handler(e->body, &state);
+
+  const long len = ftell(fp);
+  if ((head_len < 0) || (len < head_len) || !mutt_file_seek(fp, 0, SEEK_SET))
+    goto done;
+
+  index_add(bi, e, fp, head_len, len - head_len);
+
+done:
+  mutt_file_fclose(&fp);
+  mx_msg_close(m, &msg);
+}
+
+/**
+ * body_index_update - Index the new messages in a Mailbox
+ * @param m     Mailbox
+ * @param first Index of the first new Email
+ *
+ * This is called when new mail arrives, so it's ready to be searched.
+ */
+void body_index_update(struct Mailbox *m, int first)
+{
+  if (!m || (first < 0) || (first >= m->msg_count))
+    return;
+
+  struct BodyIndex *bi = body_index_open(m);
+  if (!bi)
+    return;
+
+  mutt_debug(LL_DEBUG2, "indexing %d new messages\n", m->msg_count - first);
+  for (int i = first; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e)
+      break;
+    index_email(bi, m, e);
+  }
+
+  body_index_close(&bi);
+}
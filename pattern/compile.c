@@ -85,6 +85,8 @@ static bool eat_regex(struct Pattern *pat, PatternCompFlags flags,
   {
     pat->p.str = mutt_str_dup(buf->data);
     pat->ign_case = mutt_mb_is_lower(buf->data);
+    if ((pat->op == MUTT_PAT_BODY) || (pat->op == MUTT_PAT_WHOLE_MSG))
+      pat->bquery = body_index_query_new(buf->data, false, pat->ign_case);
   }
   else if (pat->group_match)
   {
@@ -106,6 +108,8 @@ static bool eat_regex(struct Pattern *pat, PatternCompFlags flags,
       FREE(&pat->p.regex);
       goto out;
     }
+    if ((pat->op == MUTT_PAT_BODY) || (pat->op == MUTT_PAT_WHOLE_MSG))
+      pat->bquery = body_index_query_new(buf->data, true, (case_flags & REG_ICASE));
   }
 
   rc = true;
@@ -806,6 +810,8 @@ void mutt_pattern_free(struct PatternList **pat)
 #ifdef USE_DEBUG_GRAPHVIZ
     FREE(&np->raw_pattern);
 #endif
+    pattern_program_free(&np->program);
+    body_index_query_free(&np->bquery);
     mutt_pattern_free(&np->child);
     FREE(&np);
 
@@ -815,6 +821,29 @@ void mutt_pattern_free(struct PatternList **pat)
   FREE(pat);
 }
 
+/**
+ * mutt_pattern_has_date - Does a Pattern test the date of an Email?
+ * @param pat Pattern to check
+ * @retval true The Pattern, or one of its children, is a `~d` or `~r` test
+ */
+bool mutt_pattern_has_date(const struct PatternList *pat)
+{
+  if (!pat)
+    return false;
+
+  const struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat, entries)
+  {
+    if ((np->op == MUTT_PAT_DATE) || (np->op == MUTT_PAT_DATE_RECEIVED) ||
+        mutt_pattern_has_date(np->child))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /**
  * mutt_pattern_new - Create a new Pattern
  * @retval ptr Newly created Pattern
@@ -894,7 +923,7 @@ static struct Pattern *attach_new_leaf(struct PatternList **curlist)
 }
 
 /**
- * mutt_pattern_comp - Create a Pattern
+ * pattern_comp - Parse a Pattern
  * @param mv    Mailbox view
  * @param menu  Current Menu
  * @param s     Pattern string
@@ -902,9 +931,9 @@ static struct Pattern *attach_new_leaf(struct PatternList **curlist)
  * @param err   Buffer for error messages
  * @retval ptr Newly allocated Pattern
  */
-struct PatternList *mutt_pattern_comp(struct MailboxView *mv, struct Menu *menu,
-                                      const char *s, PatternCompFlags flags,
-                                      struct Buffer *err)
+static struct PatternList *pattern_comp(struct MailboxView *mv, struct Menu *menu,
+                                        const char *s, PatternCompFlags flags,
+                                        struct Buffer *err)
 {
   /* curlist when assigned will always point to a list containing at least one node
    * with a Pattern value.  */
@@ -1009,7 +1038,7 @@ struct PatternList *mutt_pattern_comp(struct MailboxView *mv, struct Menu *menu,
           is_alias = false;
           /* compile the sub-expression */
           buf = mutt_strn_dup(ps.dptr + 1, p - (ps.dptr + 1));
-          leaf->child = mutt_pattern_comp(mv, menu, buf, flags, err);
+          leaf->child = pattern_comp(mv, menu, buf, flags, err);
           if (!leaf->child)
           {
             FREE(&buf);
@@ -1102,7 +1131,7 @@ struct PatternList *mutt_pattern_comp(struct MailboxView *mv, struct Menu *menu,
         }
         /* compile the sub-expression */
         buf = mutt_strn_dup(ps.dptr + 1, p - (ps.dptr + 1));
-        struct PatternList *sub = mutt_pattern_comp(mv, menu, buf, flags, err);
+        struct PatternList *sub = pattern_comp(mv, menu, buf, flags, err);
         FREE(&buf);
         if (!sub)
           goto cleanup;
@@ -1151,3 +1180,27 @@ cleanup:
   mutt_pattern_free(&curlist);
   return NULL;
 }
+
+/**
+ * mutt_pattern_comp - Create a Pattern
+ * @param mv    Mailbox view
+ * @param menu  Current Menu
+ * @param s     Pattern string
+ * @param flags Flags, e.g. #MUTT_PC_FULL_MSG
+ * @param err   Buffer for error messages
+ * @retval ptr Newly allocated Pattern
+ *
+ * The Pattern is parsed, then flattened into a PatternProgram.
+ */
+struct PatternList *mutt_pattern_comp(struct MailboxView *mv, struct Menu *menu,
+                                      const char *s, PatternCompFlags flags,
+                                      struct Buffer *err)
+{
+  struct PatternList *pat = pattern_comp(mv, menu, s, flags, err);
+  if (!pat)
+    return NULL;
+
+  struct Pattern *first = SLIST_FIRST(pat);
+  first->program = pattern_program_new(first);
+  return pat;
+}
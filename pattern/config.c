@@ -36,12 +36,18 @@
  */
 static struct ConfigDef PatternVars[] = {
   // clang-format off
+  { "body_index", DT_BOOL, false, 0, NULL,
+    "Index the text of local messages in the header cache, to speed up body searches"
+  },
   { "external_search_command", DT_STRING|DT_COMMAND, 0, 0, NULL,
     "External search command"
   },
   { "pattern_format", DT_STRING, IP "%2n %-15e  %d", 0, NULL,
     "printf-like format string for the pattern completion menu"
   },
+  { "pattern_threads", DT_NUMBER|DT_NOT_NEGATIVE, 4, 0, NULL,
+    "Number of threads used to match a pattern against a mailbox"
+  },
   { "thorough_search", DT_BOOL, true, 0, NULL,
     "Decode headers and messages before searching them"
   },
@@ -56,10 +56,6 @@
 #include <sys/stat.h>
 #endif
 
-static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
-                         struct Mailbox *m, struct Email *e,
-                         struct Message *msg, struct PatternCache *cache);
-
 /**
  * patmatch - Compare a string to a Pattern
  * @param pat Pattern to use
@@ -103,12 +99,14 @@ static void print_crypt_pattern_op_error(int op)
 /**
  * msg_search - Search an email
  * @param pat   Pattern to find
- * @param e   Email
- * @param msg Message
+ * @param flags Flags, e.g. #MUTT_MATCH_THOROUGH
+ * @param e     Email
+ * @param msg   Message
  * @retval true Pattern found
  * @retval false Error or pattern not found
  */
-static bool msg_search(struct Pattern *pat, struct Email *e, struct Message *msg)
+static bool msg_search(struct Pattern *pat, PatternExecFlags flags,
+                       struct Email *e, struct Message *msg)
 {
   assert(msg);
 
@@ -116,6 +114,7 @@ static bool msg_search(struct Pattern *pat, struct Email *e, struct Message *msg
 
   FILE *fp = NULL;
   long len = 0;
+  long head_len = -1;
 #ifdef USE_FMEMOPEN
   char *temp = NULL;
   size_t tempsize = 0;
@@ -125,8 +124,8 @@ static bool msg_search(struct Pattern *pat, struct Email *e, struct Message *msg
 
   const bool needs_head = (pat->op == MUTT_PAT_HEADER) || (pat->op == MUTT_PAT_WHOLE_MSG);
   const bool needs_body = (pat->op == MUTT_PAT_BODY) || (pat->op == MUTT_PAT_WHOLE_MSG);
-  const bool c_thorough_search = cs_subset_bool(NeoMutt->sub, "thorough_search");
-  if (c_thorough_search)
+  const bool thorough = (flags & MUTT_MATCH_THOROUGH);
+  if (thorough)
   {
     /* decode the header / body */
     struct State state = { 0 };
@@ -151,6 +150,7 @@ static bool msg_search(struct Pattern *pat, struct Email *e, struct Message *msg
     if (needs_head)
     {
       mutt_copy_header(msg->fp, e, state.fp_out, CH_FROM | CH_DECODE, NULL, 0);
+      head_len = ftell(state.fp_out);
     }
 
     if (needs_body)
@@ -215,6 +215,20 @@ static bool msg_search(struct Pattern *pat, struct Email *e, struct Message *msg
     }
     len = (long) st.st_size;
 #endif
+
+    /* save the decoded text in the body index, for the next search */
+    if (pat->bquery && needs_body && (len >= MAX(head_len, 0)))
+    {
+      body_index_add(pat->bquery, e, fp, head_len, len - MAX(head_len, 0));
+      if (!mutt_file_seek(fp, 0, SEEK_SET))
+      {
+        mutt_file_fclose(&fp);
+#ifdef USE_FMEMOPEN
+        FREE(&temp);
+#endif
+        return false;
+      }
+    }
   }
   else
   {
@@ -278,7 +292,7 @@ static bool msg_search(struct Pattern *pat, struct Email *e, struct Message *msg
     }
   }
 
-  if (c_thorough_search)
+  if (thorough)
     mutt_file_fclose(&fp);
 
 #ifdef USE_FMEMOPEN
@@ -775,7 +789,7 @@ static int msg_search_sendmode(struct Email *e, struct Pattern *pat)
  * @retval true The pattern needs a full message
  * @retval false The pattern does not need a full message
  */
-static bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat)
+bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat)
 {
   if ((pat->op == MUTT_PAT_MIMETYPE) || (pat->op == MUTT_PAT_MIMEATTACH))
   {
@@ -821,9 +835,8 @@ static bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat
  * cache: For repeated matches against the same Header, passing in non-NULL will
  *        store some of the cacheable pattern matches in this structure.
  */
-static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
-                         struct Mailbox *m, struct Email *e,
-                         struct Message *msg, struct PatternCache *cache)
+bool pattern_exec(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m,
+                  struct Email *e, struct Message *msg, struct PatternCache *cache)
 {
   switch (pat->op)
   {
@@ -889,7 +902,7 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
       if ((m->type == MUTT_IMAP) && pat->string_match)
         return e->matched;
 #endif
-      return pat->pat_not ^ msg_search(pat, e, msg);
+      return pat->pat_not ^ msg_search(pat, flags, e, msg);
     case MUTT_PAT_SERVERSEARCH:
 #ifdef USE_IMAP
       if (!m)
@@ -904,6 +917,7 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
     case MUTT_PAT_SENDER:
       if (!e->env)
         return false;
+      email_materialize(e);
       return pat->pat_not ^ match_addrlist(pat, (flags & MUTT_MATCH_FULL_ADDRESS),
                                            1, &e->env->sender);
     case MUTT_PAT_FROM:
@@ -949,6 +963,7 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
     case MUTT_PAT_ADDRESS:
       if (!e->env)
         return false;
+      email_materialize(e);
       return pat->pat_not ^ match_addrlist(pat, (flags & MUTT_MATCH_FULL_ADDRESS),
                                            5, &e->env->from, &e->env->sender,
                                            &e->env->to, &e->env->cc, &e->env->bcc);
@@ -1137,15 +1152,10 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
 bool mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags,
                        struct Mailbox *m, struct Email *e, struct PatternCache *cache)
 {
-  const bool needs_msg = pattern_needs_msg(m, pat);
-  struct Message *msg = needs_msg ? mx_msg_open(m, e) : NULL;
-  if (needs_msg && !msg)
-  {
-    return false;
-  }
-  const bool matched = pattern_exec(pat, flags, m, e, msg, cache);
-  mx_msg_close(m, &msg);
-  return matched;
+  if (!pat->program)
+    pat->program = pattern_program_new(pat);
+
+  return pattern_program_exec(pat->program, flags, m, e, cache);
 }
 
 /**
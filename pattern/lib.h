@@ -28,6 +28,7 @@
  *
  * | File                  | Description                  |
  * | :-------------------- | :--------------------------- |
+ * | pattern/body_index.c  | @subpage pattern_body_index  |
  * | pattern/compile.c     | @subpage pattern_compile     |
  * | pattern/config.c      | @subpage pattern_config      |
  * | pattern/dlg_pattern.c | @subpage pattern_dlg_pattern |
@@ -35,7 +36,9 @@
  * | pattern/flags.c       | @subpage pattern_flags       |
  * | pattern/functions.c   | @subpage pattern_functions   |
  * | pattern/message.c     | @subpage pattern_message     |
+ * | pattern/parallel.c    | @subpage pattern_parallel    |
  * | pattern/pattern.c     | @subpage pattern_pattern     |
+ * | pattern/program.c     | @subpage pattern_program     |
  */
 
 #ifndef MUTT_PATTERN_LIB_H
@@ -50,11 +53,13 @@
 
 struct AliasMenuData;
 struct AliasView;
+struct BodyIndexQuery;
 struct Email;
 struct Envelope;
 struct Mailbox;
 struct MailboxView;
 struct Menu;
+struct PatternProgram;
 
 #define MUTT_ALIAS_SIMPLESEARCH "~f %s | ~t %s | ~c %s"
 
@@ -88,6 +93,8 @@ struct Pattern
     char *str;                   ///< String, if string_match is set
     struct ListHead multi_cases; ///< Multiple strings for ~I pattern
   } p;
+  struct PatternProgram *program; ///< Flattened form, used by mutt_pattern_exec()
+  struct BodyIndexQuery *bquery;  ///< Text needed by a body search, see $body_index
 #ifdef USE_DEBUG_GRAPHVIZ
   const char *raw_pattern;
 #endif
@@ -98,6 +105,7 @@ SLIST_HEAD(PatternList, Pattern);
 typedef uint8_t PatternExecFlags;         ///< Flags for mutt_pattern_exec(), e.g. #MUTT_MATCH_FULL_ADDRESS
 #define MUTT_PAT_EXEC_NO_FLAGS         0  ///< No flags are set
 #define MUTT_MATCH_FULL_ADDRESS  (1 << 0) ///< Match the full address
+#define MUTT_MATCH_THOROUGH      (1 << 1) ///< Decode the message before searching it, see $thorough_search
 
 /**
  * struct PatternCache - Cache commonly-used patterns
@@ -184,6 +192,7 @@ bool mutt_pattern_alias_exec(struct Pattern *pat, PatternExecFlags flags,
 struct PatternList *mutt_pattern_comp(struct MailboxView *mv, struct Menu *menu, const char *s, PatternCompFlags flags, struct Buffer *err);
 void mutt_check_simple(struct Buffer *s, const char *simple);
 void mutt_pattern_free(struct PatternList **pat);
+bool mutt_pattern_has_date(const struct PatternList *pat);
 bool dlg_select_pattern(char *buf, size_t buflen);
 
 int mutt_which_case(const char *s);
@@ -194,4 +203,6 @@ int mutt_pattern_alias_func(char *prompt, struct AliasMenuData *mdata, struct Me
 int mutt_search_command(struct MailboxView *mv, struct Menu *menu, int cur, int op);
 int mutt_search_alias_command(struct Menu *menu, int cur, int op);
 
+void body_index_update(struct Mailbox *m, int first);
+
 #endif /* MUTT_PATTERN_LIB_H */
@@ -0,0 +1,572 @@
+/**
+ * @file
+ * Match a Pattern against many Emails at once
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page pattern_parallel Match a Pattern against many Emails at once
+ *
+ * Limit, tag and search test every Email in a Mailbox.  This can be spread
+ * over $pattern_threads worker threads, in one of two ways.
+ *
+ * If the Pattern only looks at flags and headers, and every test is safe to
+ * run off the main thread, the Emails are shared out in chunks.  The workers
+ * and the main thread each test a chunk at a time, writing into a results
+ * array.  The Emails aren't changed.
+ *
+ * If the Pattern needs to read the messages, e.g. `~b`, the tests are run by
+ * the main thread (decoding isn't thread-safe).  The workers read the messages
+ * ahead of it, at most #PREFETCH_WINDOW messages ahead, so they're in the page
+ * cache when the main thread gets to them.  This is only done for local
+ * mailboxes: mbox, MMDF, Maildir and MH.
+ *
+ * The caller applies the results, so the Mailbox is only changed by the main
+ * thread.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "lib.h"
+#include "ncrypt/lib.h"
+#include "progress/lib.h"
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+/// Number of Emails a worker takes at a time
+#define MATCH_CHUNK 64
+
+/// Don't start any threads for fewer Emails than this
+#define MATCH_MIN_EMAILS 1024
+
+/// Maximum number of messages read ahead of the main thread
+#define PREFETCH_WINDOW 32
+
+/// Size of a worker's read buffer
+#define PREFETCH_BUFSIZE 65536
+
+/**
+ * struct PrefetchFile - Part of a file to read ahead
+ */
+struct PrefetchFile
+{
+  char *path;    ///< File to read, NULL to use PatternBatch.mbox_path
+  LOFF_T offset; ///< Start of the message
+  LOFF_T length; ///< Length of the message, 0 for the whole file
+};
+ARRAY_HEAD(PrefetchFileArray, struct PrefetchFile);
+
+/**
+ * struct PatternBatch - Match a Pattern against an array of Emails
+ */
+struct PatternBatch
+{
+  struct Pattern *pat;             ///< Pattern to match
+  PatternExecFlags flags;          ///< Flags, e.g. #MUTT_MATCH_FULL_ADDRESS
+  struct Mailbox *mailbox;         ///< Mailbox
+  struct EmailArray *emails;       ///< Emails to test
+  bool *matches;                   ///< Results, one per Email
+  struct PrefetchFileArray files;  ///< Messages to read ahead
+  const char *mbox_path;           ///< Mailbox file (mbox, MMDF)
+  size_t next;                     ///< Next Email to test, or message to read
+  size_t consumed;                 ///< Number of Emails tested by the main thread
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_t lock;            ///< Protects next, consumed and num_idle
+  pthread_cond_t cond_space;       ///< Signalled when the main thread catches up
+  pthread_t *threads;              ///< Worker threads
+  int num_threads;                 ///< Number of worker threads
+  int num_idle;                    ///< Number of workers waiting for cond_space
+  bool stop;                       ///< Tell the workers to finish
+#endif
+};
+
+/**
+ * pattern_is_thread_safe - Can a Pattern be tested off the main thread?
+ * @param pat Pattern
+ * @retval true Every test only reads the Email's flags and headers
+ *
+ * Tests which log, use the config, open the message, change the Pattern or
+ * look at other Emails, e.g. thread patterns, aren't safe.
+ */
+static bool pattern_is_thread_safe(const struct Pattern *pat)
+{
+  if (pat->group_match || pat->dynamic)
+    return false;
+
+  switch (pat->op)
+  {
+    case MUTT_PAT_AND:
+    case MUTT_PAT_OR:
+    {
+      struct Pattern *np = NULL;
+      SLIST_FOREACH(np, pat->child, entries)
+      {
+        if (!pattern_is_thread_safe(np))
+          return false;
+      }
+      return true;
+    }
+
+    case MUTT_ALL:
+    case MUTT_EXPIRED:
+    case MUTT_SUPERSEDED:
+    case MUTT_FLAG:
+    case MUTT_TAG:
+    case MUTT_NEW:
+    case MUTT_UNREAD:
+    case MUTT_REPLIED:
+    case MUTT_OLD:
+    case MUTT_READ:
+    case MUTT_DELETED:
+    case MUTT_PAT_MESSAGE:
+    case MUTT_PAT_DATE:
+    case MUTT_PAT_DATE_RECEIVED:
+    case MUTT_PAT_FROM:
+    case MUTT_PAT_TO:
+    case MUTT_PAT_CC:
+    case MUTT_PAT_BCC:
+    case MUTT_PAT_RECIPIENT:
+    case MUTT_PAT_SUBJECT:
+    case MUTT_PAT_ID:
+    case MUTT_PAT_ID_EXTERNAL:
+    case MUTT_PAT_SCORE:
+    case MUTT_PAT_SIZE:
+    case MUTT_PAT_REFERENCE:
+    case MUTT_PAT_COLLAPSED:
+    case MUTT_PAT_HORMEL:
+    case MUTT_PAT_DUPLICATED:
+    case MUTT_PAT_UNREFERENCED:
+    case MUTT_PAT_BROKEN:
+    case MUTT_PAT_XLABEL:
+    case MUTT_PAT_DRIVER_TAGS:
+#ifdef USE_NNTP
+    case MUTT_PAT_NEWSGROUPS:
+#endif
+      return true;
+
+    case MUTT_PAT_CRYPT_SIGN:
+    case MUTT_PAT_CRYPT_VERIFIED:
+    case MUTT_PAT_CRYPT_ENCRYPT:
+      // Without crypto, these print an error
+      return (WithCrypto != 0);
+
+    case MUTT_PAT_PGP_KEY:
+      return ((WithCrypto & APPLICATION_PGP) != 0);
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * match_range - Test a range of Emails
+ * @param pb    Batch
+ * @param start First Email
+ * @param end   End of the range (exclusive)
+ *
+ * @note This may be called from worker threads
+ */
+static void match_range(struct PatternBatch *pb, size_t start, size_t end)
+{
+  for (size_t i = start; i < end; i++)
+  {
+    struct Email *e = *ARRAY_GET(pb->emails, i);
+    pb->matches[i] = pattern_program_exec(pb->pat->program, pb->flags,
+                                          pb->mailbox, e, NULL);
+  }
+}
+
+/**
+ * prefetch_file - Read a message, so it's in the page cache
+ * @param pf  Message to read
+ * @param fd  Open mailbox file (mbox, MMDF), or -1
+ * @param buf Scratch buffer, #PREFETCH_BUFSIZE bytes
+ *
+ * Errors are ignored; the main thread will report them when it opens the
+ * message.
+ *
+ * @note This is called from worker threads, so it mustn't log or use any
+ *       shared state.
+ */
+static void prefetch_file(const struct PrefetchFile *pf, int fd, char *buf)
+{
+  if (pf->path)
+  {
+    fd = open(pf->path, O_RDONLY);
+    if (fd < 0)
+      return;
+  }
+  else if (fd < 0)
+  {
+    return;
+  }
+
+  LOFF_T pos = pf->offset;
+  while (true)
+  {
+    size_t want = PREFETCH_BUFSIZE;
+    if (!pf->path)
+    {
+      const LOFF_T left = pf->offset + pf->length - pos;
+      if (left <= 0)
+        break;
+      want = MIN(want, (size_t) left);
+    }
+
+    ssize_t rc = pread(fd, buf, want, pos);
+    if ((rc < 0) && (errno == EINTR))
+      continue;
+    if (rc <= 0)
+      break;
+    pos += rc;
+  }
+
+  if (pf->path)
+    close(fd);
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+/**
+ * match_worker - Test chunks of Emails until there are none left
+ * @param arg Batch
+ * @retval NULL Always
+ */
+static void *match_worker(void *arg)
+{
+  struct PatternBatch *pb = arg;
+  const size_t num = ARRAY_SIZE(pb->emails);
+
+  pthread_mutex_lock(&pb->lock);
+  while (!pb->stop && (pb->next < num))
+  {
+    size_t start = pb->next;
+    size_t end = MIN(start + MATCH_CHUNK, num);
+    pb->next = end;
+    pthread_mutex_unlock(&pb->lock);
+
+    match_range(pb, start, end);
+
+    pthread_mutex_lock(&pb->lock);
+  }
+  pthread_mutex_unlock(&pb->lock);
+
+  return NULL;
+}
+
+/**
+ * prefetch_worker - Read messages ahead of the main thread
+ * @param arg Batch
+ * @retval NULL Always
+ */
+static void *prefetch_worker(void *arg)
+{
+  struct PatternBatch *pb = arg;
+  char *buf = mutt_mem_malloc(PREFETCH_BUFSIZE);
+  int fd = -1;
+  if (pb->mbox_path)
+    fd = open(pb->mbox_path, O_RDONLY);
+
+  pthread_mutex_lock(&pb->lock);
+  while (!pb->stop && (pb->next < ARRAY_SIZE(&pb->files)))
+  {
+    if (pb->next >= (pb->consumed + PREFETCH_WINDOW))
+    {
+      pb->num_idle++;
+      pthread_cond_wait(&pb->cond_space, &pb->lock);
+      pb->num_idle--;
+      continue;
+    }
+
+    struct PrefetchFile *pf = ARRAY_GET(&pb->files, pb->next);
+    pb->next++;
+    pthread_mutex_unlock(&pb->lock);
+
+    prefetch_file(pf, fd, buf);
+
+    pthread_mutex_lock(&pb->lock);
+  }
+  pthread_mutex_unlock(&pb->lock);
+
+  if (fd >= 0)
+    close(fd);
+  FREE(&buf);
+  return NULL;
+}
+
+/**
+ * batch_start - Start the worker threads
+ * @param pb          Batch
+ * @param num_threads Number of threads to start
+ * @param worker      Worker function
+ */
+static void batch_start(struct PatternBatch *pb, int num_threads, void *(*worker)(void *))
+{
+  if (num_threads <= 0)
+    return;
+
+  /* Signals must be handled by the main thread */
+  sigset_t all = { 0 };
+  sigset_t old = { 0 };
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+
+  pb->threads = mutt_mem_calloc(num_threads, sizeof(pthread_t));
+  for (int i = 0; i < num_threads; i++)
+  {
+    int rc = pthread_create(&pb->threads[pb->num_threads], NULL, worker, pb);
+    if (rc != 0)
+    {
+      mutt_debug(LL_DEBUG1, "pthread_create: %s (errno %d)\n", strerror(rc), rc);
+      break;
+    }
+    pb->num_threads++;
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+/**
+ * batch_stop - Stop the worker threads and wait for them
+ * @param pb Batch
+ */
+static void batch_stop(struct PatternBatch *pb)
+{
+  pthread_mutex_lock(&pb->lock);
+  pb->stop = true;
+  pthread_cond_broadcast(&pb->cond_space);
+  pthread_mutex_unlock(&pb->lock);
+
+  for (int i = 0; i < pb->num_threads; i++)
+    pthread_join(pb->threads[i], NULL);
+  FREE(&pb->threads);
+  pb->num_threads = 0;
+}
+#endif
+
+/**
+ * match_headers - Test the Emails, sharing the work with the workers
+ * @param pb          Batch
+ * @param num_threads Number of worker threads
+ * @param progress    Progress bar, may be NULL
+ */
+static void match_headers(struct PatternBatch *pb, int num_threads, struct Progress *progress)
+{
+  const size_t num = ARRAY_SIZE(pb->emails);
+
+#ifdef HAVE_PTHREAD_CREATE
+  if ((num_threads > 0) && (num >= MATCH_MIN_EMAILS))
+  {
+    batch_start(pb, num_threads, match_worker);
+    mutt_debug(LL_DEBUG2, "matching %zu emails with %d threads\n", num, pb->num_threads);
+  }
+
+  pthread_mutex_lock(&pb->lock);
+  while (pb->next < num)
+  {
+    size_t start = pb->next;
+    size_t end = MIN(start + MATCH_CHUNK, num);
+    pb->next = end;
+    pthread_mutex_unlock(&pb->lock);
+
+    match_range(pb, start, end);
+    progress_update(progress, start, -1);
+
+    pthread_mutex_lock(&pb->lock);
+  }
+  pthread_mutex_unlock(&pb->lock);
+
+  batch_stop(pb);
+#else
+  for (size_t i = 0; i < num; i += MATCH_CHUNK)
+  {
+    match_range(pb, i, MIN(i + MATCH_CHUNK, num));
+    progress_update(progress, i, -1);
+  }
+#endif
+}
+
+/**
+ * prefetch_init - Work out which messages to read ahead
+ * @param pb Batch
+ * @retval true The Mailbox type supports reading ahead
+ */
+static bool prefetch_init(struct PatternBatch *pb)
+{
+  struct Mailbox *m = pb->mailbox;
+  if (!m)
+    return false;
+
+  const bool is_mbox = (m->type == MUTT_MBOX) || (m->type == MUTT_MMDF);
+  const bool is_dir = (m->type == MUTT_MAILDIR) || (m->type == MUTT_MH);
+  if (!is_mbox && !is_dir)
+    return false;
+
+  struct Buffer *path = buf_pool_get();
+  struct Email **ep = NULL;
+  ARRAY_FOREACH(ep, pb->emails)
+  {
+    struct Email *e = *ep;
+    struct PrefetchFile pf = { 0 };
+    if (is_dir)
+    {
+      if (!e->path)
+        continue;
+      buf_printf(path, "%s/%s", mailbox_path(m), e->path);
+      pf.path = buf_strdup(path);
+    }
+    else
+    {
+      if (!e->body)
+        continue;
+      pf.offset = e->offset;
+      pf.length = e->body->offset + e->body->length - e->offset;
+    }
+    ARRAY_ADD(&pb->files, pf);
+  }
+  buf_pool_release(&path);
+
+  if (is_mbox)
+    pb->mbox_path = mailbox_path(m);
+
+  return true;
+}
+
+/**
+ * match_messages - Test the Emails, while the workers read ahead
+ * @param pb          Batch
+ * @param num_threads Number of worker threads
+ * @param progress    Progress bar, may be NULL
+ */
+static void match_messages(struct PatternBatch *pb, int num_threads, struct Progress *progress)
+{
+  const size_t num = ARRAY_SIZE(pb->emails);
+
+#ifdef HAVE_PTHREAD_CREATE
+  if ((num_threads > 0) && (num > 1) && pb->mailbox &&
+      pattern_needs_msg(pb->mailbox, pb->pat) && prefetch_init(pb))
+  {
+    batch_start(pb, MIN(num_threads, (int) num), prefetch_worker);
+    mutt_debug(LL_DEBUG2, "reading %zu messages ahead with %d threads\n",
+               ARRAY_SIZE(&pb->files), pb->num_threads);
+  }
+#endif
+
+  for (size_t i = 0; i < num; i++)
+  {
+    struct Email *e = *ARRAY_GET(pb->emails, i);
+    progress_update(progress, i, -1);
+    pb->matches[i] = mutt_pattern_exec(pb->pat, pb->flags, pb->mailbox, e, NULL);
+
+#ifdef HAVE_PTHREAD_CREATE
+    if (pb->num_threads > 0)
+    {
+      pthread_mutex_lock(&pb->lock);
+      pb->consumed = i + 1;
+      /* Don't read messages we've already passed */
+      if (pb->next < pb->consumed)
+        pb->next = pb->consumed;
+      /* Wake the workers in batches, rather than for every message */
+      if ((pb->num_idle > 0) && (pb->next <= (pb->consumed + (PREFETCH_WINDOW / 2))))
+        pthread_cond_broadcast(&pb->cond_space);
+      pthread_mutex_unlock(&pb->lock);
+    }
+#endif
+  }
+
+#ifdef HAVE_PTHREAD_CREATE
+  batch_stop(pb);
+#endif
+}
+
+/**
+ * pattern_exec_emails - Match a Pattern against an array of Emails
+ * @param[in]  pat      Pattern to match
+ * @param[in]  flags    Flags, e.g. #MUTT_MATCH_FULL_ADDRESS
+ * @param[in]  m        Mailbox
+ * @param[in]  ea       Emails to test
+ * @param[out] matches  Results, one per Email
+ * @param[in]  progress Progress bar, may be NULL
+ *
+ * This gives the same results as calling mutt_pattern_exec() for each Email,
+ * but it may use worker threads, see $pattern_threads.
+ */
+void pattern_exec_emails(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m,
+                         struct EmailArray *ea, bool *matches, struct Progress *progress)
+{
+  if (!pat || !ea || !matches || ARRAY_EMPTY(ea))
+    return;
+
+  if (!pat->program)
+    pat->program = pattern_program_new(pat);
+
+  struct PatternBatch pb = { 0 };
+  pb.pat = pat;
+  pb.flags = flags;
+  pb.mailbox = m;
+  pb.emails = ea;
+  pb.matches = matches;
+  ARRAY_INIT(&pb.files);
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_mutex_init(&pb.lock, NULL);
+  pthread_cond_init(&pb.cond_space, NULL);
+#endif
+
+  /* The body index summarises the decoded text */
+  struct BodyIndex *bi = NULL;
+  if (body_index_needed(pat))
+  {
+    const bool c_thorough_search = cs_subset_bool(NeoMutt->sub, "thorough_search");
+    if (c_thorough_search)
+      bi = body_index_open(m);
+  }
+  body_index_attach(pat, bi);
+
+  const short c_pattern_threads = cs_subset_number(NeoMutt->sub, "pattern_threads");
+  if (pattern_is_thread_safe(pat))
+    match_headers(&pb, c_pattern_threads, progress);
+  else
+    match_messages(&pb, c_pattern_threads, progress);
+
+  body_index_attach(pat, NULL);
+  body_index_close(&bi);
+
+#ifdef HAVE_PTHREAD_CREATE
+  pthread_cond_destroy(&pb.cond_space);
+  pthread_mutex_destroy(&pb.lock);
+#endif
+
+  struct PrefetchFile *pf = NULL;
+  ARRAY_FOREACH(pf, &pb.files)
+  {
+    FREE(&pf->path);
+  }
+  ARRAY_FREE(&pb.files);
+}
@@ -56,6 +56,12 @@
 #include "imap/lib.h"
 #endif
 
+/// Number of Emails to test at once, when searching
+#define SEARCH_BATCH 1024
+
+/// Number of Emails to test at once, when searching the message bodies
+#define SEARCH_BATCH_MSG 32
+
 /**
  * RangeRegexes - Set of Regexes for various range types
  *
@@ -347,13 +353,21 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
     mv->collapsed = false;
     int padding = mx_msg_padding_size(m);
 
-    for (int i = 0; i < m->msg_count; i++)
+    struct EmailArray ea = ARRAY_HEAD_INITIALIZER;
+    for (int i = 0; (i < m->msg_count) && m->emails[i]; i++)
+      ARRAY_ADD(&ea, m->emails[i]);
+
+    bool *matches = mutt_mem_calloc(MAX(ARRAY_SIZE(&ea), 1), sizeof(bool));
+    if (!match_all)
+    {
+      pattern_exec_emails(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, &ea,
+                          matches, progress);
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(&ea); i++)
     {
       struct Email *e = m->emails[i];
-      if (!e)
-        break;
 
-      progress_update(progress, i, -1);
       /* new limit pattern implicitly uncollapses all threads */
       e->vnum = -1;
       e->visible = false;
@@ -361,8 +375,7 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
       e->collapsed = false;
       e->num_hidden = 0;
 
-      if (match_all ||
-          mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
+      if (match_all || matches[i])
       {
         e->vnum = m->vcount;
         e->visible = true;
@@ -372,16 +385,28 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
         mv->vsize += b->length + b->offset - b->hdr_offset + padding;
       }
     }
+
+    FREE(&matches);
+    ARRAY_FREE(&ea);
   }
   else
   {
+    struct EmailArray ea = ARRAY_HEAD_INITIALIZER;
     for (int i = 0; i < m->vcount; i++)
     {
       struct Email *e = mutt_get_virt_email(m, i);
-      if (!e)
-        continue;
-      progress_update(progress, i, -1);
-      if (mutt_pattern_exec(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
+      if (e)
+        ARRAY_ADD(&ea, e);
+    }
+
+    bool *matches = mutt_mem_calloc(MAX(ARRAY_SIZE(&ea), 1), sizeof(bool));
+    pattern_exec_emails(SLIST_FIRST(pat), MUTT_MATCH_FULL_ADDRESS, m, &ea,
+                        matches, progress);
+
+    for (int i = 0; i < ARRAY_SIZE(&ea); i++)
+    {
+      struct Email *e = *ARRAY_GET(&ea, i);
+      if (matches[i])
       {
         switch (op)
         {
@@ -398,6 +423,9 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
         }
       }
     }
+
+    FREE(&matches);
+    ARRAY_FREE(&ea);
   }
   progress_free(&progress);
 
@@ -432,6 +460,54 @@ bail:
   return rc;
 }
 
+/**
+ * search_batch - Match the search pattern against the next few Emails
+ * @param m    Mailbox
+ * @param pat  Search pattern
+ * @param cur  Index of the first Email to test
+ * @param incr Direction of the search, 1 or -1
+ * @param wrap True if the search wraps around the ends of the Mailbox
+ *
+ * The results are cached in Email.searched and Email.matched.  Testing the
+ * Emails in a batch allows pattern_exec_emails() to use its worker threads.
+ */
+static void search_batch(struct Mailbox *m, struct Pattern *pat, int cur, int incr, bool wrap)
+{
+  /* Searching bodies is slow, so don't get too far ahead */
+  const size_t batch = pattern_needs_msg(m, pat) ? SEARCH_BATCH_MSG : SEARCH_BATCH;
+
+  struct EmailArray ea = ARRAY_HEAD_INITIALIZER;
+  for (int i = cur, j = 0; (j < m->vcount) && (ARRAY_SIZE(&ea) < batch); j++, i += incr)
+  {
+    if ((i > m->vcount - 1) || (i < 0))
+    {
+      if (!wrap)
+        break;
+      i = (i < 0) ? m->vcount - 1 : 0;
+    }
+
+    struct Email *e = mutt_get_virt_email(m, i);
+    if (!e)
+      break;
+    if (!e->searched)
+      ARRAY_ADD(&ea, e);
+  }
+
+  bool *matches = mutt_mem_calloc(MAX(ARRAY_SIZE(&ea), 1), sizeof(bool));
+  pattern_exec_emails(pat, MUTT_MATCH_FULL_ADDRESS, m, &ea, matches, NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(&ea); i++)
+  {
+    struct Email *e = *ARRAY_GET(&ea, i);
+    /* remember that we've already searched this message */
+    e->searched = true;
+    e->matched = matches[i];
+  }
+
+  FREE(&matches);
+  ARRAY_FREE(&ea);
+}
+
 /**
  * mutt_search_command - Perform a search
  * @param mv   Mailbox view to search through
@@ -555,32 +631,17 @@ int mutt_search_command(struct MailboxView *mv, struct Menu *menu, int cur, int
     if (!e)
       goto done;
 
-    if (e->searched)
-    {
-      /* if we've already evaluated this message, use the cached value */
-      if (e->matched)
-      {
-        mutt_clear_error();
-        if (msg && *msg)
-          mutt_message(msg);
-        rc = i;
-        goto done;
-      }
-    }
-    else
+    /* test this message, and the next few, unless we already know */
+    if (!e->searched)
+      search_batch(m, SLIST_FIRST(SearchPattern), i, incr, c_wrap_search);
+
+    if (e->matched)
     {
-      /* remember that we've already searched this message */
-      e->searched = true;
-      e->matched = mutt_pattern_exec(SLIST_FIRST(SearchPattern),
-                                     MUTT_MATCH_FULL_ADDRESS, m, e, NULL);
-      if (e->matched)
-      {
-        mutt_clear_error();
-        if (msg && *msg)
-          mutt_message(msg);
-        rc = i;
-        goto done;
-      }
+      mutt_clear_error();
+      if (msg && *msg)
+        mutt_message(msg);
+      rc = i;
+      goto done;
     }
 
     if (SigInt)
@@ -24,10 +24,17 @@
 #define MUTT_PATTERN_PRIVATE_H
 
 #include <stdbool.h>
+#include <stdio.h>
 #include "mutt/lib.h"
 #include "lib.h"
 
+struct BodyIndex;
+struct Email;
+struct EmailArray;
+struct Mailbox;
 struct MailboxView;
+struct Message;
+struct Progress;
 
 /**
  * struct PatternEntry - A line in the Pattern Completion menu
@@ -136,6 +143,24 @@ extern const struct PatternFlags Flags[];
 const struct PatternFlags *lookup_op(int op);
 const struct PatternFlags *lookup_tag(char tag);
 bool eval_date_minmax(struct Pattern *pat, const char *s, struct Buffer *err);
+bool pattern_exec(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m, struct Email *e, struct Message *msg, struct PatternCache *cache);
+bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat);
+
+struct PatternProgram *pattern_program_new (struct Pattern *pat);
+void                   pattern_program_free(struct PatternProgram **ptr);
+bool                   pattern_program_exec(const struct PatternProgram *prog, PatternExecFlags flags, struct Mailbox *m, struct Email *e, struct PatternCache *cache);
+struct BodyIndex      *body_index_open          (struct Mailbox *m);
+void                   body_index_close         (struct BodyIndex **ptr);
+bool                   body_index_needed        (const struct Pattern *pat);
+void                   body_index_attach        (struct Pattern *pat, struct BodyIndex *bi);
+bool                   body_index_may_match     (const struct BodyIndexQuery *q, struct Email *e, int op);
+void                   body_index_add           (const struct BodyIndexQuery *q, struct Email *e, FILE *fp, long head_len, long body_len);
+struct BodyIndexQuery *body_index_query_new     (const char *str, bool is_regex, bool ign_case);
+void                   body_index_query_free    (struct BodyIndexQuery **ptr);
+bool                   body_index_text_may_match(const struct BodyIndexQuery *q, const char *text);
+
+void pattern_exec_emails(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m, struct EmailArray *ea, bool *matches, struct Progress *progress);
+
 bool eat_message_range(struct Pattern *pat, PatternCompFlags flags, struct Buffer *s, struct Buffer *err, struct MailboxView *mv);
 
 #endif /* MUTT_PATTERN_PRIVATE_H */
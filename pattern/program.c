@@ -0,0 +1,299 @@
+/**
+ * @file
+ * Flatten a Pattern into a program
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page pattern_program Flatten a Pattern into a program
+ *
+ * The Pattern tree is turned into a flat list of tests.  Each test says which
+ * test to run next, depending on its result.  The AND and OR nodes disappear:
+ * they're encoded in the jumps.
+ *
+ * e.g. `~F (~s foo | ~N)` becomes:
+ *
+ * | # | Test    | Match  | No match |
+ * | - | :------ | :----- | :------- |
+ * | 0 | ~s foo  | MATCH  | NO MATCH |
+ * | 1 | ~N      | MATCH  | 0        |
+ * | 2 | ~F      | 1      | NO MATCH |
+ *
+ * The program starts at test 2.  Within each AND/OR, the cheap tests, e.g.
+ * flags and dates, are run before the expensive ones, e.g. regexes, addresses
+ * and searching the message body.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include "private.h"
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "lib.h"
+#include "mx.h"
+
+#define PROG_MATCH    -1 ///< Program has finished, the Email matches
+#define PROG_NO_MATCH -2 ///< Program has finished, the Email doesn't match
+
+/**
+ * struct PatternTest - One step of a PatternProgram
+ */
+struct PatternTest
+{
+  struct Pattern *pat; ///< Pattern to test, never an AND or OR
+  int on_match;        ///< Next test if it matches, or #PROG_MATCH, #PROG_NO_MATCH
+  int on_no_match;     ///< Next test if it doesn't match
+  bool needs_msg;      ///< Test may need the message to be opened
+};
+ARRAY_HEAD(PatternTestArray, struct PatternTest);
+
+/**
+ * struct PatternCost - A Pattern and the cost of testing it
+ */
+struct PatternCost
+{
+  struct Pattern *pat; ///< Pattern
+  int cost;            ///< Cost, see pattern_cost()
+};
+ARRAY_HEAD(PatternCostArray, struct PatternCost);
+
+/**
+ * struct PatternProgram - A Pattern flattened into a list of tests
+ */
+struct PatternProgram
+{
+  struct PatternTestArray tests; ///< Tests to run
+  int start;                     ///< First test, or #PROG_MATCH, #PROG_NO_MATCH
+};
+
+/**
+ * pattern_cost - Estimate the cost of testing a Pattern
+ * @param pat Pattern
+ * @retval num Cost, higher is slower
+ */
+static int pattern_cost(const struct Pattern *pat)
+{
+  switch (pat->op)
+  {
+    case MUTT_PAT_AND:
+    case MUTT_PAT_OR:
+    {
+      int cost = 0;
+      struct Pattern *np = NULL;
+      SLIST_FOREACH(np, pat->child, entries)
+      {
+        cost = MAX(cost, pattern_cost(np));
+      }
+      return cost;
+    }
+
+    case MUTT_PAT_DATE:
+    case MUTT_PAT_DATE_RECEIVED:
+      return pat->dynamic ? 1 : 0;
+
+    case MUTT_PAT_SUBJECT:
+    case MUTT_PAT_ID:
+    case MUTT_PAT_ID_EXTERNAL:
+    case MUTT_PAT_REFERENCE:
+    case MUTT_PAT_XLABEL:
+    case MUTT_PAT_HORMEL:
+    case MUTT_PAT_DRIVER_TAGS:
+#ifdef USE_NNTP
+    case MUTT_PAT_NEWSGROUPS:
+#endif
+      return 2;
+
+    case MUTT_PAT_FROM:
+    case MUTT_PAT_TO:
+    case MUTT_PAT_CC:
+    case MUTT_PAT_BCC:
+    case MUTT_PAT_SENDER:
+    case MUTT_PAT_ADDRESS:
+    case MUTT_PAT_RECIPIENT:
+    case MUTT_PAT_LIST:
+    case MUTT_PAT_SUBSCRIBED_LIST:
+    case MUTT_PAT_PERSONAL_RECIP:
+    case MUTT_PAT_PERSONAL_FROM:
+      return 3;
+
+    case MUTT_PAT_THREAD:
+    case MUTT_PAT_PARENT:
+    case MUTT_PAT_CHILDREN:
+      return 4;
+
+    case MUTT_PAT_BODY:
+    case MUTT_PAT_HEADER:
+    case MUTT_PAT_WHOLE_MSG:
+    case MUTT_PAT_MIMEATTACH:
+    case MUTT_PAT_MIMETYPE:
+      return 5;
+
+    default:
+      // Flags, numbers and sizes
+      return 0;
+  }
+}
+
+/**
+ * program_add - Add a Pattern to a program
+ * @param prog        Program
+ * @param pat         Pattern to add
+ * @param on_match    Where to go if the Pattern matches
+ * @param on_no_match Where to go if the Pattern doesn't match
+ * @retval num Entry point of the Pattern
+ *
+ * The tests are generated backwards, so that the jump targets are always known.
+ */
+static int program_add(struct PatternProgram *prog, struct Pattern *pat,
+                       int on_match, int on_no_match)
+{
+  if ((pat->op != MUTT_PAT_AND) && (pat->op != MUTT_PAT_OR))
+  {
+    const bool needs_msg = (pat->op == MUTT_PAT_BODY) || (pat->op == MUTT_PAT_HEADER) ||
+                           (pat->op == MUTT_PAT_WHOLE_MSG) ||
+                           (pat->op == MUTT_PAT_MIMEATTACH) ||
+                           (pat->op == MUTT_PAT_MIMETYPE);
+    // Thread patterns run their own program against other Emails
+    if (((pat->op == MUTT_PAT_THREAD) || (pat->op == MUTT_PAT_PARENT) ||
+         (pat->op == MUTT_PAT_CHILDREN)) &&
+        pat->child && !SLIST_FIRST(pat->child)->program)
+    {
+      struct Pattern *first = SLIST_FIRST(pat->child);
+      first->program = pattern_program_new(first);
+    }
+
+    struct PatternTest test = { pat, on_match, on_no_match, needs_msg };
+    ARRAY_ADD(&prog->tests, test);
+    return ARRAY_SIZE(&prog->tests) - 1;
+  }
+
+  if (pat->pat_not)
+  {
+    const int tmp = on_match;
+    on_match = on_no_match;
+    on_no_match = tmp;
+  }
+
+  // Order the children by cost; a stable sort keeps the user's order for ties
+  struct PatternCostArray children = ARRAY_HEAD_INITIALIZER;
+  struct Pattern *np = NULL;
+  SLIST_FOREACH(np, pat->child, entries)
+  {
+    struct PatternCost pc = { np, pattern_cost(np) };
+    size_t i = ARRAY_SIZE(&children);
+    ARRAY_ADD(&children, pc);
+    for (; (i > 0) && (ARRAY_GET(&children, i - 1)->cost > pc.cost); i--)
+    {
+      ARRAY_SET(&children, i, *ARRAY_GET(&children, i - 1));
+    }
+    ARRAY_SET(&children, i, pc);
+  }
+
+  // AND: every child must match; OR: any child may match
+  const bool is_and = (pat->op == MUTT_PAT_AND);
+  int next = is_and ? on_match : on_no_match;
+  for (size_t i = ARRAY_SIZE(&children); i > 0; i--)
+  {
+    struct Pattern *child = ARRAY_GET(&children, i - 1)->pat;
+    if (is_and)
+      next = program_add(prog, child, next, on_no_match);
+    else
+      next = program_add(prog, child, on_match, next);
+  }
+
+  ARRAY_FREE(&children);
+  return next;
+}
+
+/**
+ * pattern_program_new - Flatten a Pattern into a program
+ * @param pat Pattern
+ * @retval ptr New PatternProgram
+ */
+struct PatternProgram *pattern_program_new(struct Pattern *pat)
+{
+  struct PatternProgram *prog = mutt_mem_calloc(1, sizeof(struct PatternProgram));
+  ARRAY_INIT(&prog->tests);
+  prog->start = program_add(prog, pat, PROG_MATCH, PROG_NO_MATCH);
+  return prog;
+}
+
+/**
+ * pattern_program_free - Free a PatternProgram
+ * @param[out] ptr PatternProgram to free
+ */
+void pattern_program_free(struct PatternProgram **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct PatternProgram *prog = *ptr;
+  ARRAY_FREE(&prog->tests);
+  FREE(ptr);
+}
+
+/**
+ * pattern_program_exec - Run a PatternProgram against an Email
+ * @param prog  Program to run
+ * @param flags Flags, e.g. #MUTT_MATCH_FULL_ADDRESS
+ * @param m     Mailbox
+ * @param e     Email
+ * @param cache Cache for common Patterns
+ * @retval true Success, pattern matched
+ * @retval false Pattern did not match
+ *
+ * The message is only opened if a test needs it.
+ */
+bool pattern_program_exec(const struct PatternProgram *prog, PatternExecFlags flags,
+                          struct Mailbox *m, struct Email *e, struct PatternCache *cache)
+{
+  struct Message *msg = NULL;
+
+  int pc = prog->start;
+  while (pc >= 0)
+  {
+    const struct PatternTest *test = ARRAY_GET(&prog->tests, pc);
+
+    // The body index may show that a search can't match, without reading the message
+    if (test->pat->bquery && !body_index_may_match(test->pat->bquery, e, test->pat->op))
+    {
+      pc = test->pat->pat_not ? test->on_match : test->on_no_match;
+      continue;
+    }
+
+    if (test->needs_msg && !msg && m && pattern_needs_msg(m, test->pat))
+    {
+      msg = mx_msg_open(m, e);
+      if (!msg)
+        return false;
+
+      const bool c_thorough_search = cs_subset_bool(NeoMutt->sub, "thorough_search");
+      if (c_thorough_search)
+        flags |= MUTT_MATCH_THOROUGH;
+    }
+
+    if (pattern_exec(test->pat, flags, m, e, msg, cache))
+      pc = test->on_match;
+    else
+      pc = test->on_no_match;
+  }
+
+  mx_msg_close(m, &msg);
+  return (pc == PROG_MATCH);
+}
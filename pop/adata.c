@@ -50,7 +50,7 @@ void pop_adata_free(void **ptr)
   {
     if (adata->conn->close)
       adata->conn->close(adata->conn);
-    FREE(&adata->conn);
+    mutt_socket_free(&adata->conn);
   }
 
   FREE(ptr);
@@ -105,6 +105,21 @@ static int fetch_message(const char *line, void *data)
   return 0;
 }
 
+/**
+ * fetch_buffer - Append line to a Buffer - Implements ::pop_fetch_t - @ingroup pop_fetch_api
+ * @param line String to append
+ * @param data Buffer
+ * @retval 0 Always
+ */
+static int fetch_buffer(const char *line, void *data)
+{
+  struct Buffer *buf = data;
+
+  buf_addstr(buf, line);
+  buf_addch(buf, '\n');
+  return 0;
+}
+
 /**
  * pop_read_header - Read header
  * @param adata POP Account data
@@ -112,20 +127,13 @@ static int fetch_message(const char *line, void *data)
  * @retval  0 Success
  * @retval -1 Connection lost
  * @retval -2 Invalid command or execution error
- * @retval -3 Error writing to tempfile
  */
 static int pop_read_header(struct PopAccountData *adata, struct Email *e)
 {
-  FILE *fp = mutt_file_mkstemp();
-  if (!fp)
-  {
-    mutt_perror(_("Can't create temporary file"));
-    return -3;
-  }
-
   int index = 0;
   size_t length = 0;
   char buf[1024] = { 0 };
+  struct Buffer *hdr = buf_pool_get();
 
   struct PopEmailData *edata = pop_edata_get(e);
 
@@ -136,7 +144,7 @@ static int pop_read_header(struct PopAccountData *adata, struct Email *e)
     sscanf(buf, "+OK %d %zu", &index, &length);
 
     snprintf(buf, sizeof(buf), "TOP %d 0\r\n", edata->refno);
-    rc = pop_fetch_data(adata, buf, NULL, fetch_message, fp);
+    rc = pop_fetch_data(adata, buf, NULL, fetch_buffer, hdr);
 
     if (adata->cmd_top == 2)
     {
@@ -162,16 +170,11 @@ static int pop_read_header(struct PopAccountData *adata, struct Email *e)
   {
     case 0:
     {
-      rewind(fp);
-      e->env = mutt_rfc822_read_header(fp, e, false, false);
-      e->body->length = length - e->body->offset + 1;
-      rewind(fp);
-      while (!feof(fp))
-      {
+      e->env = mutt_rfc822_read_header_mem(buf_string(hdr), buf_len(hdr), e, false, false);
+      /* The server's lines end in CRLF, ours in LF */
+      e->body->length = length - e->body->offset;
+      for (const char *nl = buf_string(hdr); (nl = strchr(nl, '\n')); nl++)
         e->body->length--;
-        if (!fgets(buf, sizeof(buf), fp))
-          break;
-      }
       break;
     }
     case -2:
@@ -179,14 +182,9 @@ static int pop_read_header(struct PopAccountData *adata, struct Email *e)
       mutt_error("%s", adata->err_msg);
       break;
     }
-    case -3:
-    {
-      mutt_error(_("Can't write header to temporary file"));
-      break;
-    }
   }
 
-  mutt_file_fclose(&fp);
+  buf_pool_release(&hdr);
   return rc;
 }
 
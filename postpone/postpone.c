@@ -450,7 +450,7 @@ static int create_tmp_files_for_attachments(FILE *fp_body, struct Buffer *file,
 
         e_new->security |= sec_type;
         b->type = TYPE_TEXT;
-        mutt_str_replace(&b->subtype, "plain");
+        mutt_intern_replace(&b->subtype, "plain");
         if (sec_type & APPLICATION_PGP)
           mutt_param_delete(&b->parameter, "x-action");
       }
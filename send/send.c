@@ -2148,6 +2148,16 @@ int mutt_send_message(SendFlags flags, struct Email *e_templ, const char *tempfi
   if (ea && (ARRAY_SIZE(ea) == 1))
     e_cur = *ARRAY_GET(ea, 0);
 
+  if (ea)
+  {
+    // Replying needs the whole Envelope, e.g. Reply-To, Mail-Followup-To
+    struct Email **ep = NULL;
+    ARRAY_FOREACH(ep, ea)
+    {
+      email_materialize(*ep);
+    }
+  }
+
   int rc = -1;
 
 #ifdef USE_NNTP
@@ -3045,6 +3055,7 @@ bool mutt_send_list_subscribe(struct Mailbox *m, struct Email *e)
     return false;
   }
 
+  email_materialize(e);
   const char *mailto = e->env->list_subscribe;
   if (!mailto)
   {
@@ -3074,6 +3085,7 @@ bool mutt_send_list_unsubscribe(struct Mailbox *m, struct Email *e)
     return false;
   }
 
+  email_materialize(e);
   const char *mailto = e->env->list_unsubscribe;
   if (!mailto)
   {
@@ -174,7 +174,7 @@ bye:
   if ((type != TYPE_OTHER) || (*xtype != '\0'))
   {
     att->type = type;
-    mutt_str_replace(&att->subtype, subtype);
+    mutt_intern_replace(&att->subtype, subtype);
     mutt_str_replace(&att->xtype, xtype);
   }
 
@@ -1126,7 +1126,11 @@ int mutt_write_fcc(const char *path, struct Email *e, const char *msgid, bool po
     fprintf(msg->fp, "Mutt-Fcc: %s\n", fcc);
 
   if ((m_fcc->type == MUTT_MMDF) || (m_fcc->type == MUTT_MBOX))
+  {
+    /* Leave room for the other flags, so they can be changed in place later */
     fprintf(msg->fp, "Status: RO\n");
+    fprintf(msg->fp, "X-Status: %-*s\n", STATUS_PAD_WIDTH, "");
+  }
 
   /* (postponement) if the mail is to be signed or encrypted, save this info */
   if (((WithCrypto & APPLICATION_PGP) != 0) && post && (e->security & APPLICATION_PGP))
@@ -1199,7 +1199,7 @@ int mutt_smtp_send(const struct AddressList *from, const struct AddressList *to,
   } while (false);
 
   mutt_socket_close(adata.conn);
-  FREE(&adata.conn);
+  mutt_socket_free(&adata.conn);
 
   if (rc == SMTP_ERR_READ)
     mutt_error(_("SMTP session failed: read error"));
@@ -29,8 +29,11 @@
  */
 
 #include "config.h"
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "mutt/lib.h"
 #include "address/lib.h"
 #include "config/lib.h"
@@ -48,32 +51,8 @@
 #include "nntp/lib.h"
 #endif
 
-/**
- * struct EmailCompare - Context for compare_email_shim()
- */
-struct EmailCompare
-{
-  enum MailboxType type; ///< Current mailbox type
-  short sort;            ///< Primary sort
-  short sort_aux;        ///< Secondary sort
-};
-
-/**
- * compare_email_shim - qsort_r() comparator to drive mutt_compare_emails
- * @param a   Pointer to first email
- * @param b   Pointer to second email
- * @param arg EmailCompare with needed context
- * @retval <0 a precedes b
- * @retval  0 a identical to b (should not happen in practice)
- * @retval >0 b precedes a
- */
-static int compare_email_shim(const void *a, const void *b, void *arg)
-{
-  const struct Email *ea = *(struct Email const *const *) a;
-  const struct Email *eb = *(struct Email const *const *) b;
-  const struct EmailCompare *cmp = arg;
-  return mutt_compare_emails(ea, eb, cmp->type, cmp->sort, cmp->sort_aux);
-}
+/// Config handle for $reverse_alias
+static struct ConfigHandle HandleReverseAlias = CONFIG_HANDLE("reverse_alias");
 
 /**
  * compare_score - Compare two emails using their scores - Implements ::sort_mail_t - @ingroup sort_mail_api
@@ -143,7 +122,7 @@ const char *mutt_get_name(const struct Address *a)
 
   if (a)
   {
-    const bool c_reverse_alias = cs_subset_bool(NeoMutt->sub, "reverse_alias");
+    const bool c_reverse_alias = ch_bool(NeoMutt->sub, &HandleReverseAlias);
     if (c_reverse_alias && (ali = alias_reverse_lookup(a)) && ali->personal)
       return buf_string(ali->personal);
     if (a->personal)
@@ -350,6 +329,389 @@ int mutt_compare_emails(const struct Email *a, const struct Email *b,
   return rc;
 }
 
+/**
+ * struct SortKey - One precomputed sort key for an Email
+ *
+ * The meaning of the fields depends on the sort method.
+ */
+struct SortKey
+{
+  int64_t num;      ///< Numeric key, e.g. date, size, score
+  double spam;      ///< Numeric part of the spam value
+  const char *str;  ///< Case-folded text, or the raw spam value; NULL if absent
+  const char *rest; ///< Text following the spam value's number
+  size_t off;       ///< Offset of the case-folded text in the string pool
+};
+
+/**
+ * struct SortEntry - An Email with its precomputed sort keys
+ */
+struct SortEntry
+{
+  struct Email *email;   ///< Email being sorted
+  int index;             ///< Copy of Email.index, the final tie-break
+  struct SortKey key[2]; ///< Keys for the primary and secondary sorts
+};
+
+/**
+ * struct SortPlan - How to compare two SortEntry
+ */
+struct SortPlan
+{
+  enum SortType method[2]; ///< Primary and secondary sort methods
+  bool reverse[2];         ///< Reverse the primary and secondary sorts
+  sort_mail_t func[2];     ///< Fallback comparison for methods without a key
+};
+
+/// Maximum length of a from/to sort key, matching compare_from()
+#define SORT_NAME_LEN 127
+
+/**
+ * pool_add_folded - Add a case-folded copy of a string to the pool
+ * @param pool Pool of strings
+ * @param str  String to add
+ * @param len  Maximum number of bytes to copy
+ * @retval num Offset of the string in the pool
+ *
+ * The folding matches strcasecmp(), so a plain strcmp() of two folded strings
+ * gives the same result as mutt_istr_cmp() on the originals.
+ */
+static size_t pool_add_folded(struct Buffer *pool, const char *str, size_t len)
+{
+  size_t off = buf_len(pool);
+  for (; str && *str && (len > 0); str++, len--)
+    buf_addch(pool, (char) tolower((unsigned char) *str));
+  buf_addch(pool, '\0');
+  return off;
+}
+
+/**
+ * sort_key_extract - Compute the sort key for an Email
+ * @param[in]  e      Email
+ * @param[in]  method Sort method, see #SortType
+ * @param[out] key    Key to fill
+ * @param[in]  pool   Pool for case-folded strings
+ *
+ * Case-folded strings are stored as offsets into the pool, because the pool
+ * may be reallocated.  sort_keys_fixup() turns them into pointers.
+ */
+static void sort_key_extract(struct Email *e, enum SortType method,
+                             struct SortKey *key, struct Buffer *pool)
+{
+  memset(key, 0, sizeof(*key));
+  switch (method)
+  {
+    case SORT_DATE:
+      key->num = e->date_sent;
+      break;
+    case SORT_FROM:
+      key->off = pool_add_folded(pool, mutt_get_name(TAILQ_FIRST(&e->env->from)),
+                                 SORT_NAME_LEN);
+      break;
+    case SORT_LABEL:
+      if (e->env && e->env->x_label && *(e->env->x_label))
+        key->off = pool_add_folded(pool, e->env->x_label, SIZE_MAX);
+      else
+        key->off = SIZE_MAX;
+      break;
+    case SORT_ORDER:
+      key->num = e->index;
+      break;
+    case SORT_RECEIVED:
+      key->num = e->received;
+      break;
+    case SORT_SCORE:
+      key->num = e->score;
+      break;
+    case SORT_SIZE:
+      key->num = e->body->length;
+      break;
+    case SORT_SPAM:
+    {
+      if (!e->env || buf_is_empty(&e->env->spam))
+        break;
+      char *rest = NULL;
+      key->str = e->env->spam.data;
+      key->spam = strtod(key->str, &rest);
+      key->rest = rest;
+      break;
+    }
+    case SORT_SUBJECT:
+      key->num = e->date_sent;
+      if (e->env->real_subj)
+        key->off = pool_add_folded(pool, e->env->real_subj, SIZE_MAX);
+      else
+        key->off = SIZE_MAX;
+      break;
+    case SORT_TO:
+      key->off = pool_add_folded(pool, mutt_get_name(TAILQ_FIRST(&e->env->to)),
+                                 SORT_NAME_LEN);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * sort_keys_fixup - Turn the string pool offsets into pointers
+ * @param entries Sort entries
+ * @param num     Number of entries
+ * @param plan    Sort plan
+ * @param pool    Pool of case-folded strings
+ */
+static void sort_keys_fixup(struct SortEntry *entries, size_t num,
+                            const struct SortPlan *plan, struct Buffer *pool)
+{
+  for (int k = 0; k < 2; k++)
+  {
+    switch (plan->method[k])
+    {
+      case SORT_FROM:
+      case SORT_LABEL:
+      case SORT_SUBJECT:
+      case SORT_TO:
+        break;
+      default:
+        continue;
+    }
+
+    for (size_t i = 0; i < num; i++)
+    {
+      struct SortKey *key = &entries[i].key[k];
+      key->str = (key->off == SIZE_MAX) ? NULL : pool->data + key->off;
+    }
+  }
+}
+
+/**
+ * sort_key_cmp - Compare two precomputed sort keys
+ * @param a       First entry
+ * @param b       Second entry
+ * @param plan    Sort plan
+ * @param k       Index of the key to compare, 0 (primary) or 1 (secondary)
+ * @retval <0 a precedes b
+ * @retval  0 a and b are equal for this key
+ * @retval >0 b precedes a
+ *
+ * The results match those of the sort_mail_t functions, e.g. compare_from().
+ */
+static int sort_key_cmp(const struct SortEntry *a, const struct SortEntry *b,
+                        const struct SortPlan *plan, int k)
+{
+  const struct SortKey *ka = &a->key[k];
+  const struct SortKey *kb = &b->key[k];
+  const bool reverse = plan->reverse[k];
+  int rc = 0;
+
+  switch (plan->method[k])
+  {
+    case SORT_DATE:
+    case SORT_ORDER:
+    case SORT_RECEIVED:
+    case SORT_SIZE:
+      rc = mutt_numeric_cmp(ka->num, kb->num);
+      break;
+
+    case SORT_SCORE:
+      rc = mutt_numeric_cmp(kb->num, ka->num); /* note that this is reverse */
+      break;
+
+    case SORT_FROM:
+    case SORT_TO:
+      rc = strcmp(ka->str, kb->str);
+      break;
+
+    case SORT_SUBJECT:
+      if (!ka->str)
+        rc = kb->str ? -1 : mutt_numeric_cmp(ka->num, kb->num);
+      else if (!kb->str)
+        rc = 1;
+      else
+        rc = strcmp(ka->str, kb->str);
+      break;
+
+    case SORT_LABEL:
+      if (ka->str && !kb->str)
+        return reverse ? 1 : -1;
+      if (!ka->str && kb->str)
+        return reverse ? -1 : 1;
+      if (!ka->str && !kb->str)
+        return 0;
+      rc = strcmp(ka->str, kb->str);
+      break;
+
+    case SORT_SPAM:
+      if (ka->str && !kb->str)
+        return reverse ? -1 : 1;
+      if (!ka->str && kb->str)
+        return reverse ? 1 : -1;
+      if (!ka->str && !kb->str)
+        return 0;
+      if ((ka->rest == ka->str) || (kb->rest == kb->str))
+      {
+        rc = mutt_str_cmp(ka->rest, kb->rest);
+        break;
+      }
+      rc = (ka->spam < kb->spam) ? -1 : (ka->spam > kb->spam) ? 1 : 0;
+      if (rc == 0)
+        rc = mutt_str_cmp(ka->rest, kb->rest);
+      break;
+
+    default:
+      if (plan->func[k])
+        return plan->func[k](a->email, b->email, reverse);
+      return 0;
+  }
+
+  return reverse ? -rc : rc;
+}
+
+/**
+ * sort_entry_cmp - Compare two sort entries using both sort methods
+ * @param a    First entry
+ * @param b    Second entry
+ * @param plan Sort plan
+ * @retval <0 a precedes b
+ * @retval  0 a and b are identical (should not happen in practice)
+ * @retval >0 b precedes a
+ *
+ * This is the precomputed equivalent of mutt_compare_emails().
+ */
+static int sort_entry_cmp(const struct SortEntry *a, const struct SortEntry *b,
+                          const struct SortPlan *plan)
+{
+  int rc = sort_key_cmp(a, b, plan, 0);
+  if (rc == 0)
+    rc = sort_key_cmp(a, b, plan, 1);
+  if (rc == 0)
+    rc = mutt_numeric_cmp(a->index, b->index);
+  return rc;
+}
+
+/**
+ * sort_entries - Stable merge sort of an array of SortEntry
+ * @param entries Entries to sort
+ * @param num     Number of entries
+ * @param plan    Sort plan
+ *
+ * Short runs are sorted by insertion, then merged bottom-up, alternating
+ * between the array and a scratch copy.  Each pass reads and writes the
+ * entries sequentially.
+ */
+static void sort_entries(struct SortEntry *entries, size_t num, const struct SortPlan *plan)
+{
+  const size_t run = 16;
+
+  for (size_t lo = 0; lo < num; lo += run)
+  {
+    const size_t hi = MIN(lo + run, num);
+    for (size_t i = lo + 1; i < hi; i++)
+    {
+      struct SortEntry tmp = entries[i];
+      size_t j = i;
+      for (; (j > lo) && (sort_entry_cmp(&entries[j - 1], &tmp, plan) > 0); j--)
+        entries[j] = entries[j - 1];
+      entries[j] = tmp;
+    }
+  }
+
+  if (num <= run)
+    return;
+
+  struct SortEntry *scratch = mutt_mem_malloc(num * sizeof(struct SortEntry));
+  struct SortEntry *src = entries;
+  struct SortEntry *dst = scratch;
+
+  for (size_t width = run; width < num; width *= 2)
+  {
+    for (size_t lo = 0; lo < num; lo += 2 * width)
+    {
+      const size_t mid = MIN(lo + width, num);
+      const size_t hi = MIN(lo + 2 * width, num);
+      size_t i = lo, j = mid, out = lo;
+
+      /* Already in order, e.g. when re-sorting a sorted mailbox */
+      if ((mid < hi) && (sort_entry_cmp(&src[mid - 1], &src[mid], plan) <= 0))
+      {
+        memcpy(&dst[lo], &src[lo], (hi - lo) * sizeof(struct SortEntry));
+        continue;
+      }
+
+      while ((i < mid) && (j < hi))
+      {
+        if (sort_entry_cmp(&src[j], &src[i], plan) < 0)
+          dst[out++] = src[j++];
+        else
+          dst[out++] = src[i++];
+      }
+      if (i < mid)
+        memcpy(&dst[out], &src[i], (mid - i) * sizeof(struct SortEntry));
+      else if (j < hi)
+        memcpy(&dst[out], &src[j], (hi - j) * sizeof(struct SortEntry));
+    }
+
+    struct SortEntry *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != entries)
+    memcpy(entries, src, num * sizeof(struct SortEntry));
+  FREE(&scratch);
+}
+
+/**
+ * sort_emails_by_key - Sort the Emails of a Mailbox using precomputed keys
+ * @param m        Mailbox
+ * @param sort     Primary sort to use (generally $sort)
+ * @param sort_aux Secondary sort (generally $sort_aux)
+ *
+ * The sort keys are extracted once per Email, so expensive keys, such as the
+ * reverse-alias lookup of $sort=from, aren't recomputed for every comparison.
+ * The order is the same as sorting with mutt_compare_emails().
+ */
+static void sort_emails_by_key(struct Mailbox *m, short sort, short sort_aux)
+{
+  const size_t num = m->msg_count;
+  const enum MailboxType type = mx_type(m);
+
+  struct SortPlan plan = { 0 };
+  plan.method[0] = sort & SORT_MASK;
+  plan.method[1] = sort_aux & SORT_MASK;
+  plan.reverse[0] = (sort & SORT_REVERSE) != 0;
+  plan.reverse[1] = (sort_aux & SORT_REVERSE) != 0;
+  for (int k = 0; k < 2; k++)
+  {
+    plan.func[k] = get_sort_func(plan.method[k], type);
+#ifdef USE_NNTP
+    /* News articles are ordered by their article number, so use the function */
+    if ((plan.method[k] == SORT_ORDER) && (type == MUTT_NNTP))
+      plan.method[k] = SORT_MAX;
+#endif
+  }
+
+  struct SortEntry *entries = mutt_mem_malloc(num * sizeof(struct SortEntry));
+  struct Buffer pool = buf_make(0);
+
+  for (size_t i = 0; i < num; i++)
+  {
+    struct Email *e = m->emails[i];
+    entries[i].email = e;
+    entries[i].index = e->index;
+    for (int k = 0; k < 2; k++)
+      sort_key_extract(e, plan.method[k], &entries[i].key[k], &pool);
+  }
+  sort_keys_fixup(entries, num, &plan, &pool);
+
+  sort_entries(entries, num, &plan);
+
+  for (size_t i = 0; i < num; i++)
+    m->emails[i] = entries[i].email;
+
+  buf_dealloc(&pool);
+  FREE(&entries);
+}
+
 /**
  * mutt_sort_headers - Sort emails by their headers
  * @param mv    Mailbox View
@@ -409,12 +771,9 @@ void mutt_sort_headers(struct MailboxView *mv, bool init)
   }
   else
   {
-    struct EmailCompare cmp;
-    cmp.type = mx_type(m);
-    cmp.sort = cs_subset_sort(NeoMutt->sub, "sort");
-    cmp.sort_aux = cs_subset_sort(NeoMutt->sub, "sort_aux");
-    mutt_qsort_r((void *) m->emails, m->msg_count, sizeof(struct Email *),
-                 compare_email_shim, &cmp);
+    const short c_sort = cs_subset_sort(NeoMutt->sub, "sort");
+    const short c_sort_aux = cs_subset_sort(NeoMutt->sub, "sort_aux");
+    sort_emails_by_key(m, c_sort, c_sort_aux);
   }
 
   /* adjust the virtual message numbers */
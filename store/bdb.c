@@ -251,6 +251,31 @@ static int store_bdb_delete_record(StoreHandle *store, const char *key, size_t k
   return sdata->db->del(sdata->db, NULL, &dkey, 0);
 }
 
+/**
+ * store_bdb_begin_batch - Implements StoreOps::begin_batch() - @ingroup store_begin_batch
+ *
+ * The environment is opened without DB_INIT_TXN, so there are no transactions.
+ * Writes already go through the memory pool and are flushed on close.
+ */
+static int store_bdb_begin_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  return 0;
+}
+
+/**
+ * store_bdb_commit_batch - Implements StoreOps::commit_batch() - @ingroup store_commit_batch
+ */
+static int store_bdb_commit_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  return 0;
+}
+
 /**
  * store_bdb_close - Implements StoreOps::close() - @ingroup store_close
  */
@@ -132,6 +132,31 @@ static int store_gdbm_delete_record(StoreHandle *store, const char *key, size_t
   return gdbm_delete(db, dkey);
 }
 
+/**
+ * store_gdbm_begin_batch - Implements StoreOps::begin_batch() - @ingroup store_begin_batch
+ *
+ * GDBM has no transactions.  Writes are applied as they are made and, like the
+ * other backends, not synced to disk, so there's nothing to group.
+ */
+static int store_gdbm_begin_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  return 0;
+}
+
+/**
+ * store_gdbm_commit_batch - Implements StoreOps::commit_batch() - @ingroup store_commit_batch
+ */
+static int store_gdbm_commit_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  return 0;
+}
+
 /**
  * store_gdbm_close - Implements StoreOps::close() - @ingroup store_close
  */
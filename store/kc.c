@@ -129,6 +129,42 @@ static int store_kyotocabinet_delete_record(StoreHandle *store, const char *key,
   return 0;
 }
 
+/**
+ * store_kyotocabinet_begin_batch - Implements StoreOps::begin_batch() - @ingroup store_begin_batch
+ */
+static int store_kyotocabinet_begin_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  KCDB *db = store;
+  if (!kcdbbegintran(db, 0))
+  {
+    int ecode = kcdbecode(db);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
+/**
+ * store_kyotocabinet_commit_batch - Implements StoreOps::commit_batch() - @ingroup store_commit_batch
+ */
+static int store_kyotocabinet_commit_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  KCDB *db = store;
+  if (!kcdbendtran(db, 1))
+  {
+    int ecode = kcdbecode(db);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
 /**
  * store_kyotocabinet_close - Implements StoreOps::close() - @ingroup store_close
  */
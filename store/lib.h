@@ -136,6 +136,33 @@ struct StoreOps
    */
   int (*delete_record)(StoreHandle *store, const char *key, size_t klen);
 
+  /**
+   * @defgroup store_begin_batch begin_batch()
+   * @ingroup store_api
+   *
+   * begin_batch - Start grouping writes into a single transaction
+   * @param[in] store Store retrieved via open()
+   * @retval 0   Success
+   * @retval num Error, a backend-specific error code
+   *
+   * All calls to store() and delete_record() until the matching
+   * commit_batch() may be buffered by the backend and written in one go.
+   * fetch() MUST see the records written inside the batch.
+   * Backends without transactions may treat this as a no-op.
+   */
+  int (*begin_batch)(StoreHandle *store);
+
+  /**
+   * @defgroup store_commit_batch commit_batch()
+   * @ingroup store_api
+   *
+   * commit_batch - Write out the records grouped by begin_batch()
+   * @param[in] store Store retrieved via open()
+   * @retval 0   Success
+   * @retval num Error, a backend-specific error code
+   */
+  int (*commit_batch)(StoreHandle *store);
+
   /**
    * @defgroup store_close close()
    * @ingroup store_api
@@ -167,6 +194,8 @@ bool                   store_is_valid_backend(const char *str);
     .free           = store_##_name##_free,                                    \
     .store          = store_##_name##_store,                                   \
     .delete_record  = store_##_name##_delete_record,                           \
+    .begin_batch    = store_##_name##_begin_batch,                             \
+    .commit_batch   = store_##_name##_commit_batch,                            \
     .close          = store_##_name##_close,                                   \
     .version        = store_##_name##_version,                                 \
   };
@@ -318,6 +318,48 @@ static int store_lmdb_delete_record(StoreHandle *store, const char *key, size_t
   return rc;
 }
 
+/**
+ * store_lmdb_begin_batch - Implements StoreOps::begin_batch() - @ingroup store_begin_batch
+ */
+static int store_lmdb_begin_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LmdbStoreData *sdata = store;
+
+  int rc = lmdb_get_write_txn(sdata);
+  if (rc != MDB_SUCCESS)
+    mutt_debug(LL_DEBUG2, "lmdb_get_write_txn: %s\n", mdb_strerror(rc));
+
+  return rc;
+}
+
+/**
+ * store_lmdb_commit_batch - Implements StoreOps::commit_batch() - @ingroup store_commit_batch
+ */
+static int store_lmdb_commit_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LmdbStoreData *sdata = store;
+
+  if (!sdata->txn || (sdata->txn_mode != TXN_WRITE))
+    return MDB_SUCCESS;
+
+  int rc = mdb_txn_commit(sdata->txn);
+  if (rc != MDB_SUCCESS)
+    mutt_debug(LL_DEBUG2, "mdb_txn_commit: %s\n", mdb_strerror(rc));
+
+  /* The transaction handle is freed, even on failure */
+  sdata->txn_mode = TXN_UNINITIALIZED;
+  sdata->txn = NULL;
+  return rc;
+}
+
 /**
  * store_lmdb_close - Implements StoreOps::close() - @ingroup store_close
  */
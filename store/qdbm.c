@@ -110,6 +110,34 @@ static int store_qdbm_delete_record(StoreHandle *store, const char *key, size_t
   return success ? 0 : dpecode ? dpecode : -1;
 }
 
+/**
+ * store_qdbm_begin_batch - Implements StoreOps::begin_batch() - @ingroup store_begin_batch
+ */
+static int store_qdbm_begin_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  VILLA *db = store;
+  bool success = vltranbegin(db);
+  return success ? 0 : dpecode ? dpecode : -1;
+}
+
+/**
+ * store_qdbm_commit_batch - Implements StoreOps::commit_batch() - @ingroup store_commit_batch
+ */
+static int store_qdbm_commit_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  VILLA *db = store;
+  bool success = vltrancommit(db);
+  return success ? 0 : dpecode ? dpecode : -1;
+}
+
 /**
  * store_qdbm_close - Implements StoreOps::close() - @ingroup store_close
  */
@@ -123,6 +123,42 @@ static int store_tokyocabinet_delete_record(StoreHandle *store, const char *key,
   return 0;
 }
 
+/**
+ * store_tokyocabinet_begin_batch - Implements StoreOps::begin_batch() - @ingroup store_begin_batch
+ */
+static int store_tokyocabinet_begin_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  TCBDB *db = store;
+  if (!tcbdbtranbegin(db))
+  {
+    int ecode = tcbdbecode(db);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
+/**
+ * store_tokyocabinet_commit_batch - Implements StoreOps::commit_batch() - @ingroup store_commit_batch
+ */
+static int store_tokyocabinet_commit_batch(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  TCBDB *db = store;
+  if (!tcbdbtrancommit(db))
+  {
+    int ecode = tcbdbecode(db);
+    return ecode ? ecode : -1;
+  }
+  return 0;
+}
+
 /**
  * store_tokyocabinet_close - Implements StoreOps::close() - @ingroup store_close
  */
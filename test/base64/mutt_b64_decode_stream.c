@@ -0,0 +1,106 @@
+/**
+ * @file
+ * Test code for mutt_b64_decode_stream()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "test_common.h"
+
+struct B64StreamTest
+{
+  const char *encoded; ///< Base64 text
+  const char *clear;   ///< Expected result
+  bool done;           ///< Padding is expected
+};
+
+void test_mutt_b64_decode_stream(void)
+{
+  // size_t mutt_b64_decode_stream(struct Base64Decoder *dec, const char *in, size_t inlen, char *out);
+
+  {
+    char out[16] = { 0 };
+    struct Base64Decoder dec = { 0 };
+    TEST_CHECK(mutt_b64_decode_stream(NULL, "SGVsbG8=", 8, out) == 0);
+    TEST_CHECK(mutt_b64_decode_stream(&dec, NULL, 8, out) == 0);
+    TEST_CHECK(mutt_b64_decode_stream(&dec, "SGVsbG8=", 8, NULL) == 0);
+  }
+
+  static const struct B64StreamTest tests[] = {
+    // clang-format off
+    { "",                         "",                  false },
+    { "SGVsbG8=",                 "Hello",             true  },
+    { "SGVsbA==",                 "Hell",              true  },
+    { "SGVs",                     "Hel",               false },
+    { "SGVsbG8",                  "Hel",               false },
+    { "SGVs\r\nbG8h\r\n",         "Hello!",            false },
+    { " S G V s\tb G 8 h ",       "Hello!",            false },
+    { "SGVsbA==bG8h",             "Hell",              true  },
+    { "SGVsbG8gd29ybGQhIQ==\n",   "Hello world!!",     true  },
+    { "=SGVs",                    "",                  true  },
+    { "\x80SGVs\xff",             "Hel",               false },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    const struct B64StreamTest *t = &tests[i];
+    TEST_CASE(t->encoded);
+    const size_t len = strlen(t->encoded);
+
+    /* Decode the text in one block, then split at every position */
+    for (size_t split = 0; split <= len; split++)
+    {
+      char out[64] = { 0 };
+      struct Base64Decoder dec = { 0 };
+      size_t olen = mutt_b64_decode_stream(&dec, t->encoded, split, out);
+      olen += mutt_b64_decode_stream(&dec, t->encoded + split, len - split, out + olen);
+      out[olen] = '\0';
+      TEST_CHECK_STR_EQ(out, t->clear);
+      TEST_CHECK(dec.done == t->done);
+      TEST_MSG("Split: %zu", split);
+    }
+  }
+
+  {
+    /* A long stream, fed one byte at a time */
+    char clear[256] = { 0 };
+    for (size_t i = 0; i < sizeof(clear); i++)
+      clear[i] = (char) i;
+
+    char encoded[512] = { 0 };
+    mutt_b64_encode(clear, sizeof(clear), encoded, sizeof(encoded));
+
+    char out[sizeof(clear) + 3] = { 0 };
+    struct Base64Decoder dec = { 0 };
+    size_t olen = 0;
+    for (const char *p = encoded; *p; p++)
+      olen += mutt_b64_decode_stream(&dec, p, 1, out + olen);
+
+    TEST_CHECK(olen == sizeof(clear));
+    TEST_CHECK(memcmp(out, clear, sizeof(clear)) == 0);
+    TEST_CHECK(dec.done);
+  }
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * Shared code for the benchmarks
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_BENCH_BENCH_H
+#define TEST_BENCH_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Minimum time to run each benchmark for, in milliseconds
+#define BENCH_MIN_MS 500
+
+uint64_t bench_now_us(void);
+void     bench_report(const char *name, const char *variant, double rate, const char *units);
+
+void bench_decode(void);
+void bench_hash(void);
+
+#endif /* TEST_BENCH_BENCH_H */
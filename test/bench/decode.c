@@ -0,0 +1,490 @@
+/**
+ * @file
+ * Benchmark the base64 and quoted-printable decoders
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * The "new" decoders are the ones in handler.c, called through
+ * mutt_decode_attachment().  The "old" ones are copies of the decoders they
+ * replaced, which read one character, or one short line, at a time.
+ *
+ * Throughput is measured in encoded (input) bytes.
+ */
+
+#include "config.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "bench.h"
+#include "handler.h"
+
+/// Size of the decoded test data
+#define DECODED_SIZE (4 * 1024 * 1024)
+
+#define BUFI_SIZE 1000
+#define BUFO_SIZE 2000
+
+/**
+ * old_convert_to_state - Write decoded text, without conversion
+ * @param cd     Iconv conversion descriptor, unused
+ * @param bufi   Buffer with text to convert
+ * @param l      Length of buffer
+ * @param state  State to write to
+ */
+static void old_convert_to_state(iconv_t cd, char *bufi, size_t *l, struct State *state)
+{
+  if (!bufi)
+    return;
+
+  state_prefix_put(state, bufi, *l);
+  *l = 0;
+}
+
+/**
+ * old_decode_base64 - Decode base64-encoded text, the old way
+ * @param state  State to work with
+ * @param len    Length of text to decode
+ * @param istext Mime part is plain text
+ * @param cd     Iconv conversion descriptor
+ */
+static void old_decode_base64(struct State *state, size_t len, bool istext, iconv_t cd)
+{
+  char buf[5] = { 0 };
+  int ch, i;
+  bool cr = false;
+  char bufi[BUFI_SIZE] = { 0 };
+  size_t l = 0;
+
+  buf[4] = '\0';
+
+  if (istext)
+    state_set_prefix(state);
+
+  while (len > 0)
+  {
+    for (i = 0; (i < 4) && (len > 0); len--)
+    {
+      ch = fgetc(state->fp_in);
+      if (ch == EOF)
+        break;
+      if ((ch >= 0) && (ch < 128) && ((base64val(ch) != -1) || (ch == '=')))
+        buf[i++] = ch;
+    }
+    if (i != 4)
+      break;
+
+    const int c1 = base64val(buf[0]);
+    const int c2 = base64val(buf[1]);
+
+    /* first char */
+    ch = (c1 << 2) | (c2 >> 4);
+
+    if (cr && (ch != '\n'))
+      bufi[l++] = '\r';
+
+    cr = false;
+
+    if (istext && (ch == '\r'))
+      cr = true;
+    else
+      bufi[l++] = ch;
+
+    /* second char */
+    if (buf[2] == '=')
+      break;
+    const int c3 = base64val(buf[2]);
+    ch = ((c2 & 0xf) << 4) | (c3 >> 2);
+
+    if (cr && (ch != '\n'))
+      bufi[l++] = '\r';
+
+    cr = false;
+
+    if (istext && (ch == '\r'))
+      cr = true;
+    else
+      bufi[l++] = ch;
+
+    /* third char */
+    if (buf[3] == '=')
+      break;
+    const int c4 = base64val(buf[3]);
+    ch = ((c3 & 0x3) << 6) | c4;
+
+    if (cr && (ch != '\n'))
+      bufi[l++] = '\r';
+
+    cr = false;
+
+    if (istext && (ch == '\r'))
+      cr = true;
+    else
+      bufi[l++] = ch;
+
+    if ((l + 8) >= sizeof(bufi))
+      old_convert_to_state(cd, bufi, &l, state);
+  }
+
+  if (cr)
+    bufi[l++] = '\r';
+
+  old_convert_to_state(cd, bufi, &l, state);
+  old_convert_to_state(cd, 0, 0, state);
+
+  state_reset_prefix(state);
+}
+
+/**
+ * old_qp_decode_triple - Decode a quoted-printable triplet, the old way
+ * @param s State to work with
+ * @param d Decoded character
+ * @retval 0 Success
+ * @retval -1 Error
+ */
+static int old_qp_decode_triple(char *s, char *d)
+{
+  /* soft line break */
+  if ((s[0] == '=') && (s[1] == '\0'))
+    return 1;
+
+  /* quoted-printable triple */
+  if ((s[0] == '=') && isxdigit((unsigned char) s[1]) && isxdigit((unsigned char) s[2]))
+  {
+    *d = (hexval(s[1]) << 4) | hexval(s[2]);
+    return 0;
+  }
+
+  /* something else */
+  return -1;
+}
+
+/**
+ * old_qp_decode_line - Decode a line of quoted-printable text, the old way
+ * @param dest Buffer for result
+ * @param src  Text to decode
+ * @param l    Bytes written to buffer
+ * @param last Last character of the line
+ */
+static void old_qp_decode_line(char *dest, char *src, size_t *l, int last)
+{
+  char *d = NULL, *s = NULL;
+  char c = 0;
+
+  int kind = -1;
+  bool soft = false;
+
+  for (d = dest, s = src; *s;)
+  {
+    switch ((kind = old_qp_decode_triple(s, &c)))
+    {
+      case 0:
+        *d++ = c;
+        s += 3;
+        break; /* qp triple */
+      case -1:
+        *d++ = *s++;
+        break; /* single character */
+      case 1:
+        soft = true;
+        s++;
+        break; /* soft line break */
+    }
+  }
+
+  if (!soft && (last == '\n'))
+  {
+    if ((kind == 0) && (c == '\r'))
+      *(d - 1) = '\n';
+    else
+      *d++ = '\n';
+  }
+
+  *d = '\0';
+  *l = d - dest;
+}
+
+/**
+ * old_decode_quoted - Decode quoted-printable text, the old way
+ * @param state  State to work with
+ * @param len    Length of text to decode
+ * @param istext Mime part is plain text
+ * @param cd     Iconv conversion descriptor
+ */
+static void old_decode_quoted(struct State *state, long len, bool istext, iconv_t cd)
+{
+  char line[256] = { 0 };
+  char decline[512] = { 0 };
+  size_t l = 0;
+  size_t l3;
+
+  if (istext)
+    state_set_prefix(state);
+
+  while (len > 0)
+  {
+    if (!fgets(line, MIN((ssize_t) sizeof(line), len + 1), state->fp_in))
+      break;
+
+    size_t linelen = strlen(line);
+    len -= linelen;
+
+    const int last = (linelen != 0) ? line[linelen - 1] : 0;
+
+    if (last == '\n')
+    {
+      while ((linelen > 0) && isspace(line[linelen - 1]))
+        linelen--;
+      line[linelen] = '\0';
+    }
+
+    old_qp_decode_line(decline + l, line, &l3, last);
+    l += l3;
+    old_convert_to_state(cd, decline, &l, state);
+  }
+
+  old_convert_to_state(cd, 0, 0, state);
+  state_reset_prefix(state);
+}
+
+/**
+ * make_text - Generate some text with CRLF line endings
+ * @param buf Buffer for the text
+ *
+ * One byte in 64 is 8-bit, so that quoted-printable has something to encode.
+ */
+static void make_text(struct Buffer *buf)
+{
+  static const char *words[] = { "the", "quick", "brown", "fox", "jumps", "over",
+                                 "lazy", "dog", "=", "caf\xc3\xa9", "\t" };
+  uint32_t seed = 1;
+  size_t col = 0;
+  while (buf_len(buf) < DECODED_SIZE)
+  {
+    seed = (seed * 1103515245) + 12345;
+    const char *word = words[(seed >> 16) % mutt_array_size(words)];
+    buf_addstr(buf, word);
+    col += strlen(word) + 1;
+    if (col > 60)
+    {
+      buf_addstr(buf, "\r\n");
+      col = 0;
+    }
+    else
+    {
+      buf_addch(buf, ' ');
+    }
+  }
+}
+
+/**
+ * make_binary - Generate some random bytes
+ * @param buf Buffer for the bytes
+ */
+static void make_binary(struct Buffer *buf)
+{
+  uint32_t seed = 1;
+  buf_alloc(buf, DECODED_SIZE + 1);
+  for (size_t i = 0; i < DECODED_SIZE; i++)
+  {
+    seed = (seed * 1103515245) + 12345;
+    buf->data[i] = (char) (seed >> 16);
+  }
+  buf->dptr = buf->data + DECODED_SIZE;
+}
+
+/**
+ * encode_base64 - Encode some data as base64, in lines of 76 characters
+ * @param fp  File to write to
+ * @param src Data to encode
+ */
+static void encode_base64(FILE *fp, const struct Buffer *src)
+{
+  char out[128] = { 0 };
+  for (size_t off = 0; off < buf_len(src); off += 57)
+  {
+    const size_t n = MIN(57, buf_len(src) - off);
+    mutt_b64_encode(src->data + off, n, out, sizeof(out));
+    fprintf(fp, "%s\n", out);
+  }
+}
+
+/**
+ * encode_qp - Encode some text as quoted-printable
+ * @param fp  File to write to
+ * @param src Text to encode
+ */
+static void encode_qp(FILE *fp, const struct Buffer *src)
+{
+  size_t col = 0;
+  for (size_t i = 0; i < buf_len(src); i++)
+  {
+    const unsigned char c = src->data[i];
+    if ((c == '\r') && (src->data[i + 1] == '\n'))
+    {
+      fputc('\n', fp);
+      col = 0;
+      i++;
+      continue;
+    }
+
+    if (col > 72)
+    {
+      fputs("=\n", fp);
+      col = 0;
+    }
+
+    if ((c == '=') || (c < 32) || (c > 126))
+    {
+      fprintf(fp, "=%02X", c);
+      col += 3;
+    }
+    else
+    {
+      fputc(c, fp);
+      col++;
+    }
+  }
+}
+
+/**
+ * file_equal - Do two files have the same contents?
+ * @param fp1 First file
+ * @param fp2 Second file
+ * @retval true The contents match
+ */
+static bool file_equal(FILE *fp1, FILE *fp2)
+{
+  rewind(fp1);
+  rewind(fp2);
+  int c1, c2;
+  do
+  {
+    c1 = fgetc(fp1);
+    c2 = fgetc(fp2);
+  } while ((c1 == c2) && (c1 != EOF));
+  return c1 == c2;
+}
+
+/**
+ * run_decoder - Time a decoder
+ * @param fp_in  Encoded data
+ * @param fp_out File for the decoded data
+ * @param b      Body describing the data, for the new decoder
+ * @param old    Use the old decoder
+ * @retval num Throughput in MB/s
+ */
+static double run_decoder(FILE *fp_in, FILE *fp_out, struct Body *b, bool old)
+{
+  const bool istext = (b->type == TYPE_TEXT);
+  size_t total = 0;
+  const uint64_t start = bench_now_us();
+  uint64_t now = start;
+
+  do
+  {
+    rewind(fp_in);
+    rewind(fp_out);
+    struct State state = { 0 };
+    state.fp_in = fp_in;
+    state.fp_out = fp_out;
+
+    if (!old)
+      mutt_decode_attachment(b, &state);
+    else if (b->encoding == ENC_BASE64)
+      old_decode_base64(&state, b->length, istext, ICONV_T_INVALID);
+    else
+      old_decode_quoted(&state, b->length, istext, ICONV_T_INVALID);
+
+    fflush(fp_out);
+    total += b->length;
+    now = bench_now_us();
+  } while ((now - start) < (BENCH_MIN_MS * 1000));
+
+  return (double) total / (double) (now - start);
+}
+
+/**
+ * bench_one - Compare the old and new decoders on some data
+ * @param name     Name of the benchmark
+ * @param src      Data to encode
+ * @param encoding Encoding to use, e.g. #ENC_BASE64
+ * @param istext   Treat the data as text
+ */
+static void bench_one(const char *name, const struct Buffer *src,
+                      enum ContentEncoding encoding, bool istext)
+{
+  FILE *fp_in = tmpfile();
+  FILE *fp_new = tmpfile();
+  FILE *fp_old = tmpfile();
+  if (!fp_in || !fp_new || !fp_old)
+  {
+    fprintf(stderr, "%s: can't create temporary files\n", name);
+    goto done;
+  }
+
+  if (encoding == ENC_BASE64)
+    encode_base64(fp_in, src);
+  else
+    encode_qp(fp_in, src);
+  fflush(fp_in);
+
+  struct Body *b = mutt_body_new();
+  b->type = istext ? TYPE_TEXT : TYPE_APPLICATION;
+  b->subtype = mutt_str_dup(istext ? "plain" : "octet-stream");
+  b->disposition = istext ? DISP_INLINE : DISP_ATTACH;
+  b->encoding = encoding;
+  b->offset = 0;
+  b->length = ftell(fp_in);
+
+  bench_report(name, "old", run_decoder(fp_in, fp_old, b, true), "MB/s");
+  bench_report(name, "new", run_decoder(fp_in, fp_new, b, false), "MB/s");
+
+  if (!file_equal(fp_old, fp_new))
+    fprintf(stderr, "%s: the decoders' output differs\n", name);
+
+  mutt_body_free(&b);
+
+done:
+  mutt_file_fclose(&fp_in);
+  mutt_file_fclose(&fp_new);
+  mutt_file_fclose(&fp_old);
+}
+
+/**
+ * bench_decode - Benchmark the base64 and quoted-printable decoders
+ */
+void bench_decode(void)
+{
+  struct Buffer binary = buf_make(0);
+  struct Buffer text = buf_make(0);
+  make_binary(&binary);
+  make_text(&text);
+
+  bench_one("decode base64, binary", &binary, ENC_BASE64, false);
+  bench_one("decode base64, text", &text, ENC_BASE64, true);
+  bench_one("decode quoted-printable", &text, ENC_QUOTED_PRINTABLE, true);
+
+  buf_dealloc(&binary);
+  buf_dealloc(&text);
+}
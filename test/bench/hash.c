@@ -0,0 +1,410 @@
+/**
+ * @file
+ * Benchmark the Hash Table
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * The "new" Hash Table is the one in mutt/hash.c.  The "old" one is a copy of
+ * the chained Hash Table it replaced, which had a fixed number of buckets.
+ *
+ * The keys are like those NeoMutt uses: Message-IDs (`id_hash`), Subjects
+ * with many duplicates (`subj_hash`) and IMAP UIDs (`uid_hash`).  "Grown"
+ * tables are created with 1/10 of the keys they end up holding.
+ *
+ * Throughput is measured in millions of operations per second.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "bench.h"
+
+/// Number of keys in each Hash Table
+#define NUM_KEYS 200000
+
+/// Multiplier for the old string hash function
+#define SOME_PRIME 149711
+
+/**
+ * struct OldHashTable - The old chained Hash Table
+ */
+struct OldHashTable
+{
+  size_t num_elems;                                   ///< Number of buckets
+  bool allow_dups;                                    ///< Duplicate keys are allowed
+  struct HashElem **table;                            ///< Buckets
+  size_t (*gen_hash)(union HashKey key, size_t num);  ///< Generate a hash id
+  int (*cmp_key)(union HashKey a, union HashKey b);   ///< Compare two keys
+};
+
+/**
+ * old_gen_string_hash - Generate a hash from a string, the old way
+ * @param key       Key
+ * @param num_elems Number of buckets
+ * @retval num Bucket
+ */
+static size_t old_gen_string_hash(union HashKey key, size_t num_elems)
+{
+  size_t hash = 0;
+  for (const unsigned char *s = (const unsigned char *) key.strkey; *s != '\0';)
+    hash += ((hash << 7) + *s++);
+  return (hash * SOME_PRIME) % num_elems;
+}
+
+/**
+ * old_cmp_string_key - Compare two string keys, the old way
+ * @param a First key
+ * @param b Second key
+ * @retval num Result, like strcmp()
+ */
+static int old_cmp_string_key(union HashKey a, union HashKey b)
+{
+  return mutt_str_cmp(a.strkey, b.strkey);
+}
+
+/**
+ * old_gen_int_hash - Generate a hash from an integer, the old way
+ * @param key       Key
+ * @param num_elems Number of buckets
+ * @retval num Bucket
+ */
+static size_t old_gen_int_hash(union HashKey key, size_t num_elems)
+{
+  return key.intkey % num_elems;
+}
+
+/**
+ * old_cmp_int_key - Compare two integer keys, the old way
+ * @param a First key
+ * @param b Second key
+ * @retval num Result, like strcmp()
+ */
+static int old_cmp_int_key(union HashKey a, union HashKey b)
+{
+  if (a.intkey == b.intkey)
+    return 0;
+  if (a.intkey < b.intkey)
+    return -1;
+  return 1;
+}
+
+/**
+ * old_hash_new - Create a Hash Table, the old way
+ * @param num_elems  Number of buckets
+ * @param int_keys   The keys are integers
+ * @param allow_dups Duplicate keys are allowed
+ * @retval ptr New Hash Table
+ */
+static struct OldHashTable *old_hash_new(size_t num_elems, bool int_keys, bool allow_dups)
+{
+  struct OldHashTable *table = mutt_mem_calloc(1, sizeof(struct OldHashTable));
+  table->num_elems = MAX(num_elems, 2);
+  table->allow_dups = allow_dups;
+  table->gen_hash = int_keys ? old_gen_int_hash : old_gen_string_hash;
+  table->cmp_key = int_keys ? old_cmp_int_key : old_cmp_string_key;
+  table->table = mutt_mem_calloc(table->num_elems, sizeof(struct HashElem *));
+  return table;
+}
+
+/**
+ * old_hash_insert - Add to a Hash Table, the old way
+ * @param table Hash Table
+ * @param key   Key
+ * @param data  Data
+ */
+static void old_hash_insert(struct OldHashTable *table, union HashKey key, void *data)
+{
+  struct HashElem *he = mutt_mem_calloc(1, sizeof(struct HashElem));
+  const size_t hash = table->gen_hash(key, table->num_elems);
+  he->key = key;
+  he->data = data;
+
+  if (table->allow_dups)
+  {
+    he->next = table->table[hash];
+    table->table[hash] = he;
+    return;
+  }
+
+  struct HashElem *tmp = NULL;
+  struct HashElem *last = NULL;
+  for (tmp = table->table[hash]; tmp; last = tmp, tmp = tmp->next)
+  {
+    const int rc = table->cmp_key(tmp->key, key);
+    if (rc == 0)
+    {
+      FREE(&he);
+      return;
+    }
+    if (rc > 0)
+      break;
+  }
+  if (last)
+    last->next = he;
+  else
+    table->table[hash] = he;
+  he->next = tmp;
+}
+
+/**
+ * old_hash_find - Find in a Hash Table, the old way
+ * @param table Hash Table
+ * @param key   Key
+ * @retval ptr Data
+ */
+static void *old_hash_find(const struct OldHashTable *table, union HashKey key)
+{
+  const size_t hash = table->gen_hash(key, table->num_elems);
+  for (struct HashElem *he = table->table[hash]; he; he = he->next)
+  {
+    if (table->cmp_key(key, he->key) == 0)
+      return he->data;
+  }
+  return NULL;
+}
+
+/**
+ * old_hash_free - Free a Hash Table, the old way
+ * @param ptr Hash Table to free
+ */
+static void old_hash_free(struct OldHashTable **ptr)
+{
+  struct OldHashTable *table = *ptr;
+  for (size_t i = 0; i < table->num_elems; i++)
+  {
+    struct HashElem *he = table->table[i];
+    while (he)
+    {
+      struct HashElem *next = he->next;
+      FREE(&he);
+      he = next;
+    }
+  }
+  FREE(&table->table);
+  FREE(ptr);
+}
+
+/**
+ * struct HashBench - Keys for the benchmarks
+ */
+struct HashBench
+{
+  char *ids[NUM_KEYS];             ///< Message-IDs
+  char *misses[NUM_KEYS];          ///< Message-IDs that aren't in the table
+  char *subjects[NUM_KEYS];        ///< Subjects, each used about ten times
+  unsigned int dense[NUM_KEYS];    ///< Sequential UIDs
+  unsigned int sparse[NUM_KEYS];   ///< Ascending UIDs, with gaps
+};
+
+/**
+ * struct HashCase - One Hash Table benchmark
+ */
+struct HashCase
+{
+  const char *name;          ///< Name of the benchmark
+  const void *keys;          ///< Keys to insert
+  const void *lookups;       ///< Keys to look up, NULL to time the inserts
+  bool int_keys;             ///< The keys are integers
+  bool allow_dups;           ///< Duplicate keys are allowed
+  size_t size;               ///< Initial size of the table
+};
+
+/**
+ * case_key - Get a key of a benchmark
+ * @param hc   Benchmark
+ * @param keys Keys
+ * @param i    Index of the key
+ * @retval obj Key
+ */
+static union HashKey case_key(const struct HashCase *hc, const void *keys, size_t i)
+{
+  union HashKey key = { 0 };
+  if (hc->int_keys)
+    key.intkey = ((const unsigned int *) keys)[i];
+  else
+    key.strkey = ((char *const *) keys)[i];
+  return key;
+}
+
+/**
+ * table_fill - Create a Hash Table and insert all the keys
+ * @param hc  Benchmark
+ * @param old Use the old Hash Table
+ * @retval ptr Hash Table
+ */
+static void *table_fill(const struct HashCase *hc, bool old)
+{
+  if (old)
+  {
+    struct OldHashTable *table = old_hash_new(hc->size, hc->int_keys, hc->allow_dups);
+    for (size_t i = 0; i < NUM_KEYS; i++)
+      old_hash_insert(table, case_key(hc, hc->keys, i), (void *) (i + 1));
+    return table;
+  }
+
+  struct HashTable *table = NULL;
+  if (hc->int_keys)
+  {
+    table = mutt_hash_int_new(hc->size, MUTT_HASH_NO_FLAGS);
+    for (size_t i = 0; i < NUM_KEYS; i++)
+      mutt_hash_int_insert(table, case_key(hc, hc->keys, i).intkey, (void *) (i + 1));
+  }
+  else
+  {
+    table = mutt_hash_new(hc->size, hc->allow_dups ? MUTT_HASH_ALLOW_DUPS : MUTT_HASH_NO_FLAGS);
+    for (size_t i = 0; i < NUM_KEYS; i++)
+      mutt_hash_insert(table, case_key(hc, hc->keys, i).strkey, (void *) (i + 1));
+  }
+  return table;
+}
+
+/**
+ * table_free - Free a Hash Table
+ * @param table Hash Table
+ * @param old   It's the old Hash Table
+ */
+static void table_free(void *table, bool old)
+{
+  if (old)
+  {
+    struct OldHashTable *ot = table;
+    old_hash_free(&ot);
+  }
+  else
+  {
+    struct HashTable *nt = table;
+    mutt_hash_free(&nt);
+  }
+}
+
+/**
+ * table_lookup - Look up all the keys
+ * @param hc    Benchmark
+ * @param table Hash Table
+ * @param old   It's the old Hash Table
+ * @retval num Sum of the data found, to compare the Hash Tables
+ */
+static size_t table_lookup(const struct HashCase *hc, void *table, bool old)
+{
+  size_t sum = 0;
+  for (size_t i = 0; i < NUM_KEYS; i++)
+  {
+    const union HashKey key = case_key(hc, hc->lookups, i);
+    if (old)
+      sum += (size_t) old_hash_find(table, key);
+    else if (hc->int_keys)
+      sum += (size_t) mutt_hash_int_find(table, key.intkey);
+    else
+      sum += (size_t) mutt_hash_find(table, key.strkey);
+  }
+  return sum;
+}
+
+/**
+ * run_case - Time a Hash Table
+ * @param[in]  hc  Benchmark
+ * @param[in]  old Use the old Hash Table
+ * @param[out] sum Sum of the data found
+ * @retval num Throughput in millions of operations per second
+ */
+static double run_case(const struct HashCase *hc, bool old, size_t *sum)
+{
+  void *table = hc->lookups ? table_fill(hc, old) : NULL;
+  size_t total = 0;
+  const uint64_t start = bench_now_us();
+  uint64_t now = start;
+
+  do
+  {
+    if (hc->lookups)
+    {
+      *sum = table_lookup(hc, table, old);
+    }
+    else
+    {
+      table = table_fill(hc, old);
+      table_free(table, old);
+      table = NULL;
+    }
+    total += NUM_KEYS;
+    now = bench_now_us();
+  } while ((now - start) < (BENCH_MIN_MS * 1000));
+
+  if (table)
+    table_free(table, old);
+
+  return (double) total / (double) (now - start);
+}
+
+/**
+ * bench_hash - Benchmark the Hash Table
+ */
+void bench_hash(void)
+{
+  struct HashBench *hb = mutt_mem_calloc(1, sizeof(struct HashBench));
+
+  char buf[128] = { 0 };
+  uint32_t seed = 1;
+  unsigned int uid = 0;
+  for (size_t i = 0; i < NUM_KEYS; i++)
+  {
+    seed = (seed * 1103515245) + 12345;
+    snprintf(buf, sizeof(buf), "<%08x.%zu@mail.example.com>", seed, i);
+    hb->ids[i] = mutt_str_dup(buf);
+    snprintf(buf, sizeof(buf), "<%08x.%zu@news.example.org>", seed, i);
+    hb->misses[i] = mutt_str_dup(buf);
+    snprintf(buf, sizeof(buf), "Re: Meeting notes %zu", (size_t) (seed >> 8) % (NUM_KEYS / 10));
+    hb->subjects[i] = mutt_str_dup(buf);
+    hb->dense[i] = i + 1;
+    uid += 1 + ((seed >> 16) % 8);
+    hb->sparse[i] = uid;
+  }
+
+  const struct HashCase cases[] = {
+    // clang-format off
+    { "hash Message-ID lookups, sized", hb->ids,      hb->ids,    false, false, NUM_KEYS * 2 },
+    { "hash Message-ID lookups, grown", hb->ids,      hb->ids,    false, false, NUM_KEYS / 10 },
+    { "hash Message-ID misses, grown",  hb->ids,      hb->misses, false, false, NUM_KEYS / 10 },
+    { "hash Subject inserts, grown",    hb->subjects, NULL,       false, true,  NUM_KEYS / 10 },
+    { "hash UID lookups, dense",        hb->dense,    hb->dense,  true,  false, 6 * NUM_KEYS / 5 },
+    { "hash UID lookups, sparse",       hb->sparse,   hb->sparse, true,  false, 6 * NUM_KEYS / 5 },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(cases); i++)
+  {
+    size_t sum_old = 0;
+    size_t sum_new = 0;
+    bench_report(cases[i].name, "old", run_case(&cases[i], true, &sum_old), "Mops/s");
+    bench_report(cases[i].name, "new", run_case(&cases[i], false, &sum_new), "Mops/s");
+    if (sum_old != sum_new)
+      fprintf(stderr, "%s: the Hash Tables found different data\n", cases[i].name);
+  }
+
+  for (size_t i = 0; i < NUM_KEYS; i++)
+  {
+    FREE(&hb->ids[i]);
+    FREE(&hb->misses[i]);
+    FREE(&hb->subjects[i]);
+  }
+  FREE(&hb);
+}
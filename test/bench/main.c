@@ -0,0 +1,119 @@
+/**
+ * @file
+ * Benchmark hub
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "bench.h"
+#include "globals.h" // IWYU pragma: keep
+#include "init.h"
+
+bool StartupComplete = true; ///< The benchmarks don't read any config files
+
+/**
+ * struct Benchmark - A benchmark that can be run
+ */
+struct Benchmark
+{
+  const char *name;  ///< Name, used to select the benchmark
+  void (*run)(void); ///< Function to run it
+};
+
+/// All the benchmarks
+static const struct Benchmark Benchmarks[] = {
+  // clang-format off
+  { "decode", bench_decode },
+  { "hash",   bench_hash   },
+  { NULL, NULL },
+  // clang-format on
+};
+
+/**
+ * bench_now_us - Get a monotonic time
+ * @retval num Time in microseconds
+ */
+uint64_t bench_now_us(void)
+{
+  struct timespec ts = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t) ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/**
+ * bench_report - Print the result of a benchmark
+ * @param name    Name of the benchmark
+ * @param variant Which implementation was measured, e.g. "old"
+ * @param rate    Throughput
+ * @param units   Units of the throughput, e.g. "MB/s"
+ */
+void bench_report(const char *name, const char *variant, double rate, const char *units)
+{
+  printf("%-32s %-8s %10.1f %s\n", name, variant, rate, units);
+  fflush(stdout);
+}
+
+/**
+ * main - Run the benchmarks
+ * @param argc Number of command line arguments
+ * @param argv Names of the benchmarks to run; all of them if none
+ * @retval 0 Success
+ * @retval 1 Error
+ */
+int main(int argc, char *argv[])
+{
+  MuttLogger = log_disp_null;
+  struct ConfigSet *cs = cs_new(500);
+  NeoMutt = neomutt_new(cs);
+  init_config(cs);
+  OptNoCurses = true;
+
+  int rc = 0;
+  for (int i = 1; i < argc; i++)
+  {
+    bool found = false;
+    for (const struct Benchmark *b = Benchmarks; b->name; b++)
+      found |= mutt_str_equal(argv[i], b->name);
+    if (!found)
+    {
+      fprintf(stderr, "Unknown benchmark: %s\n", argv[i]);
+      rc = 1;
+    }
+  }
+
+  for (const struct Benchmark *b = Benchmarks; (rc == 0) && b->name; b++)
+  {
+    bool run = (argc < 2);
+    for (int i = 1; i < argc; i++)
+      run |= mutt_str_equal(argv[i], b->name);
+    if (run)
+      b->run();
+  }
+
+  neomutt_free(&NeoMutt);
+  cs_free(&cs);
+  return rc;
+}
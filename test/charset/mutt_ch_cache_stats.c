@@ -0,0 +1,182 @@
+/**
+ * @file
+ * Test code for mutt_ch_cache_stats()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "test_common.h"
+
+void test_mutt_ch_cache_stats(void)
+{
+  // void mutt_ch_cache_stats(struct IconvCacheStats *stats);
+
+  struct IconvCacheStats stats = { 0 };
+
+  {
+    mutt_ch_cache_stats(NULL);
+    TEST_CHECK_(1, "mutt_ch_cache_stats(NULL)");
+  }
+
+  mutt_ch_cache_cleanup();
+
+  {
+    TEST_CASE("Empty");
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.descriptors == 0);
+    TEST_CHECK(stats.hits == 0);
+    TEST_CHECK(stats.misses == 0);
+    TEST_CHECK(stats.evictions == 0);
+    TEST_CHECK(stats.name_hits == 0);
+    TEST_CHECK(stats.name_misses == 0);
+    TEST_CHECK(stats.name_flushes == 0);
+  }
+
+  {
+    TEST_CASE("Lookups");
+    mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.descriptors == 1);
+    TEST_CHECK(stats.hits == 0);
+    TEST_CHECK(stats.misses == 1);
+    TEST_CHECK(stats.name_misses == 1);
+
+    // The same names
+    mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.descriptors == 1);
+    TEST_CHECK(stats.hits == 2);
+    TEST_CHECK(stats.misses == 1);
+    TEST_CHECK(stats.name_hits == 2);
+    TEST_CHECK(stats.name_misses == 1);
+
+    // Different names for the same conversion
+    mutt_ch_iconv_open("UTF-8", "latin1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.descriptors == 1);
+    TEST_CHECK(stats.hits == 3);
+    TEST_CHECK(stats.misses == 1);
+    TEST_CHECK(stats.name_hits == 2);
+    TEST_CHECK(stats.name_misses == 2);
+
+    // A different conversion
+    mutt_ch_iconv_open("utf-8", "iso-8859-2", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.descriptors == 2);
+    TEST_CHECK(stats.hits == 3);
+    TEST_CHECK(stats.misses == 2);
+    TEST_CHECK(stats.evictions == 0);
+    TEST_CHECK(stats.name_flushes == 0);
+
+    // Every lookup is counted once
+    TEST_CHECK((stats.hits + stats.misses) == 5);
+    TEST_CHECK((stats.name_hits + stats.name_misses) == 5);
+  }
+
+  mutt_ch_cache_cleanup();
+
+  {
+    TEST_CASE("Evictions");
+    char name[32] = { 0 };
+    const int count = 200;
+    for (int i = 0; i < count; i++)
+    {
+      snprintf(name, sizeof(name), "x-bogus-%d", i);
+      mutt_ch_iconv_open("utf-8", name, MUTT_ICONV_NO_FLAGS);
+    }
+
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.misses == count);
+    TEST_CHECK(stats.hits == 0);
+    TEST_CHECK(stats.evictions > 0);
+    TEST_CHECK((stats.descriptors + stats.evictions) == count);
+    TEST_MSG("descriptors %d, evictions %ld", stats.descriptors, stats.evictions);
+    // Each eviction forgets the resolved names
+    TEST_CHECK(stats.name_flushes == stats.evictions);
+
+    // The most recent conversion is still cached
+    snprintf(name, sizeof(name), "x-bogus-%d", count - 1);
+    mutt_ch_iconv_open("utf-8", name, MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.hits == 1);
+    TEST_CHECK(stats.misses == count);
+
+    // The oldest conversion was dropped
+    mutt_ch_iconv_open("utf-8", "x-bogus-0", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.hits == 1);
+    TEST_CHECK(stats.misses == (count + 1));
+    TEST_CHECK((stats.descriptors + stats.evictions) == (count + 1));
+  }
+
+  mutt_ch_cache_cleanup();
+
+  {
+    TEST_CASE("Hooks");
+    mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.name_hits == 1);
+    TEST_CHECK(stats.name_flushes == 0);
+
+    // A new hook forgets the resolved names, but keeps the descriptors
+    struct Buffer err = buf_make(256);
+    TEST_CHECK(mutt_ch_lookup_add(MUTT_LOOKUP_CHARSET, "^x-unknown$", "iso-8859-2", &err));
+    buf_dealloc(&err);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.name_flushes == 1);
+    TEST_CHECK(stats.descriptors == 1);
+
+    mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.name_hits == 1);
+    TEST_CHECK(stats.name_misses == 2);
+    TEST_CHECK(stats.hits == 2);
+    TEST_CHECK(stats.misses == 1);
+
+    // Removing the hooks forgets them again
+    mutt_ch_lookup_remove();
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.name_flushes == 2);
+
+    // There's nothing to forget
+    mutt_ch_lookup_remove();
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.name_flushes == 2);
+  }
+
+  {
+    TEST_CASE("Cleanup");
+    mutt_ch_cache_cleanup();
+    mutt_ch_cache_stats(&stats);
+    TEST_CHECK(stats.descriptors == 0);
+    TEST_CHECK(stats.hits == 0);
+    TEST_CHECK(stats.misses == 0);
+    TEST_CHECK(stats.evictions == 0);
+    TEST_CHECK(stats.name_hits == 0);
+    TEST_CHECK(stats.name_misses == 0);
+    TEST_CHECK(stats.name_flushes == 0);
+  }
+}
@@ -24,7 +24,9 @@
 #include "config.h"
 #include "acutest.h"
 #include <stddef.h>
+#include <stdio.h>
 #include "mutt/lib.h"
+#include "test_common.h"
 
 void test_mutt_ch_iconv_open(void)
 {
@@ -37,4 +39,81 @@ void test_mutt_ch_iconv_open(void)
   {
     TEST_CHECK(mutt_ch_iconv_open("apple", NULL, MUTT_ICONV_NO_FLAGS) != NULL);
   }
+
+  {
+    // Different names for the same conversion share a descriptor
+    iconv_t cd1 = mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(iconv_t_valid(cd1));
+    iconv_t cd2 = mutt_ch_iconv_open("UTF-8", "latin1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd2 == cd1);
+    iconv_t cd3 = mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(cd3 == cd1);
+    iconv_t cd4 = mutt_ch_iconv_open("utf-8", "iso-8859-2", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(iconv_t_valid(cd4));
+    TEST_CHECK(cd4 != cd1);
+  }
+
+  {
+    // Changing the charset-hooks changes the cached conversions
+    iconv_t cd = mutt_ch_iconv_open("utf-8", "x-unknown", MUTT_ICONV_HOOK_FROM);
+    TEST_CHECK(!iconv_t_valid(cd));
+
+    struct Buffer err = buf_make(256);
+    TEST_CHECK(mutt_ch_lookup_add(MUTT_LOOKUP_CHARSET, "^x-unknown$", "iso-8859-1", &err));
+    buf_dealloc(&err);
+
+    cd = mutt_ch_iconv_open("utf-8", "x-unknown", MUTT_ICONV_HOOK_FROM);
+    TEST_CHECK(iconv_t_valid(cd));
+    TEST_CHECK(cd == mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS));
+
+    // The hooks only apply to MUTT_ICONV_HOOK_FROM
+    cd = mutt_ch_iconv_open("utf-8", "x-unknown", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(!iconv_t_valid(cd));
+
+    mutt_ch_lookup_remove();
+    cd = mutt_ch_iconv_open("utf-8", "x-unknown", MUTT_ICONV_HOOK_FROM);
+    TEST_CHECK(!iconv_t_valid(cd));
+  }
+
+  {
+    // Changing the hooks doesn't close descriptors that callers may hold
+    iconv_t cd = mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(iconv_t_valid(cd));
+
+    struct Buffer err = buf_make(256);
+    TEST_CHECK(mutt_ch_lookup_add(MUTT_LOOKUP_ICONV, "^x-unknown$", "iso-8859-1", &err));
+    TEST_CHECK(mutt_ch_lookup_add(MUTT_LOOKUP_CHARSET, "^x-other$", "iso-8859-2", &err));
+    buf_dealloc(&err);
+
+    char in[] = "caf\xe9";
+    char out[16] = { 0 };
+    const char *ib = in;
+    size_t ibl = sizeof(in) - 1;
+    char *ob = out;
+    size_t obl = sizeof(out);
+    TEST_CHECK(iconv(cd, (ICONV_CONST char **) &ib, &ibl, &ob, &obl) == 0);
+    TEST_CHECK_STR_EQ(out, "caf\xc3\xa9");
+
+    // An iconv-hook picks the descriptor for the name that it gives iconv_open()
+    TEST_CHECK(mutt_ch_iconv_open("utf-8", "x-unknown", MUTT_ICONV_NO_FLAGS) == cd);
+    TEST_CHECK(mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS) == cd);
+
+    mutt_ch_lookup_remove();
+    TEST_CHECK(mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS) == cd);
+    TEST_CHECK(!iconv_t_valid(mutt_ch_iconv_open("utf-8", "x-unknown", MUTT_ICONV_NO_FLAGS)));
+  }
+
+  {
+    // Fill the cache beyond its capacity
+    char name[32] = { 0 };
+    for (int i = 0; i < 300; i++)
+    {
+      snprintf(name, sizeof(name), "x-bogus-%d", i);
+      TEST_CHECK(!iconv_t_valid(mutt_ch_iconv_open("utf-8", name, MUTT_ICONV_NO_FLAGS)));
+    }
+    iconv_t cd = mutt_ch_iconv_open("utf-8", "iso-8859-1", MUTT_ICONV_NO_FLAGS);
+    TEST_CHECK(iconv_t_valid(cd));
+  }
+
+  mutt_ch_cache_cleanup();
 }
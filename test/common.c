@@ -42,6 +42,9 @@ char *HomeDir = NULL;
 int SigInt = 0;
 int SigWinch = 0;
 char *ShortHostname = "example";
+char *Username = NULL;
+/// Mailbox returned by get_current_mailbox()
+struct Mailbox *TestCurrentMailbox = NULL;
 
 #define TEST_DIR "NEOMUTT_TEST_DIR"
 
@@ -162,6 +165,7 @@ done:
 void test_fini(void)
 {
   config_cache_cleanup();
+  config_handle_cleanup();
   test_neomutt_destroy();
   buf_pool_cleanup();
 }
@@ -183,7 +187,7 @@ enum QuadOption mutt_yesorno(const char *msg, enum QuadOption def)
 
 struct Mailbox *get_current_mailbox(void)
 {
-  return NULL;
+  return TestCurrentMailbox;
 }
 
 struct MailboxView *get_current_mailbox_view(void)
@@ -121,12 +121,16 @@ static void one_test(const struct ComprOps *compr_ops, short level, size_t size)
   void *copy = mutt_mem_malloc(clen);
   memcpy(copy, cdata, clen);
 
-  void *ddata = compr_ops->decompress(compr_handle, copy, clen);
+  size_t dlen = 0;
+  void *ddata = compr_ops->decompress(compr_handle, copy, clen, &dlen);
   FREE(&copy);
 
   if (!TEST_CHECK(ddata != NULL))
     return;
 
+  if (!TEST_CHECK(dlen == size))
+    return;
+
   if (!TEST_CHECK(memcmp(compress_test_data, ddata, size) == 0))
     return;
 
@@ -35,7 +35,7 @@ void test_compress_zlib(void)
 {
   // ComprHandle *open(short level);
   // void *compress(ComprHandle *handle, const char *data, size_t dlen, size_t *clen);
-  // void *decompress(ComprHandle *handle, const char *cbuf, size_t clen);
+  // void *decompress(ComprHandle *handle, const char *cbuf, size_t clen, size_t *dlen);
   // void close(ComprHandle **ptr);
 
   const struct ComprOps *compr_ops = compress_get_ops("zlib");
@@ -45,7 +45,7 @@ void test_compress_zlib(void)
   {
     // Degenerate tests
     TEST_CHECK(compr_ops->compress(NULL, NULL, 0, NULL) == NULL);
-    TEST_CHECK(compr_ops->decompress(NULL, NULL, 0) == NULL);
+    TEST_CHECK(compr_ops->decompress(NULL, NULL, 0, NULL) == NULL);
     ComprHandle *compr_handle = NULL;
     compr_ops->close(NULL);
     TEST_CHECK_(1, "compr_ops->close(NULL)");
@@ -74,18 +74,20 @@ void test_compress_zlib(void)
     ComprHandle *compr_handle = compr_ops->open(MIN_COMP_LEVEL);
     TEST_CHECK(compr_handle != NULL);
 
+    size_t dlen = 0;
+
     const char zeroes[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
 
-    void *result = compr_ops->decompress(compr_handle, zeroes, 0);
+    void *result = compr_ops->decompress(compr_handle, zeroes, 0, &dlen);
     TEST_CHECK(result == NULL);
 
-    result = compr_ops->decompress(compr_handle, zeroes, sizeof(zeroes));
+    result = compr_ops->decompress(compr_handle, zeroes, sizeof(zeroes), &dlen);
     TEST_CHECK(result == NULL);
 
     const char ones[] = { 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
                           0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01 };
-    result = compr_ops->decompress(compr_handle, ones, sizeof(ones));
+    result = compr_ops->decompress(compr_handle, ones, sizeof(ones), &dlen);
     TEST_CHECK(result == NULL);
 
     compr_ops->close(&compr_handle);
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * Test code for config handles
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "common.h" // IWYU pragma: keep
+#include "test_common.h"
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",  DT_BOOL,   false,    0, NULL, },
+  { "Banana", DT_NUMBER, 42,       0, NULL, },
+  { "Cherry", DT_STRING, IP "abc", 0, NULL, },
+  { NULL },
+};
+// clang-format on
+
+static struct ConfigHandle HandleApple = CONFIG_HANDLE("Apple");
+static struct ConfigHandle HandleBanana = CONFIG_HANDLE("Banana");
+static struct ConfigHandle HandleCherry = CONFIG_HANDLE("Cherry");
+
+void test_config_handle(void)
+{
+  log_line(__func__);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+  struct ConfigSubset *sub = NeoMutt->sub;
+
+  // Resolve the handles, then read the current values
+  {
+    TEST_CHECK(ch_bool(sub, &HandleApple) == false);
+    TEST_CHECK(HandleApple.he != NULL);
+    TEST_CHECK(ch_number(sub, &HandleBanana) == 42);
+    TEST_CHECK_STR_EQ(ch_string(sub, &HandleCherry), "abc");
+
+    cs_subset_str_native_set(sub, "Apple", true, NULL);
+    cs_subset_str_native_set(sub, "Banana", 7, NULL);
+    cs_subset_str_string_set(sub, "Cherry", "xyz", NULL);
+
+    TEST_CHECK(ch_bool(sub, &HandleApple) == true);
+    TEST_CHECK(ch_number(sub, &HandleBanana) == 7);
+    TEST_CHECK_STR_EQ(ch_string(sub, &HandleCherry), "xyz");
+  }
+
+  // A handle follows the Subset it's read from
+  {
+    struct ConfigSubset *sub_a = cs_subset_new("account", sub, NeoMutt->notify);
+    sub_a->scope = SET_SCOPE_ACCOUNT;
+
+    TEST_CHECK(ch_bool(sub_a, &HandleApple) == true);
+    TEST_CHECK(HandleApple.sub == sub_a);
+
+    cs_subset_str_native_set(sub_a, "Apple", false, NULL);
+    TEST_CHECK(ch_bool(sub_a, &HandleApple) == false);
+    TEST_CHECK(ch_bool(sub, &HandleApple) == true);
+    TEST_CHECK(ch_bool(sub_a, &HandleApple) == false);
+
+    // Freeing the Subset deletes its config items, resetting the handles
+    cs_subset_free(&sub_a);
+    TEST_CHECK(HandleApple.he == NULL);
+    TEST_CHECK(HandleBanana.he == NULL);
+    TEST_CHECK(ch_bool(sub, &HandleApple) == true);
+  }
+
+  config_handle_cleanup();
+  TEST_CHECK(HandleApple.he == NULL);
+  TEST_CHECK(!HandleApple.listed);
+
+  log_line(__func__);
+}
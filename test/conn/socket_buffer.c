@@ -0,0 +1,393 @@
+/**
+ * @file
+ * Test code for reading from a Connection's buffer
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "conn/lib.h"
+#include "test_common.h"
+
+/// Size of the Connection's buffer, `$socket_buffer_size`
+#define TEST_BUFFER_SIZE 1024
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "socket_buffer_size", DT_LONG, TEST_BUFFER_SIZE, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * struct Script - Data that a fake Connection will return
+ *
+ * Each call to read() returns, at most, the next chunk.  Once the chunks have
+ * run out, the Connection returns EOF.
+ */
+struct Script
+{
+  const char **chunks; ///< Data to return, NULL-terminated
+  size_t chunk;        ///< Index of the current chunk
+  size_t offset;       ///< Offset into the current chunk
+  int reads;           ///< Number of calls to read()
+};
+
+/**
+ * script_read - Read from a scripted Connection - Implements Connection::read() - @ingroup connection_read
+ */
+static int script_read(struct Connection *conn, char *buf, size_t count)
+{
+  struct Script *script = conn->sockdata;
+  script->reads++;
+
+  const char *chunk = script->chunks[script->chunk];
+  if (!chunk)
+    return 0;
+
+  size_t len = strlen(chunk) - script->offset;
+  if (len > count)
+    len = count;
+
+  memcpy(buf, chunk + script->offset, len);
+  script->offset += len;
+  if (chunk[script->offset] == '\0')
+  {
+    script->chunk++;
+    script->offset = 0;
+  }
+  return len;
+}
+
+/**
+ * script_close - Close a scripted Connection - Implements Connection::close() - @ingroup connection_close
+ */
+static int script_close(struct Connection *conn)
+{
+  return 0;
+}
+
+/**
+ * script_open - Set up a scripted Connection
+ * @param conn   Connection to set up
+ * @param script Data to return
+ * @param chunks Chunks of data, NULL-terminated
+ */
+static void script_open(struct Connection *conn, struct Script *script, const char **chunks)
+{
+  memset(conn, 0, sizeof(*conn));
+  memset(script, 0, sizeof(*script));
+  script->chunks = chunks;
+  conn->sockdata = script;
+  conn->read = script_read;
+  conn->close = script_close;
+  conn->fd = 99;
+}
+
+/**
+ * script_close_conn - Free a scripted Connection's buffer
+ * @param conn Connection
+ */
+static void script_close_conn(struct Connection *conn)
+{
+  FREE(&conn->inbuf);
+}
+
+/**
+ * old_buffer_readln - Read a line, like mutt_socket_buffer_readln_d() used to
+ * @param buf  Buffer to store the line
+ * @param conn Connection to a server
+ * @retval  0 Success
+ * @retval -1 Error
+ *
+ * This is the byte-by-byte implementation, before the Connection's buffer
+ * was searched for the end of the line.
+ */
+static int old_buffer_readln(struct Buffer *buf, struct Connection *conn)
+{
+  char ch;
+  bool has_cr = false;
+
+  buf_reset(buf);
+
+  while (true)
+  {
+    if (mutt_socket_readchar(conn, &ch) != 1)
+      return -1;
+
+    if (ch == '\n')
+      break;
+
+    if (has_cr)
+    {
+      buf_addch(buf, '\r');
+      has_cr = false;
+    }
+
+    if (ch == '\r')
+      has_cr = true;
+    else
+      buf_addch(buf, ch);
+  }
+
+  return 0;
+}
+
+/**
+ * compare_readln - Compare mutt_socket_buffer_readln_d() with the old version
+ * @param chunks Chunks of data, NULL-terminated
+ */
+static void compare_readln(const char **chunks)
+{
+  struct Connection conn_old = { 0 };
+  struct Connection conn_new = { 0 };
+  struct Script script_old = { 0 };
+  struct Script script_new = { 0 };
+  script_open(&conn_old, &script_old, chunks);
+  script_open(&conn_new, &script_new, chunks);
+
+  struct Buffer *buf_old = buf_pool_get();
+  struct Buffer *buf_new = buf_pool_get();
+
+  for (int i = 0; i < 100; i++)
+  {
+    const int rc_old = old_buffer_readln(buf_old, &conn_old);
+    const int rc_new = mutt_socket_buffer_readln_d(buf_new, &conn_new, LL_DEBUG5);
+    TEST_CHECK(rc_new == rc_old);
+    TEST_MSG("line %d: Expected %d, Got %d", i, rc_old, rc_new);
+    TEST_CHECK(buf_len(buf_new) == buf_len(buf_old));
+    TEST_CHECK(memcmp(buf_string(buf_new), buf_string(buf_old), buf_len(buf_old)) == 0);
+    TEST_MSG("line %d: Expected '%s', Got '%s'", i, buf_string(buf_old), buf_string(buf_new));
+    if (rc_old < 0)
+      break;
+  }
+
+  buf_pool_release(&buf_old);
+  buf_pool_release(&buf_new);
+  script_close_conn(&conn_old);
+  script_close_conn(&conn_new);
+}
+
+void test_socket_buffer(void)
+{
+  // int   mutt_socket_buffer_readln_d(struct Buffer *buf, struct Connection *conn, int dbg);
+  // int   mutt_socket_read_buffered  (struct Connection *conn, char *buf, size_t len);
+  // char *mutt_socket_readln_borrow  (struct Connection *conn, size_t *len, int dbg);
+  // int   mutt_socket_readln_d       (char *buf, size_t buflen, struct Connection *conn, int dbg);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  // Don't report the end of each script as an error
+  log_dispatcher_t old_logger = MuttLogger;
+  MuttLogger = log_disp_null;
+
+  struct Connection conn = { 0 };
+  struct Script script = { 0 };
+  char line[4096] = { 0 };
+  size_t len = 0;
+
+  {
+    TEST_CASE("Line split across reads");
+    static const char *chunks[] = { "hel", "lo\r", "\nwor", "ld\n", NULL };
+    script_open(&conn, &script, chunks);
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) == 6);
+    TEST_CHECK_STR_EQ(line, "hello");
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) == 6);
+    TEST_CHECK_STR_EQ(line, "world");
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) == -1);
+    TEST_CHECK(conn.fd == -1);
+    script_close_conn(&conn);
+
+    script_open(&conn, &script, chunks);
+    const char *borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK_STR_EQ(borrowed, "hello");
+    TEST_CHECK(len == 5);
+    borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK_STR_EQ(borrowed, "world");
+    TEST_CHECK(len == 5);
+    TEST_CHECK(mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5) == NULL);
+    script_close_conn(&conn);
+  }
+
+  {
+    TEST_CASE("CRLF and bare LF");
+    static const char *chunks[] = { "crlf\r\nlf\n\r\n\ncr\rin\r\nthe middle\r\r\n", NULL };
+    static const char *expected[] = { "crlf", "lf", "", "", "cr\rin", "the middle\r", NULL };
+
+    script_open(&conn, &script, chunks);
+    for (int i = 0; expected[i]; i++)
+    {
+      TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) > 0);
+      TEST_CHECK_STR_EQ(line, expected[i]);
+    }
+    script_close_conn(&conn);
+
+    script_open(&conn, &script, chunks);
+    for (int i = 0; expected[i]; i++)
+    {
+      const char *borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+      TEST_CHECK_STR_EQ(borrowed, expected[i]);
+      TEST_CHECK(len == strlen(expected[i]));
+    }
+    script_close_conn(&conn);
+  }
+
+  {
+    TEST_CASE("Line longer than the buffer");
+    char *long_line = mutt_mem_malloc((3 * TEST_BUFFER_SIZE) + 8);
+    memset(long_line, 'x', 3 * TEST_BUFFER_SIZE);
+    strcpy(long_line + (3 * TEST_BUFFER_SIZE), "\r\nend\n");
+    const char *chunks[] = { long_line, NULL };
+
+    // The borrowed line stays in the buffer, which grows to fit it
+    script_open(&conn, &script, chunks);
+    const char *borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK(borrowed != NULL);
+    TEST_CHECK(len == (3 * TEST_BUFFER_SIZE));
+    TEST_CHECK(conn.inbuf_size >= (3 * TEST_BUFFER_SIZE));
+    borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK_STR_EQ(borrowed, "end");
+    script_close_conn(&conn);
+
+    // A copied line is read in pieces, the buffer stays the same size
+    script_open(&conn, &script, chunks);
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) ==
+               ((3 * TEST_BUFFER_SIZE) + 1));
+    TEST_CHECK(strlen(line) == (3 * TEST_BUFFER_SIZE));
+    TEST_CHECK(conn.inbuf_size == TEST_BUFFER_SIZE);
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) == 4);
+    TEST_CHECK_STR_EQ(line, "end");
+    script_close_conn(&conn);
+
+    // A line that doesn't fit in the caller's buffer is split
+    script_open(&conn, &script, chunks);
+    char small[100] = { 0 };
+    TEST_CHECK(mutt_socket_readln_d(small, sizeof(small), &conn, LL_DEBUG5) == sizeof(small));
+    TEST_CHECK(strlen(small) == (sizeof(small) - 1));
+    script_close_conn(&conn);
+
+    struct Buffer *buf = buf_pool_get();
+    script_open(&conn, &script, chunks);
+    TEST_CHECK(mutt_socket_buffer_readln_d(buf, &conn, LL_DEBUG5) == 0);
+    TEST_CHECK(buf_len(buf) == (3 * TEST_BUFFER_SIZE));
+    TEST_CHECK(conn.inbuf_size == TEST_BUFFER_SIZE);
+    TEST_CHECK(mutt_socket_buffer_readln_d(buf, &conn, LL_DEBUG5) == 0);
+    TEST_CHECK_STR_EQ(buf_string(buf), "end");
+    script_close_conn(&conn);
+    buf_pool_release(&buf);
+
+    FREE(&long_line);
+  }
+
+  {
+    TEST_CASE("Partial consume");
+    // The unread part of the buffer is moved to the front before a refill
+    static const char *chunks[] = { "first\nsec", "ond\nthird\n", NULL };
+    script_open(&conn, &script, chunks);
+    const char *borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK_STR_EQ(borrowed, "first");
+    TEST_CHECK(conn.bufpos == 6);
+    TEST_CHECK(conn.available == 9);
+
+    borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK_STR_EQ(borrowed, "second");
+    TEST_CHECK(borrowed == conn.inbuf);
+    TEST_CHECK(script.reads == 2);
+
+    borrowed = mutt_socket_readln_borrow(&conn, &len, LL_DEBUG5);
+    TEST_CHECK_STR_EQ(borrowed, "third");
+    TEST_CHECK(script.reads == 2);
+    TEST_CHECK(conn.bufpos == conn.available);
+    script_close_conn(&conn);
+  }
+
+  {
+    TEST_CASE("Buffered and direct reads");
+    // An IMAP literal: a line, a block of data, then the rest of the line
+    static const char *chunks[] = { "* 1 FETCH (BODY[] {26}\r\nabcdefghij",
+                                    "klmnopqrstuvwxyz)\r\n", "a1 OK\r\n", NULL };
+    script_open(&conn, &script, chunks);
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) > 0);
+    TEST_CHECK_STR_EQ(line, "* 1 FETCH (BODY[] {26}");
+
+    // The data that's already buffered comes first
+    char data[64] = { 0 };
+    TEST_CHECK(mutt_socket_read_buffered(&conn, data, 26) == 10);
+    TEST_CHECK(script.reads == 1);
+    // then the buffer is refilled from the socket
+    TEST_CHECK(mutt_socket_read_buffered(&conn, data + 10, 16) == 16);
+    TEST_CHECK(script.reads == 2);
+    TEST_CHECK_STR_EQ(data, "abcdefghijklmnopqrstuvwxyz");
+
+    // The rest of the line is still in the buffer
+    TEST_CHECK(mutt_socket_poll(&conn, 0) == 3);
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) > 0);
+    TEST_CHECK_STR_EQ(line, ")");
+    TEST_CHECK(mutt_socket_readln_d(line, sizeof(line), &conn, LL_DEBUG5) > 0);
+    TEST_CHECK_STR_EQ(line, "a1 OK");
+    TEST_CHECK(mutt_socket_read_buffered(&conn, data, sizeof(data)) == -1);
+    script_close_conn(&conn);
+
+    // Single characters and blocks can be mixed, too
+    script_open(&conn, &script, chunks);
+    char ch = 0;
+    TEST_CHECK(mutt_socket_readchar(&conn, &ch) == 1);
+    TEST_CHECK(ch == '*');
+    TEST_CHECK(mutt_socket_read_buffered(&conn, data, 3) == 3);
+    TEST_CHECK(memcmp(data, " 1 ", 3) == 0);
+    TEST_CHECK(mutt_socket_readchar(&conn, &ch) == 1);
+    TEST_CHECK(ch == 'F');
+    script_close_conn(&conn);
+  }
+
+  {
+    TEST_CASE("mutt_socket_buffer_readln_d() is unchanged");
+    static const char *split[] = { "one\r", "\ntw", "o\n\r", "\n", "\r\r\n", "x\ry\n", NULL };
+    static const char *whole[] = { "one\r\ntwo\n\r\n\r\r\nx\ry\n", NULL };
+    static const char *partial[] = { "one\r\npart", NULL };
+    static const char *partial_cr[] = { "one\r\npartial\r", NULL };
+    static const char *empty[] = { NULL };
+
+    compare_readln(split);
+    compare_readln(whole);
+    compare_readln(partial);
+    compare_readln(partial_cr);
+    compare_readln(empty);
+
+    // One byte per read
+    const char *text = "one\r\ntwo\n\r\n\r\r\nx\ry\npartial\r";
+    const char *bytes[64] = { 0 };
+    char pieces[64][2] = { { 0 } };
+    for (size_t i = 0; text[i]; i++)
+    {
+      pieces[i][0] = text[i];
+      bytes[i] = pieces[i];
+    }
+    compare_readln(bytes);
+  }
+
+  MuttLogger = old_logger;
+}
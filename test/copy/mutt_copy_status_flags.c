@@ -0,0 +1,82 @@
+/**
+ * @file
+ * Test code for mutt_copy_status_flags()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "copy.h"
+#include "test_common.h"
+
+/**
+ * struct StatusTest - Flags of an Email and the headers they need
+ */
+struct StatusTest
+{
+  bool read;           ///< Email.read
+  bool old;            ///< Email.old
+  bool replied;        ///< Email.replied
+  bool flagged;        ///< Email.flagged
+  const char *status;  ///< Expected value of Status:
+  const char *xstatus; ///< Expected value of X-Status:
+};
+
+void test_mutt_copy_status_flags(void)
+{
+  // void mutt_copy_status_flags(const struct Email *e, char *status, char *xstatus);
+
+  static const struct StatusTest tests[] = {
+    // clang-format off
+    { false, false, false, false, "",   ""   },
+    { true,  false, false, false, "RO", ""   },
+    { false, true,  false, false, "O",  ""   },
+    { true,  true,  false, false, "RO", ""   },
+    { false, false, true,  false, "",   "A"  },
+    { false, false, false, true,  "",   "F"  },
+    { false, false, true,  true,  "",   "AF" },
+    { true,  true,  true,  true,  "RO", "AF" },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    const struct StatusTest *t = &tests[i];
+    struct Email *e = email_new();
+    e->read = t->read;
+    e->old = t->old;
+    e->replied = t->replied;
+    e->flagged = t->flagged;
+
+    char status[STATUS_FLAGS_SIZE] = { 0 };
+    char xstatus[STATUS_FLAGS_SIZE] = { 0 };
+    memset(status, 'x', sizeof(status));
+    memset(xstatus, 'x', sizeof(xstatus));
+    mutt_copy_status_flags(e, status, xstatus);
+    TEST_CASE_("%zu", i);
+    TEST_CHECK_STR_EQ(status, t->status);
+    TEST_CHECK_STR_EQ(xstatus, t->xstatus);
+
+    email_free(&e);
+  }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file
+ * Test code for email_materialize()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "test_common.h"
+
+static void test_lazy_load(struct Email *e)
+{
+  e->env->organization = mutt_str_dup(e->lazy_data);
+  FREE(&e->lazy_data);
+}
+
+void test_email_materialize(void)
+{
+  // void email_materialize(struct Email *e);
+
+  {
+    email_materialize(NULL);
+    TEST_CHECK_(1, "email_materialize(NULL)");
+  }
+
+  {
+    struct Email *e = email_new();
+    email_materialize(e);
+    TEST_CHECK(e->lazy_data == NULL);
+    email_free(&e);
+  }
+
+  {
+    struct Email *e = email_new();
+    e->env = mutt_env_new();
+    e->lazy_data = mutt_str_dup("Apple");
+    e->lazy_load = test_lazy_load;
+
+    email_materialize(e);
+    TEST_CHECK(e->lazy_data == NULL);
+    TEST_CHECK_STR_EQ(e->env->organization, "Apple");
+
+    // A second call does nothing
+    email_materialize(e);
+    TEST_CHECK_STR_EQ(e->env->organization, "Apple");
+    email_free(&e);
+  }
+
+  {
+    // Unused lazy data is freed with the Email
+    struct Email *e = email_new();
+    e->lazy_data = mutt_str_dup("Apple");
+    e->lazy_load = test_lazy_load;
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+  }
+}
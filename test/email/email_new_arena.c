@@ -0,0 +1,114 @@
+/**
+ * @file
+ * Test code for email_new_arena()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+
+void test_email_new_arena(void)
+{
+  // struct Email *email_new_arena(struct EmailArena *ea);
+
+  {
+    struct Email *e = email_new_arena(NULL);
+    TEST_CHECK(e != NULL);
+    TEST_CHECK(e->arena == NULL);
+    TEST_CHECK(e->visible);
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+  }
+
+  {
+    struct EmailArena *ea = email_arena_new();
+    TEST_CHECK(ea != NULL);
+
+    struct Email *e = email_new_arena(ea);
+    e->env = mutt_env_new_arena(ea);
+    e->body = mutt_body_new_arena(ea);
+    TEST_CHECK(e->arena == ea);
+    TEST_CHECK(e->env->arena == ea);
+    TEST_CHECK(e->body->arena == ea);
+    TEST_CHECK(e->visible);
+    TEST_CHECK(TAILQ_EMPTY(&e->env->from));
+    TEST_CHECK(e->body->disposition == DISP_ATTACH);
+    TEST_CHECK(email_arena_live(ea) == 3);
+
+    // The fields are allocated normally
+    e->env->subject = mutt_str_dup("apple");
+    e->body->subtype = mutt_str_dup("plain");
+
+    // Freed objects are reused, and cleared
+    struct Email *old = e;
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+    TEST_CHECK(email_arena_live(ea) == 0);
+
+    e = email_new_arena(ea);
+    TEST_CHECK(e == old);
+    TEST_CHECK(e->env == NULL);
+    TEST_CHECK(e->body == NULL);
+    email_free(&e);
+
+    email_arena_free(&ea);
+    TEST_CHECK(ea == NULL);
+  }
+
+  {
+    // Objects are spread over several blocks
+    struct EmailArena *ea = email_arena_new();
+    struct Email *emails[2000] = { 0 };
+    for (int i = 0; i < mutt_array_size(emails); i++)
+    {
+      emails[i] = email_new_arena(ea);
+      emails[i]->index = i;
+    }
+    TEST_CHECK(email_arena_live(ea) == mutt_array_size(emails));
+
+    bool ok = true;
+    for (int i = 0; i < mutt_array_size(emails); i++)
+      ok &= (emails[i]->index == i) && (emails[i]->sequence == emails[0]->sequence + i);
+    TEST_CHECK(ok);
+
+    for (int i = 0; i < mutt_array_size(emails); i++)
+      email_free(&emails[i]);
+    TEST_CHECK(email_arena_live(ea) == 0);
+    email_arena_free(&ea);
+  }
+
+  {
+    // An Email can outlive its Mailbox's arena
+    struct EmailArena *ea = email_arena_new();
+    struct Email *e = email_new_arena(ea);
+    e->env = mutt_env_new_arena(ea);
+
+    email_arena_free(&ea);
+    TEST_CHECK(ea == NULL);
+
+    e->env->subject = mutt_str_dup("banana");
+    TEST_CHECK(mutt_str_equal(e->env->subject, "banana"));
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+  }
+}
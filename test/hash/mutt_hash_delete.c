@@ -24,6 +24,7 @@
 #include "config.h"
 #include "acutest.h"
 #include <stddef.h>
+#include <stdio.h>
 #include "mutt/lib.h"
 
 void test_mutt_hash_delete(void)
@@ -61,4 +62,48 @@ void test_mutt_hash_delete(void)
     mutt_hash_delete(table, "banana", NULL);
     mutt_hash_free(&table);
   }
+
+  {
+    // Deleting keys mustn't hide the keys that collided with them
+    struct HashTable *table = mutt_hash_new(10, MUTT_HASH_STRDUP_KEYS);
+    char key[32] = { 0 };
+    for (size_t i = 0; i < 2000; i++)
+    {
+      snprintf(key, sizeof(key), "key%zu", i);
+      mutt_hash_insert(table, key, (void *) (i + 1));
+    }
+
+    for (size_t i = 0; i < 2000; i += 2)
+    {
+      snprintf(key, sizeof(key), "key%zu", i);
+      mutt_hash_delete(table, key, NULL);
+    }
+    TEST_CHECK(table->num_keys == 1000);
+
+    for (size_t i = 0; i < 2000; i++)
+    {
+      snprintf(key, sizeof(key), "key%zu", i);
+      void *data = mutt_hash_find(table, key);
+      if (i % 2)
+        TEST_CHECK(data == (void *) (i + 1));
+      else
+        TEST_CHECK(data == NULL);
+    }
+    mutt_hash_free(&table);
+  }
+
+  {
+    struct HashTable *table = mutt_hash_new(128, MUTT_HASH_ALLOW_DUPS);
+    mutt_hash_insert(table, "banana", &dummy1);
+    mutt_hash_insert(table, "banana", &dummy2);
+    mutt_hash_insert(table, "banana", &dummy3);
+    mutt_hash_delete(table, "banana", &dummy2);
+    struct HashElem *he = mutt_hash_find_bucket(table, "banana");
+    TEST_CHECK((he != NULL) && (he->data == &dummy3));
+    TEST_CHECK((he != NULL) && (he->next != NULL) && (he->next->data == &dummy1));
+    mutt_hash_delete(table, "banana", NULL);
+    TEST_CHECK(!mutt_hash_find_bucket(table, "banana"));
+    TEST_CHECK(table->num_keys == 0);
+    mutt_hash_free(&table);
+  }
 }
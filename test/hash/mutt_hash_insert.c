@@ -24,6 +24,7 @@
 #include "config.h"
 #include "acutest.h"
 #include <stddef.h>
+#include <stdio.h>
 #include "mutt/lib.h"
 
 void test_mutt_hash_insert(void)
@@ -45,4 +46,30 @@ void test_mutt_hash_insert(void)
     TEST_CHECK(mutt_hash_insert(table, "apple", NULL) != NULL);
     mutt_hash_free(&table);
   }
+
+  {
+    // The table grows, but the HashElems don't move
+    struct HashTable *table = mutt_hash_new(2, MUTT_HASH_STRDUP_KEYS);
+    const size_t num_elems = table->num_elems;
+    struct HashElem *first = mutt_hash_insert(table, "key0", NULL);
+
+    char key[32] = { 0 };
+    for (size_t i = 1; i < 5000; i++)
+    {
+      snprintf(key, sizeof(key), "key%zu", i);
+      TEST_CHECK(mutt_hash_insert(table, key, (void *) i) != NULL);
+    }
+
+    TEST_CHECK(table->num_elems > num_elems);
+    TEST_CHECK(table->num_keys == 5000);
+    TEST_CHECK(mutt_hash_find_elem(table, "key0") == first);
+    TEST_CHECK(!mutt_hash_insert(table, "key42", NULL));
+
+    for (size_t i = 1; i < 5000; i++)
+    {
+      snprintf(key, sizeof(key), "key%zu", i);
+      TEST_CHECK(mutt_hash_find(table, key) == (void *) i);
+    }
+    mutt_hash_free(&table);
+  }
 }
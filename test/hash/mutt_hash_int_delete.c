@@ -24,7 +24,9 @@
 #include "config.h"
 #include "acutest.h"
 #include <stddef.h>
+#include <stdint.h>
 #include "mutt/lib.h"
+#include "test_common.h"
 
 void test_mutt_hash_int_delete(void)
 {
@@ -41,4 +43,41 @@ void test_mutt_hash_int_delete(void)
     TEST_CHECK_(1, "mutt_hash_int_delete(table, 0, NULL)");
     mutt_hash_free(&table);
   }
+
+  {
+    struct HashTable *table = mutt_hash_int_new(10, MUTT_HASH_NO_FLAGS);
+    for (unsigned int i = 0; i < 3000; i++)
+      mutt_hash_int_insert(table, i * 3, (void *) (uintptr_t) (i + 1));
+
+    for (unsigned int i = 0; i < 3000; i += 3)
+      mutt_hash_int_delete(table, i * 3, NULL);
+
+    for (unsigned int i = 0; i < 3000; i++)
+    {
+      void *data = mutt_hash_int_find(table, i * 3);
+      if ((i % 3) == 0)
+        TEST_CHECK(data == NULL);
+      else
+        TEST_CHECK(data == (void *) (uintptr_t) (i + 1));
+    }
+    mutt_hash_free(&table);
+  }
+
+  {
+    // The keys after a deleted one, which share its home slot, can still be found
+    struct HashTable *table = mutt_hash_int_new(8, MUTT_HASH_NO_FLAGS);
+    mutt_hash_int_insert(table, 6, "apple");
+    mutt_hash_int_insert(table, 14, "banana");
+    mutt_hash_int_insert(table, 22, "cherry");
+    mutt_hash_int_insert(table, 7, "damson");
+    mutt_hash_int_delete(table, 14, NULL);
+    TEST_CHECK(mutt_hash_int_find(table, 14) == NULL);
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 6), "apple");
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 22), "cherry");
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 7), "damson");
+    mutt_hash_int_delete(table, 6, NULL);
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 22), "cherry");
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 7), "damson");
+    mutt_hash_free(&table);
+  }
 }
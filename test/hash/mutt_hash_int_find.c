@@ -25,6 +25,7 @@
 #include "acutest.h"
 #include <stddef.h>
 #include "mutt/lib.h"
+#include "test_common.h"
 
 void test_mutt_hash_int_find(void)
 {
@@ -45,4 +46,18 @@ void test_mutt_hash_int_find(void)
     mutt_hash_int_find(table, 42);
     mutt_hash_free(&table);
   }
+
+  {
+    // Keys that share a home slot are stored in the following slots
+    struct HashTable *table = mutt_hash_int_new(8, MUTT_HASH_NO_FLAGS);
+    mutt_hash_int_insert(table, 7, "apple");
+    mutt_hash_int_insert(table, 15, "banana");
+    mutt_hash_int_insert(table, 0, "cherry");
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 7), "apple");
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 15), "banana");
+    TEST_CHECK_STR_EQ(mutt_hash_int_find(table, 0), "cherry");
+    TEST_CHECK(mutt_hash_int_find(table, 23) == NULL);
+    TEST_CHECK(mutt_hash_int_find(table, 8) == NULL);
+    mutt_hash_free(&table);
+  }
 }
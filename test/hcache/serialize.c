@@ -0,0 +1,298 @@
+/**
+ * @file
+ * Test code for the Header Cache record format
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "hcache/serialize.h"
+#include "test_common.h"
+
+/// Space left for the caller at the start of a dump, like hcache_store()
+#define TEST_HLEN 8
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "auto_subscribe", DT_BOOL, false, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+static struct Email *test_email(const char *subject)
+{
+  struct Email *e = email_new();
+  e->read = true;
+  e->flagged = true;
+  e->date_sent = 1700000000;
+  e->received = 1700000100;
+  e->lines = 42;
+  e->zhours = 1;
+
+  e->env = mutt_env_new();
+  e->env->subject = mutt_str_dup(subject);
+  e->env->real_subj = e->env->subject;
+  e->env->message_id = mutt_str_dup("<apple@example.com>");
+  e->env->organization = mutt_str_dup("Orchard");
+  e->env->x_label = mutt_str_dup("fruit");
+  mutt_addrlist_parse(&e->env->from, "Ann Apple <ann@example.com>");
+  mutt_addrlist_parse(&e->env->sender, "Bob Banana <bob@example.com>");
+  mutt_list_insert_tail(&e->env->references, mutt_str_dup("<one@example.com>"));
+  mutt_list_insert_tail(&e->env->references, mutt_str_dup("<two@example.com>"));
+  mutt_list_insert_tail(&e->env->userhdrs, mutt_str_dup("X-Fruit: apple"));
+
+  e->body = mutt_body_new();
+  e->body->type = TYPE_TEXT;
+  e->body->subtype = mutt_str_dup("plain");
+  e->body->length = 1234;
+  mutt_param_set(&e->body->parameter, "charset", "utf-8");
+
+  return e;
+}
+
+static void check_email(struct Email *e, const char *subject)
+{
+  if (!TEST_CHECK(e != NULL) || !TEST_CHECK(e->env != NULL) ||
+      !TEST_CHECK(e->body != NULL))
+  {
+    return;
+  }
+
+  TEST_CHECK(e->read);
+  TEST_CHECK(e->flagged);
+  TEST_CHECK(!e->replied);
+  TEST_CHECK(e->date_sent == 1700000000);
+  TEST_CHECK(e->received == 1700000100);
+  TEST_CHECK(e->lines == 42);
+  TEST_CHECK(e->zhours == 1);
+
+  TEST_CHECK_STR_EQ(e->env->subject, subject);
+  TEST_CHECK_STR_EQ(e->env->message_id, "<apple@example.com>");
+  TEST_CHECK_STR_EQ(e->env->x_label, "fruit");
+  struct Address *a = TAILQ_FIRST(&e->env->from);
+  if (TEST_CHECK(a != NULL))
+  {
+    TEST_CHECK_STR_EQ(buf_string(a->personal), "Ann Apple");
+    TEST_CHECK_STR_EQ(buf_string(a->mailbox), "ann@example.com");
+  }
+  struct ListNode *np = STAILQ_FIRST(&e->env->references);
+  if (TEST_CHECK(np != NULL))
+    TEST_CHECK_STR_EQ(np->data, "<one@example.com>");
+
+  TEST_CHECK(e->body->type == TYPE_TEXT);
+  TEST_CHECK_STR_EQ(e->body->subtype, "plain");
+  TEST_CHECK(e->body->length == 1234);
+  TEST_CHECK_STR_EQ(mutt_param_get(&e->body->parameter, "charset"), "utf-8");
+}
+
+static void check_email_rest(struct Email *e)
+{
+  if (!TEST_CHECK(e != NULL) || !TEST_CHECK(e->env != NULL))
+    return;
+
+  TEST_CHECK_STR_EQ(e->env->organization, "Orchard");
+  struct Address *a = TAILQ_FIRST(&e->env->sender);
+  if (TEST_CHECK(a != NULL))
+    TEST_CHECK_STR_EQ(buf_string(a->mailbox), "bob@example.com");
+  struct ListNode *np = STAILQ_FIRST(&e->env->userhdrs);
+  if (TEST_CHECK(np != NULL))
+    TEST_CHECK_STR_EQ(np->data, "X-Fruit: apple");
+}
+
+static void test_round_trip(bool lazy)
+{
+  struct Email *e = test_email("Apples");
+  size_t dlen = 0;
+  unsigned char *d = serial_dump_email(e, TEST_HLEN, &dlen, false);
+  email_free(&e);
+  if (!TEST_CHECK(d != NULL) || !TEST_CHECK(dlen > TEST_HLEN))
+    return;
+
+  TEST_CHECK(serial_record_size(d + TEST_HLEN) == (dlen - TEST_HLEN));
+
+  e = serial_restore_email(d + TEST_HLEN, dlen - TEST_HLEN, false, lazy, NULL);
+  check_email(e, "Apples");
+  if (lazy)
+  {
+    TEST_CHECK(e->lazy_data != NULL);
+    TEST_CHECK(e->env->organization == NULL);
+    email_materialize(e);
+    TEST_CHECK(e->lazy_data == NULL);
+  }
+  check_email_rest(e);
+
+  email_free(&e);
+  FREE(&d);
+}
+
+static void test_convert(bool lazy)
+{
+  // "café" in iso-8859-1, then in utf-8
+  const char *latin1 = "caf\xe9";
+  const char *utf8 = "caf\xc3\xa9";
+
+  const bool old_utf8 = CharsetIsUtf8;
+  TEST_CHECK(cs_subset_str_string_set(NeoMutt->sub, "charset", "iso-8859-1", NULL) == CSR_SUCCESS);
+  CharsetIsUtf8 = false;
+
+  struct Email *e = test_email(latin1);
+  mutt_str_replace(&e->env->organization, latin1);
+  size_t dlen = 0;
+  unsigned char *d = serial_dump_email(e, TEST_HLEN, &dlen, true);
+  email_free(&e);
+
+  if (TEST_CHECK(d != NULL))
+  {
+    // The cache always holds utf-8
+    const unsigned char *rec = d + TEST_HLEN;
+    TEST_CHECK_STR_EQ(serial_record_str(rec, dlen - TEST_HLEN, HCR_SUBJECT), utf8);
+    TEST_CHECK_STR_EQ(serial_record_str(rec, dlen - TEST_HLEN, HCR_ORGANIZATION), utf8);
+
+    e = serial_restore_email(rec, dlen - TEST_HLEN, true, lazy, NULL);
+    if (TEST_CHECK(e != NULL))
+    {
+      TEST_CHECK_STR_EQ(e->env->subject, latin1);
+      email_materialize(e);
+      TEST_CHECK_STR_EQ(e->env->organization, latin1);
+    }
+    email_free(&e);
+
+    // Without conversion, the utf-8 is returned as-is
+    e = serial_restore_email(rec, dlen - TEST_HLEN, false, false, NULL);
+    if (TEST_CHECK(e != NULL))
+      TEST_CHECK_STR_EQ(e->env->subject, utf8);
+    email_free(&e);
+  }
+  FREE(&d);
+
+  cs_subset_str_string_set(NeoMutt->sub, "charset", "utf-8", NULL);
+  CharsetIsUtf8 = old_utf8;
+}
+
+void test_hcache_serialize(void)
+{
+  // void *        serial_dump_email   (const struct Email *e, size_t hlen, size_t *dlen, bool convert);
+  // struct Email *serial_restore_email(const unsigned char *d, size_t dlen, bool convert, bool lazy, struct EmailArena *ea);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  {
+    TEST_CHECK(serial_restore_email(NULL, 0, false, false, NULL) == NULL);
+  }
+
+  {
+    TEST_CASE("Full");
+    test_round_trip(false);
+  }
+
+  {
+    TEST_CASE("Lazy");
+    test_round_trip(true);
+  }
+
+  {
+    TEST_CASE("Convert");
+    test_convert(false);
+  }
+
+  {
+    TEST_CASE("Convert, lazy");
+    test_convert(true);
+  }
+
+  {
+    TEST_CASE("Truncated");
+    struct Email *e = test_email("Apples");
+    size_t dlen = 0;
+    unsigned char *d = serial_dump_email(e, 0, &dlen, false);
+    email_free(&e);
+
+    // Copy each prefix, so that reading past it would be caught by a sanitiser
+    for (size_t len = 0; len < dlen; len++)
+    {
+      unsigned char *copy = mutt_mem_malloc(MAX(len, 1));
+      memcpy(copy, d, len);
+      e = serial_restore_email(copy, len, false, false, NULL);
+      if (!TEST_CHECK(e == NULL))
+        TEST_MSG("Length %zu of %zu", len, dlen);
+      email_free(&e);
+      FREE(&copy);
+    }
+    FREE(&d);
+  }
+
+  {
+    TEST_CASE("Corrupt");
+    struct Email *e = test_email("Apples");
+    size_t dlen = 0;
+    unsigned char *d = serial_dump_email(e, 0, &dlen, false);
+    email_free(&e);
+
+    struct HcRecordHeader hdr = { 0 };
+    TEST_CHECK(serial_record_header(d, dlen, &hdr));
+
+    // Wrong version
+    unsigned char *copy = mutt_mem_malloc(dlen);
+    memcpy(copy, d, dlen);
+    copy[0] ^= 0xff;
+    TEST_CHECK(serial_restore_email(copy, dlen, false, false, NULL) == NULL);
+    TEST_CHECK(!serial_record_header(copy, dlen, &hdr));
+
+    // Every offset in the table points past the end
+    memcpy(copy, d, dlen);
+    for (size_t i = 0; i < HCR_MAX; i++)
+    {
+      const uint32_t off = 0xfffffff0;
+      memcpy(copy + sizeof(struct HcRecordHeader) + (i * sizeof(uint32_t)), &off, sizeof(off));
+    }
+    e = serial_restore_email(copy, dlen, false, true, NULL);
+    if (TEST_CHECK(e != NULL))
+    {
+      TEST_CHECK(e->env->subject == NULL);
+      TEST_CHECK(TAILQ_EMPTY(&e->env->from));
+      email_materialize(e);
+      TEST_CHECK(e->env->organization == NULL);
+    }
+    email_free(&e);
+
+    // Damage each byte in turn; the result doesn't matter, as long as it's safe
+    for (size_t i = 0; i < dlen; i++)
+    {
+      memcpy(copy, d, dlen);
+      copy[i] ^= 0xa5;
+      e = serial_restore_email(copy, dlen, false, true, NULL);
+      email_materialize(e);
+      email_free(&e);
+    }
+    TEST_CHECK_(1, "Damaged records");
+
+    FREE(&copy);
+    FREE(&d);
+  }
+}
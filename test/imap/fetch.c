@@ -0,0 +1,241 @@
+/**
+ * @file
+ * Test code for sharing out the headers to download between connections
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "imap/adata.h"
+#include "imap/fetch.h"
+#include "imap/mdata.h"
+#include "imap/msn.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "imap_fetch_chunk_size", DT_LONG, 0, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/// A cached Email, for the MSN table
+static struct Email CachedEmail = { 0 };
+
+/**
+ * cache_msns - Mark some messages as being in the header cache
+ * @param mdata Mailbox data
+ * @param first First MSN
+ * @param last  Last MSN
+ */
+static void cache_msns(struct ImapMboxData *mdata, unsigned int first, unsigned int last)
+{
+  for (unsigned int msn = first; msn <= last; msn++)
+    imap_msn_set(&mdata->msn, msn - 1, &CachedEmail);
+}
+
+/**
+ * check_stream - Check the range of MSNs given to a connection
+ * @param fs        Connection
+ * @param msn_begin Expected first MSN
+ * @param msn_end   Expected last MSN
+ */
+static void check_stream(const struct FetchStream *fs, unsigned int msn_begin,
+                         unsigned int msn_end)
+{
+  TEST_CHECK(fs->msn_begin == msn_begin);
+  TEST_CHECK(fs->msn_end == msn_end);
+  TEST_MSG("Expected %u:%u, Got %u:%u", msn_begin, msn_end, fs->msn_begin, fs->msn_end);
+}
+
+void test_imap_fetch(void)
+{
+  // unsigned int imap_fetch_conns(unsigned int count, int max_conns);
+  // unsigned int imap_fetch_count(const struct MSNArray *msn, bool evalhc, unsigned int msn_begin, unsigned int msn_end);
+  // unsigned int imap_fetch_partition(const struct MSNArray *msn, bool evalhc, unsigned int msn_begin, unsigned int msn_end, struct FetchStream *streams, unsigned int num_streams);
+  // void imap_fetch_examine_parse(struct FetchExamine *fe, const char *s);
+  // bool imap_fetch_examine_check(const struct FetchExamine *fe, const struct ImapMboxData *mdata, unsigned int msn_end);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  struct ImapMboxData mdata = { 0 };
+  struct Mailbox m = { 0 };
+  m.mdata = &mdata;
+  struct ImapAccountData adata = { 0 };
+  adata.mailbox = &m;
+  struct FetchStream streams[4] = { 0 };
+
+  {
+    TEST_CASE("Connections");
+    TEST_CHECK(imap_fetch_conns(0, 3) == 0);
+    TEST_CHECK(imap_fetch_conns((2 * IMAP_FETCH_CONN_MIN) - 1, 3) == 0);
+    TEST_CHECK(imap_fetch_conns(2 * IMAP_FETCH_CONN_MIN, 3) == 1);
+    TEST_CHECK(imap_fetch_conns((3 * IMAP_FETCH_CONN_MIN) - 1, 3) == 1);
+    TEST_CHECK(imap_fetch_conns(3 * IMAP_FETCH_CONN_MIN, 3) == 2);
+    TEST_CHECK(imap_fetch_conns(100 * IMAP_FETCH_CONN_MIN, 3) == 3);
+    TEST_CHECK(imap_fetch_conns(100 * IMAP_FETCH_CONN_MIN, 0) == 0);
+    TEST_CHECK(imap_fetch_conns(100 * IMAP_FETCH_CONN_MIN, -1) == 0);
+  }
+
+  {
+    TEST_CASE("Count");
+    imap_msn_reserve(&mdata.msn, 20);
+    cache_msns(&mdata, 1, 10);
+    cache_msns(&mdata, 15, 16);
+    TEST_CHECK(imap_fetch_count(NULL, true, 1, 20) == 0);
+    TEST_CHECK(imap_fetch_count(&mdata.msn, true, 1, 20) == 8);
+    TEST_CHECK(imap_fetch_count(&mdata.msn, true, 11, 14) == 4);
+    TEST_CHECK(imap_fetch_count(&mdata.msn, true, 20, 19) == 0);
+    // Without the header cache, every header is needed
+    TEST_CHECK(imap_fetch_count(&mdata.msn, false, 1, 20) == 20);
+
+    // Too few headers for an extra connection, even though the Mailbox is big
+    imap_msn_reserve(&mdata.msn, 10 * IMAP_FETCH_CONN_MIN);
+    cache_msns(&mdata, 1, (10 * IMAP_FETCH_CONN_MIN) - 10);
+    const unsigned int count = imap_fetch_count(&mdata.msn, true, 1, 10 * IMAP_FETCH_CONN_MIN);
+    TEST_CHECK(count == 10);
+    TEST_CHECK(imap_fetch_conns(count, 3) == 0);
+    imap_msn_free(&mdata.msn);
+  }
+
+  {
+    TEST_CASE("Partition, no cache");
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, false, 1, 10, NULL, 3) == 0);
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, false, 1, 10, streams, 3) == 3);
+    check_stream(&streams[0], 1, 4);
+    check_stream(&streams[1], 5, 7);
+    check_stream(&streams[2], 8, 10);
+
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, false, 1, 10, streams, 1) == 1);
+    check_stream(&streams[0], 1, 10);
+  }
+
+  {
+    TEST_CASE("Partition, only the uncached headers");
+    // Uncached: 11, 12, 13, 14, 17, 18, 19, 20
+    imap_msn_reserve(&mdata.msn, 20);
+    cache_msns(&mdata, 1, 10);
+    cache_msns(&mdata, 15, 16);
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, true, 1, 20, streams, 3) == 3);
+    check_stream(&streams[0], 11, 13);
+    check_stream(&streams[1], 14, 18);
+    check_stream(&streams[2], 19, 20);
+
+    // Each connection gets the same number of uncached headers, give or take one
+    unsigned int total = 0;
+    for (int i = 0; i < 3; i++)
+    {
+      const unsigned int count = imap_fetch_count(&mdata.msn, true, streams[i].msn_begin,
+                                                  streams[i].msn_end);
+      TEST_CHECK((count == 2) || (count == 3));
+      total += count;
+    }
+    TEST_CHECK(total == 8);
+  }
+
+  {
+    TEST_CASE("Partition, more connections than headers");
+    // Uncached: 11, 12, 13, 14, 17, 18, 19, 20
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, true, 12, 16, streams, 4) == 3);
+    check_stream(&streams[0], 12, 12);
+    check_stream(&streams[1], 13, 13);
+    check_stream(&streams[2], 14, 14);
+    TEST_CHECK(streams[3].msn_begin > streams[3].msn_end);
+
+    // Everything is cached
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, true, 1, 10, streams, 2) == 0);
+    TEST_CHECK(streams[0].msn_begin > streams[0].msn_end);
+    TEST_CHECK(streams[1].msn_begin > streams[1].msn_end);
+    imap_msn_free(&mdata.msn);
+  }
+
+  {
+    TEST_CASE("Fallback, a connection fails");
+    // Three connections share 30 headers; the second stops after five
+    // headers and the third fails.  The Mailbox's connection fetches the rest.
+    struct Buffer *buf = buf_pool_get();
+    unsigned int fetch_msn_end = 0;
+    imap_msn_reserve(&mdata.msn, 30);
+    TEST_CHECK(imap_fetch_partition(&mdata.msn, false, 1, 30, streams, 3) == 3);
+    check_stream(&streams[1], 11, 20);
+    cache_msns(&mdata, 1, 10);
+    cache_msns(&mdata, 11, 15);
+
+    TEST_CHECK(imap_fetch_msn_seqset(buf, &adata, true, 1, 30, &fetch_msn_end) == 15);
+    TEST_CHECK_STR_EQ(buf_string(buf), "16:30");
+    TEST_CHECK(fetch_msn_end >= 30);
+
+    // Every connection succeeded, nothing is left
+    cache_msns(&mdata, 16, 30);
+    TEST_CHECK(imap_fetch_msn_seqset(buf, &adata, true, 1, 30, &fetch_msn_end) == 0);
+    TEST_CHECK_STR_EQ(buf_string(buf), "");
+
+    imap_msn_free(&mdata.msn);
+    buf_pool_release(&buf);
+  }
+
+  {
+    TEST_CASE("Fallback, the connections disagree");
+    // void imap_fetch_examine_parse(struct FetchExamine *fe, const char *s);
+    static const char *responses[] = {
+      "* FLAGS (\\Answered \\Flagged \\Deleted \\Seen \\Draft)",
+      "* OK [PERMANENTFLAGS ()] Read-only mailbox",
+      "* 100 EXISTS",
+      "* 3 RECENT",
+      "* OK [UIDVALIDITY 1234] UIDs valid",
+      "* OK [UIDNEXT 4392] Predicted next UID",
+      "a0002 OK [READ-ONLY] Examine completed",
+      NULL,
+    };
+
+    struct FetchExamine fe = { 0 };
+    imap_fetch_examine_parse(NULL, responses[0]);
+    imap_fetch_examine_parse(&fe, NULL);
+    for (int i = 0; responses[i]; i++)
+      imap_fetch_examine_parse(&fe, responses[i]);
+    TEST_CHECK(fe.uidvalidity == 1234);
+    TEST_CHECK(fe.exists == 100);
+
+    mdata.uidvalidity = 1234;
+    TEST_CHECK(!imap_fetch_examine_check(NULL, &mdata, 100));
+    TEST_CHECK(!imap_fetch_examine_check(&fe, NULL, 100));
+    TEST_CHECK(imap_fetch_examine_check(&fe, &mdata, 100));
+    // New mail doesn't change the numbers of the old messages
+    TEST_CHECK(imap_fetch_examine_check(&fe, &mdata, 90));
+    // Some of the messages are missing
+    TEST_CHECK(!imap_fetch_examine_check(&fe, &mdata, 101));
+
+    // The Mailbox has been recreated
+    mdata.uidvalidity = 1235;
+    TEST_CHECK(!imap_fetch_examine_check(&fe, &mdata, 100));
+
+    // The server didn't say
+    struct FetchExamine fe2 = { 0 };
+    imap_fetch_examine_parse(&fe2, "* 100 exists");
+    TEST_CHECK(fe2.exists == 100);
+    mdata.uidvalidity = 0;
+    TEST_CHECK(!imap_fetch_examine_check(&fe2, &mdata, 100));
+  }
+}
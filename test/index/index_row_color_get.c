@@ -0,0 +1,97 @@
+/**
+ * @file
+ * Test code for index_row_color_get()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "color/lib.h"
+#include "index/row_cache.h"
+
+void test_index_row_color_get(void)
+{
+  // bool index_row_color_get(struct Email *e, enum ColorId cid, struct AttrColor **ac);
+
+  struct AttrColor author = { 0 };
+  struct AttrColor subject = { 0 };
+  struct AttrColor *ac = NULL;
+
+  {
+    TEST_CHECK(!index_row_color_get(NULL, MT_COLOR_INDEX_AUTHOR, &ac));
+    index_row_color_set(NULL, MT_COLOR_INDEX_AUTHOR, &author);
+  }
+
+  {
+    // Nothing is cached without a line
+    struct Email *e = email_new();
+    index_row_color_set(e, MT_COLOR_INDEX_AUTHOR, &author);
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+    email_free(&e);
+  }
+
+  {
+    struct Email *e = email_new();
+    index_row_set(e, 80, MUTT_FORMAT_INDEX, false, "apple");
+
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, NULL));
+
+    index_row_color_set(e, MT_COLOR_INDEX_AUTHOR, &author);
+    index_row_color_set(e, MT_COLOR_INDEX_SUBJECT, &subject);
+    TEST_CHECK(index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+    TEST_CHECK(ac == &author);
+    TEST_CHECK(index_row_color_get(e, MT_COLOR_INDEX_SUBJECT, &ac));
+    TEST_CHECK(ac == &subject);
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_DATE, &ac));
+
+    // No colour is cached too
+    index_row_color_set(e, MT_COLOR_INDEX_DATE, NULL);
+    ac = &author;
+    TEST_CHECK(index_row_color_get(e, MT_COLOR_INDEX_DATE, &ac));
+    TEST_CHECK(ac == NULL);
+
+    // Colours that aren't cached
+    index_row_color_set(e, MT_COLOR_INDEX_TAG, &author);
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_TAG, &ac));
+    index_row_color_set(e, MT_COLOR_INDEX, &author);
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX, &ac));
+    index_row_color_set(e, MT_COLOR_NORMAL, &author);
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_NORMAL, &ac));
+
+    // Reformatting the line discards its colours
+    index_row_set(e, 80, MUTT_FORMAT_INDEX, false, "banana");
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+
+    // So does a flush
+    index_row_color_set(e, MT_COLOR_INDEX_AUTHOR, &author);
+    TEST_CHECK(index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+    index_row_flush();
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+    index_row_color_set(e, MT_COLOR_INDEX_AUTHOR, &author);
+    TEST_CHECK(!index_row_color_get(e, MT_COLOR_INDEX_AUTHOR, &ac));
+
+    email_free(&e);
+  }
+}
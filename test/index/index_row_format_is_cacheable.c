@@ -0,0 +1,67 @@
+/**
+ * @file
+ * Test code for index_row_format_is_cacheable()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "index/row_cache.h"
+
+/**
+ * struct FormatTest - An Index format and whether its lines can be cached
+ */
+struct FormatTest
+{
+  const char *fmt; ///< Index format
+  bool cacheable;  ///< Expected result
+};
+
+void test_index_row_format_is_cacheable(void)
+{
+  // bool index_row_format_is_cacheable(const char *fmt);
+
+  static const struct FormatTest tests[] = {
+    // clang-format off
+    { NULL,                                                  true  },
+    { "",                                                    true  },
+    { "%4C %Z %{%b %d} %-15.15L (%?l?%4l&%4c?) %s",          true  },
+    { "%4C %Z %[%H:%M] %(%d/%m) %s",                         true  },
+    { "%4C %<M?[%M]&%4c> %s",                                true  },
+    { "100%% [sure] (maybe)",                                true  },
+    { "%%?[1d?today&older?",                                 true  },
+    { "%4C %?[1d?%[%H:%M]&%[%d %b]? %s",                     false },
+    { "%4C %?(1w?new&old? %s",                               false },
+    { "%4C %<[1d?%[%H:%M]&%[%d %b]> %s",                     false },
+    { "%4C %<(>2m?ancient&recent> %s",                       false },
+    { "%4C %<M?%<[1y?%[%b %d]&%[%Y]>&%4c> %s",               false },
+    { "%",                                                   true  },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i].fmt ? tests[i].fmt : "NULL");
+    TEST_CHECK(index_row_format_is_cacheable(tests[i].fmt) == tests[i].cacheable);
+  }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * Test code for index_row_get()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "index/row_cache.h"
+#include "test_common.h"
+
+void test_index_row_get(void)
+{
+  // const char *index_row_get(struct Email *e, int cols, MuttFormatFlags flags, bool in_pager);
+
+  {
+    TEST_CHECK(index_row_get(NULL, 80, MUTT_FORMAT_INDEX, false) == NULL);
+    index_row_set(NULL, 80, MUTT_FORMAT_INDEX, false, "apple");
+  }
+
+  {
+    struct Email *e = email_new();
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX, false) == NULL);
+
+    index_row_set(e, 80, MUTT_FORMAT_INDEX, false, NULL);
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX, false) == NULL);
+
+    index_row_set(e, 80, MUTT_FORMAT_INDEX, false, "apple");
+    TEST_CHECK_STR_EQ(index_row_get(e, 80, MUTT_FORMAT_INDEX, false), "apple");
+
+    // Replacing the line
+    index_row_set(e, 80, MUTT_FORMAT_INDEX, false, "banana");
+    TEST_CHECK_STR_EQ(index_row_get(e, 80, MUTT_FORMAT_INDEX, false), "banana");
+
+    // Formatted differently
+    TEST_CHECK(index_row_get(e, 81, MUTT_FORMAT_INDEX, false) == NULL);
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX | MUTT_FORMAT_FORCESUBJ, false) == NULL);
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX, true) == NULL);
+    TEST_CHECK_STR_EQ(index_row_get(e, 80, MUTT_FORMAT_INDEX, false), "banana");
+
+    // Renumbered
+    e->msgno = 5;
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX, false) == NULL);
+    e->msgno = 0;
+    e->vnum = 7;
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX, false) == NULL);
+    e->vnum = 0;
+    TEST_CHECK_STR_EQ(index_row_get(e, 80, MUTT_FORMAT_INDEX, false), "banana");
+
+    // Flushed
+    index_row_flush();
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_INDEX, false) == NULL);
+
+    email_free(&e);
+  }
+
+  {
+    // The thread tree is part of the line
+    struct Email *e = email_new();
+    e->tree = mutt_str_dup("->");
+    index_row_set(e, 80, MUTT_FORMAT_TREE, false, "cherry");
+    TEST_CHECK_STR_EQ(index_row_get(e, 80, MUTT_FORMAT_TREE, false), "cherry");
+
+    e->tree[0] = '`';
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_TREE, false) == NULL);
+    e->tree[0] = '-';
+    TEST_CHECK_STR_EQ(index_row_get(e, 80, MUTT_FORMAT_TREE, false), "cherry");
+
+    FREE(&e->tree);
+    TEST_CHECK(index_row_get(e, 80, MUTT_FORMAT_TREE, false) == NULL);
+
+    email_free(&e);
+  }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * Test code for mutt_intern_free()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+
+void test_mutt_intern_free(void)
+{
+  // void mutt_intern_free(char **ptr);
+
+  {
+    mutt_intern_free(NULL);
+    TEST_CHECK_(1, "mutt_intern_free(NULL)");
+  }
+
+  {
+    char *str = NULL;
+    mutt_intern_free(&str);
+    TEST_CHECK_(1, "mutt_intern_free(&str)");
+  }
+
+  {
+    const size_t count = mutt_intern_count();
+
+    char *a = mutt_intern_get("banana");
+    char *b = mutt_intern_get("banana");
+
+    // An ordinary string with the same contents
+    char *c = mutt_str_dup("banana");
+    mutt_intern_free(&c);
+    TEST_CHECK(c == NULL);
+    TEST_CHECK(mutt_intern_count() == (count + 1));
+
+    // The shared string lives until its last user releases it
+    mutt_intern_free(&a);
+    TEST_CHECK(a == NULL);
+    TEST_CHECK(mutt_str_equal(b, "banana"));
+    TEST_CHECK(mutt_intern_count() == (count + 1));
+
+    mutt_intern_free(&b);
+    TEST_CHECK(b == NULL);
+    TEST_CHECK(mutt_intern_count() == count);
+  }
+}
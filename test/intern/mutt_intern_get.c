@@ -0,0 +1,78 @@
+/**
+ * @file
+ * Test code for mutt_intern_get()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+
+void test_mutt_intern_get(void)
+{
+  // char *mutt_intern_get(const char *str);
+
+  {
+    TEST_CHECK(mutt_intern_get(NULL) == NULL);
+  }
+
+  {
+    const size_t count = mutt_intern_count();
+    char buf[32] = "apple";
+
+    char *a = mutt_intern_get(buf);
+    TEST_CHECK(a != buf);
+    TEST_CHECK(mutt_str_equal(a, "apple"));
+    TEST_CHECK(mutt_intern_count() == (count + 1));
+
+    // The same string is shared
+    mutt_str_copy(buf, "apple", sizeof(buf));
+    char *b = mutt_intern_get(buf);
+    TEST_CHECK(b == a);
+    TEST_CHECK(mutt_intern_count() == (count + 1));
+
+    // Case matters
+    char *c = mutt_intern_get("Apple");
+    TEST_CHECK(c != a);
+    TEST_CHECK(mutt_intern_count() == (count + 2));
+
+    mutt_intern_free(&a);
+    mutt_intern_free(&b);
+    mutt_intern_free(&c);
+    TEST_CHECK(mutt_intern_count() == count);
+  }
+
+  {
+    const size_t count = mutt_intern_count();
+    char *e = mutt_intern_get("");
+    TEST_CHECK(e != NULL);
+    TEST_CHECK(e[0] == '\0');
+    mutt_intern_free(&e);
+    TEST_CHECK(e == NULL);
+    TEST_CHECK(mutt_intern_count() == count);
+
+    // A freed empty string mustn't be found again
+    e = mutt_intern_get("");
+    TEST_CHECK(e != NULL);
+    mutt_intern_free(&e);
+    TEST_CHECK(mutt_intern_count() == count);
+  }
+}
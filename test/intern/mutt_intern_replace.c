@@ -0,0 +1,59 @@
+/**
+ * @file
+ * Test code for mutt_intern_replace()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+
+void test_mutt_intern_replace(void)
+{
+  // void mutt_intern_replace(char **ptr, const char *str);
+
+  {
+    mutt_intern_replace(NULL, "apple");
+    TEST_CHECK_(1, "mutt_intern_replace(NULL, \"apple\")");
+  }
+
+  {
+    const size_t count = mutt_intern_count();
+
+    char *str = mutt_str_dup("cherry");
+    mutt_intern_replace(&str, "damson");
+    TEST_CHECK(mutt_str_equal(str, "damson"));
+
+    char *other = mutt_intern_get("damson");
+    TEST_CHECK(other == str);
+
+    // The new string may be part of the old one
+    mutt_intern_replace(&str, str + 3);
+    TEST_CHECK(mutt_str_equal(str, "son"));
+    TEST_CHECK(mutt_str_equal(other, "damson"));
+
+    mutt_intern_replace(&str, NULL);
+    TEST_CHECK(str == NULL);
+
+    mutt_intern_free(&other);
+    TEST_CHECK(mutt_intern_count() == count);
+  }
+}
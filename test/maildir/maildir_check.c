@@ -0,0 +1,362 @@
+/**
+ * @file
+ * Test code for the Maildir Check
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "maildir/lib.h"
+#include "maildir/check.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "mail_check_recent", DT_BOOL, false, 0, NULL, },
+  { "maildir_check_cur", DT_BOOL, false, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * struct CheckTest - A Maildir and what a check should find
+ */
+struct CheckTest
+{
+  const char *name;     ///< Name of the Maildir
+  const char *new[4];   ///< Files in new/
+  const char *cur[8];   ///< Files in cur/
+  int msg_count;        ///< Expected Mailbox.msg_count
+  int msg_unread;       ///< Expected Mailbox.msg_unread
+  int msg_flagged;      ///< Expected Mailbox.msg_flagged
+  int msg_new;          ///< Expected Mailbox.msg_new
+  int msg_new_cur;      ///< Expected Mailbox.msg_new, with `$maildir_check_cur`
+};
+
+static const struct CheckTest Tests[] = {
+  // clang-format off
+  { "empty", { NULL }, { NULL },
+    0, 0, 0, 0, 0 },
+  { "new", { "1.apple", "2.banana", "3.cherry", NULL }, { NULL },
+    3, 3, 0, 3, 3 },
+  { "cur", { NULL }, { "4.damson:2,S", "5.elder:2,FS", "6.fig:2,F", "7.grape:2,ST", "8.hazel", ".lemon", NULL },
+    4, 2, 2, 0, 2 },
+  { "mixed", { "1.apple", "2.banana:2,F", NULL }, { "3.cherry:2,S", "4.damson:2,T", NULL },
+    3, 2, 1, 2, 2 },
+  // clang-format on
+};
+
+/// Number of Mailboxes to check at once, each Maildir is used several times
+#define NUM_MAILBOXES (4 * mutt_array_size(Tests))
+
+/**
+ * create_file - Create an empty file
+ * @param dir  Directory
+ * @param name Filename
+ * @retval true Success
+ */
+static bool create_file(const char *dir, const char *name)
+{
+  char path[PATH_MAX] = { 0 };
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  FILE *fp = mutt_file_fopen(path, "w");
+  if (!fp)
+    return false;
+  mutt_file_fclose(&fp);
+  return true;
+}
+
+/**
+ * create_maildir - Create a Maildir
+ * @param root Parent directory
+ * @param t    Contents of the Maildir
+ * @retval true Success
+ */
+static bool create_maildir(const char *root, const struct CheckTest *t)
+{
+  char path[PATH_MAX] = { 0 };
+
+  snprintf(path, sizeof(path), "%s/%s/tmp", root, t->name);
+  if (mutt_file_mkdir(path, S_IRWXU) != 0)
+    return false;
+
+  snprintf(path, sizeof(path), "%s/%s/new", root, t->name);
+  if (mutt_file_mkdir(path, S_IRWXU) != 0)
+    return false;
+  for (int i = 0; t->new[i]; i++)
+    if (!create_file(path, t->new[i]))
+      return false;
+
+  snprintf(path, sizeof(path), "%s/%s/cur", root, t->name);
+  if (mutt_file_mkdir(path, S_IRWXU) != 0)
+    return false;
+  for (int i = 0; t->cur[i]; i++)
+    if (!create_file(path, t->cur[i]))
+      return false;
+
+  return true;
+}
+
+/**
+ * create_mailboxes - Create a Mailbox for each test Maildir
+ * @param root      Parent directory
+ * @param mailboxes Array for the Mailboxes
+ */
+static void create_mailboxes(const char *root, struct Mailbox **mailboxes)
+{
+  for (size_t i = 0; i < NUM_MAILBOXES; i++)
+  {
+    struct Mailbox *m = mailbox_new();
+    buf_printf(&m->pathbuf, "%s/%s", root, Tests[i % mutt_array_size(Tests)].name);
+    m->type = MUTT_MAILDIR;
+    mailboxes[i] = m;
+  }
+}
+
+/**
+ * free_mailboxes - Free the test Mailboxes
+ * @param mailboxes Mailboxes to free
+ */
+static void free_mailboxes(struct Mailbox **mailboxes)
+{
+  for (size_t i = 0; i < NUM_MAILBOXES; i++)
+    mailbox_free(&mailboxes[i]);
+}
+
+/**
+ * check_sync - Check the Mailboxes one at a time, like `$mail_check_threads` = 0
+ * @param mailboxes   Mailboxes to check
+ * @param num         Number of Mailboxes
+ * @param check_stats Count the messages, too
+ */
+static void check_sync(struct Mailbox **mailboxes, size_t num, bool check_stats)
+{
+  for (size_t i = 0; i < num; i++)
+  {
+    struct MdCheckJob job = { 0 };
+    maildir_check_job_init(&job, mailboxes[i], check_stats);
+    maildir_check_job_run(&job);
+    maildir_check_job_apply(&job, mailboxes[i]);
+    FREE(&job.path);
+  }
+}
+
+/**
+ * check_threads - Check the Mailboxes using worker threads
+ * @param mailboxes   Mailboxes to check
+ * @param check_stats Count the messages, too
+ * @param num_threads Number of worker threads
+ */
+static void check_threads(struct Mailbox **mailboxes, bool check_stats, int num_threads)
+{
+  struct MdCheck *mc = maildir_check_new();
+  for (size_t i = 0; i < NUM_MAILBOXES; i++)
+    maildir_check_add(mc, mailboxes[i], check_stats);
+
+  maildir_check_start(mc, num_threads);
+
+  size_t applied = 0;
+  while (maildir_check_apply(mc, true))
+    applied++;
+
+  TEST_CHECK(applied == NUM_MAILBOXES);
+  TEST_CHECK(!maildir_check_busy(mc));
+  maildir_check_free(&mc);
+  TEST_CHECK(mc == NULL);
+}
+
+/**
+ * compare_mailboxes - Compare the results of two checks
+ * @param expected    Mailboxes checked one at a time
+ * @param actual      Mailboxes checked by worker threads
+ * @param check_cur   `$maildir_check_cur` was set
+ * @param check_stats The messages were counted
+ */
+static void compare_mailboxes(struct Mailbox **expected, struct Mailbox **actual,
+                              bool check_cur, bool check_stats)
+{
+  for (size_t i = 0; i < NUM_MAILBOXES; i++)
+  {
+    const struct CheckTest *t = &Tests[i % mutt_array_size(Tests)];
+    struct Mailbox *me = expected[i];
+    struct Mailbox *ma = actual[i];
+    TEST_CASE_("%s %zu", t->name, i);
+
+    const int msg_new = check_cur ? t->msg_new_cur : t->msg_new;
+    TEST_CHECK(me->type == MUTT_MAILDIR);
+    TEST_CHECK(me->has_new == (msg_new > 0));
+    if (check_stats)
+    {
+      TEST_CHECK(me->msg_count == t->msg_count);
+      TEST_CHECK(me->msg_unread == t->msg_unread);
+      TEST_CHECK(me->msg_flagged == t->msg_flagged);
+      TEST_CHECK(me->msg_new == msg_new);
+    }
+
+    TEST_CHECK(ma->type == me->type);
+    TEST_CHECK(ma->has_new == me->has_new);
+    TEST_CHECK(ma->msg_count == me->msg_count);
+    TEST_CHECK(ma->msg_unread == me->msg_unread);
+    TEST_CHECK(ma->msg_flagged == me->msg_flagged);
+    TEST_CHECK(ma->msg_new == me->msg_new);
+  }
+}
+
+void test_maildir_check(void)
+{
+  // struct MdCheck *maildir_check_new  (void);
+  // void            maildir_check_add  (struct MdCheck *mc, struct Mailbox *m, bool check_stats);
+  // void            maildir_check_start(struct MdCheck *mc, int num_threads);
+  // struct Mailbox *maildir_check_apply(struct MdCheck *mc, bool wait);
+  // bool            maildir_check_busy (struct MdCheck *mc);
+  // void            maildir_check_free (struct MdCheck **ptr);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  {
+    maildir_check_add(NULL, NULL, false);
+    maildir_check_start(NULL, 0);
+    TEST_CHECK(maildir_check_apply(NULL, true) == NULL);
+    TEST_CHECK(!maildir_check_busy(NULL));
+    maildir_check_free(NULL);
+  }
+
+  struct Buffer *root = buf_pool_get();
+  buf_mktemp(root);
+
+  for (size_t i = 0; i < mutt_array_size(Tests); i++)
+  {
+    if (!TEST_CHECK(create_maildir(buf_string(root), &Tests[i])))
+      goto done;
+  }
+
+  static const int thread_counts[] = { 0, 1, 4 };
+
+  for (int check_cur = 0; check_cur < 2; check_cur++)
+  {
+    cs_subset_str_native_set(NeoMutt->sub, "maildir_check_cur", check_cur, NULL);
+    for (int check_stats = 0; check_stats < 2; check_stats++)
+    {
+      for (size_t i = 0; i < mutt_array_size(thread_counts); i++)
+      {
+        TEST_CASE_("check_cur %d, check_stats %d, threads %d", check_cur,
+                   check_stats, thread_counts[i]);
+        struct Mailbox *expected[NUM_MAILBOXES] = { 0 };
+        struct Mailbox *actual[NUM_MAILBOXES] = { 0 };
+        create_mailboxes(buf_string(root), expected);
+        create_mailboxes(buf_string(root), actual);
+
+        check_sync(expected, NUM_MAILBOXES, check_stats);
+        check_threads(actual, check_stats, thread_counts[i]);
+        compare_mailboxes(expected, actual, check_cur, check_stats);
+
+        free_mailboxes(expected);
+        free_mailboxes(actual);
+      }
+    }
+  }
+  cs_subset_str_native_set(NeoMutt->sub, "maildir_check_cur", false, NULL);
+
+  {
+    TEST_CASE("Not a directory");
+    struct Buffer *path = buf_pool_get();
+    buf_printf(path, "%s/file", buf_string(root));
+    TEST_CHECK(create_file(buf_string(root), "file"));
+
+    struct Mailbox *m1 = mailbox_new();
+    buf_copy(&m1->pathbuf, path);
+    m1->type = MUTT_MAILDIR;
+    struct Mailbox *m2 = mailbox_new();
+    buf_copy(&m2->pathbuf, path);
+    m2->type = MUTT_MAILDIR;
+
+    check_sync(&m1, 1, true);
+    TEST_CHECK(m1->type == MUTT_UNKNOWN);
+
+    struct MdCheck *mc = maildir_check_new();
+    maildir_check_add(mc, m2, true);
+    maildir_check_start(mc, 1);
+    TEST_CHECK(maildir_check_apply(mc, true) == m2);
+    TEST_CHECK(maildir_check_apply(mc, true) == NULL);
+    maildir_check_free(&mc);
+    TEST_CHECK(m2->type == MUTT_UNKNOWN);
+    TEST_CHECK(m2->msg_count == m1->msg_count);
+
+    mailbox_free(&m1);
+    mailbox_free(&m2);
+    buf_pool_release(&path);
+  }
+
+  {
+    TEST_CASE("Missing directory");
+    struct Buffer *path = buf_pool_get();
+    buf_printf(path, "%s/missing/new", buf_string(root));
+    TEST_CHECK(mutt_file_mkdir(buf_string(path), S_IRWXU) == 0);
+    TEST_CHECK(create_file(buf_string(path), "1.apple"));
+    buf_printf(path, "%s/missing/cur", buf_string(root));
+
+    struct Mailbox *m = mailbox_new();
+    buf_printf(&m->pathbuf, "%s/missing", buf_string(root));
+    m->type = MUTT_MAILDIR;
+
+    // The check doesn't create cur/, it's left to the main thread
+    struct MdCheckJob job = { 0 };
+    maildir_check_job_init(&job, m, true);
+    maildir_check_job_run(&job);
+    TEST_CHECK(job.missing);
+    TEST_CHECK(access(buf_string(path), F_OK) != 0);
+
+    maildir_check_job_apply(&job, m);
+    FREE(&job.path);
+    TEST_CHECK(access(buf_string(path), F_OK) == 0);
+    TEST_CHECK(m->type == MUTT_MAILDIR);
+    TEST_CHECK(m->msg_count == 1);
+    TEST_CHECK(m->msg_new == 1);
+
+    mailbox_free(&m);
+    buf_pool_release(&path);
+  }
+
+  {
+    TEST_CASE("Mailbox deleted during the check");
+    struct Mailbox *m = mailbox_new();
+    buf_printf(&m->pathbuf, "%s/%s", buf_string(root), Tests[1].name);
+    m->type = MUTT_MAILDIR;
+
+    struct MdCheck *mc = maildir_check_new();
+    maildir_check_add(mc, m, true);
+    maildir_check_start(mc, 1);
+    mailbox_free(&m);
+    TEST_CHECK(maildir_check_apply(mc, true) == NULL);
+    TEST_CHECK(!maildir_check_busy(mc));
+    maildir_check_free(&mc);
+  }
+
+done:
+  mutt_file_rmtree(buf_string(root));
+  buf_pool_release(&root);
+}
@@ -0,0 +1,321 @@
+/**
+ * @file
+ * Test code for checking a Maildir using the Monitor's events
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <limits.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "gui/lib.h"
+#include "maildir/lib.h"
+#include "monitor.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "body_index",                  DT_BOOL,   false, 0, NULL, },
+  { "check_new",                   DT_BOOL,   true,  0, NULL, },
+  { "flag_safe",                   DT_BOOL,   false, 0, NULL, },
+  { "header_cache",                DT_PATH,   0,     0, NULL, },
+  { "maildir_header_cache_verify", DT_BOOL,   true,  0, NULL, },
+  { "maildir_read_threads",        DT_NUMBER, 0,     0, NULL, },
+  { "maildir_trash",               DT_BOOL,   false, 0, NULL, },
+  { "reply_regex",                 DT_REGEX,  IP "^((re)(\\[[0-9]+\\])*:[ \t]*)*", 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+static int ScanCount = 0;  ///< Number of files found by scanning the directories
+static int EventCount = 0; ///< Number of files found from the Monitor's events
+
+/**
+ * log_count_files - Count the files the Maildir check looks at - Implements ::log_dispatcher_t
+ */
+static int log_count_files(time_t stamp, const char *file, int line,
+                           const char *function, enum LogLevel level, ...)
+{
+  va_list ap;
+  va_start(ap, level);
+  const char *fmt = va_arg(ap, const char *);
+  va_end(ap);
+
+  if (!mutt_str_startswith(fmt, "queueing"))
+    return 0;
+
+  if (mutt_str_equal(function, "maildir_parse_dir"))
+    ScanCount++;
+  else if (mutt_str_equal(function, "maildir_check_events"))
+    EventCount++;
+  return 0;
+}
+
+/**
+ * create_file - Create a file containing a short email
+ * @param dir  Maildir
+ * @param name Filename, including the subdirectory
+ * @retval true Success
+ */
+static bool create_file(const char *dir, const char *name)
+{
+  char path[PATH_MAX] = { 0 };
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  FILE *fp = mutt_file_fopen(path, "w");
+  if (!fp)
+    return false;
+  fprintf(fp, "From: apple@example.com\nSubject: %s\n\nbanana\n", name);
+  mutt_file_fclose(&fp);
+  return true;
+}
+
+/**
+ * rename_file - Rename a file in a Maildir
+ * @param dir  Maildir
+ * @param from Old filename, including the subdirectory
+ * @param to   New filename, including the subdirectory
+ * @retval true Success
+ */
+static bool rename_file(const char *dir, const char *from, const char *to)
+{
+  char old_path[PATH_MAX] = { 0 };
+  char new_path[PATH_MAX] = { 0 };
+  snprintf(old_path, sizeof(old_path), "%s/%s", dir, from);
+  snprintf(new_path, sizeof(new_path), "%s/%s", dir, to);
+  return rename(old_path, new_path) == 0;
+}
+
+/**
+ * create_maildir - Create an empty Maildir
+ * @param dir Path of the Maildir
+ * @retval true Success
+ */
+static bool create_maildir(const char *dir)
+{
+  static const char *subdirs[] = { "tmp", "new", "cur" };
+  char path[PATH_MAX] = { 0 };
+
+  for (size_t i = 0; i < mutt_array_size(subdirs); i++)
+  {
+    snprintf(path, sizeof(path), "%s/%s", dir, subdirs[i]);
+    if (mutt_file_mkdir(path, S_IRWXU) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * find_email - Find an Email by its filename
+ * @param m    Mailbox
+ * @param path Filename, including the subdirectory
+ * @retval ptr  Matching Email
+ * @retval NULL No match
+ */
+static struct Email *find_email(struct Mailbox *m, const char *path)
+{
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (e && mutt_str_equal(e->path, path))
+      return e;
+  }
+  return NULL;
+}
+
+/**
+ * check_mailbox - Check the Maildir for changes
+ * @param m Mailbox
+ * @retval enum #MxStatus
+ */
+static enum MxStatus check_mailbox(struct Mailbox *m)
+{
+  ScanCount = 0;
+  EventCount = 0;
+  return MxMaildirOps.mbox_check(m);
+}
+
+void test_maildir_monitor(void)
+{
+  // static enum MxStatus maildir_check(struct Mailbox *m);
+  // int mutt_monitor_events(struct Mailbox *m, struct MonitorEventArray *events);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  log_dispatcher_t old_logger = MuttLogger;
+  MuttLogger = log_count_files;
+
+  struct Buffer *root = buf_pool_get();
+  buf_mktemp(root);
+  char path[PATH_MAX] = { 0 };
+  struct Mailbox *m = NULL;
+  struct Mailbox *m_other = NULL;
+
+  // The Monitor compares the Mailbox's real path
+  if (!TEST_CHECK(mutt_file_mkdir(buf_string(root), S_IRWXU) == 0) ||
+      !TEST_CHECK(realpath(buf_string(root), path) != NULL))
+  {
+    goto done;
+  }
+  buf_strcpy(root, path);
+
+  m = mailbox_new();
+  buf_printf(&m->pathbuf, "%s/current", buf_string(root));
+  m->realpath = buf_strdup(&m->pathbuf);
+  m->type = MUTT_MAILDIR;
+
+  m_other = mailbox_new();
+  buf_printf(&m_other->pathbuf, "%s/other", buf_string(root));
+  m_other->realpath = buf_strdup(&m_other->pathbuf);
+  m_other->type = MUTT_MAILDIR;
+
+  const char *dir = mailbox_path(m);
+  if (!TEST_CHECK(create_maildir(dir)) || !TEST_CHECK(create_maildir(mailbox_path(m_other))) ||
+      !TEST_CHECK(create_file(dir, "new/1.apple")) ||
+      !TEST_CHECK(create_file(dir, "cur/2.banana:2,S")))
+  {
+    goto done;
+  }
+
+  if (!TEST_CHECK(MxMaildirOps.mbox_open(m) == MX_OPEN_OK) ||
+      !TEST_CHECK(m->msg_count == 2))
+  {
+    goto done;
+  }
+
+  // Make the Mailbox current, like the Index does
+  TestCurrentMailbox = m;
+  // Don't let mutt_monitor_poll() wait
+  const int old_timeout = MuttGetchTimeout;
+  MuttGetchTimeout = 0;
+  TEST_CHECK(mutt_monitor_add(m_other) == 0);
+  TEST_CHECK(mutt_monitor_add(NULL) == 0);
+
+  {
+    TEST_CASE("First check");
+    // The Monitor has only just started, so its events can't be used yet
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_OK);
+    TEST_CHECK(m->msg_count == 2);
+    TEST_CHECK(EventCount == 0);
+  }
+
+  {
+    TEST_CASE("Nothing changed");
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_OK);
+    TEST_CHECK(m->msg_count == 2);
+    TEST_CHECK(ScanCount == 0);
+    TEST_CHECK(EventCount == 0);
+  }
+
+  {
+    TEST_CASE("Add");
+    TEST_CHECK(create_file(dir, "new/3.cherry"));
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_NEW_MAIL);
+    TEST_CHECK(m->msg_count == 3);
+    TEST_CHECK(find_email(m, "new/3.cherry") != NULL);
+    TEST_CHECK(ScanCount == 0);
+    TEST_CHECK(EventCount == 1);
+  }
+
+  {
+    TEST_CASE("Rename");
+    TEST_CHECK(rename_file(dir, "new/1.apple", "cur/1.apple:2,S"));
+    // The flags are set by mutt_set_flag(), which is a dummy here
+    check_mailbox(m);
+    TEST_CHECK(m->msg_count == 3);
+    TEST_CHECK(find_email(m, "cur/1.apple:2,S") != NULL);
+    TEST_CHECK(find_email(m, "new/1.apple") == NULL);
+    TEST_CHECK(ScanCount == 0);
+    TEST_CHECK(EventCount == 1);
+  }
+
+  {
+    TEST_CASE("Another Mailbox changes");
+    // The event is read by the check, but it's reported by the next poll
+    TEST_CHECK(create_file(mailbox_path(m_other), "new/4.damson"));
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_OK);
+    TEST_CHECK(ScanCount == 0);
+    mutt_monitor_poll();
+    TEST_CHECK(MonitorFilesChanged);
+  }
+
+  {
+    TEST_CASE("Overflow");
+    // Too many events for the inotify queue, or the Monitor, to hold.
+    // The Mailbox must be scanned, but none of the changes can be missed.
+    TEST_CHECK(create_file(dir, "new/5.elder"));
+    for (int i = 0; i < 16384; i++)
+    {
+      if (!rename_file(dir, "new/5.elder", "new/5.elder.tmp") ||
+          !rename_file(dir, "new/5.elder.tmp", "new/5.elder"))
+      {
+        TEST_CHECK(false);
+        break;
+      }
+    }
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_NEW_MAIL);
+    TEST_CHECK(m->msg_count == 4);
+    TEST_CHECK(find_email(m, "new/5.elder") != NULL);
+    TEST_CHECK(find_email(m, "new/5.elder.tmp") == NULL);
+    TEST_CHECK(ScanCount == 4);
+    TEST_CHECK(EventCount == 0);
+
+    // The lost events are reported as a change, too
+    mutt_monitor_poll();
+    TEST_CHECK(MonitorFilesChanged);
+
+    // Afterwards, the Monitor's events are used again
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_OK);
+    TEST_CHECK(ScanCount == 0);
+  }
+
+  {
+    TEST_CASE("Delete");
+    char file[PATH_MAX] = { 0 };
+    snprintf(file, sizeof(file), "%s/cur/2.banana:2,S", dir);
+    TEST_CHECK(unlink(file) == 0);
+    TEST_CHECK(check_mailbox(m) == MX_STATUS_REOPENED);
+    struct Email *e = find_email(m, "cur/2.banana:2,S");
+    TEST_CHECK((e != NULL) && e->deleted);
+    TEST_CHECK(ScanCount == 0);
+    TEST_CHECK(EventCount == 0);
+  }
+
+  mutt_monitor_remove(NULL);
+  mutt_monitor_remove(m_other);
+  TestCurrentMailbox = NULL;
+  MuttGetchTimeout = old_timeout;
+
+done:
+  mailbox_free(&m);
+  mailbox_free(&m_other);
+  mutt_file_rmtree(buf_string(root));
+  buf_pool_release(&root);
+  MuttLogger = old_logger;
+}
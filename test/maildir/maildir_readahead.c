@@ -0,0 +1,510 @@
+/**
+ * @file
+ * Test code for the Maildir Readahead
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "maildir/lib.h"
+#include "maildir/readahead.h"
+#include "test_common.h"
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#endif
+
+static const struct Mapping TestSortMethods[] = {
+  // clang-format off
+  { "unsorted", SORT_ORDER },
+  { NULL,       0 },
+  // clang-format on
+};
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "check_new",                    DT_BOOL,   true,  0, NULL, },
+  { "flag_safe",                    DT_BOOL,   false, 0, NULL, },
+  { "header_cache",                 DT_PATH,   0,     0, NULL, },
+  { "header_cache_backend",         DT_STRING, 0,     0, NULL, },
+  { "header_cache_compress_method", DT_STRING, 0,     0, NULL, },
+  { "maildir_header_cache_verify",  DT_BOOL,   true,  0, NULL, },
+  { "maildir_read_threads",         DT_NUMBER, 0,     0, NULL, },
+  { "maildir_trash",                DT_BOOL,   false, 0, NULL, },
+  { "mh_seq_flagged",               DT_STRING, IP "flagged", 0, NULL, },
+  { "mh_seq_replied",               DT_STRING, IP "replied", 0, NULL, },
+  { "mh_seq_unseen",                DT_STRING, IP "unseen",  0, NULL, },
+  { "reply_regex",                  DT_REGEX,  IP "^((re)(\\[[0-9]+\\])*:[ \t]*)*", 0, NULL, },
+  { "sort",                         DT_SORT,   SORT_ORDER, IP TestSortMethods, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/// Number of worker threads started by maildir_readahead_start()
+static int ThreadCount = -1;
+
+/**
+ * log_count_threads - Find out how many threads were started - Implements ::log_dispatcher_t
+ */
+static int log_count_threads(time_t stamp, const char *file, int line,
+                             const char *function, enum LogLevel level, ...)
+{
+  if (!mutt_str_equal(function, "maildir_readahead_start"))
+    return 0;
+
+  va_list ap;
+  va_start(ap, level);
+  const char *fmt = va_arg(ap, const char *);
+  if (mutt_str_startswith(fmt, "reading"))
+  {
+    (void) va_arg(ap, size_t);
+    ThreadCount = va_arg(ap, int);
+  }
+  va_end(ap);
+  return 0;
+}
+
+/**
+ * enum MessageKind - Shapes of message file
+ */
+enum MessageKind
+{
+  MSG_PLAIN,        ///< Short header and body
+  MSG_CRLF,         ///< Lines end in CRLF
+  MSG_LONG_HEADER,  ///< Header is longer than the first read
+  MSG_NO_BODY,      ///< No blank line after the header
+  MSG_EMPTY,        ///< Empty file
+};
+
+/**
+ * create_message - Create a message file
+ * @param path Path of the file
+ * @param kind Shape of the message, e.g. #MSG_CRLF
+ * @param num  Number used in the Subject
+ * @retval true Success
+ */
+static bool create_message(const char *path, enum MessageKind kind, int num)
+{
+  FILE *fp = mutt_file_fopen(path, "w");
+  if (!fp)
+    return false;
+
+  const char *eol = (kind == MSG_CRLF) ? "\r\n" : "\n";
+  if (kind != MSG_EMPTY)
+  {
+    fprintf(fp, "From: apple@example.com%s", eol);
+    fprintf(fp, "Message-Id: <%d@example.com>%s", num, eol);
+    fprintf(fp, "Date: Mon, 1 Jan 2024 00:%02d:00 +0000%s", num % 60, eol);
+    if (kind == MSG_LONG_HEADER)
+    {
+      for (int i = 0; i < 200; i++)
+        fprintf(fp, "X-Padding-%03d: %040d\n", i, i);
+    }
+    fprintf(fp, "Subject: message %d%s", num, eol);
+    if (kind != MSG_NO_BODY)
+      fprintf(fp, "%sbanana%scherry%s", eol, eol, eol);
+  }
+
+  mutt_file_fclose(&fp);
+  return true;
+}
+
+/**
+ * create_mailbox - Create a Maildir or MH mailbox full of messages
+ * @param dir  Path of the mailbox
+ * @param type Mailbox type, #MUTT_MAILDIR or #MUTT_MH
+ * @param num  Number of messages
+ * @retval num Number of messages that aren't empty
+ * @retval -1  Error
+ *
+ * The messages cycle through the #MessageKind shapes.  An MH mailbox gets no
+ * empty messages, because the MH reader can't sort a mailbox containing them.
+ */
+static int create_mailbox(const char *dir, enum MailboxType type, int num)
+{
+  static const char *maildir_names[] = {
+    "new/%03d.apple", "cur/%03d.banana:2,S", "cur/%03d.cherry:2,FS", "cur/%03d.damson:2,",
+  };
+  static const char *subdirs[] = { "tmp", "new", "cur" };
+  struct Buffer *path = buf_pool_get();
+  char name[64] = { 0 };
+  const int num_kinds = (type == MUTT_MAILDIR) ? (MSG_EMPTY + 1) : MSG_EMPTY;
+  int count = 0;
+  int rc = -1;
+
+  if (mutt_file_mkdir(dir, S_IRWXU) != 0)
+    goto done;
+  if (type == MUTT_MAILDIR)
+  {
+    for (size_t i = 0; i < mutt_array_size(subdirs); i++)
+    {
+      buf_printf(path, "%s/%s", dir, subdirs[i]);
+      if (mutt_file_mkdir(buf_string(path), S_IRWXU) != 0)
+        goto done;
+    }
+  }
+  else
+  {
+    buf_printf(path, "%s/.mh_sequences", dir);
+    if (!create_message(buf_string(path), MSG_EMPTY, 0))
+      goto done;
+  }
+
+  for (int i = 1; i <= num; i++)
+  {
+    if (type == MUTT_MAILDIR)
+      snprintf(name, sizeof(name), maildir_names[i % mutt_array_size(maildir_names)], i);
+    else
+      snprintf(name, sizeof(name), "%d", i);
+    buf_printf(path, "%s/%s", dir, name);
+    if (!create_message(buf_string(path), i % num_kinds, i))
+      goto done;
+    if ((i % num_kinds) != MSG_EMPTY)
+      count++;
+  }
+  rc = count;
+
+done:
+  buf_pool_release(&path);
+  return rc;
+}
+
+/**
+ * open_mailbox - Open a Maildir or MH mailbox
+ * @param dir         Path of the mailbox
+ * @param type        Mailbox type, #MUTT_MAILDIR or #MUTT_MH
+ * @param num_threads Value for `$maildir_read_threads`
+ * @retval ptr Mailbox, or NULL on failure
+ */
+static struct Mailbox *open_mailbox(const char *dir, enum MailboxType type, int num_threads)
+{
+  cs_subset_str_native_set(NeoMutt->sub, "maildir_read_threads", num_threads, NULL);
+
+  struct Mailbox *m = mailbox_new();
+  buf_strcpy(&m->pathbuf, dir);
+  m->type = type;
+
+  const struct MxOps *ops = (type == MUTT_MAILDIR) ? &MxMaildirOps : &MxMhOps;
+  ThreadCount = -1;
+  if (ops->mbox_open(m) != MX_OPEN_OK)
+    mailbox_free(&m);
+  return m;
+}
+
+/**
+ * compare_emails - Check that two Emails were parsed identically
+ * @param e1 First Email
+ * @param e2 Second Email
+ */
+static void compare_emails(const struct Email *e1, const struct Email *e2)
+{
+  TEST_CHECK_STR_EQ(e1->path, e2->path);
+  TEST_CHECK_STR_EQ(e1->env->subject, e2->env->subject);
+  TEST_CHECK_STR_EQ(e1->env->message_id, e2->env->message_id);
+  TEST_CHECK(e1->date_sent == e2->date_sent);
+  TEST_CHECK(e1->received == e2->received);
+  TEST_CHECK(e1->body->offset == e2->body->offset);
+  TEST_CHECK(e1->body->length == e2->body->length);
+  TEST_CHECK(e1->read == e2->read);
+  TEST_CHECK(e1->flagged == e2->flagged);
+  TEST_CHECK(e1->old == e2->old);
+}
+
+/**
+ * test_parse_order - Parse a mailbox with and without threads
+ * @param root Temporary directory
+ * @param type Mailbox type, #MUTT_MAILDIR or #MUTT_MH
+ */
+static void test_parse_order(const char *root, enum MailboxType type)
+{
+  // More messages than the window, so the workers have to wait for the caller
+  const int num = READAHEAD_WINDOW + 100;
+  struct Buffer *dir = buf_pool_get();
+  buf_printf(dir, "%s/%s", root, mailbox_get_type_name(type));
+  struct Mailbox *m_sync = NULL;
+
+  // The empty messages are skipped
+  const int expected = create_mailbox(buf_string(dir), type, num);
+  if (!TEST_CHECK(expected > 0))
+    goto done;
+
+  m_sync = open_mailbox(buf_string(dir), type, 0);
+  if (!TEST_CHECK(m_sync != NULL))
+    goto done;
+  TEST_CHECK(ThreadCount == -1);
+  TEST_CHECK(m_sync->msg_count == expected);
+  TEST_MSG("Expected %d, Got %d", expected, m_sync->msg_count);
+
+  static const int threads[] = { 1, 4, 16 };
+  for (size_t i = 0; i < mutt_array_size(threads); i++)
+  {
+    TEST_CASE_("%s, %d threads", mailbox_get_type_name(type), threads[i]);
+    struct Mailbox *m = open_mailbox(buf_string(dir), type, threads[i]);
+    if (!TEST_CHECK(m != NULL))
+      continue;
+
+    TEST_CHECK(ThreadCount == threads[i]);
+    if (TEST_CHECK(m->msg_count == m_sync->msg_count))
+    {
+      for (int j = 0; j < m->msg_count; j++)
+        compare_emails(m_sync->emails[j], m->emails[j]);
+    }
+    mailbox_free(&m);
+  }
+
+  // Without threads, the Maildir is parsed the same way as a single message
+  if (type == MUTT_MAILDIR)
+  {
+    TEST_CASE("maildir, maildir_parse_message()");
+    struct Buffer *path = buf_pool_get();
+    for (int i = 0; i < m_sync->msg_count; i++)
+    {
+      struct Email *e1 = m_sync->emails[i];
+      struct Email *e2 = maildir_email_new(NULL);
+      e2->path = mutt_str_dup(e1->path);
+      buf_printf(path, "%s/%s", buf_string(dir), e1->path);
+      TEST_CHECK(maildir_parse_message(MUTT_MAILDIR, buf_string(path), e1->old, e2));
+      compare_emails(e1, e2);
+      email_free(&e2);
+    }
+    buf_pool_release(&path);
+  }
+
+done:
+  mailbox_free(&m_sync);
+  buf_pool_release(&dir);
+}
+
+/**
+ * check_read - Check a file read by the Readahead
+ * @param mr  File contents
+ * @param num Number used in the Subject
+ */
+static void check_read(const struct MdRead *mr, int num)
+{
+  char subject[64] = { 0 };
+  snprintf(subject, sizeof(subject), "Subject: message %d\n", num);
+
+  if (!TEST_CHECK(mr != NULL))
+    return;
+  TEST_CHECK(mr->done);
+  TEST_CHECK(mr->err == 0);
+  TEST_MSG("Error %d reading %s", mr->err, mr->path);
+  TEST_CHECK(mr->data && (mr->len > 0) && mutt_strn_equal(mr->data, "From: ", 6));
+  TEST_CHECK((mr->len <= mr->size) && (mr->size > 0));
+
+  // The whole header has been read
+  TEST_CHECK(mr->data && mutt_strn_rfind(mr->data, mr->len, subject));
+}
+
+void test_maildir_readahead(void)
+{
+  // void                 maildir_readahead_add    (struct MdReadahead *ra, const char *path);
+  // void                 maildir_readahead_free   (struct MdReadahead **ptr);
+  // const struct MdRead *maildir_readahead_get    (struct MdReadahead *ra, size_t idx);
+  // struct MdReadahead * maildir_readahead_new    (void);
+  // void                 maildir_readahead_release(struct MdReadahead *ra, size_t idx);
+  // void                 maildir_readahead_start  (struct MdReadahead *ra, int num_threads);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  log_dispatcher_t old_logger = MuttLogger;
+  MuttLogger = log_count_threads;
+
+  struct Buffer *root = buf_pool_get();
+  buf_mktemp(root);
+  struct Buffer *path = buf_pool_get();
+  struct Buffer *dir = buf_pool_get();
+
+  if (!TEST_CHECK(mutt_file_mkdir(buf_string(root), S_IRWXU) == 0))
+    goto done;
+
+  buf_printf(dir, "%s/plain", buf_string(root));
+  const int num = READAHEAD_WINDOW + 50;
+  if (!TEST_CHECK(mutt_file_mkdir(buf_string(dir), S_IRWXU) == 0))
+    goto done;
+  for (int i = 0; i < num; i++)
+  {
+    buf_printf(path, "%s/%d", buf_string(dir), i);
+    if (!TEST_CHECK(create_message(buf_string(path), (i == 7) ? MSG_LONG_HEADER : MSG_PLAIN, i)))
+      goto done;
+  }
+
+  {
+    struct MdReadahead *ra = NULL;
+    maildir_readahead_add(NULL, "apple");
+    maildir_readahead_add(ra, NULL);
+    maildir_readahead_start(NULL, 4);
+    TEST_CHECK(maildir_readahead_get(NULL, 0) == NULL);
+    maildir_readahead_release(NULL, 0);
+    maildir_readahead_free(NULL);
+    maildir_readahead_free(&ra);
+
+    ra = maildir_readahead_new();
+    TEST_CHECK(maildir_readahead_get(ra, 0) == NULL);
+    maildir_readahead_start(ra, 4);
+    maildir_readahead_free(&ra);
+  }
+
+  {
+    TEST_CASE("Window");
+    struct MdReadahead *ra = maildir_readahead_new();
+    for (int i = 0; i < num; i++)
+    {
+      buf_printf(path, "%s/%d", buf_string(dir), i);
+      maildir_readahead_add(ra, buf_string(path));
+    }
+    maildir_readahead_start(ra, 4);
+    TEST_CHECK(ThreadCount == 4);
+
+    // Nothing has been released, so the workers must stop at the end of the
+    // window.  Give them time to go further, then delete the rest of the files.
+    check_read(maildir_readahead_get(ra, READAHEAD_WINDOW - 1), READAHEAD_WINDOW - 1);
+    mutt_date_sleep_ms(100);
+    for (int i = READAHEAD_WINDOW; i < num; i++)
+    {
+      buf_printf(path, "%s/%d", buf_string(dir), i);
+      TEST_CHECK(unlink(buf_string(path)) == 0);
+    }
+
+    for (int i = 0; i < num; i++)
+    {
+      const struct MdRead *mr = maildir_readahead_get(ra, i);
+      if (i < READAHEAD_WINDOW)
+      {
+        check_read(mr, i);
+      }
+      else
+      {
+        TEST_CHECK((mr != NULL) && (mr->err == ENOENT) && !mr->data);
+        TEST_MSG("File %d was read before it was needed", i);
+      }
+      maildir_readahead_release(ra, i);
+      TEST_CHECK(!mr->data);
+    }
+    maildir_readahead_free(&ra);
+
+    for (int i = READAHEAD_WINDOW; i < num; i++)
+    {
+      buf_printf(path, "%s/%d", buf_string(dir), i);
+      TEST_CHECK(create_message(buf_string(path), MSG_PLAIN, i));
+    }
+  }
+
+  {
+    TEST_CASE("No threads");
+    struct MdReadahead *ra = maildir_readahead_new();
+    for (int i = 0; i < 10; i++)
+    {
+      buf_printf(path, "%s/%d", buf_string(dir), i);
+      maildir_readahead_add(ra, buf_string(path));
+    }
+    ThreadCount = -1;
+    maildir_readahead_start(ra, 0);
+    TEST_CHECK(ThreadCount == -1);
+
+    // The files are read on demand
+    buf_printf(path, "%s/%d", buf_string(dir), 9);
+    TEST_CHECK(unlink(buf_string(path)) == 0);
+    for (int i = 0; i < 10; i++)
+    {
+      const struct MdRead *mr = maildir_readahead_get(ra, i);
+      if (i < 9)
+        check_read(mr, i);
+      else
+        TEST_CHECK((mr != NULL) && (mr->err == ENOENT));
+      maildir_readahead_release(ra, i);
+    }
+    maildir_readahead_free(&ra);
+    TEST_CHECK(create_message(buf_string(path), MSG_PLAIN, 9));
+  }
+
+#if defined(HAVE_PTHREAD_CREATE) && defined(__GLIBC__)
+  {
+    // Ask for thread stacks larger than the address space allows
+    TEST_CASE("Threads can't start");
+    pthread_attr_t attr_old;
+    pthread_attr_t attr;
+    struct rlimit rl_old = { 0 };
+    struct rlimit rl = { 0 };
+    long pages = 0;
+    FILE *fp = mutt_file_fopen("/proc/self/statm", "r");
+    if (TEST_CHECK(fp && (fscanf(fp, "%ld", &pages) == 1)) &&
+        TEST_CHECK(getrlimit(RLIMIT_AS, &rl_old) == 0) &&
+        TEST_CHECK(pthread_getattr_default_np(&attr_old) == 0))
+    {
+      struct MdReadahead *ra = maildir_readahead_new();
+      for (int i = 0; i < 10; i++)
+      {
+        buf_printf(path, "%s/%d", buf_string(dir), i);
+        maildir_readahead_add(ra, buf_string(path));
+      }
+
+      pthread_attr_init(&attr);
+      pthread_attr_setstacksize(&attr, (size_t) 1 << 40);
+      rl = rl_old;
+      rl.rlim_cur = (pages * sysconf(_SC_PAGESIZE)) + (64 * 1024 * 1024);
+      TEST_CHECK(pthread_setattr_default_np(&attr) == 0);
+      TEST_CHECK(setrlimit(RLIMIT_AS, &rl) == 0);
+      maildir_readahead_start(ra, 4);
+      TEST_CHECK(setrlimit(RLIMIT_AS, &rl_old) == 0);
+      TEST_CHECK(pthread_setattr_default_np(&attr_old) == 0);
+      pthread_attr_destroy(&attr);
+      pthread_attr_destroy(&attr_old);
+      TEST_CHECK(ThreadCount == 0);
+      TEST_MSG("%d threads were started", ThreadCount);
+
+      // The caller reads the files itself
+      for (int i = 0; i < 10; i++)
+      {
+        check_read(maildir_readahead_get(ra, i), i);
+        maildir_readahead_release(ra, i);
+      }
+      maildir_readahead_free(&ra);
+    }
+    mutt_file_fclose(&fp);
+  }
+#endif
+
+  {
+    TEST_CASE("Parse order");
+    test_parse_order(buf_string(root), MUTT_MAILDIR);
+    test_parse_order(buf_string(root), MUTT_MH);
+  }
+
+done:
+  mutt_file_rmtree(buf_string(root));
+  buf_pool_release(&root);
+  buf_pool_release(&path);
+  buf_pool_release(&dir);
+  MuttLogger = old_logger;
+}
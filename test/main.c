@@ -84,6 +84,7 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_mutt_b64_buffer_decode)                               \
   NEOMUTT_TEST_ITEM(test_mutt_b64_buffer_encode)                               \
   NEOMUTT_TEST_ITEM(test_mutt_b64_decode)                                      \
+  NEOMUTT_TEST_ITEM(test_mutt_b64_decode_stream)                               \
   NEOMUTT_TEST_ITEM(test_mutt_b64_encode)                                      \
                                                                                \
   /* body */                                                                   \
@@ -129,6 +130,7 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_buf_upper)                                            \
                                                                                \
   /* charset */                                                                \
+  NEOMUTT_TEST_ITEM(test_mutt_ch_cache_stats)                                  \
   NEOMUTT_TEST_ITEM(test_mutt_ch_canonical_charset)                            \
   NEOMUTT_TEST_ITEM(test_mutt_ch_charset_lookup)                               \
   NEOMUTT_TEST_ITEM(test_mutt_ch_check)                                        \
@@ -157,6 +159,7 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_config_cache)                                         \
   NEOMUTT_TEST_ITEM(test_config_dump)                                          \
   NEOMUTT_TEST_ITEM(test_config_enum)                                          \
+  NEOMUTT_TEST_ITEM(test_config_handle)                                        \
   NEOMUTT_TEST_ITEM(test_config_helpers)                                       \
   NEOMUTT_TEST_ITEM(test_config_initial)                                       \
   NEOMUTT_TEST_ITEM(test_config_long)                                          \
@@ -174,12 +177,17 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_config_synonym)                                       \
   NEOMUTT_TEST_ITEM(test_config_variable)                                      \
                                                                                \
+  /* conn */                                                                   \
+  NEOMUTT_TEST_ITEM(test_socket_buffer)                                        \
   /* convert */                                                                \
   NEOMUTT_TEST_ITEM(test_mutt_convert_file_to)                                 \
   NEOMUTT_TEST_ITEM(test_mutt_convert_file_from_to)                            \
   NEOMUTT_TEST_ITEM(test_mutt_update_content_info)                             \
   NEOMUTT_TEST_ITEM(test_mutt_get_content_info)                                \
                                                                                \
+  /* copy */                                                                   \
+  NEOMUTT_TEST_ITEM(test_mutt_copy_status_flags)                               \
+                                                                               \
   /* core */                                                                   \
   NEOMUTT_TEST_ITEM(test_buf_mktemp_full)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_file_mkstemp_full)                               \
@@ -206,7 +214,9 @@ void test_fini(void);
   /* email */                                                                  \
   NEOMUTT_TEST_ITEM(test_email_cmp_strict)                                     \
   NEOMUTT_TEST_ITEM(test_email_free)                                           \
+  NEOMUTT_TEST_ITEM(test_email_materialize)                                    \
   NEOMUTT_TEST_ITEM(test_email_new)                                            \
+  NEOMUTT_TEST_ITEM(test_email_new_arena)                                      \
   NEOMUTT_TEST_ITEM(test_email_size)                                           \
   NEOMUTT_TEST_ITEM(test_mutt_autocrypthdr_free)                               \
   NEOMUTT_TEST_ITEM(test_mutt_autocrypthdr_new)                                \
@@ -358,8 +368,19 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_mutt_idna_to_ascii_lz)                                \
                                                                                \
   /* imap */                                                                   \
+  NEOMUTT_TEST_ITEM(test_imap_fetch)                                           \
   NEOMUTT_TEST_ITEM(test_imap_msg_set)                                         \
                                                                                \
+  /* index */                                                                  \
+  NEOMUTT_TEST_ITEM(test_index_row_color_get)                                  \
+  NEOMUTT_TEST_ITEM(test_index_row_format_is_cacheable)                        \
+  NEOMUTT_TEST_ITEM(test_index_row_get)                                        \
+                                                                               \
+  /* intern */                                                                 \
+  NEOMUTT_TEST_ITEM(test_mutt_intern_free)                                     \
+  NEOMUTT_TEST_ITEM(test_mutt_intern_get)                                      \
+  NEOMUTT_TEST_ITEM(test_mutt_intern_replace)                                  \
+                                                                               \
   /* list */                                                                   \
   NEOMUTT_TEST_ITEM(test_mutt_list_clear)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_list_compare)                                    \
@@ -400,11 +421,18 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_mailbox_size_sub)                                     \
   NEOMUTT_TEST_ITEM(test_mailbox_update)                                       \
                                                                                \
+  /* maildir */                                                                \
+  NEOMUTT_TEST_ITEM(test_maildir_check)                                        \
+  NEOMUTT_TEST_ITEM(test_maildir_readahead)                                    \
+                                                                               \
   /* mapping */                                                                \
   NEOMUTT_TEST_ITEM(test_mutt_map_get_name)                                    \
   NEOMUTT_TEST_ITEM(test_mutt_map_get_value)                                   \
   NEOMUTT_TEST_ITEM(test_mutt_map_get_value_n)                                 \
                                                                                \
+  /* mbox */                                                                   \
+  NEOMUTT_TEST_ITEM(test_mbox_patch_status)                                    \
+                                                                               \
   /* mbyte */                                                                  \
   NEOMUTT_TEST_ITEM(test_mutt_mb_charlen)                                      \
   NEOMUTT_TEST_ITEM(test_mutt_mb_filter_unprintable)                           \
@@ -450,6 +478,9 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_notify_send)                                          \
   NEOMUTT_TEST_ITEM(test_notify_set_parent)                                    \
                                                                                \
+  /* pager */                                                                  \
+  NEOMUTT_TEST_ITEM(test_pager_stream_read)                                    \
+                                                                               \
   /* parameter */                                                              \
   NEOMUTT_TEST_ITEM(test_mutt_param_cmp_strict)                                \
   NEOMUTT_TEST_ITEM(test_mutt_param_delete)                                    \
@@ -475,7 +506,9 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_mutt_rfc822_parse_line)                               \
   NEOMUTT_TEST_ITEM(test_mutt_rfc822_parse_message)                            \
   NEOMUTT_TEST_ITEM(test_mutt_rfc822_read_header)                              \
+  NEOMUTT_TEST_ITEM(test_mutt_rfc822_read_header_mem)                          \
   NEOMUTT_TEST_ITEM(test_mutt_rfc822_read_line)                                \
+  NEOMUTT_TEST_ITEM(test_mutt_rfc822_read_line_mem)                            \
   NEOMUTT_TEST_ITEM(test_parse_extract_token)                                  \
   NEOMUTT_TEST_ITEM(test_parse_rc)                                             \
   NEOMUTT_TEST_ITEM(test_parse_set)                                            \
@@ -498,8 +531,12 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_mutt_path_to_absolute)                                \
                                                                                \
   /* pattern */                                                                \
+  NEOMUTT_TEST_ITEM(test_body_index_query)                                     \
   NEOMUTT_TEST_ITEM(test_mutt_pattern_comp)                                    \
+  NEOMUTT_TEST_ITEM(test_mutt_pattern_exec)                                    \
+  NEOMUTT_TEST_ITEM(test_mutt_pattern_has_date)                                \
   NEOMUTT_TEST_ITEM(test_mutt_pattern_leak)                                    \
+  NEOMUTT_TEST_ITEM(test_pattern_exec_emails)                                  \
                                                                                \
   /* prex */                                                                   \
   NEOMUTT_TEST_ITEM(test_mutt_prex_capture)                                    \
@@ -560,6 +597,7 @@ void test_fini(void);
                                                                                \
   /* sort */                                                                   \
   NEOMUTT_TEST_ITEM(test_mutt_qsort_r)                                         \
+  NEOMUTT_TEST_ITEM(test_mutt_sort_headers)                                    \
                                                                                \
   /* string */                                                                 \
   NEOMUTT_TEST_ITEM(test_mutt_istr_equal)                                      \
@@ -621,6 +659,7 @@ void test_fini(void);
   NEOMUTT_TEST_ITEM(test_insert_message)                                       \
   NEOMUTT_TEST_ITEM(test_is_descendant)                                        \
   NEOMUTT_TEST_ITEM(test_mutt_break_thread)                                    \
+  NEOMUTT_TEST_ITEM(test_mutt_sort_threads)                                    \
   NEOMUTT_TEST_ITEM(test_unlink_message)                                       \
                                                                                \
   /* url */                                                                    \
@@ -641,6 +680,13 @@ NEOMUTT_TEST_LIST
 #if defined(USE_LZ4) || defined(USE_ZLIB) || defined(USE_ZSTD)
   NEOMUTT_TEST_ITEM(test_compress_common)
 #endif
+#ifdef USE_HCACHE
+  NEOMUTT_TEST_ITEM(test_hcache_serialize)
+  NEOMUTT_TEST_ITEM(test_mbox_hcache)
+#endif
+#ifdef USE_INOTIFY
+  NEOMUTT_TEST_ITEM(test_maildir_monitor)
+#endif
 #ifdef USE_LZ4
   NEOMUTT_TEST_ITEM(test_compress_lz4)
 #endif
@@ -693,6 +739,13 @@ TEST_LIST = {
 #if defined(USE_LZ4) || defined(USE_ZLIB) || defined(USE_ZSTD)
 NEOMUTT_TEST_ITEM(test_compress_common)
 #endif
+#ifdef USE_HCACHE
+  NEOMUTT_TEST_ITEM(test_hcache_serialize)
+  NEOMUTT_TEST_ITEM(test_mbox_hcache)
+#endif
+#ifdef USE_INOTIFY
+  NEOMUTT_TEST_ITEM(test_maildir_monitor)
+#endif
 #ifdef USE_LZ4
   NEOMUTT_TEST_ITEM(test_compress_lz4)
 #endif
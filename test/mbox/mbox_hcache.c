@@ -0,0 +1,339 @@
+/**
+ * @file
+ * Test code for reading an mbox Mailbox from the header cache
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "mbox/lib.h"
+#include "mutt_thread.h"
+#include "test_common.h"
+
+static const struct Mapping TestSortMethods[] = {
+  // clang-format off
+  { "unsorted", SORT_ORDER },
+  { NULL,       0 },
+  // clang-format on
+};
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "auto_subscribe",               DT_BOOL,   false,  0, NULL, },
+  { "check_mbox_size",              DT_BOOL,   false,  0, NULL, },
+  { "header_cache",                 DT_PATH,   0,      0, NULL, },
+  { "header_cache_backend",         DT_STRING, IP "gdbm", 0, NULL, },
+  { "header_cache_compress_level",  DT_NUMBER, 1,      0, NULL, },
+  { "header_cache_compress_method", DT_STRING, 0,      0, NULL, },
+  { "mail_check_recent",            DT_BOOL,   true,   0, NULL, },
+  { "reply_regex",                  DT_REGEX,  IP "^((re)(\\[[0-9]+\\])*:[ \t]*)*", 0, NULL, },
+  { "sort",                         DT_SORT,   SORT_ORDER, IP TestSortMethods, NULL, },
+  { "use_threads",                  DT_ENUM,   UT_FLAT, IP &UseThreadsTypeDef, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * add_message - Append a message to an mbox file
+ * @param path    Path of the mbox file
+ * @param from    Sender, used in the From_ line
+ * @param subject Subject of the message
+ * @retval true Success
+ */
+static bool add_message(const char *path, const char *from, const char *subject)
+{
+  FILE *fp = mutt_file_fopen(path, "a");
+  if (!fp)
+    return false;
+  fprintf(fp, "From %s Mon Jan  1 00:00:00 2024\nFrom: %s\nSubject: %s\n\nHello\n\n",
+          from, from, subject);
+  mutt_file_fclose(&fp);
+  return true;
+}
+
+/**
+ * edit_file - Change some text in a file without changing its size
+ * @param path       Path of the file
+ * @param old_text   Text to replace
+ * @param new_text   Replacement, the same length as old_text
+ * @param keep_mtime If true, the file keeps its modification time
+ * @retval true Success
+ *
+ * If the mtime isn't kept, it's moved forward, as if the file had been
+ * rewritten by another program.
+ */
+static bool edit_file(const char *path, const char *old_text, const char *new_text, bool keep_mtime)
+{
+  struct stat st = { 0 };
+  char buf[4096] = { 0 };
+  bool rc = false;
+
+  FILE *fp = mutt_file_fopen(path, "r+");
+  if (!fp || (fstat(fileno(fp), &st) != 0))
+    goto done;
+
+  const size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+  const char *found = strstr(buf, old_text);
+  if ((len == 0) || !found || (strlen(old_text) != strlen(new_text)))
+    goto done;
+
+  if (!mutt_file_seek(fp, found - buf, SEEK_SET) || (fputs(new_text, fp) == EOF))
+    goto done;
+  if (mutt_file_fclose(&fp) != 0)
+    goto done;
+
+  struct timespec ts[2] = { st.st_atim, st.st_mtim };
+  if (!keep_mtime)
+    ts[1].tv_sec++;
+  rc = (utimensat(AT_FDCWD, path, ts, 0) == 0);
+
+done:
+  mutt_file_fclose(&fp);
+  return rc;
+}
+
+/**
+ * open_mbox - Open an mbox Mailbox
+ * @param path Path of the mbox file
+ * @retval ptr Mailbox, or NULL on failure
+ */
+static struct Mailbox *open_mbox(const char *path)
+{
+  struct Mailbox *m = mailbox_new();
+  buf_strcpy(&m->pathbuf, path);
+  m->type = MUTT_MBOX;
+  m->account = account_new(NULL, NeoMutt->sub);
+  m->account->type = MUTT_MBOX;
+
+  if (MxMboxOps.mbox_open(m) != MX_OPEN_OK)
+  {
+    account_free(&m->account);
+    mailbox_free(&m);
+  }
+  return m;
+}
+
+/**
+ * close_mbox - Close an mbox Mailbox
+ * @param ptr Mailbox to close
+ */
+static void close_mbox(struct Mailbox **ptr)
+{
+  struct Mailbox *m = *ptr;
+  if (!m)
+    return;
+
+  MxMboxOps.mbox_close(m);
+  account_free(&m->account);
+  mailbox_free(ptr);
+}
+
+/**
+ * check_subjects - Check the Subjects of a Mailbox's Emails
+ * @param m        Mailbox
+ * @param subjects Expected Subjects, NULL-terminated
+ */
+static void check_subjects(struct Mailbox *m, const char **subjects)
+{
+  int count = 0;
+  for (; subjects[count]; count++)
+  {
+    if (!TEST_CHECK(count < m->msg_count))
+      return;
+    struct Email *e = m->emails[count];
+    TEST_CHECK_STR_EQ(e->env->subject, subjects[count]);
+    TEST_CHECK(e->index == count);
+  }
+  TEST_CHECK(m->msg_count == count);
+  TEST_MSG("Expected %d, Got %d", count, m->msg_count);
+}
+
+/**
+ * create_mbox - Create an mbox and fill the header cache
+ * @param path  Path of the mbox file
+ * @param cache Directory for the header cache
+ * @retval true Success
+ *
+ * The mbox contains three messages: apple, banana and cherry.
+ */
+static bool create_mbox(const char *path, const char *cache)
+{
+  mutt_file_unlink(path);
+  mutt_file_rmtree(cache);
+  if ((mutt_file_mkdir(cache, S_IRWXU) != 0) ||
+      !add_message(path, "apple@example.com", "apple") ||
+      !add_message(path, "banana@example.com", "banana") ||
+      !add_message(path, "cherry@example.com", "cherry"))
+  {
+    return false;
+  }
+
+  struct Mailbox *m = open_mbox(path);
+  if (!m)
+    return false;
+
+  const bool rc = (m->msg_count == 3);
+  close_mbox(&m);
+  return rc;
+}
+
+void test_mbox_hcache(void)
+{
+  // static enum MxOpenReturns mbox_mbox_open(struct Mailbox *m);
+  // static enum MxStatus mbox_mbox_sync(struct Mailbox *m);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  struct Buffer *root = buf_pool_get();
+  struct Buffer *path = buf_pool_get();
+  struct Buffer *cache = buf_pool_get();
+  struct Mailbox *m = NULL;
+
+  buf_mktemp(root);
+  if (!TEST_CHECK(mutt_file_mkdir(buf_string(root), S_IRWXU) == 0))
+    goto done;
+  buf_printf(path, "%s/mbox", buf_string(root));
+  buf_printf(cache, "%s/hcache", buf_string(root));
+  cs_subset_str_string_set(NeoMutt->sub, "header_cache", buf_string(cache), NULL);
+
+  // The messages are changed on disk, without changing the file's size.
+  // If the old Subject is seen, the Email came from the cache.
+
+  {
+    TEST_CASE("Restore from the cache");
+    TEST_CHECK(create_mbox(buf_string(path), buf_string(cache)));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: apple", "Subject: APPLE", true));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: cherry", "Subject: CHERRY", true));
+
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const char *subjects[] = { "apple", "banana", "cherry", NULL };
+      check_subjects(m, subjects);
+      struct Email *e = m->emails[2];
+      TEST_CHECK((e->body->offset + e->body->length + 1) == m->size);
+    }
+    close_mbox(&m);
+  }
+
+  {
+    TEST_CASE("Rewritten in place");
+    TEST_CHECK(create_mbox(buf_string(path), buf_string(cache)));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: apple", "Subject: APPLE", false));
+
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const char *subjects[] = { "APPLE", "banana", "cherry", NULL };
+      check_subjects(m, subjects);
+    }
+    close_mbox(&m);
+  }
+
+  {
+    TEST_CASE("Changed From_ line");
+    TEST_CHECK(create_mbox(buf_string(path), buf_string(cache)));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: apple", "Subject: APPLE", true));
+    TEST_CHECK(edit_file(buf_string(path), "From banana@", "From BANANA@", true));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: banana", "Subject: BANANA", true));
+
+    // Only the message with the new fingerprint is parsed
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const char *subjects[] = { "apple", "BANANA", "cherry", NULL };
+      check_subjects(m, subjects);
+    }
+    close_mbox(&m);
+  }
+
+  {
+    TEST_CASE("Appended messages");
+    TEST_CHECK(create_mbox(buf_string(path), buf_string(cache)));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: cherry", "Subject: CHERRY", true));
+    TEST_CHECK(add_message(buf_string(path), "damson@example.com", "damson"));
+    TEST_CHECK(add_message(buf_string(path), "elder@example.com", "elder"));
+
+    // The old messages come from the cache, only the new ones are parsed
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const char *subjects[] = { "apple", "banana", "cherry", "damson", "elder", NULL };
+      check_subjects(m, subjects);
+    }
+    close_mbox(&m);
+
+    // Afterwards, the whole file is in the cache
+    TEST_CHECK(edit_file(buf_string(path), "Subject: elder", "Subject: ELDER", true));
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const char *subjects[] = { "apple", "banana", "cherry", "damson", "elder", NULL };
+      check_subjects(m, subjects);
+    }
+    close_mbox(&m);
+  }
+
+  {
+    TEST_CASE("Sync");
+    TEST_CHECK(create_mbox(buf_string(path), buf_string(cache)));
+
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const LOFF_T offset = m->emails[2]->offset;
+      m->emails[2]->deleted = true;
+      m->msg_deleted = 1;
+      m->changed = true;
+      TEST_CHECK(MxMboxOps.mbox_sync(m) == MX_STATUS_OK);
+      TEST_CHECK(m->size == offset);
+    }
+    close_mbox(&m);
+
+    // The new message is where the deleted one was, with the same From_ line.
+    // Only the messages before the rewritten part of the file may be cached.
+    TEST_CHECK(add_message(buf_string(path), "cherry@example.com", "damson"));
+    TEST_CHECK(edit_file(buf_string(path), "Subject: apple", "Subject: APPLE", false));
+
+    m = open_mbox(buf_string(path));
+    if (TEST_CHECK(m != NULL))
+    {
+      const char *subjects[] = { "apple", "banana", "damson", NULL };
+      check_subjects(m, subjects);
+    }
+    close_mbox(&m);
+  }
+
+done:
+  mutt_file_rmtree(buf_string(root));
+  buf_pool_release(&root);
+  buf_pool_release(&path);
+  buf_pool_release(&cache);
+}
@@ -0,0 +1,271 @@
+/**
+ * @file
+ * Test code for mbox_patch_status()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "mbox/lib.h"
+#include "copy.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "reply_regex", DT_REGEX, IP "^((re)(\\[[0-9]+\\])*:[ \t]*)*", 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/// The From_ line of every test message
+#define FROM_LINE "From apple@example.com Mon Jan  1 00:00:00 2024\n"
+
+/**
+ * struct PatchTest - A message whose flags have changed
+ */
+struct PatchTest
+{
+  const char *name;     ///< Name of the test case
+  const char *header;   ///< Header of the message, after the From_ line
+  bool read;            ///< New value of Email.read
+  bool replied;         ///< New value of Email.replied
+  bool flagged;         ///< New value of Email.flagged
+  int rc;               ///< Expected result of mbox_patch_status()
+  const char *expected; ///< Expected header afterwards
+};
+
+/**
+ * status_headers - Get the Status: and X-Status: headers that NeoMutt writes
+ * @param[in]  read    Value of Email.read
+ * @param[in]  replied Value of Email.replied
+ * @param[in]  flagged Value of Email.flagged
+ * @param[in]  pad     Write fixed-width headers, like #CH_PAD_STATUS
+ * @param[out] buf     Buffer for the headers
+ * @param[in]  buflen  Length of the buffer
+ */
+static void status_headers(bool read, bool replied, bool flagged, bool pad,
+                           char *buf, size_t buflen)
+{
+  struct Email *e = email_new();
+  e->read = read;
+  e->replied = replied;
+  e->flagged = flagged;
+
+  buf[0] = '\0';
+  FILE *fp = tmpfile();
+  if (TEST_CHECK(fp != NULL))
+  {
+    mutt_copy_status_headers(fp, e, pad);
+    rewind(fp);
+    const size_t len = fread(buf, 1, buflen - 1, fp);
+    buf[len] = '\0';
+    mutt_file_fclose(&fp);
+  }
+  email_free(&e);
+}
+
+/**
+ * patch_test - Patch the flags of a message
+ * @param t Test to run
+ */
+static void patch_test(const struct PatchTest *t)
+{
+  TEST_CASE(t->name);
+
+  FILE *fp = tmpfile();
+  if (!TEST_CHECK(fp != NULL))
+    return;
+
+  const char *body = "\nHello\n";
+  fprintf(fp, "%s%s%s", FROM_LINE, t->header, body);
+
+  struct MboxAccountData adata = { 0 };
+  adata.fp = fp;
+  struct Account a = { 0 };
+  a.adata = &adata;
+  struct Mailbox m = { 0 };
+  m.type = MUTT_MBOX;
+  m.account = &a;
+
+  struct Email *e = email_new();
+  e->env = mutt_env_new();
+  e->body = mutt_body_new();
+  e->offset = 0;
+  e->body->offset = strlen(FROM_LINE) + strlen(t->header) + 1;
+  e->read = t->read;
+  e->replied = t->replied;
+  e->flagged = t->flagged;
+  e->changed = true;
+
+  TEST_CHECK(mbox_patch_status(&m, e) == t->rc);
+  TEST_MSG("Expected %d", t->rc);
+  fflush(fp);
+
+  // The file is unchanged, apart from the flags
+  char buf[1024] = { 0 };
+  rewind(fp);
+  const size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+  buf[len] = '\0';
+
+  char expected[1024] = { 0 };
+  snprintf(expected, sizeof(expected), "%s%s%s", FROM_LINE, t->expected, body);
+  TEST_CHECK_STR_EQ(buf, expected);
+
+  // The parser ignores the padding
+  if (t->rc == 1)
+  {
+    struct Email *e2 = email_new();
+    if (TEST_CHECK(mutt_file_seek(fp, strlen(FROM_LINE), SEEK_SET)))
+    {
+      struct Envelope *env = mutt_rfc822_read_header(fp, e2, false, false);
+      TEST_CHECK(e2->read == t->read);
+      TEST_CHECK(e2->replied == t->replied);
+      TEST_CHECK(e2->flagged == t->flagged);
+      mutt_env_free(&env);
+    }
+    email_free(&e2);
+  }
+
+  email_free(&e);
+  mutt_file_fclose(&fp);
+}
+
+void test_mbox_patch_status(void)
+{
+  // int mbox_patch_status(struct Mailbox *m, struct Email *e);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  {
+    TEST_CHECK(mbox_patch_status(NULL, NULL) == -1);
+  }
+
+  static const struct PatchTest tests[] = {
+    // clang-format off
+    { "Read to unread",
+      "Status: RO\nX-Status: AF\n", false, true, false, 1,
+      "Status:   \nX-Status: A \n" },
+    { "Unread to read",
+      "Subject: Apples\nStatus:   \nX-Status:   \n", true, true, true, 1,
+      "Subject: Apples\nStatus: RO\nX-Status: AF\n" },
+    { "No room in Status:",
+      "Status: O\nX-Status: F\n", true, false, true, 0,
+      "Status: O\nX-Status: F\n" },
+    { "No room in X-Status:",
+      "Status: RO\nX-Status: F\n", true, true, true, 0,
+      "Status: RO\nX-Status: F\n" },
+    { "Missing X-Status:",
+      "Status: RO\n", true, false, true, 0,
+      "Status: RO\n" },
+    { "Missing, but not needed",
+      "Status: RO\n", false, false, false, 1,
+      "Status:   \n" },
+    { "Neither header",
+      "Subject: Apples\n", false, false, false, 1,
+      "Subject: Apples\n" },
+    { "CRLF",
+      "Status: RO\r\nX-Status: AF\r\n", true, false, true, 1,
+      "Status: RO\r\nX-Status: F \r\n" },
+    { "Duplicate",
+      "Status: RO\nStatus: RO\nX-Status: AF\n", false, false, false, 0,
+      "Status: RO\nStatus: RO\nX-Status: AF\n" },
+    { "Folded",
+      "Status: R\n O\nX-Status: AF\n", false, false, false, 0,
+      "Status: R\n O\nX-Status: AF\n" },
+    { "Other spelling",
+      "status: RO\nX-Status: AF\n", false, false, false, 0,
+      "status: RO\nX-Status: AF\n" },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+    patch_test(&tests[i]);
+
+  {
+    // A message written with no flags can have any flags set in place
+    char header[256] = { 0 };
+    char expected[256] = { 0 };
+    char name[64] = { 0 };
+    status_headers(false, false, false, true, header, sizeof(header));
+    TEST_CHECK_STR_EQ(header, "Status:   \nX-Status:   \n");
+
+    for (int i = 0; i < 8; i++)
+    {
+      const bool read = (i & 1);
+      const bool replied = (i & 2);
+      const bool flagged = (i & 4);
+      status_headers(read, replied, flagged, true, expected, sizeof(expected));
+      snprintf(name, sizeof(name), "Padded, read %d, replied %d, flagged %d",
+               read, replied, flagged);
+
+      const struct PatchTest t = { name, header, read, replied, flagged, 1, expected };
+      patch_test(&t);
+    }
+
+    // Every flag fits in the padded headers
+    status_headers(true, true, true, true, header, sizeof(header));
+    TEST_CHECK_STR_EQ(header, "Status: RO\nX-Status: AF\n");
+    status_headers(false, false, false, true, expected, sizeof(expected));
+    const struct PatchTest t = { "Padded, all flags cleared", header, false, false, false, 1, expected };
+    patch_test(&t);
+  }
+
+  {
+    // Without the padding, the message has to be rewritten
+    char header[256] = { 0 };
+    status_headers(false, false, false, false, header, sizeof(header));
+    TEST_CHECK_STR_EQ(header, "");
+    const struct PatchTest t = { "Not padded", header, true, false, true, 0, header };
+    patch_test(&t);
+  }
+
+  {
+    // Other changes need the message to be rewritten
+    struct MboxAccountData adata = { 0 };
+    struct Account a = { 0 };
+    a.adata = &adata;
+    struct Mailbox m = { 0 };
+    m.account = &a;
+    struct Email *e = email_new();
+    e->env = mutt_env_new();
+    e->body = mutt_body_new();
+    e->body->offset = 100;
+
+    e->deleted = true;
+    TEST_CHECK(mbox_patch_status(&m, e) == 0);
+    e->deleted = false;
+
+    e->attach_del = true;
+    TEST_CHECK(mbox_patch_status(&m, e) == 0);
+    e->attach_del = false;
+
+    e->env->changed = MUTT_ENV_CHANGED_SUBJECT;
+    TEST_CHECK(mbox_patch_status(&m, e) == 0);
+
+    email_free(&e);
+  }
+}
@@ -0,0 +1,263 @@
+/**
+ * @file
+ * Test code for pager_stream_read()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "pager/lib.h"
+#include "pager/private_data.h"
+#include "pager/stream.h"
+#include "test_common.h"
+
+static int ErrorCount = 0; ///< Number of errors logged
+
+/**
+ * log_count_errors - Count the errors - Implements ::log_dispatcher_t
+ */
+static int log_count_errors(time_t stamp, const char *file, int line,
+                            const char *function, enum LogLevel level, ...)
+{
+  if (level == LL_ERROR)
+    ErrorCount++;
+  return 0;
+}
+
+/**
+ * struct StreamTest - A decoding process, and the file being streamed into
+ */
+struct StreamTest
+{
+  struct Buffer *fname;         ///< Pager's file
+  int fd_go;                    ///< Tell the process to send the next chunk
+  struct PagerPrivateData priv; ///< Private Pager data
+};
+
+/**
+ * stream_start - Start a fake decoding process
+ * @param st     Stream Test
+ * @param chunks Text to send; the process waits before sending each chunk after the first
+ * @param num    Number of chunks
+ * @param rc     Exit code of the process
+ * @retval true Success
+ */
+static bool stream_start(struct StreamTest *st, const char **chunks, int num, int rc)
+{
+  memset(st, 0, sizeof(*st));
+  st->fname = buf_pool_get();
+  buf_mktemp(st->fname);
+  FILE *fp = mutt_file_fopen(buf_string(st->fname), "w");
+  if (!TEST_CHECK(fp != NULL))
+    return false;
+  mutt_file_fclose(&fp);
+
+  int fd_data[2];
+  int fd_go[2];
+  if (!TEST_CHECK((pipe(fd_data) == 0) && (pipe(fd_go) == 0)))
+    return false;
+
+  fflush(NULL);
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    close(fd_data[0]);
+    close(fd_go[1]);
+    for (int i = 0; i < num; i++)
+    {
+      char c = 0;
+      if ((i > 0) && (read(fd_go[0], &c, 1) != 1))
+        _exit(2);
+      const size_t len = strlen(chunks[i]);
+      if (write(fd_data[1], chunks[i], len) != (ssize_t) len)
+        _exit(2);
+    }
+    _exit(rc);
+  }
+
+  close(fd_data[1]);
+  close(fd_go[0]);
+  if (!TEST_CHECK(pid > 0))
+    return false;
+  st->fd_go = fd_go[1];
+
+  struct PagerData pdata = { 0 };
+  pdata.fname = buf_string(st->fname);
+  pdata.pid = pid;
+  pdata.fd = fd_data[0];
+
+  st->priv.fp = mutt_file_fopen(buf_string(st->fname), "r");
+  st->priv.stream = pager_stream_new(&pdata);
+  return TEST_CHECK(st->priv.fp != NULL) && TEST_CHECK(st->priv.stream != NULL);
+}
+
+/**
+ * stream_next - Let the process send its next chunk
+ * @param st Stream Test
+ */
+static void stream_next(struct StreamTest *st)
+{
+  TEST_CHECK(write(st->fd_go, "x", 1) == 1);
+}
+
+/**
+ * stream_check - Check the Pager's file
+ * @param st       Stream Test
+ * @param expected Expected contents
+ */
+static void stream_check(struct StreamTest *st, const char *expected)
+{
+  char buf[256] = { 0 };
+  FILE *fp = mutt_file_fopen(buf_string(st->fname), "r");
+  if (!TEST_CHECK(fp != NULL))
+    return;
+  const size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+  buf[len] = '\0';
+  mutt_file_fclose(&fp);
+
+  TEST_CHECK_STR_EQ(buf, expected);
+  TEST_CHECK(st->priv.st.st_size == (off_t) strlen(expected));
+}
+
+/**
+ * stream_end - Stop the process and delete the file
+ * @param st Stream Test
+ */
+static void stream_end(struct StreamTest *st)
+{
+  pager_stream_free(&st->priv.stream);
+  mutt_file_fclose(&st->priv.fp);
+  if (st->fd_go > 0)
+    close(st->fd_go);
+  if (st->fname)
+    mutt_file_unlink(buf_string(st->fname));
+  buf_pool_release(&st->fname);
+}
+
+void test_pager_stream_read(void)
+{
+  // bool pager_stream_read(struct PagerPrivateData *priv, LOFF_T offset);
+
+  log_dispatcher_t old_logger = MuttLogger;
+  MuttLogger = log_count_errors;
+
+  {
+    TEST_CHECK(!pager_stream_read(NULL, 0));
+    pager_stream_finish(NULL);
+    pager_stream_free(NULL);
+
+    struct PagerData pdata = { 0 };
+    pdata.fd = -1;
+    TEST_CHECK(pager_stream_new(NULL) == NULL);
+    TEST_CHECK(pager_stream_new(&pdata) == NULL);
+  }
+
+  {
+    TEST_CASE("Partial lines");
+    static const char *chunks[] = { "apple\nban", "ana\ncherry", "\ndamson" };
+    struct StreamTest st = { 0 };
+    ErrorCount = 0;
+    if (stream_start(&st, chunks, mutt_array_size(chunks), 0))
+    {
+      // Only the complete line is added
+      TEST_CHECK(pager_stream_read(&st.priv, 0));
+      stream_check(&st, "apple\n");
+      TEST_CHECK(pager_stream_read(&st.priv, 5));
+      stream_check(&st, "apple\n");
+      TEST_CHECK(st.priv.stream != NULL);
+
+      // The rest of the line arrives
+      stream_next(&st);
+      TEST_CHECK(pager_stream_read(&st.priv, 6));
+      stream_check(&st, "apple\nbanana\n");
+
+      // A chunk that ends a line
+      stream_next(&st);
+      TEST_CHECK(pager_stream_read(&st.priv, 13));
+      stream_check(&st, "apple\nbanana\ncherry\n");
+
+      // The last line has no newline
+      TEST_CHECK(pager_stream_read(&st.priv, 20));
+      stream_check(&st, "apple\nbanana\ncherry\ndamson");
+      TEST_CHECK(st.priv.stream == NULL);
+      TEST_CHECK(!pager_stream_read(&st.priv, 26));
+      TEST_CHECK(ErrorCount == 0);
+    }
+    stream_end(&st);
+  }
+
+  {
+    TEST_CASE("Empty");
+    static const char *chunks[] = { "" };
+    struct StreamTest st = { 0 };
+    ErrorCount = 0;
+    if (stream_start(&st, chunks, mutt_array_size(chunks), 0))
+    {
+      TEST_CHECK(!pager_stream_read(&st.priv, 0));
+      stream_check(&st, "");
+      TEST_CHECK(st.priv.stream == NULL);
+      TEST_CHECK(ErrorCount == 0);
+    }
+    stream_end(&st);
+  }
+
+  {
+    TEST_CASE("Process fails");
+    static const char *chunks[] = { "apple\nbanana" };
+    struct StreamTest st = { 0 };
+    ErrorCount = 0;
+    if (stream_start(&st, chunks, mutt_array_size(chunks), 1))
+    {
+      // What was decoded is kept, and the error is reported
+      pager_stream_finish(&st.priv);
+      stream_check(&st, "apple\nbanana");
+      TEST_CHECK(st.priv.stream == NULL);
+      TEST_CHECK(ErrorCount == 1);
+      TEST_CHECK(!pager_stream_read(&st.priv, 12));
+    }
+    stream_end(&st);
+  }
+
+  {
+    TEST_CASE("Pager quits");
+    static const char *chunks[] = { "apple\n", "banana\n" };
+    struct StreamTest st = { 0 };
+    ErrorCount = 0;
+    if (stream_start(&st, chunks, mutt_array_size(chunks), 0))
+    {
+      // The process is waiting, so it has to be stopped
+      TEST_CHECK(pager_stream_read(&st.priv, 0));
+      pager_stream_free(&st.priv.stream);
+      TEST_CHECK(st.priv.stream == NULL);
+      stream_check(&st, "apple\n");
+      TEST_CHECK(ErrorCount == 0);
+    }
+    stream_end(&st);
+  }
+
+  MuttLogger = old_logger;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * Test code for mutt_rfc822_read_header_mem()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "reply_regex", DT_REGEX, IP "^((re)(\\[[0-9]+\\])*:[ \t]*)*", 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+void test_mutt_rfc822_read_header_mem(void)
+{
+  // struct Envelope *mutt_rfc822_read_header_mem(const char *data, size_t datalen, struct Email *e, bool user_hdrs, bool weed);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  {
+    struct Email e = { 0 };
+    TEST_CHECK(!mutt_rfc822_read_header_mem(NULL, 0, &e, false, false));
+  }
+
+  {
+    struct Envelope *env = NULL;
+    TEST_CHECK((env = mutt_rfc822_read_header_mem("", 0, NULL, false, false)) != NULL);
+    mutt_env_free(&env);
+  }
+
+  {
+    /* Parsing from memory matches parsing from a file */
+    const char msg[] = "From john@example.com Mon Jan  1 00:00:00 2024\n"
+                       "From: John Doe <john@example.com>\n"
+                       "Subject: hello\n"
+                       "  world\n"
+                       "Message-ID: <1234@example.com>\n"
+                       "\n"
+                       "body\n";
+    const LOFF_T offset = 100;
+
+    struct Email *e_mem = email_new();
+    e_mem->offset = offset;
+    struct Envelope *env_mem = mutt_rfc822_read_header_mem(msg, sizeof(msg) - 1,
+                                                           e_mem, false, false);
+
+    FILE *fp = test_make_file_with_contents((char *) msg, sizeof(msg) - 1);
+    struct Email *e_file = email_new();
+    struct Envelope *env_file = mutt_rfc822_read_header(fp, e_file, false, false);
+
+    TEST_CHECK_STR_EQ(env_mem->subject, "hello world");
+    TEST_CHECK_STR_EQ(env_mem->subject, env_file->subject);
+    TEST_CHECK_STR_EQ(env_mem->message_id, env_file->message_id);
+    TEST_CHECK_STR_EQ(buf_string(TAILQ_FIRST(&env_mem->from)->mailbox), "john@example.com");
+    TEST_CHECK(e_mem->body->hdr_offset == offset);
+    TEST_CHECK(e_mem->body->offset == (offset + e_file->body->offset));
+    TEST_CHECK(strcmp(msg + e_file->body->offset, "body\n") == 0);
+
+    mutt_env_free(&env_mem);
+    mutt_env_free(&env_file);
+    email_free(&e_mem);
+    email_free(&e_file);
+    fclose(fp);
+  }
+
+  {
+    /* Parsing stops at the end of the data */
+    const char msg[] = "Subject: one\nFrom: a@example.com\n";
+    struct Email *e = email_new();
+    struct Envelope *env = mutt_rfc822_read_header_mem(msg, 13, e, false, false);
+    TEST_CHECK_STR_EQ(env->subject, "one");
+    TEST_CHECK(TAILQ_EMPTY(&env->from));
+    TEST_CHECK(e->body->offset == 13);
+    mutt_env_free(&env);
+    email_free(&e);
+  }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * Test code for mutt_rfc822_read_line_mem()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <string.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "test_common.h"
+
+static struct Rfc822ReadLineMemTestData
+{
+  const char *input;
+  const char *output;
+  size_t read;
+} test_data[] = {
+  /* clang-format off */
+  { "Subject: basic stuff\n",              "Subject: basic stuff",  21 },
+  { "Subject: basic stuff\n\n  ",          "Subject: basic stuff",  21 },
+  { "Subject: long\n subject\n",           "Subject: long subject", 23 },
+  { "Subject: long\n      subject\n",      "Subject: long subject", 28 },
+  { "Subject: one\nAnother: two\n",        "Subject: one",          13 },
+  { "Subject: one    \n",                  "Subject: one",          17 },
+  { "Subject: crlf\r\n\r\n",               "Subject: crlf",         15 },
+  { "Subject: no newline",                 "Subject: no newline",   19 },
+  { "Subject: fold\n\tat end",             "Subject: fold at end",  21 },
+  { "\n",                                  "",                      1  },
+  { "  leading space\nSubject: x\n",       "",                      16 },
+  { "",                                    "",                      0  },
+  /* clang-format on */
+};
+
+void test_mutt_rfc822_read_line_mem(void)
+{
+  // size_t mutt_rfc822_read_line_mem(const char *data, size_t datalen, struct Buffer *buf);
+
+  {
+    struct Buffer buf = { 0 };
+    TEST_CHECK(mutt_rfc822_read_line_mem(NULL, 10, &buf) == 0);
+  }
+
+  {
+    TEST_CHECK(mutt_rfc822_read_line_mem("Subject: x\n", 11, NULL) == 0);
+  }
+
+  {
+    const char input[] = "Head1: val1.1\n  val1.2\nHead2: val2.1\n val2.2\n";
+    struct Buffer *buf = buf_pool_get();
+
+    const size_t after1 = mutt_rfc822_read_line_mem(input, sizeof(input) - 1, buf);
+    TEST_CHECK_STR_EQ(buf_string(buf), "Head1: val1.1 val1.2");
+
+    mutt_rfc822_read_line_mem(input + after1, sizeof(input) - 1 - after1, buf);
+    TEST_CHECK_STR_EQ(buf_string(buf), "Head2: val2.1 val2.2");
+
+    /* The length limits how far we read */
+    mutt_rfc822_read_line_mem(input, 20, buf);
+    TEST_CHECK_STR_EQ(buf_string(buf), "Head1: val1.1 val1");
+
+    buf_pool_release(&buf);
+  }
+
+  for (size_t i = 0; i < mutt_array_size(test_data); i++)
+  {
+    TEST_CASE(test_data[i].input);
+    struct Buffer *buf = buf_pool_get();
+    const size_t read = mutt_rfc822_read_line_mem(test_data[i].input,
+                                                  strlen(test_data[i].input), buf);
+    if (!TEST_CHECK(read == test_data[i].read))
+    {
+      TEST_MSG("Expected: %zu", test_data[i].read);
+      TEST_MSG("Actual  : %zu", read);
+    }
+    TEST_CHECK_STR_EQ(buf_string(buf), test_data[i].output);
+    buf_pool_release(&buf);
+  }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * Test code for the body index queries
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "pattern/lib.h"
+#include "pattern/private.h"
+
+struct BodyIndexTest
+{
+  const char *search;
+  bool is_regex;
+  const char *text;
+  bool may_match;
+};
+
+void test_body_index_query(void)
+{
+  // struct BodyIndexQuery *body_index_query_new(const char *str, bool is_regex, bool ign_case);
+  // bool body_index_text_may_match(const struct BodyIndexQuery *q, const char *text);
+
+  {
+    TEST_CHECK(body_index_text_may_match(NULL, "apple") == true);
+    struct BodyIndexQuery *q = body_index_query_new(NULL, true, false);
+    TEST_CHECK(q != NULL);
+    TEST_CHECK(body_index_text_may_match(q, NULL) == true);
+    body_index_query_free(&q);
+    body_index_query_free(NULL);
+  }
+
+  static const struct BodyIndexTest tests[] = {
+    // clang-format off
+    // Plain text
+    { "banana",          false, "a banana split",          true  },
+    { "banana",          false, "an apple",                false },
+    { "BANANA",          false, "a banana split",          true  },
+    { "ban",             false, "cherry",                  false },
+    { "ba",              false, "cherry",                  true  },
+    // The text must be on one line
+    { "banana",          false, "ban\nana",                false },
+    // Regexes
+    { "banana",          true,  "a Banana split",          true  },
+    { "ban.na",          true,  "a nana",                  false },
+    { "ban.na",          true,  "a banana",                true  },
+    { "ba+na",           true,  "baaaana",                 true  },
+    { "colou?r",         true,  "the color red",           true  },
+    { "colou?r",         true,  "the colour red",          true  },
+    { "colou?r",         true,  "the shade red",           false },
+    { "x{2}yz",          true,  "xxyz",                    true  },
+    { "a[bc]def",        true,  "acdef",                   true  },
+    { "a[]x]def",        true,  "a]def",                   true  },
+    { "a[[:digit:]]def", true,  "a1def",                   true  },
+    { "(apple)? pie",    true,  "cherry pie",              true  },
+    { "(apple)? pie",    true,  "cherry cake",             false },
+    { "^apple$",         true,  "apple",                   true  },
+    { "\\bapple\\b",     true,  "an apple",                true  },
+    { "a\\.b\\.c",       true,  "a.b.c",                   true  },
+    { "a\\.b\\.c",       true,  "axbxc",                   false },
+    // Alternation can't be indexed
+    { "apple|pear",      true,  "cherry",                  true  },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    const struct BodyIndexTest *t = &tests[i];
+    TEST_CASE(t->search);
+    struct BodyIndexQuery *q = body_index_query_new(t->search, t->is_regex,
+                                                    mutt_mb_is_lower(t->search));
+    const bool rc = body_index_text_may_match(q, t->text);
+    TEST_CHECK(rc == t->may_match);
+    TEST_MSG("Text: '%s', Expected: %d, Got: %d", t->text, t->may_match, rc);
+    body_index_query_free(&q);
+  }
+}
@@ -90,12 +90,19 @@ short AbortKey;
 bool OptForceRefresh;
 bool OptIgnoreMacroEvents;
 bool OptKeepQuiet;
+bool OptNeedRescore;
+bool OptNeedResort;
 bool OptNoCurses;
+bool OptResortInit;
 bool OptSearchInvalid;
 bool OptSearchReverse;
+bool OptSortSubthreads;
 
 typedef uint8_t MuttFormatFlags;
 typedef uint16_t CompletionFlags;
+typedef uint16_t CopyMessageFlags;
+typedef uint32_t CopyHeaderFlags;
+typedef uint8_t MsgOpenFlags;
 typedef uint16_t PagerFlags;
 typedef uint8_t SelectFileFlags;
 
@@ -143,6 +150,12 @@ int mutt_copy_header(FILE *in, struct Email *e, FILE *out, int flags, const char
   return -1;
 }
 
+int mutt_copy_message(FILE *fp_out, struct Email *e, struct Message *msg,
+                      CopyMessageFlags cmflags, CopyHeaderFlags chflags, int wraplen)
+{
+  return -1;
+}
+
 int mutt_count_body_parts(struct Mailbox *m, struct Email *e, struct Message *msg)
 {
   return g_body_parts;
@@ -166,10 +179,41 @@ void mutt_str_pretty_size(char *buf, size_t buflen, size_t num)
 {
 }
 
+void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_mbox)
+{
+}
+
 void mutt_set_flag(struct Mailbox *m, struct Email *e, int flag, bool bf, bool upd_mbox)
 {
 }
 
+void mx_alloc_memory(struct Mailbox *m, int req_size)
+{
+  req_size = ROUND_UP(MAX(req_size, m->email_max) + 1, 25);
+  mutt_mem_realloc(&m->emails, req_size * sizeof(struct Email *));
+  mutt_mem_realloc(&m->v2r, req_size * sizeof(int));
+  for (int i = m->email_max; i < req_size; i++)
+  {
+    m->emails[i] = NULL;
+    m->v2r[i] = -1;
+  }
+  m->email_max = req_size;
+}
+
+void mx_fastclose_mailbox(struct Mailbox *m, bool keep_account)
+{
+}
+
+enum MxStatus mx_mbox_close(struct Mailbox *m)
+{
+  return MX_STATUS_ERROR;
+}
+
+bool mx_mbox_open(struct Mailbox *m, OpenMailboxFlags flags)
+{
+  return false;
+}
+
 int mx_msg_close(struct Mailbox *m, struct Message **msg)
 {
   return 0;
@@ -180,11 +224,26 @@ struct Message *mx_msg_open(struct Mailbox *m, struct Email *e)
   return NULL;
 }
 
+struct Message *mx_msg_open_new(struct Mailbox *m, const struct Email *e, MsgOpenFlags flags)
+{
+  return NULL;
+}
+
 int mx_msg_padding_size(struct Mailbox *m)
 {
   return 0;
 }
 
+enum MailboxType mx_type(struct Mailbox *m)
+{
+  return m ? m->type : MUTT_MAILBOX_ERROR;
+}
+
+int nntp_compare_order(const struct Email *a, const struct Email *b, bool reverse)
+{
+  return 0;
+}
+
 const char *myvar_get(const char *var)
 {
   return NULL;
@@ -252,16 +311,22 @@ int mutt_pager(const char *banner, const char *fname, PagerFlags flags, struct P
   return 0;
 }
 
+#ifndef USE_INOTIFY
 int mutt_monitor_poll(void)
 {
   return 0;
 }
+#endif
 
 int mutt_system(const char *cmd)
 {
   return 0;
 }
 
+void buf_pretty_mailbox(struct Buffer *buf)
+{
+}
+
 void buf_select_file(struct Buffer *file, SelectFileFlags flags, char ***files, int *numfiles)
 {
 }
@@ -301,6 +366,10 @@ int mutt_complete(char *buf, size_t buflen)
   return 0;
 }
 
+void mutt_encode_path(struct Buffer *buf, const char *src)
+{
+}
+
 char *mutt_expand_path(char *buf, size_t buflen)
 {
   return NULL;
@@ -319,6 +388,10 @@ int mutt_label_complete(char *buf, size_t buflen, int numtabs)
   return 0;
 }
 
+void mutt_make_label_hash(struct Mailbox *m)
+{
+}
+
 struct Mailbox *mutt_mailbox_next(struct Mailbox *m_cur, struct Buffer *s)
 {
   return NULL;
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * Test code for mutt_pattern_exec()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "pattern/lib.h"
+#include "test_common.h"
+
+struct ExecTest
+{
+  const char *pattern; ///< Pattern to compile
+  bool expected[4];    ///< Result for each of the test Emails
+};
+
+void test_mutt_pattern_exec(void)
+{
+  // bool mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m, struct Email *e, struct PatternCache *cache);
+
+  // Emails: 0 = new, 1 = flagged + read, 2 = deleted + read, 3 = flagged + new
+  static const struct ExecTest tests[] = {
+    // clang-format off
+    { "~N",                  { true,  false, false, true  } },
+    { "!~N",                 { false, true,  true,  false } },
+    { "~F ~N",               { false, false, false, true  } },
+    { "~F | ~D",             { false, true,  true,  true  } },
+    { "!(~F | ~D)",          { true,  false, false, false } },
+    { "~N !(~F ~N)",         { true,  false, false, false } },
+    { "~D | (~F !~N)",       { false, true,  true,  false } },
+    { "!(!~F | !~N) | ~D",   { false, false, true,  true  } },
+    { "(~N | ~D) (~F | ~D)", { false, false, true,  true  } },
+    { "~R ~F",               { false, true,  false, false } },
+    // clang-format on
+  };
+
+  struct Email *emails[4] = { 0 };
+  for (int i = 0; i < mutt_array_size(emails); i++)
+  {
+    emails[i] = email_new();
+    emails[i]->msgno = i;
+  }
+  emails[1]->flagged = true;
+  emails[1]->read = true;
+  emails[2]->deleted = true;
+  emails[2]->read = true;
+  emails[3]->flagged = true;
+
+  struct Buffer *err = buf_pool_get();
+  for (int i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i].pattern);
+    struct PatternList *pat = mutt_pattern_comp(NULL, NULL, tests[i].pattern,
+                                                MUTT_PC_NO_FLAGS, err);
+    if (!TEST_CHECK(pat != NULL))
+    {
+      TEST_MSG("%s", buf_string(err));
+      continue;
+    }
+
+    for (int j = 0; j < mutt_array_size(emails); j++)
+    {
+      const bool rc = mutt_pattern_exec(SLIST_FIRST(pat), MUTT_PAT_EXEC_NO_FLAGS,
+                                        NULL, emails[j], NULL);
+      TEST_CHECK(rc == tests[i].expected[j]);
+      TEST_MSG("Email %d: Expected %d, Got %d", j, tests[i].expected[j], rc);
+    }
+    mutt_pattern_free(&pat);
+  }
+  buf_pool_release(&err);
+
+  for (int i = 0; i < mutt_array_size(emails); i++)
+    email_free(&emails[i]);
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ * Test code for mutt_pattern_has_date()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "pattern/lib.h"
+
+/**
+ * struct DateTest - A pattern and whether it tests a date
+ */
+struct DateTest
+{
+  const char *pattern; ///< Pattern to compile
+  bool has_date;       ///< Expected result
+};
+
+void test_mutt_pattern_has_date(void)
+{
+  // bool mutt_pattern_has_date(const struct PatternList *pat);
+
+  {
+    TEST_CHECK(!mutt_pattern_has_date(NULL));
+  }
+
+  static const struct DateTest tests[] = {
+    // clang-format off
+    { "~N",                    false },
+    { "~F ~s apple",           false },
+    { "~d <1d",                true  },
+    { "~r 01/01/2020-",        true  },
+    { "!~d <1w",               true  },
+    { "~N ~d <1d",             true  },
+    { "~F | (~s apple ~r <2d)", true },
+    { "~(~d <1m)",             true  },
+    { "~(~s apple)",           false },
+    // clang-format on
+  };
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i].pattern);
+    struct Buffer *err = buf_pool_get();
+    struct PatternList *pat = mutt_pattern_comp(NULL, NULL, tests[i].pattern, 0, err);
+    if (TEST_CHECK(pat != NULL))
+      TEST_CHECK(mutt_pattern_has_date(pat) == tests[i].has_date);
+    TEST_MSG("%s", buf_string(err));
+    mutt_pattern_free(&pat);
+    buf_pool_release(&err);
+  }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file
+ * Test code for pattern_exec_emails()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "pattern/lib.h"
+#include "pattern/private.h"
+#include "test_common.h"
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "pattern_threads", DT_NUMBER|DT_NOT_NEGATIVE, 4, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+void test_pattern_exec_emails(void)
+{
+  // void pattern_exec_emails(struct Pattern *pat, PatternExecFlags flags, struct Mailbox *m, struct EmailArray *ea, bool *matches, struct Progress *progress);
+
+  static const char *tests[] = {
+    "~N",
+    "~F | ~D",
+    "~N !(~F ~N)",
+    "~s 7 !~D",
+    "~f bob | ~F",
+    "~s 99 | ~F",
+  };
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  // Enough Emails for the worker threads to be used
+  struct EmailArray ea = ARRAY_HEAD_INITIALIZER;
+  struct Buffer *buf = buf_pool_get();
+  for (int i = 0; i < 5000; i++)
+  {
+    struct Email *e = email_new();
+    e->msgno = i;
+    e->flagged = ((i % 3) == 0);
+    e->read = ((i % 5) == 0);
+    e->deleted = ((i % 7) == 0);
+    e->env = mutt_env_new();
+    buf_printf(buf, "message %d", i);
+    e->env->subject = buf_strdup(buf);
+    const char *from = ((i % 2) == 0) ? "bob@example.com" : "alice@example.com";
+    mutt_addrlist_append(&e->env->from, mutt_addr_create(NULL, from));
+    ARRAY_ADD(&ea, e);
+  }
+  buf_pool_release(&buf);
+
+  bool *matches = mutt_mem_calloc(ARRAY_SIZE(&ea), sizeof(bool));
+  struct Buffer *err = buf_pool_get();
+  for (int i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i]);
+    struct PatternList *pat = mutt_pattern_comp(NULL, NULL, tests[i],
+                                                MUTT_PC_NO_FLAGS, err);
+    if (!TEST_CHECK(pat != NULL))
+    {
+      TEST_MSG("%s", buf_string(err));
+      continue;
+    }
+
+    for (int threads = 0; threads <= 4; threads += 4)
+    {
+      cs_subset_str_native_set(NeoMutt->sub, "pattern_threads", threads, NULL);
+      memset(matches, 0, ARRAY_SIZE(&ea) * sizeof(bool));
+      pattern_exec_emails(SLIST_FIRST(pat), MUTT_PAT_EXEC_NO_FLAGS, NULL, &ea,
+                          matches, NULL);
+
+      int bad = 0;
+      for (size_t j = 0; j < ARRAY_SIZE(&ea); j++)
+      {
+        const bool rc = mutt_pattern_exec(SLIST_FIRST(pat), MUTT_PAT_EXEC_NO_FLAGS,
+                                          NULL, *ARRAY_GET(&ea, j), NULL);
+        if (rc != matches[j])
+          bad++;
+      }
+      TEST_CHECK(bad == 0);
+      TEST_MSG("%d threads: %d differences", threads, bad);
+    }
+    mutt_pattern_free(&pat);
+  }
+  buf_pool_release(&err);
+  FREE(&matches);
+
+  struct Email **ep = NULL;
+  ARRAY_FOREACH(ep, &ea)
+  {
+    email_free(ep);
+  }
+  ARRAY_FREE(&ea);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file
+ * Test code for mutt_sort_headers()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "mutt_thread.h"
+#include "mview.h"
+#include "sort.h"
+#include "test_common.h"
+
+/// Number of Emails in the test Mailbox
+#define NUM_EMAILS 50
+
+static const struct Mapping HeaderSortMethods[] = {
+  // clang-format off
+  { "date",          SORT_DATE },
+  { "date-received", SORT_RECEIVED },
+  { "from",          SORT_FROM },
+  { "label",         SORT_LABEL },
+  { "mailbox-order", SORT_ORDER },
+  { "score",         SORT_SCORE },
+  { "size",          SORT_SIZE },
+  { "spam",          SORT_SPAM },
+  { "subject",       SORT_SUBJECT },
+  { "threads",       SORT_THREADS },
+  { "to",            SORT_TO },
+  { NULL, 0 },
+  // clang-format on
+};
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "idn_decode",    DT_BOOL, true,  0, NULL, },
+  { "reverse_alias", DT_BOOL, false, 0, NULL, },
+  { "score",         DT_BOOL, false, 0, NULL, },
+  { "sort",          DT_SORT|DT_SORT_REVERSE|DT_SORT_LAST, SORT_DATE,  IP HeaderSortMethods, NULL, },
+  { "sort_aux",      DT_SORT|DT_SORT_REVERSE|DT_SORT_LAST, SORT_DATE,  IP HeaderSortMethods, NULL, },
+  { "use_threads",   DT_ENUM, UT_FLAT, IP &UseThreadsTypeDef, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/// Sort methods that don't need threads
+static const short Methods[] = {
+  SORT_DATE, SORT_FROM,  SORT_LABEL, SORT_ORDER,   SORT_RECEIVED,
+  SORT_SCORE, SORT_SIZE, SORT_SPAM,  SORT_SUBJECT, SORT_TO,
+};
+
+/// Names, which often tie, and differ only by case
+static const char *Names[] = {
+  "Ann Apple <ann@example.com>",
+  "ann apple <ann2@example.com>",
+  "bob@example.com",
+  "Bob <bob@example.com>",
+  "",
+  "\"Zed\" <zed@example.com>",
+};
+
+/// Spam values, including ties on the number
+static const char *SpamValues[] = { "", "5.0 maybe", "5.0 likely", "12", "-1.5", "5" };
+
+/// Labels, including blank ones
+static const char *Labels[] = { NULL, "", "Work", "work", "home" };
+
+/// Subjects, including a missing one
+static const char *Subjects[] = { NULL, "Apples", "apples", "Bananas", "cherries" };
+
+static struct Email *test_email(int index)
+{
+  struct Email *e = email_new();
+  e->index = index;
+  e->vnum = 0;
+  e->date_sent = 1700000000 + ((index * 7) % 10) * 3600;
+  e->received = 1700000000 + ((index * 3) % 8) * 60;
+  e->score = (index % 4) - 1;
+
+  e->env = mutt_env_new();
+  mutt_addrlist_parse(&e->env->from, Names[index % mutt_array_size(Names)]);
+  mutt_addrlist_parse(&e->env->to, Names[(index / 3) % mutt_array_size(Names)]);
+  buf_strcpy(&e->env->spam, SpamValues[(index / 2) % mutt_array_size(SpamValues)]);
+  e->env->x_label = mutt_str_dup(Labels[(index * 3) % mutt_array_size(Labels)]);
+  e->env->subject = mutt_str_dup(Subjects[(index / 4) % mutt_array_size(Subjects)]);
+  e->env->real_subj = e->env->subject;
+
+  e->body = mutt_body_new();
+  e->body->length = (index * 11) % 6;
+  return e;
+}
+
+static const char *sort_name(short sort, char *buf, size_t buflen)
+{
+  snprintf(buf, buflen, "%s%s", (sort & SORT_REVERSE) ? "reverse-" : "",
+           mutt_map_get_name(sort & SORT_MASK, HeaderSortMethods));
+  return buf;
+}
+
+static void test_sort(struct MailboxView *mv, struct Email **unsorted, short sort, short sort_aux)
+{
+  struct Mailbox *m = mv->mailbox;
+  for (int i = 0; i < m->msg_count; i++)
+    m->emails[i] = unsorted[i];
+
+  TEST_CHECK(CSR_RESULT(cs_subset_str_native_set(NeoMutt->sub, "sort", sort, NULL)) == CSR_SUCCESS);
+  TEST_CHECK(CSR_RESULT(cs_subset_str_native_set(NeoMutt->sub, "sort_aux", sort_aux, NULL)) == CSR_SUCCESS);
+  mutt_sort_headers(mv, true);
+
+  for (int i = 0; i < (m->msg_count - 1); i++)
+  {
+    struct Email *a = m->emails[i];
+    struct Email *b = m->emails[i + 1];
+    if (!TEST_CHECK(mutt_compare_emails(a, b, m->type, sort, sort_aux) < 0))
+    {
+      char buf1[64] = { 0 };
+      char buf2[64] = { 0 };
+      TEST_MSG("sort=%s, sort_aux=%s", sort_name(sort, buf1, sizeof(buf1)),
+               sort_name(sort_aux, buf2, sizeof(buf2)));
+      TEST_MSG("Emails %d and %d are out of order", a->index, b->index);
+      return;
+    }
+  }
+
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    TEST_CHECK(m->emails[i]->msgno == i);
+    TEST_CHECK(m->v2r[i] == i);
+  }
+  TEST_CHECK(m->vcount == m->msg_count);
+}
+
+void test_mutt_sort_headers(void)
+{
+  // void mutt_sort_headers(struct MailboxView *mv, bool init);
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  {
+    mutt_sort_headers(NULL, true);
+    TEST_CHECK_(1, "mutt_sort_headers(NULL, true)");
+  }
+
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MAILDIR;
+  m->email_max = NUM_EMAILS;
+  m->msg_count = NUM_EMAILS;
+  m->emails = mutt_mem_calloc(m->email_max, sizeof(struct Email *));
+  m->v2r = mutt_mem_calloc(m->email_max, sizeof(int));
+
+  // The Mailbox isn't in index order, so the sort can't rely on it
+  struct Email *unsorted[NUM_EMAILS] = { 0 };
+  for (int i = 0; i < NUM_EMAILS; i++)
+    unsorted[i] = test_email((i * 17) % NUM_EMAILS);
+
+  struct MailboxView mv = { 0 };
+  mv.mailbox = m;
+
+  // Every pair of methods, each way round, including a method with itself
+  for (size_t i = 0; i < mutt_array_size(Methods); i++)
+  {
+    TEST_CASE(mutt_map_get_name(Methods[i], HeaderSortMethods));
+    for (size_t j = 0; j < mutt_array_size(Methods); j++)
+    {
+      test_sort(&mv, unsorted, Methods[i], Methods[j]);
+      test_sort(&mv, unsorted, Methods[i] | SORT_REVERSE, Methods[j]);
+      test_sort(&mv, unsorted, Methods[i], Methods[j] | SORT_REVERSE);
+      test_sort(&mv, unsorted, Methods[i] | SORT_REVERSE, Methods[j] | SORT_REVERSE);
+    }
+  }
+
+  {
+    TEST_CASE("Already sorted");
+    test_sort(&mv, unsorted, SORT_SUBJECT, SORT_DATE);
+    struct Email *sorted[NUM_EMAILS] = { 0 };
+    for (int i = 0; i < NUM_EMAILS; i++)
+      sorted[i] = m->emails[i];
+    test_sort(&mv, sorted, SORT_SUBJECT, SORT_DATE);
+    for (int i = 0; i < NUM_EMAILS; i++)
+      TEST_CHECK(m->emails[i] == sorted[i]);
+  }
+
+  // The Mailbox frees the Emails
+  mailbox_free(&m);
+}
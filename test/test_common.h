@@ -29,6 +29,10 @@
 #include "config.h"
 #include "mutt/lib.h"
 
+struct Mailbox;
+
+extern struct Mailbox *TestCurrentMailbox;
+
 void test_gen_path(char *buf, size_t buflen, const char *fmt);
 
 bool test_neomutt_create (void);
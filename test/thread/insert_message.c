@@ -50,4 +50,17 @@ void test_insert_message(void)
     insert_message(&tnew, &newparent, NULL);
     TEST_CHECK_(1, "insert_message(&tnew, &newparent, NULL)");
   }
+
+  {
+    struct MuttThread parent = { 0 };
+    struct MuttThread first = { 0 };
+    struct MuttThread second = { 0 };
+    insert_message(&parent.child, &parent, &first);
+    insert_message(&parent.child, &parent, &second);
+    TEST_CHECK(parent.child == &second);
+    TEST_CHECK(second.next == &first);
+    TEST_CHECK(first.prev == &second);
+    TEST_CHECK(first.parent == &parent);
+    TEST_CHECK(first.sort_dirty && second.sort_dirty);
+  }
 }
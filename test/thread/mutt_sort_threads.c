@@ -0,0 +1,344 @@
+/**
+ * @file
+ * Test code for mutt_sort_threads()
+ *
+ * @authors
+ * Copyright (C) 2026 NeoMutt Team <neomutt-devel@neomutt.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "mutt_thread.h"
+#include "mview.h"
+#include "sort.h"
+#include "test_common.h"
+
+/// Number of Emails in the test Mailbox
+#define NUM_EMAILS 60
+
+static const struct Mapping ThreadSortMethods[] = {
+  // clang-format off
+  { "date",          SORT_DATE },
+  { "date-received", SORT_RECEIVED },
+  { "mailbox-order", SORT_ORDER },
+  { "size",          SORT_SIZE },
+  { "subject",       SORT_SUBJECT },
+  { "threads",       SORT_THREADS },
+  { NULL, 0 },
+  // clang-format on
+};
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "collapse_flagged",    DT_BOOL, true,  0, NULL, },
+  { "collapse_unread",     DT_BOOL, true,  0, NULL, },
+  { "duplicate_threads",   DT_BOOL, true,  0, NULL, },
+  { "hide_limited",        DT_BOOL, false, 0, NULL, },
+  { "hide_missing",        DT_BOOL, true,  0, NULL, },
+  { "hide_thread_subject", DT_BOOL, true,  0, NULL, },
+  { "hide_top_limited",    DT_BOOL, false, 0, NULL, },
+  { "hide_top_missing",    DT_BOOL, true,  0, NULL, },
+  { "narrow_tree",         DT_BOOL, false, 0, NULL, },
+  { "reverse_alias",       DT_BOOL, false, 0, NULL, },
+  { "score",               DT_BOOL, false, 0, NULL, },
+  { "sort",                DT_SORT|DT_SORT_REVERSE|DT_SORT_LAST, SORT_DATE, IP ThreadSortMethods, NULL, },
+  { "sort_aux",            DT_SORT|DT_SORT_REVERSE|DT_SORT_LAST, SORT_DATE, IP ThreadSortMethods, NULL, },
+  { "sort_re",             DT_BOOL, true,  0, NULL, },
+  { "strict_threads",      DT_BOOL, false, 0, NULL, },
+  { "thread_received",     DT_BOOL, false, 0, NULL, },
+  { "use_threads",         DT_ENUM, UT_THREADS, IP &UseThreadsTypeDef, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * struct ThreadTest - A threading configuration to test
+ */
+struct ThreadTest
+{
+  const char *name;        ///< Name of the test case
+  enum UseThreads threads; ///< $use_threads
+  short sort;              ///< $sort
+  short sort_aux;          ///< $sort_aux
+  bool strict;             ///< $strict_threads
+  bool duplicates;         ///< $duplicate_threads
+};
+
+/**
+ * rank_to_id - Find the Email that was written at a given time
+ * @param rank Order in which the Emails were written
+ * @retval num Id of the Email
+ *
+ * The Emails arrive in a different order (their id) to the one they were
+ * written in (their rank), so replies often arrive before their parents.
+ * 13 is the inverse of 37, modulo #NUM_EMAILS.
+ */
+static int rank_to_id(int rank)
+{
+  return (rank * 13) % NUM_EMAILS;
+}
+
+/**
+ * id_to_rank - Find when an Email was written
+ * @param id Id of the Email
+ * @retval num Order in which the Email was written
+ */
+static int id_to_rank(int id)
+{
+  return (id * 37) % NUM_EMAILS;
+}
+
+/**
+ * parent_id - Find the parent of an Email
+ * @param id Id of the Email
+ * @retval num Id of the parent
+ * @retval -1  The Email starts a thread
+ */
+static int parent_id(int id)
+{
+  const int rank = id_to_rank(id);
+  if (((id % 5) == 0) || (rank < 3))
+    return -1;
+
+  return rank_to_id(rank - 1 - (id % 3));
+}
+
+static struct Email *test_email(int id)
+{
+  char buf[64] = { 0 };
+  struct Email *e = email_new();
+  e->index = id;
+  e->date_sent = 1700000000 + ((id_to_rank(id) / 2) * 3600);
+  e->received = 1700000000 + (id * 60);
+
+  e->env = mutt_env_new();
+  snprintf(buf, sizeof(buf), "<%d@example.com>", id);
+  e->env->message_id = mutt_str_dup(buf);
+
+  const int parent = parent_id(id);
+  if (parent < 0)
+  {
+    // Threads that start with the same subject are joined by $strict_threads
+    snprintf(buf, sizeof(buf), "Topic %d", (id / 5) % 4);
+  }
+  else
+  {
+    // Some parents never arrive, leaving a gap in the thread
+    if ((id % 11) == 10)
+    {
+      snprintf(buf, sizeof(buf), "<missing-%d@example.com>", id);
+      mutt_list_insert_tail(&e->env->references, mutt_str_dup(buf));
+    }
+
+    snprintf(buf, sizeof(buf), "<%d@example.com>", parent);
+    mutt_list_insert_tail(&e->env->references, mutt_str_dup(buf));
+
+    const int grandparent = parent_id(parent);
+    if (grandparent >= 0)
+    {
+      snprintf(buf, sizeof(buf), "<%d@example.com>", grandparent);
+      mutt_list_insert_tail(&e->env->references, mutt_str_dup(buf));
+    }
+
+    // Some replies change the subject
+    snprintf(buf, sizeof(buf), "Re: Topic %d", id % 4);
+  }
+  e->env->subject = mutt_str_dup(buf);
+  e->env->real_subj = e->env->subject + ((parent < 0) ? 0 : 4);
+
+  e->body = mutt_body_new();
+  e->body->length = (id * 97) % 1000;
+  return e;
+}
+
+static struct Mailbox *test_mailbox(void)
+{
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MAILDIR;
+  m->email_max = NUM_EMAILS;
+  m->emails = mutt_mem_calloc(m->email_max, sizeof(struct Email *));
+  m->v2r = mutt_mem_calloc(m->email_max, sizeof(int));
+  return m;
+}
+
+static void test_mailbox_free(struct MailboxView *mv)
+{
+  mutt_clear_threads(mv->threads);
+  mutt_thread_ctx_free(&mv->threads);
+  mutt_hash_free(&mv->mailbox->subj_hash);
+  mutt_hash_free(&mv->mailbox->id_hash);
+  mailbox_free(&mv->mailbox);
+}
+
+/**
+ * test_mview_update - Update the view after new mail, like mview_update()
+ * @param mv Mailbox View
+ * @retval num Index of the first new Email, -1 if everything was rethreaded
+ */
+static int test_mview_update(struct MailboxView *mv)
+{
+  struct Mailbox *m = mv->mailbox;
+
+  int first_new = mutt_thread_first_new(mv->threads);
+  const bool rethread = (first_new < 0);
+  if (rethread)
+  {
+    mutt_hash_free(&m->subj_hash);
+    mutt_hash_free(&m->id_hash);
+    mutt_clear_threads(mv->threads);
+    first_new = 0;
+  }
+
+  m->vcount = 0;
+  for (int msgno = 0; msgno < m->msg_count; msgno++)
+  {
+    struct Email *e = m->emails[msgno];
+    m->v2r[m->vcount] = msgno;
+    e->vnum = m->vcount++;
+    e->msgno = msgno;
+
+    if (msgno >= first_new)
+    {
+      if (m->id_hash && e->env->message_id)
+        mutt_hash_insert(m->id_hash, e->env->message_id, e);
+      if (m->subj_hash && e->env->real_subj)
+        mutt_hash_insert(m->subj_hash, e->env->real_subj, e);
+    }
+  }
+
+  mutt_sort_headers(mv, rethread);
+  return rethread ? -1 : first_new;
+}
+
+/**
+ * describe_view - Describe the order and the tree of a Mailbox View
+ * @param m   Mailbox
+ * @param buf Buffer for the result
+ */
+static void describe_view(struct Mailbox *m, struct Buffer *buf)
+{
+  buf_reset(buf);
+  for (int i = 0; i < m->vcount; i++)
+  {
+    const struct Email *e = m->emails[m->v2r[i]];
+    buf_add_printf(buf, "%s ", e->env->message_id);
+
+    // Make the tree characters printable
+    for (const char *p = e->tree; p && *p; p++)
+      buf_addch(buf, (*p < ' ') ? ('a' + *p) : *p);
+    buf_addch(buf, '\n');
+  }
+}
+
+static void test_threads(const struct ThreadTest *tt)
+{
+  struct ConfigSubset *sub = NeoMutt->sub;
+  cs_subset_str_native_set(sub, "use_threads", tt->threads, NULL);
+  cs_subset_str_native_set(sub, "sort", tt->sort, NULL);
+  cs_subset_str_native_set(sub, "sort_aux", tt->sort_aux, NULL);
+  cs_subset_str_native_set(sub, "strict_threads", tt->strict, NULL);
+  cs_subset_str_native_set(sub, "duplicate_threads", tt->duplicates, NULL);
+
+  struct Buffer *expected = buf_pool_get();
+  struct Buffer *actual = buf_pool_get();
+
+  struct MailboxView mv_inc = { 0 };
+  mv_inc.mailbox = test_mailbox();
+  mv_inc.threads = mutt_thread_ctx_init(&mv_inc);
+
+  int batch = 1;
+  int count = 5;
+  while (true)
+  {
+    const int old_count = mv_inc.mailbox->msg_count;
+    for (int i = old_count; i < count; i++)
+      mv_inc.mailbox->emails[mv_inc.mailbox->msg_count++] = test_email(i);
+
+    // A full rethread sees the Emails in their current order
+    int order[NUM_EMAILS] = { 0 };
+    for (int i = 0; i < count; i++)
+      order[i] = mv_inc.mailbox->emails[i]->index;
+
+    const int first_new = test_mview_update(&mv_inc);
+    if (old_count > 0)
+    {
+      // The new Emails were linked into the existing threads
+      TEST_CHECK(first_new == old_count);
+      TEST_MSG("Expected: %d", old_count);
+      TEST_MSG("Actual  : %d", first_new);
+    }
+    describe_view(mv_inc.mailbox, actual);
+
+    // Thread the same Emails from scratch
+    struct MailboxView mv_full = { 0 };
+    mv_full.mailbox = test_mailbox();
+    mv_full.threads = mutt_thread_ctx_init(&mv_full);
+    for (int i = 0; i < count; i++)
+      mv_full.mailbox->emails[mv_full.mailbox->msg_count++] = test_email(order[i]);
+    TEST_CHECK(test_mview_update(&mv_full) == -1);
+    describe_view(mv_full.mailbox, expected);
+    test_mailbox_free(&mv_full);
+
+    if (!TEST_CHECK_STR_EQ(buf_string(actual), buf_string(expected)))
+      TEST_MSG("After %d of %d Emails", count, NUM_EMAILS);
+
+    if (count == NUM_EMAILS)
+      break;
+    count = MIN(count + batch, NUM_EMAILS);
+    batch++;
+  }
+
+  test_mailbox_free(&mv_inc);
+  buf_pool_release(&expected);
+  buf_pool_release(&actual);
+}
+
+void test_mutt_sort_threads(void)
+{
+  // void mutt_sort_threads(struct ThreadsContext *tctx, bool init);
+
+  static const struct ThreadTest tests[] = {
+    // clang-format off
+    { "Date",                  UT_THREADS, SORT_DATE,                  SORT_DATE,                true,  true  },
+    { "Date, pseudo-threads",  UT_THREADS, SORT_DATE,                  SORT_DATE,                false, true  },
+    { "Reverse subject",       UT_THREADS, SORT_SUBJECT | SORT_REVERSE, SORT_DATE,               false, true  },
+    { "Last date",             UT_THREADS, SORT_DATE | SORT_LAST,      SORT_SIZE | SORT_REVERSE, false, false },
+    { "Reverse threads, size", UT_REVERSE, SORT_SIZE,                  SORT_ORDER,               false, true  },
+    { "Received",              UT_THREADS, SORT_RECEIVED,              SORT_RECEIVED,            true,  false },
+    // clang-format on
+  };
+
+  TEST_CHECK(cs_register_variables(NeoMutt->sub->cs, Vars, DT_NO_FLAGS));
+
+  {
+    mutt_sort_threads(NULL, true);
+    TEST_CHECK_(1, "mutt_sort_threads(NULL, true)");
+  }
+
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i].name);
+    test_threads(&tests[i]);
+  }
+}